@@ -0,0 +1,584 @@
+/*
+ * Microbenchmarks for individual internal kernels: FFT, NTT, signature
+ * decoding, the Keccak permutation, the base Gaussian sampler and the
+ * PRNG refill. speed.c measures whole operations through the external
+ * API; this program is meant to attribute a change in these to one
+ * kernel.
+ *
+ * Each kernel runs a fixed number of iterations (not a time threshold),
+ * so that two builds are always compared on the same work. A warmup run
+ * of a quarter of the iterations precedes the timed rounds; the minimum
+ * and median time per call over the rounds are reported, with TSC
+ * cycles per call on x86. With -perf, one more round is run with the
+ * hardware counters of perfctr.h enabled.
+ *
+ * Some kernels are static in their source file; shake.c and vrfy.c are
+ * included below, so this program is linked with the other library
+ * objects only.
+ *
+ * ==========================(LICENSE BEGIN)============================
+ *
+ * Copyright (c) 2025  Falcon QONE WASM Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ===========================(LICENSE END)=============================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "falcon.h"
+#include "perfctr.h"
+
+#include "shake.c"
+#include "vrfy.c"
+
+#if defined __x86_64__ || defined _M_X64 || defined __i386__ || defined _M_IX86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define HAVE_TSC   1
+#else
+#define HAVE_TSC   0
+#endif
+
+/*
+ * Number of timed rounds per kernel.
+ */
+#define ROUNDS   7
+
+/*
+ * Maximum degree (log2) of the polynomial kernels.
+ */
+#define MAX_LOGN   10
+
+static void *
+xmalloc(size_t len)
+{
+	void *buf;
+
+	buf = malloc(len);
+	if (buf == NULL) {
+		fprintf(stderr, "memory allocation error\n");
+		exit(EXIT_FAILURE);
+	}
+	return buf;
+}
+
+/*
+ * Shared state of all kernels. 'fsrc' and 'fsrc_fft' hold the FFT and
+ * iFFT inputs, restored before each call (FFT alone is not stable under
+ * repetition); the copy is included in the reported time, and is small
+ * against the transform itself.
+ */
+typedef struct {
+	unsigned logn;
+	fpr *f;
+	fpr *fsrc;
+	fpr *fsrc_fft;
+	uint16_t *h;
+	int16_t *s2;
+	uint8_t *sig;
+	size_t sig_len;
+	uint64_t A[25];
+	prng p;
+	volatile int sink;
+} kernel_context;
+
+typedef void (*kernel_fun)(kernel_context *kc, unsigned long num);
+
+static void
+kernel_fft(kernel_context *kc, unsigned long num)
+{
+	size_t len;
+
+	len = sizeof(fpr) << kc->logn;
+	while (num -- > 0) {
+		memcpy(kc->f, kc->fsrc, len);
+		Zf(FFT)(kc->f, kc->logn);
+	}
+}
+
+static void
+kernel_ifft(kernel_context *kc, unsigned long num)
+{
+	size_t len;
+
+	len = sizeof(fpr) << kc->logn;
+	while (num -- > 0) {
+		memcpy(kc->f, kc->fsrc_fft, len);
+		Zf(iFFT)(kc->f, kc->logn);
+	}
+}
+
+static void
+kernel_ntt(kernel_context *kc, unsigned long num)
+{
+	/*
+	 * Values stay in the 0..q-1 range, so the NTT can be applied
+	 * again to its own output.
+	 */
+	while (num -- > 0) {
+		mq_NTT(kc->h, kc->logn);
+	}
+}
+
+static void
+kernel_comp_decode(kernel_context *kc, unsigned long num)
+{
+	while (num -- > 0) {
+		if (Zf(comp_decode)(kc->s2, kc->logn,
+			kc->sig, kc->sig_len) != kc->sig_len)
+		{
+			fprintf(stderr, "comp_decode failed\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+static void
+kernel_process_block(kernel_context *kc, unsigned long num)
+{
+	while (num -- > 0) {
+		process_block(kc->A);
+	}
+}
+
+static void
+kernel_gaussian0(kernel_context *kc, unsigned long num)
+{
+	int s;
+
+	s = 0;
+	while (num -- > 0) {
+		s += Zf(gaussian0_sampler)(&kc->p);
+	}
+	kc->sink = s;
+}
+
+static void
+kernel_prng_refill(kernel_context *kc, unsigned long num)
+{
+	while (num -- > 0) {
+		Zf(prng_refill)(&kc->p);
+	}
+	kc->sink = kc->p.buf.d[0];
+}
+
+/*
+ * Kernels, with their iteration count per timed round. Kernels with
+ * 'poly' set are measured for degrees 512 and 1024; the iteration count
+ * is given for degree 512 and halved for degree 1024.
+ */
+static const struct {
+	const char *name;
+	kernel_fun fun;
+	int poly;
+	unsigned long iter;
+} kernels[] = {
+	{ "fft",               &kernel_fft,           1,     4000 },
+	{ "ifft",              &kernel_ifft,          1,     4000 },
+	{ "mq_ntt",            &kernel_ntt,           1,     8000 },
+	{ "comp_decode",       &kernel_comp_decode,   1,    20000 },
+	{ "process_block",     &kernel_process_block, 0,   100000 },
+	{ "gaussian0_sampler", &kernel_gaussian0,     0,  1000000 },
+	{ "prng_refill",       &kernel_prng_refill,   0,    50000 },
+	{ NULL, NULL, 0, 0 }
+};
+
+static double
+now_ns(void)
+{
+	struct timespec ts;
+
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec * 1000000000.0 + (double)ts.tv_nsec;
+}
+
+static uint64_t
+cycles(void)
+{
+#if HAVE_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static int
+cmp_double(const void *a, const void *b)
+{
+	double x, y;
+
+	x = *(const double *)a;
+	y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+/*
+ * Fill the context for degree 2^logn: random FFT input, random NTT
+ * input, and a compressed encoding of a vector with the distribution
+ * of a signature (Gaussian, sigma about 165 for degree 512).
+ */
+static void
+init_context(kernel_context *kc, unsigned logn)
+{
+	inner_shake256_context rng;
+	size_t n, u;
+
+	kc->logn = logn;
+	n = (size_t)1 << logn;
+	inner_shake256_init(&rng);
+	inner_shake256_inject(&rng, (const uint8_t *)"bench_kernels", 13);
+	inner_shake256_flip(&rng);
+	Zf(prng_init)(&kc->p, &rng);
+
+	for (u = 0; u < n; u ++) {
+		kc->fsrc[u] = fpr_of((int64_t)(prng_get_u8(&kc->p) & 0x3F) - 32);
+		kc->h[u] = (uint16_t)(prng_get_u64(&kc->p) % Q);
+	}
+	memcpy(kc->fsrc_fft, kc->fsrc, n * sizeof(fpr));
+	Zf(FFT)(kc->fsrc_fft, logn);
+
+	for (u = 0; u < n; u ++) {
+		int v, k;
+
+		/*
+		 * Sum of 12 uniform values in -32..31 is close to a
+		 * Gaussian of standard deviation 64; scaling by
+		 * 2.5 gives the right magnitude for the codec.
+		 */
+		v = 0;
+		for (k = 0; k < 12; k ++) {
+			v += (int)(prng_get_u8(&kc->p) & 0x3F) - 32;
+		}
+		kc->s2[u] = (int16_t)((v * 5) / 2);
+	}
+	kc->sig_len = Zf(comp_encode)(kc->sig, FALCON_SIG_COMPRESSED_MAXSIZE(MAX_LOGN),
+		kc->s2, logn);
+	if (kc->sig_len == 0) {
+		fprintf(stderr, "comp_encode failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (u = 0; u < 25; u ++) {
+		kc->A[u] = prng_get_u64(&kc->p);
+	}
+}
+
+/*
+ * Time one kernel: warmup, then ROUNDS rounds of 'iter' calls. Times
+ * are in nanoseconds per call; cyc is 0 if no cycle counter is used.
+ */
+static void
+run_kernel(kernel_context *kc, kernel_fun fun, unsigned long iter,
+	double *tmin, double *tmed, double *cyc)
+{
+	double t[ROUNDS];
+	uint64_t cmin;
+	int r;
+
+	fun(kc, iter / 4 + 1);
+	cmin = 0;
+	for (r = 0; r < ROUNDS; r ++) {
+		double t0;
+		uint64_t c0, c;
+
+		t0 = now_ns();
+		c0 = cycles();
+		fun(kc, iter);
+		c = cycles() - c0;
+		t[r] = (now_ns() - t0) / (double)iter;
+		if (r == 0 || c < cmin) {
+			cmin = c;
+		}
+	}
+	qsort(t, ROUNDS, sizeof t[0], &cmp_double);
+	*tmin = t[0];
+	*tmed = t[ROUNDS / 2];
+	*cyc = HAVE_TSC ? (double)cmin / (double)iter : 0.0;
+}
+
+/*
+ * One more round of 'iter' calls, with the hardware counters enabled;
+ * counts per call are written in cnt[] (-1.0 if not available).
+ */
+static void
+perf_kernel(kernel_context *kc, kernel_fun fun, unsigned long iter,
+	perfctr *pc, double *cnt)
+{
+	int i;
+
+	perfctr_start(pc);
+	fun(kc, iter);
+	perfctr_stop(pc);
+	for (i = 0; i < PERFCTR_NUM; i ++) {
+		cnt[i] = pc->ok[i] ? (double)pc->val[i] / (double)iter : -1.0;
+	}
+}
+
+/*
+ * Counter output; negative values are unavailable counters.
+ */
+static void
+print_count(double v, const char *fmt)
+{
+	if (v < 0.0) {
+		printf("null");
+	} else {
+		printf(fmt, v);
+	}
+}
+
+static void
+print_column(double v, const char *fmt, int width)
+{
+	if (v < 0.0) {
+		printf(" %*s", width, "-");
+	} else {
+		printf(" ");
+		printf(fmt, width, v);
+	}
+}
+
+static const char *
+platform_name(void)
+{
+#if defined __EMSCRIPTEN__
+	return "wasm";
+#elif defined __x86_64__ || defined _M_X64
+	return "native-x86_64";
+#elif defined __aarch64__
+	return "native-aarch64";
+#else
+	return "native";
+#endif
+}
+
+static int
+selected(const char *name, int argc, char *argv[])
+{
+	int i;
+
+	if (argc == 0) {
+		return 1;
+	}
+	for (i = 0; i < argc; i ++) {
+		if (strcmp(argv[i], name) == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	kernel_context kc;
+	perfctr pc;
+	size_t nmax;
+	unsigned long scale;
+	int json, perf, first, i, k;
+
+	json = 0;
+	perf = 0;
+	scale = 1;
+	argc --;
+	argv ++;
+	while (argc > 0 && argv[0][0] == '-') {
+		if (strcmp(argv[0], "-json") == 0) {
+			json = 1;
+		} else if (strcmp(argv[0], "-perf") == 0) {
+			perf = 1;
+		} else if (strcmp(argv[0], "-scale") == 0 && argc > 1) {
+			scale = strtoul(argv[1], NULL, 10);
+			argc --;
+			argv ++;
+		} else {
+			scale = 0;
+			break;
+		}
+		argc --;
+		argv ++;
+	}
+	for (i = 0; i < argc && scale != 0; i ++) {
+		for (k = 0; kernels[k].name != NULL; k ++) {
+			if (strcmp(argv[i], kernels[k].name) == 0) {
+				break;
+			}
+		}
+		if (kernels[k].name == NULL) {
+			scale = 0;
+		}
+	}
+	if (scale == 0) {
+		fprintf(stderr,
+"usage: bench_kernels [ -json ] [ -perf ] [ -scale N ] [ kernel... ]\n"
+"Times internal kernels with fixed iteration counts (multiplied by N,\n"
+"default 1). '-json' prints results as JSON (times in nanoseconds).\n"
+"'-perf' adds hardware counters per call (Linux perf_event_open()).\n"
+"Kernels:");
+		for (k = 0; kernels[k].name != NULL; k ++) {
+			fprintf(stderr, " %s", kernels[k].name);
+		}
+		fprintf(stderr, "\n");
+		exit(EXIT_FAILURE);
+	}
+
+	nmax = (size_t)1 << MAX_LOGN;
+	kc.f = xmalloc(nmax * sizeof(fpr));
+	kc.fsrc = xmalloc(nmax * sizeof(fpr));
+	kc.fsrc_fft = xmalloc(nmax * sizeof(fpr));
+	kc.h = xmalloc(nmax * sizeof(uint16_t));
+	kc.s2 = xmalloc(nmax * sizeof(int16_t));
+	kc.sig = xmalloc(FALCON_SIG_COMPRESSED_MAXSIZE(MAX_LOGN));
+	if (perf) {
+		int err;
+
+		if (perfctr_open(&pc, &err) == 0) {
+			fprintf(stderr, "hardware counters are not available");
+			if (err != 0) {
+				fprintf(stderr, " (perf_event_open: %s)",
+					strerror(err));
+			}
+			fprintf(stderr, "\n");
+		}
+	}
+
+	if (json) {
+		printf("{\n");
+		printf("  \"platform\": \"%s\",\n", platform_name());
+		printf("  \"rounds\": %d,\n", ROUNDS);
+		printf("  \"unit\": \"ns\",\n");
+		printf("  \"kernels\": [\n");
+	} else {
+		printf("%d rounds per kernel; time per call in nanoseconds%s\n",
+			ROUNDS, HAVE_TSC ? ", TSC cycles per call" : "");
+		printf("\n");
+		printf("kernel             degree  iterations      min   median%s%s\n",
+			HAVE_TSC ? "   cycles" : "",
+			perf ? "   IPC   br-miss  L1D-miss  LLC-miss" : "");
+	}
+	fflush(stdout);
+
+	first = 1;
+	for (k = 0; kernels[k].name != NULL; k ++) {
+		unsigned logn;
+
+		if (!selected(kernels[k].name, argc, argv)) {
+			continue;
+		}
+		for (logn = 9; logn <= MAX_LOGN; logn ++) {
+			unsigned long iter;
+			double tmin, tmed, cyc, cnt[PERFCTR_NUM], ipc;
+
+			if (!kernels[k].poly && logn > 9) {
+				break;
+			}
+			init_context(&kc, logn);
+			iter = kernels[k].iter * scale;
+			if (kernels[k].poly) {
+				iter >>= (logn - 9);
+			}
+			run_kernel(&kc, kernels[k].fun, iter, &tmin, &tmed, &cyc);
+			ipc = -1.0;
+			if (perf) {
+				perf_kernel(&kc, kernels[k].fun, iter, &pc, cnt);
+				if (cnt[PERFCTR_CYCLES] > 0.0
+					&& cnt[PERFCTR_INSTRUCTIONS] >= 0.0)
+				{
+					ipc = cnt[PERFCTR_INSTRUCTIONS]
+						/ cnt[PERFCTR_CYCLES];
+				}
+			}
+			if (json) {
+				printf("%s    { \"kernel\": \"%s\", ",
+					first ? "" : ",\n", kernels[k].name);
+				if (kernels[k].poly) {
+					printf("\"degree\": %u, ", 1u << logn);
+				} else {
+					printf("\"degree\": null, ");
+				}
+				printf("\"iterations\": %lu, \"min\": %.1f,"
+					" \"median\": %.1f, \"cycles\": ",
+					iter, tmin, tmed);
+				if (HAVE_TSC) {
+					printf("%.0f", cyc);
+				} else {
+					printf("null");
+				}
+				if (perf) {
+					printf(", \"ipc\": ");
+					print_count(ipc, "%.3f");
+					printf(", \"counters\": {");
+					for (i = 0; i < PERFCTR_NUM; i ++) {
+						printf("%s\"%s\": ", i == 0 ? " " : ", ",
+							perfctr_names[i]);
+						print_count(cnt[i], "%.1f");
+					}
+					printf(" }");
+				}
+				printf(" }");
+			} else {
+				printf("%-18s %6s %11lu %8.1f %8.1f",
+					kernels[k].name,
+					kernels[k].poly
+						? (logn == 9 ? "512" : "1024")
+						: "-",
+					iter, tmin, tmed);
+				if (HAVE_TSC) {
+					printf(" %8.0f", cyc);
+				}
+				if (perf) {
+					print_column(ipc, "%*.2f", 5);
+					print_column(cnt[PERFCTR_BRANCH_MISSES],
+						"%*.1f", 9);
+					print_column(cnt[PERFCTR_L1D_MISSES],
+						"%*.1f", 9);
+					print_column(cnt[PERFCTR_LLC_MISSES],
+						"%*.1f", 9);
+				}
+				printf("\n");
+			}
+			fflush(stdout);
+			first = 0;
+		}
+	}
+	if (json) {
+		printf("\n  ]\n");
+		printf("}\n");
+	}
+
+	free(kc.f);
+	free(kc.fsrc);
+	free(kc.fsrc_fft);
+	free(kc.h);
+	free(kc.s2);
+	free(kc.sig);
+	if (perf) {
+		perfctr_close(&pc);
+	}
+	return 0;
+}
@@ -208,6 +208,64 @@ Zf(trim_i16_decode)(
 	return in_len;
 }
 
+/* see inner.h */
+size_t
+Zf(trim_i16_decode_modq)(
+	uint16_t *x, uint32_t *sqn, unsigned logn, unsigned bits,
+	const void *in, size_t max_in_len)
+{
+	size_t n, in_len;
+	const uint8_t *buf;
+	size_t u;
+	uint32_t acc, mask1, mask2, sn, ng;
+	unsigned acc_len;
+
+	n = (size_t)1 << logn;
+	in_len = ((n * bits) + 7) >> 3;
+	if (in_len > max_in_len) {
+		return 0;
+	}
+	buf = in;
+	u = 0;
+	acc = 0;
+	acc_len = 0;
+	mask1 = ((uint32_t)1 << bits) - 1;
+	mask2 = (uint32_t)1 << (bits - 1);
+	sn = 0;
+	ng = 0;
+	while (u < n) {
+		acc = (acc << 8) | *buf ++;
+		acc_len += 8;
+		while (acc_len >= bits && u < n) {
+			uint32_t w;
+			int32_t z;
+
+			acc_len -= bits;
+			w = (acc >> acc_len) & mask1;
+			w |= -(w & mask2);
+			if (w == -mask2) {
+				/*
+				 * The -2^(bits-1) value is forbidden.
+				 */
+				return 0;
+			}
+			z = *(int32_t *)&w;
+			sn += (uint32_t)(z * z);
+			ng |= sn;
+			w += 12289 & -(w >> 31);
+			x[u ++] = (uint16_t)w;
+		}
+	}
+	if ((acc & (((uint32_t)1 << acc_len) - 1)) != 0) {
+		/*
+		 * Extra bits in the last byte must be zero.
+		 */
+		return 0;
+	}
+	*sqn = sn | -(ng >> 31);
+	return in_len;
+}
+
 /* see inner.h */
 size_t
 Zf(trim_i8_encode)(
@@ -472,6 +530,86 @@ Zf(comp_decode)(
 	return v;
 }
 
+/* see inner.h */
+size_t
+Zf(comp_decode_modq)(
+	uint16_t *x, uint32_t *sqn, unsigned logn,
+	const void *in, size_t max_in_len)
+{
+	const uint8_t *buf;
+	size_t n, u, v;
+	uint32_t acc, sn, ng;
+	unsigned acc_len;
+
+	n = (size_t)1 << logn;
+	buf = in;
+	acc = 0;
+	acc_len = 0;
+	v = 0;
+	sn = 0;
+	ng = 0;
+	for (u = 0; u < n; u ++) {
+		unsigned b, s, m;
+
+		/*
+		 * Get next eight bits: sign and low seven bits of the
+		 * absolute value.
+		 */
+		if (v >= max_in_len) {
+			return 0;
+		}
+		acc = (acc << 8) | (uint32_t)buf[v ++];
+		b = acc >> acc_len;
+		s = b & 128;
+		m = b & 127;
+
+		/*
+		 * Get next bits until a 1 is reached.
+		 */
+		for (;;) {
+			if (acc_len == 0) {
+				if (v >= max_in_len) {
+					return 0;
+				}
+				acc = (acc << 8) | (uint32_t)buf[v ++];
+				acc_len = 8;
+			}
+			acc_len --;
+			if (((acc >> acc_len) & 1) != 0) {
+				break;
+			}
+			m += 128;
+			if (m > 2047) {
+				return 0;
+			}
+		}
+
+		/*
+		 * "-0" is forbidden.
+		 */
+		if (s && m == 0) {
+			return 0;
+		}
+
+		/*
+		 * |x| <= 2047 < q, hence -x mod q is q - |x|.
+		 */
+		x[u] = (uint16_t)(s ? 12289 - m : m);
+		sn += (uint32_t)m * (uint32_t)m;
+		ng |= sn;
+	}
+
+	/*
+	 * Unused bits in the last byte must be zero.
+	 */
+	if ((acc & ((1u << acc_len) - 1u)) != 0) {
+		return 0;
+	}
+
+	*sqn = sn | -(ng >> 31);
+	return v;
+}
+
 /*
  * Key elements and signatures are polynomials with small integer
  * coefficients. Here are some statistics gathered over many
@@ -304,3 +304,18 @@ Zf(is_short_half)(
 
 	return sqn <= l2bound[logn];
 }
+
+/* see inner.h */
+int
+Zf(is_short_sqn)(uint32_t sqn1, uint32_t sqn2, unsigned logn)
+{
+	uint32_t s;
+
+	/*
+	 * Both inputs are below 2^31, or saturated to 2^32-1; in the
+	 * former case the sum cannot wrap around.
+	 */
+	s = sqn1 + sqn2;
+	s |= -((sqn1 | sqn2 | s) >> 31);
+	return s <= l2bound[logn];
+}
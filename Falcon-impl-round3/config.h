@@ -134,6 +134,28 @@
 #define FALCON_FMA   1
  */
 
+/*
+ * Enable use of WebAssembly SIMD128 intrinsics (compile with '-msimd128',
+ * e.g. with Emscripten). This requires FALCON_FPNATIVE and is exclusive
+ * with FALCON_AVX2. The FFT and polynomial operations in FFT
+ * representation then process two values at a time. Outputs are the
+ * same as with the plain native floating-point code.
+ *
+#define FALCON_WASM_SIMD   1
+ */
+
+/*
+ * Use relaxed-SIMD f64x2.relaxed_madd for the multiply-add steps of the
+ * FFT and polynomial operations (compile with '-mrelaxed-simd'). This
+ * setting has any effect only if FALCON_WASM_SIMD is also enabled. The
+ * engine may or may not fuse the operation; if it does, this has the
+ * same consequences as FALCON_FMA for AVX2. A WASM module compiled with
+ * this option will fail to load on engines that do not support
+ * relaxed-SIMD.
+ *
+#define FALCON_WASM_RELAXED   1
+ */
+
 /*
  * Assert that the platform uses little-endian encoding. If enabled,
  * then encoding and decoding of aligned multibyte values will be
@@ -171,6 +193,41 @@
 #define FALCON_KG_CHACHA20   1
  */
 
+/*
+ * Use POSIX threads in the batch functions of the external API:
+ * falcon_import_keys() then splits its key pairs over the requested
+ * number of threads, and the pipelined signing functions run sampling
+ * on worker threads, fed through a lock-free ring (this requires C11
+ * atomics), and a batch context (falcon_batch_ctx_init()) keeps a pool
+ * of worker threads that share the items of each batch call by work
+ * stealing. Results are the same with or without this setting.
+ * Programs must then be linked with -lpthread. This setting is not
+ * enabled by default.
+ *
+#define FALCON_THREADS   1
+ */
+
+/*
+ * Use POSIX threads in falcon_keygen_make_batch(): the rejection tests
+ * on each (f,g) candidate of a group (norm bounds, invertibility of f)
+ * then run on their own thread. The generated keys are the same with or
+ * without this setting. Programs must then be linked with -lpthread.
+ * If not defined explicitly, this follows FALCON_THREADS.
+ *
+#define FALCON_KG_THREADS   1
+ */
+
+/*
+ * Record the processor time spent at each depth of the NTRU equation
+ * solver during key pair generation; falcon_keygen_profile() returns
+ * the accumulated values (speed -kgdepth prints them). This is meant
+ * for benchmarking only: counters are global and not thread-safe, and
+ * each depth costs two clock() calls. This setting is not enabled by
+ * default.
+ *
+#define FALCON_KG_PROFILE   1
+ */
+
 /*
  * Use an explicit OS-provided source of randomness for seeding (for the
  * Zf(get_seed)() function implementation). Three possible sources are
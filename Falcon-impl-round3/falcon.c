@@ -32,6 +32,12 @@
 #include "falcon.h"
 #include "inner.h"
 
+#if FALCON_THREADS  // yyyTHREADS+1
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#endif  // yyyTHREADS-
+
 /* see falcon.h */
 void
 shake256_init(shake256_context *sc)
@@ -123,6 +129,115 @@ align_fpr(void *tmp)
 	return (fpr *)atmp;
 }
 
+/*
+ * Encode a private key (f, g, F) into privkey[], which has length
+ * FALCON_PRIVKEY_SIZE(logn). Returned value is 1 on success, 0 on error.
+ */
+static int
+encode_privkey(void *privkey,
+	const int8_t *f, const int8_t *g, const int8_t *F, unsigned logn)
+{
+	uint8_t *sk;
+	size_t u, v, sk_len;
+
+	sk = privkey;
+	sk_len = FALCON_PRIVKEY_SIZE(logn);
+	sk[0] = 0x50 + logn;
+	u = 1;
+	v = Zf(trim_i8_encode)(sk + u, sk_len - u,
+		f, logn, Zf(max_fg_bits)[logn]);
+	if (v == 0) {
+		return 0;
+	}
+	u += v;
+	v = Zf(trim_i8_encode)(sk + u, sk_len - u,
+		g, logn, Zf(max_fg_bits)[logn]);
+	if (v == 0) {
+		return 0;
+	}
+	u += v;
+	v = Zf(trim_i8_encode)(sk + u, sk_len - u,
+		F, logn, Zf(max_FG_bits)[logn]);
+	if (v == 0) {
+		return 0;
+	}
+	u += v;
+	return u == sk_len;
+}
+
+/*
+ * Encode a public key h into pubkey[], which has length
+ * FALCON_PUBKEY_SIZE(logn). Returned value is 1 on success, 0 on error.
+ */
+static int
+encode_pubkey(void *pubkey, const uint16_t *h, unsigned logn)
+{
+	uint8_t *pk;
+	size_t pk_len;
+
+	pk = pubkey;
+	pk_len = FALCON_PUBKEY_SIZE(logn);
+	pk[0] = 0x00 + logn;
+	return Zf(modq_encode)(pk + 1, pk_len - 1, h, logn) == pk_len - 1;
+}
+
+/*
+ * Common code for falcon_keygen_make() and falcon_keygen_make_batch();
+ * a batch of 0 means that the plain Zf(keygen)() is used. Sizes have
+ * already been checked by the caller.
+ */
+static int
+keygen_make_inner(shake256_context *rng, unsigned logn,
+	void *privkey, void *pubkey, void *tmp, unsigned batch)
+{
+	int8_t *f, *g, *F;
+	uint16_t *h;
+	uint8_t *atmp;
+	size_t n;
+	unsigned oldcw;
+
+	/*
+	 * Prepare buffers and generate private key.
+	 */
+	n = (size_t)1 << logn;
+	f = tmp;
+	g = f + n;
+	F = g + n;
+	atmp = align_u64(F + n);
+	oldcw = set_fpu_cw(2);
+	if (batch == 0) {
+		Zf(keygen)((inner_shake256_context *)rng,
+			f, g, F, NULL, NULL, logn, atmp);
+	} else {
+		Zf(keygen_batch)((inner_shake256_context *)rng,
+			f, g, F, NULL, NULL, logn, atmp, batch);
+	}
+	set_fpu_cw(oldcw);
+
+	/*
+	 * Encode private key.
+	 */
+	if (!encode_privkey(privkey, f, g, F, logn)) {
+		return FALCON_ERR_INTERNAL;
+	}
+
+	/*
+	 * Recompute public key and encode it.
+	 */
+	if (pubkey != NULL) {
+		h = (uint16_t *)align_u16(g + n);
+		atmp = (uint8_t *)(h + n);
+		if (!Zf(compute_public)(h, f, g, logn, atmp)) {
+			return FALCON_ERR_INTERNAL;
+		}
+		if (!encode_pubkey(pubkey, h, logn)) {
+			return FALCON_ERR_INTERNAL;
+		}
+	}
+
+	return 0;
+}
+
 /* see falcon.h */
 int
 falcon_keygen_make(
@@ -132,11 +247,68 @@ falcon_keygen_make(
 	void *pubkey, size_t pubkey_len,
 	void *tmp, size_t tmp_len)
 {
-	int8_t *f, *g, *F;
+	/*
+	 * Check parameters.
+	 */
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_BADARG;
+	}
+	if (privkey_len < FALCON_PRIVKEY_SIZE(logn)
+		|| (pubkey != NULL && pubkey_len < FALCON_PUBKEY_SIZE(logn))
+		|| tmp_len < FALCON_TMPSIZE_KEYGEN(logn))
+	{
+		return FALCON_ERR_SIZE;
+	}
+	return keygen_make_inner(rng, logn, privkey, pubkey, tmp, 0);
+}
+
+/* see falcon.h */
+int
+falcon_keygen_make_batch(
+	shake256_context *rng,
+	unsigned logn,
+	void *privkey, size_t privkey_len,
+	void *pubkey, size_t pubkey_len,
+	void *tmp, size_t tmp_len, unsigned batch)
+{
+	/*
+	 * Check parameters.
+	 */
+	if (logn < 1 || logn > 10
+		|| batch < 1 || batch > FALCON_KEYGEN_BATCH_MAX)
+	{
+		return FALCON_ERR_BADARG;
+	}
+	if (privkey_len < FALCON_PRIVKEY_SIZE(logn)
+		|| (pubkey != NULL && pubkey_len < FALCON_PUBKEY_SIZE(logn))
+		|| tmp_len < FALCON_TMPSIZE_KEYGEN_BATCH(logn, batch))
+	{
+		return FALCON_ERR_SIZE;
+	}
+	return keygen_make_inner(rng, logn, privkey, pubkey, tmp, batch);
+}
+
+/* see falcon.h */
+int
+falcon_keygen_profile(uint64_t *ns, size_t num, int reset)
+{
+	return Zf(keygen_profile)(ns, num, reset);
+}
+
+/* see falcon.h */
+int
+falcon_keygen_make_expanded(
+	shake256_context *rng,
+	unsigned logn,
+	void *privkey, size_t privkey_len,
+	void *pubkey, size_t pubkey_len,
+	void *expanded_key, size_t expanded_key_len,
+	void *tmp, size_t tmp_len)
+{
+	int8_t *f, *g, *F, *G;
 	uint16_t *h;
 	uint8_t *atmp;
-	size_t n, u, v, sk_len, pk_len;
-	uint8_t *sk, *pk;
+	size_t n;
 	unsigned oldcw;
 
 	/*
@@ -147,71 +319,43 @@ falcon_keygen_make(
 	}
 	if (privkey_len < FALCON_PRIVKEY_SIZE(logn)
 		|| (pubkey != NULL && pubkey_len < FALCON_PUBKEY_SIZE(logn))
-		|| tmp_len < FALCON_TMPSIZE_KEYGEN(logn))
+		|| expanded_key_len < FALCON_EXPANDEDKEY_SIZE(logn)
+		|| tmp_len < FALCON_TMPSIZE_KEYGEN_EXPANDED(logn))
 	{
 		return FALCON_ERR_SIZE;
 	}
 
 	/*
-	 * Prepare buffers and generate private key.
+	 * Generate the private key; Zf(keygen)() also returns G (from
+	 * the NTRU solver) and the public key h (from its own
+	 * invertibility test on f), so that neither has to be
+	 * recomputed. The tmp[] area after h is then reused for the
+	 * expansion.
 	 */
 	n = (size_t)1 << logn;
 	f = tmp;
 	g = f + n;
 	F = g + n;
-	atmp = align_u64(F + n);
+	G = F + n;
+	h = (uint16_t *)align_u16(G + n);
+	atmp = align_u64(h + n);
 	oldcw = set_fpu_cw(2);
 	Zf(keygen)((inner_shake256_context *)rng,
-		f, g, F, NULL, NULL, logn, atmp);
+		f, g, F, G, h, logn, atmp);
+	*(uint8_t *)expanded_key = logn;
+	Zf(expand_privkey)(align_fpr((uint8_t *)expanded_key + 1),
+		f, g, F, G, logn, atmp);
 	set_fpu_cw(oldcw);
 
 	/*
-	 * Encode private key.
+	 * Encode private and public keys.
 	 */
-	sk = privkey;
-	sk_len = FALCON_PRIVKEY_SIZE(logn);
-	sk[0] = 0x50 + logn;
-	u = 1;
-	v = Zf(trim_i8_encode)(sk + u, sk_len - u,
-		f, logn, Zf(max_fg_bits)[logn]);
-	if (v == 0) {
+	if (!encode_privkey(privkey, f, g, F, logn)) {
 		return FALCON_ERR_INTERNAL;
 	}
-	u += v;
-	v = Zf(trim_i8_encode)(sk + u, sk_len - u,
-		g, logn, Zf(max_fg_bits)[logn]);
-	if (v == 0) {
-		return FALCON_ERR_INTERNAL;
-	}
-	u += v;
-	v = Zf(trim_i8_encode)(sk + u, sk_len - u,
-		F, logn, Zf(max_FG_bits)[logn]);
-	if (v == 0) {
-		return FALCON_ERR_INTERNAL;
-	}
-	u += v;
-	if (u != sk_len) {
+	if (pubkey != NULL && !encode_pubkey(pubkey, h, logn)) {
 		return FALCON_ERR_INTERNAL;
 	}
-
-	/*
-	 * Recompute public key and encode it.
-	 */
-	if (pubkey != NULL) {
-		h = (uint16_t *)align_u16(g + n);
-		atmp = (uint8_t *)(h + n);
-		if (!Zf(compute_public)(h, f, g, logn, atmp)) {
-			return FALCON_ERR_INTERNAL;
-		}
-		pk = pubkey;
-		pk_len = FALCON_PUBKEY_SIZE(logn);
-		pk[0] = 0x00 + logn;
-		v = Zf(modq_encode)(pk + 1, pk_len - 1, h, logn);
-		if (v != pk_len - 1) {
-			return FALCON_ERR_INTERNAL;
-		}
-	}
-
 	return 0;
 }
 
@@ -294,80 +438,294 @@ falcon_make_public(
 	return 0;
 }
 
-/* see falcon.h */
-int
-falcon_get_logn(void *obj, size_t len)
+/*
+ * Maximum number of threads for falcon_import_keys().
+ */
+#define IMPORT_THREADS_MAX   64
+
+/*
+ * A range of key pairs checked by falcon_import_keys(), possibly on its
+ * own thread.
+ */
+typedef struct {
+	unsigned logn;
+	const uint8_t *sk;
+	const uint8_t *pk;
+	size_t count;
+	uint16_t *h_ntt;
+	int *results;
+	uint8_t *tmp;
+	size_t valid;
+} import_job;
+
+/*
+ * Check one key pair; tmp[] must have room for 9*2^logn bytes, with
+ * 16-bit alignment.
+ */
+static int
+import_key(unsigned logn, const uint8_t *sk, const uint8_t *pk,
+	uint16_t *h_ntt, uint8_t *tmp)
 {
-	int logn;
+	size_t n, u, v, sk_len, pk_len;
+	int8_t *f, *g, *F;
+	uint16_t *h, *hpub;
+	int ok;
 
-	if (len == 0) {
+	n = (size_t)1 << logn;
+	sk_len = FALCON_PRIVKEY_SIZE(logn);
+	pk_len = FALCON_PUBKEY_SIZE(logn);
+	h = (uint16_t *)tmp;
+	hpub = h + n;
+	f = (int8_t *)(hpub + 2 * n);
+	g = f + n;
+	F = g + n;
+
+	/*
+	 * Decode the public key first, so that its NTT form is produced
+	 * even if the private key turns out to be invalid.
+	 */
+	if (pk[0] != 0x00 + logn) {
 		return FALCON_ERR_FORMAT;
 	}
-	logn = *(uint8_t *)obj & 0x0F;
-	if (logn < 1 || logn > 10) {
+	if (Zf(modq_decode)(hpub, logn, pk + 1, pk_len - 1) != pk_len - 1) {
 		return FALCON_ERR_FORMAT;
 	}
-	return logn;
-}
-
-/* see falcon.h */
-int
-falcon_sign_start(shake256_context *rng,
-	void *nonce,
-	shake256_context *hash_data)
-{
-	shake256_extract(rng, nonce, 40);
-	shake256_init(hash_data);
-	shake256_inject(hash_data, nonce, 40);
-	return 0;
-}
-
-/* see falcon.h */
-int
-falcon_sign_dyn_finish(shake256_context *rng,
-	void *sig, size_t *sig_len, int sig_type,
-	const void *privkey, size_t privkey_len,
-	shake256_context *hash_data, const void *nonce,
-	void *tmp, size_t tmp_len)
-{
-	unsigned logn;
-	const uint8_t *sk;
-	uint8_t *es;
-	int8_t *f, *g, *F, *G;
-	uint16_t *hm;
-	int16_t *sv;
-	uint8_t *atmp;
-	size_t u, v, n, es_len;
-	unsigned oldcw;
-	inner_shake256_context sav_hash_data;
+	if (h_ntt != NULL) {
+		memcpy(h_ntt, hpub, n * sizeof *hpub);
+		Zf(to_ntt_monty)(h_ntt, logn);
+	}
 
 	/*
-	 * Get degree from private key header byte, and check
-	 * parameters.
+	 * Decode the private key (F is decoded only to validate the
+	 * encoding) and recompute the public key.
 	 */
-	if (privkey_len == 0) {
+	if (sk[0] != 0x50 + logn) {
 		return FALCON_ERR_FORMAT;
 	}
-	sk = privkey;
-	if ((sk[0] & 0xF0) != 0x50) {
+	u = 1;
+	v = Zf(trim_i8_decode)(f, logn, Zf(max_fg_bits)[logn],
+		sk + u, sk_len - u);
+	if (v == 0) {
 		return FALCON_ERR_FORMAT;
 	}
-	logn = sk[0] & 0x0F;
-	if (logn < 1 || logn > 10) {
+	u += v;
+	v = Zf(trim_i8_decode)(g, logn, Zf(max_fg_bits)[logn],
+		sk + u, sk_len - u);
+	if (v == 0) {
 		return FALCON_ERR_FORMAT;
 	}
-	if (privkey_len != FALCON_PRIVKEY_SIZE(logn)) {
+	u += v;
+	v = Zf(trim_i8_decode)(F, logn, Zf(max_FG_bits)[logn],
+		sk + u, sk_len - u);
+	if (v == 0 || u + v != sk_len) {
 		return FALCON_ERR_FORMAT;
 	}
-	if (tmp_len < FALCON_TMPSIZE_SIGNDYN(logn)) {
-		return FALCON_ERR_SIZE;
-	}
-	es_len = *sig_len;
-	if (es_len < 41) {
-		return FALCON_ERR_SIZE;
+	if (!Zf(compute_public)(h, f, g, logn, (uint8_t *)(h + 2 * n))) {
+		return FALCON_ERR_FORMAT;
 	}
-	switch (sig_type) {
-	case FALCON_SIG_COMPRESSED:
+	ok = memcmp(h, hpub, n * sizeof *h) == 0;
+	return ok ? 0 : FALCON_ERR_MISMATCH;
+}
+
+static void
+import_run(import_job *job)
+{
+	size_t n, u;
+
+	n = (size_t)1 << job->logn;
+	job->valid = 0;
+	for (u = 0; u < job->count; u ++) {
+		int r;
+
+		r = import_key(job->logn,
+			job->sk + u * FALCON_PRIVKEY_SIZE(job->logn),
+			job->pk + u * FALCON_PUBKEY_SIZE(job->logn),
+			job->h_ntt == NULL ? NULL : job->h_ntt + u * n,
+			job->tmp);
+		job->results[u] = r;
+		if (r == 0) {
+			job->valid ++;
+		}
+	}
+
+	/*
+	 * The scratch area held decoded private key elements.
+	 */
+	memset(job->tmp, 0, FALCON_TMPSIZE_IMPORT(job->logn) - 1);
+}
+
+#if FALCON_THREADS  // yyyTHREADS+1
+static void *
+import_thread(void *arg)
+{
+	import_run(arg);
+	return NULL;
+}
+#endif  // yyyTHREADS-
+
+/* see falcon.h */
+int
+falcon_import_keys(unsigned logn,
+	const void *privkeys, const void *pubkeys, size_t count,
+	uint16_t *h_ntt, int *results,
+	void *tmp, size_t tmp_len, unsigned nthreads)
+{
+	import_job jobs[IMPORT_THREADS_MAX];
+	size_t n, u, start, chunk, valid, tlen;
+	uint8_t *atmp;
+#if FALCON_THREADS  // yyyTHREADS+1
+	pthread_t th[IMPORT_THREADS_MAX];
+	int started[IMPORT_THREADS_MAX];
+#endif  // yyyTHREADS-
+
+	/*
+	 * Check parameters.
+	 */
+	if (logn < 1 || logn > 10
+		|| nthreads < 1 || nthreads > IMPORT_THREADS_MAX)
+	{
+		return FALCON_ERR_BADARG;
+	}
+	if (tmp_len < nthreads * FALCON_TMPSIZE_IMPORT(logn)) {
+		return FALCON_ERR_SIZE;
+	}
+	if (count == 0) {
+		return 0;
+	}
+
+	/*
+	 * Split the pairs into contiguous ranges of (almost) equal
+	 * sizes; each range gets its own 16-bit aligned scratch area.
+	 */
+	n = (size_t)1 << logn;
+	if (nthreads > count) {
+		nthreads = (unsigned)count;
+	}
+	tlen = FALCON_TMPSIZE_IMPORT(logn);
+	atmp = align_u16(tmp);
+	chunk = (count + nthreads - 1) / nthreads;
+	start = 0;
+	for (u = 0; u < nthreads; u ++) {
+		import_job *job;
+
+		job = &jobs[u];
+		job->logn = logn;
+		job->sk = (const uint8_t *)privkeys
+			+ start * FALCON_PRIVKEY_SIZE(logn);
+		job->pk = (const uint8_t *)pubkeys
+			+ start * FALCON_PUBKEY_SIZE(logn);
+		job->count = count - start < chunk ? count - start : chunk;
+		job->h_ntt = h_ntt == NULL ? NULL : h_ntt + start * n;
+		job->results = results + start;
+		job->tmp = atmp + u * (tlen - 1);
+		start += job->count;
+	}
+
+#if FALCON_THREADS  // yyyTHREADS+1
+	for (u = 1; u < nthreads; u ++) {
+		started[u] = pthread_create(&th[u], NULL,
+			import_thread, &jobs[u]) == 0;
+		if (!started[u]) {
+			import_run(&jobs[u]);
+		}
+	}
+	import_run(&jobs[0]);
+	for (u = 1; u < nthreads; u ++) {
+		if (started[u]) {
+			pthread_join(th[u], NULL);
+		}
+	}
+#else // yyyTHREADS+0
+	for (u = 0; u < nthreads; u ++) {
+		import_run(&jobs[u]);
+	}
+#endif  // yyyTHREADS-
+
+	valid = 0;
+	for (u = 0; u < nthreads; u ++) {
+		valid += jobs[u].valid;
+	}
+	return (int)valid;
+}
+
+/* see falcon.h */
+int
+falcon_get_logn(void *obj, size_t len)
+{
+	int logn;
+
+	if (len == 0) {
+		return FALCON_ERR_FORMAT;
+	}
+	logn = *(uint8_t *)obj & 0x0F;
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_FORMAT;
+	}
+	return logn;
+}
+
+/* see falcon.h */
+int
+falcon_sign_start(shake256_context *rng,
+	void *nonce,
+	shake256_context *hash_data)
+{
+	shake256_extract(rng, nonce, 40);
+	shake256_init(hash_data);
+	shake256_inject(hash_data, nonce, 40);
+	return 0;
+}
+
+/*
+ * Common code for falcon_sign_dyn_finish() and falcon_sign_dyn_hm(): the
+ * point to sign is either obtained from hash_data (if hm_in is NULL), or
+ * copied from hm_in.
+ */
+static int
+sign_dyn_inner(shake256_context *rng,
+	void *sig, size_t *sig_len, int sig_type,
+	const void *privkey, size_t privkey_len,
+	shake256_context *hash_data, const uint16_t *hm_in,
+	const void *nonce, void *tmp, size_t tmp_len)
+{
+	unsigned logn;
+	const uint8_t *sk;
+	uint8_t *es;
+	int8_t *f, *g, *F, *G;
+	uint16_t *hm;
+	int16_t *sv;
+	uint8_t *atmp;
+	size_t u, v, n, es_len;
+	unsigned oldcw;
+	inner_shake256_context sav_hash_data;
+
+	/*
+	 * Get degree from private key header byte, and check
+	 * parameters.
+	 */
+	if (privkey_len == 0) {
+		return FALCON_ERR_FORMAT;
+	}
+	sk = privkey;
+	if ((sk[0] & 0xF0) != 0x50) {
+		return FALCON_ERR_FORMAT;
+	}
+	logn = sk[0] & 0x0F;
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_FORMAT;
+	}
+	if (privkey_len != FALCON_PRIVKEY_SIZE(logn)) {
+		return FALCON_ERR_FORMAT;
+	}
+	if (tmp_len < FALCON_TMPSIZE_SIGNDYN_LOWMEM(logn)) {
+		return FALCON_ERR_SIZE;
+	}
+	es_len = *sig_len;
+	if (es_len < 41) {
+		return FALCON_ERR_SIZE;
+	}
+	switch (sig_type) {
+	case FALCON_SIG_COMPRESSED:
 		break;
 	case FALCON_SIG_PADDED:
 		if (*sig_len < FALCON_SIG_PADDED_SIZE(logn)) {
@@ -423,8 +781,10 @@ falcon_sign_dyn_finish(shake256_context *rng,
 	/*
 	 * Hash message to a point.
 	 */
-	shake256_flip(hash_data);
-	sav_hash_data = *(inner_shake256_context *)hash_data;
+	if (hm_in == NULL) {
+		shake256_flip(hash_data);
+		sav_hash_data = *(inner_shake256_context *)hash_data;
+	}
 
 	/*
 	 * Compute and encode signature.
@@ -437,19 +797,32 @@ falcon_sign_dyn_finish(shake256_context *rng,
 		 * we overwrite the hash output with the signature (in order
 		 * to save some RAM).
 		 */
-		*(inner_shake256_context *)hash_data = sav_hash_data;
-		if (sig_type == FALCON_SIG_CT) {
-			Zf(hash_to_point_ct)(
-				(inner_shake256_context *)hash_data,
-				hm, logn, atmp);
+		if (hm_in != NULL) {
+			memcpy(hm, hm_in, n * sizeof *hm);
 		} else {
-			Zf(hash_to_point_vartime)(
-				(inner_shake256_context *)hash_data,
-				hm, logn);
+			*(inner_shake256_context *)hash_data = sav_hash_data;
+			if (sig_type == FALCON_SIG_CT) {
+				Zf(hash_to_point_ct)(
+					(inner_shake256_context *)hash_data,
+					hm, logn, atmp);
+			} else {
+				Zf(hash_to_point_vartime)(
+					(inner_shake256_context *)hash_data,
+					hm, logn);
+			}
 		}
+		/*
+		 * A buffer smaller than FALCON_TMPSIZE_SIGNDYN selects the
+		 * low-memory variant; both yield the same signature.
+		 */
 		oldcw = set_fpu_cw(2);
-		Zf(sign_dyn)(sv, (inner_shake256_context *)rng,
-			f, g, F, G, hm, logn, atmp);
+		if (tmp_len >= FALCON_TMPSIZE_SIGNDYN(logn)) {
+			Zf(sign_dyn)(sv, (inner_shake256_context *)rng,
+				f, g, F, G, hm, logn, atmp);
+		} else {
+			Zf(sign_dyn_lowmem)(sv, (inner_shake256_context *)rng,
+				f, g, F, G, hm, logn, atmp);
+		}
 		set_fpu_cw(oldcw);
 		es = sig;
 		es_len = *sig_len;
@@ -494,6 +867,30 @@ falcon_sign_dyn_finish(shake256_context *rng,
 	}
 }
 
+/* see falcon.h */
+int
+falcon_sign_dyn_finish(shake256_context *rng,
+	void *sig, size_t *sig_len, int sig_type,
+	const void *privkey, size_t privkey_len,
+	shake256_context *hash_data, const void *nonce,
+	void *tmp, size_t tmp_len)
+{
+	return sign_dyn_inner(rng, sig, sig_len, sig_type,
+		privkey, privkey_len, hash_data, NULL, nonce, tmp, tmp_len);
+}
+
+/* see falcon.h */
+int
+falcon_sign_dyn_hm(shake256_context *rng,
+	void *sig, size_t *sig_len, int sig_type,
+	const void *privkey, size_t privkey_len,
+	const uint16_t *hm, const void *nonce,
+	void *tmp, size_t tmp_len)
+{
+	return sign_dyn_inner(rng, sig, sig_len, sig_type,
+		privkey, privkey_len, NULL, hm, nonce, tmp, tmp_len);
+}
+
 /* see falcon.h */
 int
 falcon_expand_privkey(void *expanded_key, size_t expanded_key_len,
@@ -578,13 +975,206 @@ falcon_expand_privkey(void *expanded_key, size_t expanded_key_len,
 	return 0;
 }
 
+/*
+ * Serialized expanded keys: header bytes and value size (the expanded key
+ * values start at the first 8-byte boundary after the logn byte).
+ */
+#define EKBLOB_HEADER    32
+#define EKBLOB_VERSION   1
+#define EKBLOB_VALUES(logn)   (((size_t)8 * (logn) + 40) << (logn))
+
+static uint64_t
+dec64le(const uint8_t *buf)
+{
+	return (uint64_t)buf[0]
+		| ((uint64_t)buf[1] << 8)
+		| ((uint64_t)buf[2] << 16)
+		| ((uint64_t)buf[3] << 24)
+		| ((uint64_t)buf[4] << 32)
+		| ((uint64_t)buf[5] << 40)
+		| ((uint64_t)buf[6] << 48)
+		| ((uint64_t)buf[7] << 56);
+}
+
+static void
+enc64le(uint8_t *buf, uint64_t x)
+{
+	int i;
+
+	for (i = 0; i < 8; i ++) {
+		buf[i] = (uint8_t)(x >> (i << 3));
+	}
+}
+
+/*
+ * Byte order of the 64-bit values on this platform (1 = little-endian,
+ * 2 = big-endian), as recorded in blob headers.
+ */
+static unsigned
+ekblob_byte_order(void)
+{
+	const union {
+		uint64_t w;
+		uint8_t b[8];
+	} probe = { 1 };
+
+	return probe.b[0] == 1 ? 1 : 2;
+}
+
+/*
+ * Fletcher-style checksum over 64-bit little-endian words: header bytes
+ * 0 to 15 and 24 to 31, then the expanded key values. The checksum field
+ * itself (bytes 16 to 23) is skipped. 'len' is the total blob length, a
+ * multiple of 8.
+ */
+static uint64_t
+ekblob_checksum(const uint8_t *blob, size_t len)
+{
+	uint64_t s1, s2;
+	size_t u;
+
+	s1 = 0;
+	s2 = 0;
+	for (u = 0; u < len; u += 8) {
+		if (u == 16) {
+			continue;
+		}
+		s1 += dec64le(blob + u);
+		s2 += s1;
+	}
+	return s1 ^ (s2 << 1) ^ (s2 >> 63);
+}
+
+/*
+ * Check the header and checksum of a serialized expanded key; on success,
+ * logn is returned. On error, a negative error code is returned.
+ */
+static int
+ekblob_check(const uint8_t *buf, size_t blob_len)
+{
+	unsigned logn;
+	size_t u;
+
+	if (blob_len < EKBLOB_HEADER) {
+		return FALCON_ERR_FORMAT;
+	}
+	logn = buf[5];
+	if (buf[0] != 'F' || buf[1] != 'X' || buf[2] != 'K' || buf[3] != 0x1A
+		|| buf[4] != EKBLOB_VERSION || logn < 1 || logn > 10
+		|| buf[6] != ekblob_byte_order() || buf[7] != 0
+		|| buf[31] != logn)
+	{
+		return FALCON_ERR_FORMAT;
+	}
+	for (u = 24; u < 31; u ++) {
+		if (buf[u] != 0) {
+			return FALCON_ERR_FORMAT;
+		}
+	}
+	if (dec64le(buf + 8) != (uint64_t)EKBLOB_VALUES(logn)
+		|| blob_len != FALCON_EXPANDEDKEY_BLOB_SIZE(logn))
+	{
+		return FALCON_ERR_FORMAT;
+	}
+	if (dec64le(buf + 16) != ekblob_checksum(buf, blob_len)) {
+		return FALCON_ERR_FORMAT;
+	}
+	return (int)logn;
+}
+
 /* see falcon.h */
 int
-falcon_sign_tree_finish(shake256_context *rng,
+falcon_expanded_key_save(void *blob, size_t blob_len,
+	const void *expanded_key)
+{
+	unsigned logn;
+	uint8_t *buf;
+	const uint8_t *values;
+
+	logn = *(const uint8_t *)expanded_key;
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_FORMAT;
+	}
+	if (blob_len < FALCON_EXPANDEDKEY_BLOB_SIZE(logn)) {
+		return FALCON_ERR_SIZE;
+	}
+	blob_len = FALCON_EXPANDEDKEY_BLOB_SIZE(logn);
+
+	/*
+	 * Values are moved first, since the expanded key may overlap
+	 * with the blob.
+	 */
+	buf = blob;
+	values = (const uint8_t *)align_fpr((uint8_t *)expanded_key + 1);
+	memmove(buf + EKBLOB_HEADER, values, EKBLOB_VALUES(logn));
+	memcpy(buf, "FXK\x1A", 4);
+	buf[4] = EKBLOB_VERSION;
+	buf[5] = (uint8_t)logn;
+	buf[6] = (uint8_t)ekblob_byte_order();
+	buf[7] = 0;
+	enc64le(buf + 8, (uint64_t)EKBLOB_VALUES(logn));
+	memset(buf + 16, 0, 15);
+	buf[31] = (uint8_t)logn;
+	enc64le(buf + 16, ekblob_checksum(buf, blob_len));
+	return 0;
+}
+
+/* see falcon.h */
+int
+falcon_expanded_key_open(const void **expanded_key,
+	const void *blob, size_t blob_len)
+{
+	int r;
+
+	if (((uintptr_t)blob & 7u) != 0) {
+		return FALCON_ERR_BADARG;
+	}
+	r = ekblob_check(blob, blob_len);
+	if (r < 0) {
+		return r;
+	}
+
+	/*
+	 * Byte 31 holds logn and the values start at byte 32, i.e. the
+	 * first 8-byte boundary after it: this is the in-memory layout
+	 * of an expanded key.
+	 */
+	*expanded_key = (const uint8_t *)blob + EKBLOB_HEADER - 1;
+	return 0;
+}
+
+/* see falcon.h */
+int
+falcon_expanded_key_load(void *expanded_key, size_t expanded_key_len,
+	const void *blob, size_t blob_len)
+{
+	int r;
+	unsigned logn;
+
+	r = ekblob_check(blob, blob_len);
+	if (r < 0) {
+		return r;
+	}
+	logn = (unsigned)r;
+	if (expanded_key_len < FALCON_EXPANDEDKEY_SIZE(logn)) {
+		return FALCON_ERR_SIZE;
+	}
+	*(uint8_t *)expanded_key = (uint8_t)logn;
+	memcpy(align_fpr((uint8_t *)expanded_key + 1),
+		(const uint8_t *)blob + EKBLOB_HEADER, EKBLOB_VALUES(logn));
+	return 0;
+}
+
+/*
+ * Common code for falcon_sign_tree_finish() and falcon_sign_tree_hm();
+ * see sign_dyn_inner().
+ */
+static int
+sign_tree_inner(shake256_context *rng,
 	void *sig, size_t *sig_len, int sig_type,
 	const void *expanded_key,
-	shake256_context *hash_data, const void *nonce,
-	void *tmp, size_t tmp_len)
+	shake256_context *hash_data, const uint16_t *hm_in,
+	const void *nonce, void *tmp, size_t tmp_len)
 {
 	unsigned logn;
 	uint8_t *es;
@@ -637,8 +1227,10 @@ falcon_sign_tree_finish(shake256_context *rng,
 	/*
 	 * Hash message to a point.
 	 */
-	shake256_flip(hash_data);
-	sav_hash_data = *(inner_shake256_context *)hash_data;
+	if (hm_in == NULL) {
+		shake256_flip(hash_data);
+		sav_hash_data = *(inner_shake256_context *)hash_data;
+	}
 
 	/*
 	 * Compute and encode signature.
@@ -651,15 +1243,19 @@ falcon_sign_tree_finish(shake256_context *rng,
 		 * we overwrite the hash output with the signature (in order
 		 * to save some RAM).
 		 */
-		*(inner_shake256_context *)hash_data = sav_hash_data;
-		if (sig_type == FALCON_SIG_CT) {
-			Zf(hash_to_point_ct)(
-				(inner_shake256_context *)hash_data,
-				hm, logn, atmp);
+		if (hm_in != NULL) {
+			memcpy(hm, hm_in, n * sizeof *hm);
 		} else {
-			Zf(hash_to_point_vartime)(
-				(inner_shake256_context *)hash_data,
-				hm, logn);
+			*(inner_shake256_context *)hash_data = sav_hash_data;
+			if (sig_type == FALCON_SIG_CT) {
+				Zf(hash_to_point_ct)(
+					(inner_shake256_context *)hash_data,
+					hm, logn, atmp);
+			} else {
+				Zf(hash_to_point_vartime)(
+					(inner_shake256_context *)hash_data,
+					hm, logn);
+			}
 		}
 		oldcw = set_fpu_cw(2);
 		Zf(sign_tree)(sv, (inner_shake256_context *)rng,
@@ -710,23 +1306,47 @@ falcon_sign_tree_finish(shake256_context *rng,
 
 /* see falcon.h */
 int
-falcon_sign_dyn(shake256_context *rng,
+falcon_sign_tree_finish(shake256_context *rng,
 	void *sig, size_t *sig_len, int sig_type,
-	const void *privkey, size_t privkey_len,
-	const void *data, size_t data_len,
+	const void *expanded_key,
+	shake256_context *hash_data, const void *nonce,
 	void *tmp, size_t tmp_len)
 {
-	shake256_context hd;
-	uint8_t nonce[40];
-	int r;
-
-	r = falcon_sign_start(rng, nonce, &hd);
-	if (r != 0) {
-		return r;
-	}
-	shake256_inject(&hd, data, data_len);
-	return falcon_sign_dyn_finish(rng, sig, sig_len, sig_type,
-		privkey, privkey_len, &hd, nonce, tmp, tmp_len);
+	return sign_tree_inner(rng, sig, sig_len, sig_type,
+		expanded_key, hash_data, NULL, nonce, tmp, tmp_len);
+}
+
+/* see falcon.h */
+int
+falcon_sign_tree_hm(shake256_context *rng,
+	void *sig, size_t *sig_len, int sig_type,
+	const void *expanded_key,
+	const uint16_t *hm, const void *nonce,
+	void *tmp, size_t tmp_len)
+{
+	return sign_tree_inner(rng, sig, sig_len, sig_type,
+		expanded_key, NULL, hm, nonce, tmp, tmp_len);
+}
+
+/* see falcon.h */
+int
+falcon_sign_dyn(shake256_context *rng,
+	void *sig, size_t *sig_len, int sig_type,
+	const void *privkey, size_t privkey_len,
+	const void *data, size_t data_len,
+	void *tmp, size_t tmp_len)
+{
+	shake256_context hd;
+	uint8_t nonce[40];
+	int r;
+
+	r = falcon_sign_start(rng, nonce, &hd);
+	if (r != 0) {
+		return r;
+	}
+	shake256_inject(&hd, data, data_len);
+	return falcon_sign_dyn_finish(rng, sig, sig_len, sig_type,
+		privkey, privkey_len, &hd, nonce, tmp, tmp_len);
 }
 
 /* see falcon.h */
@@ -750,6 +1370,535 @@ falcon_sign_tree(shake256_context *rng,
 		expanded_key, &hd, nonce, tmp, tmp_len);
 }
 
+/* see falcon.h */
+int
+falcon_hash_to_point(shake256_context *hash_data, unsigned logn,
+	int sig_type, uint16_t *hm, void *tmp, size_t tmp_len)
+{
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_BADARG;
+	}
+	if (tmp_len < FALCON_TMPSIZE_HASHTOPOINT(logn)) {
+		return FALCON_ERR_SIZE;
+	}
+	shake256_flip(hash_data);
+	if (sig_type == FALCON_SIG_CT) {
+		Zf(hash_to_point_ct)((inner_shake256_context *)hash_data,
+			hm, logn, align_u16(tmp));
+	} else {
+		Zf(hash_to_point_vartime)((inner_shake256_context *)hash_data,
+			hm, logn);
+	}
+	return 0;
+}
+
+/*
+ * Pipelined signing. The calling thread is the hash stage: for each job,
+ * it draws the nonce and a per-job sampling seed from the caller's RNG,
+ * absorbs nonce and message, and computes the point hm. The (hm, nonce,
+ * seed) triplet then goes to the sampling workers through a bounded ring;
+ * since everything random is drawn by the hash stage, in job order,
+ * signatures do not depend on which worker handles which job.
+ */
+
+typedef struct {
+	int sig_type;
+	const void *key;
+	size_t key_len;         /* 0 for an expanded key */
+	unsigned logn;
+	falcon_sign_job *jobs;
+	size_t wtmp_len;
+} sign_pipe;
+
+/*
+ * Sign one job from its point, nonce and sampling seed. wtmp[] has size
+ * sp->wtmp_len.
+ */
+static int
+sign_pipe_job(const sign_pipe *sp, falcon_sign_job *job,
+	const uint16_t *hm, const uint8_t *nonce, const uint8_t *seed,
+	uint8_t *wtmp)
+{
+	shake256_context rng;
+	int r;
+
+	shake256_init_prng_from_seed(&rng, seed, 48);
+	shake256_flip(&rng);
+	if (sp->key_len == 0) {
+		r = falcon_sign_tree_hm(&rng, job->sig, &job->sig_len,
+			sp->sig_type, sp->key, hm, nonce, wtmp, sp->wtmp_len);
+	} else {
+		r = falcon_sign_dyn_hm(&rng, job->sig, &job->sig_len,
+			sp->sig_type, sp->key, sp->key_len, hm, nonce,
+			wtmp, sp->wtmp_len);
+	}
+	memset(&rng, 0, sizeof rng);
+	return r;
+}
+
+/*
+ * Hash stage for one job: draw nonce and sampling seed, then absorb
+ * nonce and message into *hd (left in input mode).
+ */
+static void
+sign_pipe_absorb(shake256_context *rng, const falcon_sign_job *job,
+	shake256_context *hd, uint8_t *nonce, uint8_t *seed)
+{
+	shake256_extract(rng, nonce, 40);
+	shake256_extract(rng, seed, 48);
+	shake256_init(hd);
+	shake256_inject(hd, nonce, 40);
+	shake256_inject(hd, job->data, job->data_len);
+}
+
+/*
+ * Maximum number of sampling workers.
+ */
+#define SIGN_PIPE_WORKERS_MAX   64
+
+#if FALCON_THREADS  // yyyTHREADS+1
+
+/*
+ * Job index that tells a worker to exit.
+ */
+#define SIGN_PIPE_STOP   ((size_t)-1)
+
+/*
+ * One ring slot; the point hm (2^logn values) follows the structure.
+ * The slot at position p (modulo the ring size) may be written by the
+ * producer when seq == p, and read by a consumer when seq == p + 1;
+ * after reading, the consumer sets seq to p + ring_size.
+ */
+typedef struct {
+	atomic_size_t seq;
+	size_t job;
+	uint8_t nonce[40];
+	uint8_t seed[48];
+} sign_pipe_cell;
+
+/*
+ * Number of sched_yield() rounds a thread spends waiting on the ring
+ * before it blocks.
+ */
+#define SIGN_PIPE_SPIN   64
+
+/*
+ * Blocking fallback for the ring. A worker that finds the ring empty,
+ * or the hash stage that finds its slot busy, spins SIGN_PIPE_SPIN
+ * times, then sleeps on a condition variable: 'filled' is signalled when
+ * the hash stage publishes a slot, 'freed' when a worker releases one.
+ * The waiter counts let the other side skip the mutex when no thread
+ * sleeps: a waiter increments its count before checking the slot again,
+ * and a publisher checks the count after writing the slot, with a full
+ * fence on both sides, so that at least one of them sees the other.
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t filled;
+	pthread_cond_t freed;
+	atomic_uint workers_waiting;
+	atomic_uint producer_waiting;
+} sign_pipe_sync;
+
+typedef struct {
+	const sign_pipe *sp;
+	sign_pipe_sync *sync;
+	uint8_t *cells;
+	size_t cell_len;
+	size_t mask;
+	atomic_size_t *head;
+	uint16_t *hm;
+	uint8_t *wtmp;
+} sign_pipe_worker;
+
+/*
+ * Wake the threads sleeping on cv, if any (waiting is their count).
+ * This must be called after the slot update it reports.
+ */
+static void
+sign_pipe_wake(sign_pipe_sync *sy, atomic_uint *waiting, pthread_cond_t *cv)
+{
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_load_explicit(waiting, memory_order_relaxed) != 0) {
+		pthread_mutex_lock(&sy->lock);
+		pthread_cond_broadcast(cv);
+		pthread_mutex_unlock(&sy->lock);
+	}
+}
+
+static inline sign_pipe_cell *
+sign_pipe_cell_at(uint8_t *cells, size_t cell_len, size_t mask, size_t pos)
+{
+	return (sign_pipe_cell *)(cells + (pos & mask) * cell_len);
+}
+
+static void *
+sign_pipe_worker_run(void *arg)
+{
+	sign_pipe_worker *w;
+	const sign_pipe *sp;
+	sign_pipe_sync *sy;
+	size_t n;
+	uint8_t nonce[40], seed[48];
+
+	w = arg;
+	sp = w->sp;
+	sy = w->sync;
+	n = (size_t)1 << sp->logn;
+	for (;;) {
+		sign_pipe_cell *cell;
+		size_t pos, seq, job;
+		unsigned spins;
+
+		/*
+		 * Claim the slot at the head of the ring. Several workers
+		 * compete for it; the CAS decides which one gets it.
+		 */
+		pos = atomic_load_explicit(w->head, memory_order_relaxed);
+		spins = 0;
+		for (;;) {
+			cell = sign_pipe_cell_at(w->cells,
+				w->cell_len, w->mask, pos);
+			seq = atomic_load_explicit(&cell->seq,
+				memory_order_acquire);
+			if (seq == pos + 1) {
+				if (atomic_compare_exchange_weak_explicit(
+					w->head, &pos, pos + 1,
+					memory_order_relaxed,
+					memory_order_relaxed))
+				{
+					break;
+				}
+			} else if (seq == pos) {
+				/*
+				 * Ring is empty: wait for the hash stage,
+				 * which may be absorbing a long message.
+				 */
+				if (++ spins < SIGN_PIPE_SPIN) {
+					sched_yield();
+				} else {
+					spins = 0;
+					pthread_mutex_lock(&sy->lock);
+					atomic_fetch_add_explicit(
+						&sy->workers_waiting, 1,
+						memory_order_relaxed);
+					atomic_thread_fence(
+						memory_order_seq_cst);
+					for (;;) {
+						pos = atomic_load_explicit(
+							w->head,
+							memory_order_relaxed);
+						cell = sign_pipe_cell_at(
+							w->cells, w->cell_len,
+							w->mask, pos);
+						if (atomic_load_explicit(
+							&cell->seq,
+							memory_order_relaxed)
+							!= pos)
+						{
+							break;
+						}
+						pthread_cond_wait(&sy->filled,
+							&sy->lock);
+					}
+					atomic_fetch_sub_explicit(
+						&sy->workers_waiting, 1,
+						memory_order_relaxed);
+					pthread_mutex_unlock(&sy->lock);
+				}
+				pos = atomic_load_explicit(w->head,
+					memory_order_relaxed);
+			} else {
+				pos = atomic_load_explicit(w->head,
+					memory_order_relaxed);
+			}
+		}
+
+		/*
+		 * Copy the slot contents and release it at once, so that
+		 * the hash stage can move on while we sample.
+		 */
+		job = cell->job;
+		memcpy(nonce, cell->nonce, sizeof nonce);
+		memcpy(seed, cell->seed, sizeof seed);
+		memcpy(w->hm, cell + 1, n * sizeof *w->hm);
+		atomic_store_explicit(&cell->seq, pos + w->mask + 1,
+			memory_order_release);
+		sign_pipe_wake(sy, &sy->producer_waiting, &sy->freed);
+		if (job == SIGN_PIPE_STOP) {
+			break;
+		}
+		sp->jobs[job].status = sign_pipe_job(sp, &sp->jobs[job],
+			w->hm, nonce, seed, w->wtmp);
+	}
+	memset(seed, 0, sizeof seed);
+	return NULL;
+}
+
+/*
+ * Threaded pipeline; returns 0 on success, or -1 if no worker thread
+ * could be started (the caller then falls back to sequential signing,
+ * nothing having been consumed from the RNG).
+ */
+static int
+sign_pipe_threaded(const sign_pipe *sp, shake256_context *rng,
+	size_t count, uint8_t *atmp, unsigned nworkers, unsigned ring_size)
+{
+	sign_pipe_worker w[SIGN_PIPE_WORKERS_MAX];
+	pthread_t th[SIGN_PIPE_WORKERS_MAX];
+	sign_pipe_sync sy;
+	atomic_size_t head;
+	uint8_t *htmp, *cells;
+	size_t n, hlen, cell_len, mask, pos, u;
+	unsigned started, k;
+
+	n = (size_t)1 << sp->logn;
+	hlen = ((n << 1) + 7) & ~(size_t)7;
+	cell_len = (sizeof(sign_pipe_cell) + (n << 1) + 7) & ~(size_t)7;
+	mask = (size_t)ring_size - 1;
+	htmp = atmp;
+	cells = htmp + hlen;
+	for (u = 0; u <= mask; u ++) {
+		sign_pipe_cell *cell;
+
+		cell = sign_pipe_cell_at(cells, cell_len, mask, u);
+		atomic_init(&cell->seq, u);
+	}
+	atomic_init(&head, 0);
+	if (pthread_mutex_init(&sy.lock, NULL) != 0) {
+		return -1;
+	}
+	if (pthread_cond_init(&sy.filled, NULL) != 0) {
+		pthread_mutex_destroy(&sy.lock);
+		return -1;
+	}
+	if (pthread_cond_init(&sy.freed, NULL) != 0) {
+		pthread_cond_destroy(&sy.filled);
+		pthread_mutex_destroy(&sy.lock);
+		return -1;
+	}
+	atomic_init(&sy.workers_waiting, 0);
+	atomic_init(&sy.producer_waiting, 0);
+
+	atmp = cells + (size_t)ring_size * cell_len;
+	started = 0;
+	for (k = 0; k < nworkers; k ++) {
+		w[started].sp = sp;
+		w[started].sync = &sy;
+		w[started].cells = cells;
+		w[started].cell_len = cell_len;
+		w[started].mask = mask;
+		w[started].head = &head;
+		w[started].hm = (uint16_t *)atmp;
+		w[started].wtmp = atmp + hlen;
+		if (pthread_create(&th[started], NULL,
+			sign_pipe_worker_run, &w[started]) == 0)
+		{
+			started ++;
+			atmp += hlen + ((sp->wtmp_len + 7) & ~(size_t)7);
+		}
+	}
+	if (started == 0) {
+		pthread_cond_destroy(&sy.freed);
+		pthread_cond_destroy(&sy.filled);
+		pthread_mutex_destroy(&sy.lock);
+		return -1;
+	}
+
+	/*
+	 * Hash stage. Slot contents are written only when the slot is
+	 * free, but the (possibly long) message absorption happens
+	 * before waiting.
+	 */
+	for (pos = 0; pos < count + started; pos ++) {
+		sign_pipe_cell *cell;
+		shake256_context hd;
+		uint8_t nonce[40], seed[48];
+		unsigned spins;
+
+		if (pos < count) {
+			sign_pipe_absorb(rng, &sp->jobs[pos], &hd, nonce, seed);
+		}
+		cell = sign_pipe_cell_at(cells, cell_len, mask, pos);
+		spins = 0;
+		while (atomic_load_explicit(&cell->seq,
+			memory_order_acquire) != pos)
+		{
+			if (++ spins < SIGN_PIPE_SPIN) {
+				sched_yield();
+				continue;
+			}
+			spins = 0;
+			pthread_mutex_lock(&sy.lock);
+			atomic_fetch_add_explicit(&sy.producer_waiting, 1,
+				memory_order_relaxed);
+			atomic_thread_fence(memory_order_seq_cst);
+			while (atomic_load_explicit(&cell->seq,
+				memory_order_relaxed) != pos)
+			{
+				pthread_cond_wait(&sy.freed, &sy.lock);
+			}
+			atomic_fetch_sub_explicit(&sy.producer_waiting, 1,
+				memory_order_relaxed);
+			pthread_mutex_unlock(&sy.lock);
+		}
+		if (pos < count) {
+			falcon_hash_to_point(&hd, sp->logn, sp->sig_type,
+				(uint16_t *)(cell + 1), htmp,
+				FALCON_TMPSIZE_HASHTOPOINT(sp->logn));
+			cell->job = pos;
+			memcpy(cell->nonce, nonce, sizeof nonce);
+			memcpy(cell->seed, seed, sizeof seed);
+			memset(seed, 0, sizeof seed);
+		} else {
+			cell->job = SIGN_PIPE_STOP;
+		}
+		atomic_store_explicit(&cell->seq, pos + 1,
+			memory_order_release);
+		sign_pipe_wake(&sy, &sy.workers_waiting, &sy.filled);
+	}
+
+	for (k = 0; k < started; k ++) {
+		pthread_join(th[k], NULL);
+	}
+	pthread_cond_destroy(&sy.freed);
+	pthread_cond_destroy(&sy.filled);
+	pthread_mutex_destroy(&sy.lock);
+	return 0;
+}
+
+#endif  // yyyTHREADS-
+
+/*
+ * Common code for falcon_sign_dyn_pipeline() and
+ * falcon_sign_tree_pipeline(). wtmp_len is the per-worker signing
+ * buffer size.
+ */
+static int
+sign_pipeline(shake256_context *rng, sign_pipe *sp,
+	size_t count, void *tmp, size_t tmp_len,
+	unsigned nworkers, unsigned ring_size)
+{
+	uint8_t *atmp, *htmp, *wtmp;
+	uint16_t *hm;
+	size_t n, hlen, u;
+	uint8_t nonce[40], seed[48];
+
+	if (nworkers < 1 || nworkers > SIGN_PIPE_WORKERS_MAX
+		|| ring_size < 2 || ring_size > 4096
+		|| (ring_size & (ring_size - 1)) != 0)
+	{
+		return FALCON_ERR_BADARG;
+	}
+	switch (sp->sig_type) {
+	case FALCON_SIG_COMPRESSED:
+	case FALCON_SIG_PADDED:
+	case FALCON_SIG_CT:
+		break;
+	default:
+		return FALCON_ERR_BADARG;
+	}
+	n = (size_t)1 << sp->logn;
+	hlen = ((n << 1) + 7) & ~(size_t)7;
+	if (tmp_len < nworkers * (sp->wtmp_len + (2u << sp->logn) + 8)
+		+ ring_size * ((2u << sp->logn) + 128u)
+		+ (2u << sp->logn) + 16)
+	{
+		return FALCON_ERR_SIZE;
+	}
+	for (u = 0; u < count; u ++) {
+		sp->jobs[u].status = FALCON_ERR_INTERNAL;
+	}
+	atmp = align_u64(tmp);
+
+#if FALCON_THREADS  // yyyTHREADS+1
+	if (sign_pipe_threaded(sp, rng, count,
+		atmp, nworkers, ring_size) == 0)
+	{
+		return 0;
+	}
+#else // yyyTHREADS+0
+	(void)ring_size;
+#endif  // yyyTHREADS-
+
+	/*
+	 * Sequential pipeline: same randomness, same signatures.
+	 */
+	htmp = atmp;
+	hm = (uint16_t *)(htmp + hlen);
+	wtmp = (uint8_t *)hm + hlen;
+	for (u = 0; u < count; u ++) {
+		shake256_context hd;
+
+		sign_pipe_absorb(rng, &sp->jobs[u], &hd, nonce, seed);
+		falcon_hash_to_point(&hd, sp->logn, sp->sig_type, hm,
+			htmp, FALCON_TMPSIZE_HASHTOPOINT(sp->logn));
+		sp->jobs[u].status = sign_pipe_job(sp, &sp->jobs[u],
+			hm, nonce, seed, wtmp);
+	}
+	memset(seed, 0, sizeof seed);
+	return 0;
+}
+
+/* see falcon.h */
+int
+falcon_sign_dyn_pipeline(shake256_context *rng, int sig_type,
+	const void *privkey, size_t privkey_len,
+	falcon_sign_job *jobs, size_t count,
+	void *tmp, size_t tmp_len, unsigned nworkers, unsigned ring_size)
+{
+	sign_pipe sp;
+	const uint8_t *sk;
+	unsigned logn;
+
+	if (privkey_len == 0) {
+		return FALCON_ERR_FORMAT;
+	}
+	sk = privkey;
+	if ((sk[0] & 0xF0) != 0x50) {
+		return FALCON_ERR_FORMAT;
+	}
+	logn = sk[0] & 0x0F;
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_FORMAT;
+	}
+	if (privkey_len != FALCON_PRIVKEY_SIZE(logn)) {
+		return FALCON_ERR_FORMAT;
+	}
+	sp.sig_type = sig_type;
+	sp.key = privkey;
+	sp.key_len = privkey_len;
+	sp.logn = logn;
+	sp.jobs = jobs;
+	sp.wtmp_len = FALCON_TMPSIZE_SIGNDYN(logn);
+	return sign_pipeline(rng, &sp, count, tmp, tmp_len,
+		nworkers, ring_size);
+}
+
+/* see falcon.h */
+int
+falcon_sign_tree_pipeline(shake256_context *rng, int sig_type,
+	const void *expanded_key,
+	falcon_sign_job *jobs, size_t count,
+	void *tmp, size_t tmp_len, unsigned nworkers, unsigned ring_size)
+{
+	sign_pipe sp;
+	unsigned logn;
+
+	logn = *(const uint8_t *)expanded_key;
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_FORMAT;
+	}
+	sp.sig_type = sig_type;
+	sp.key = expanded_key;
+	sp.key_len = 0;
+	sp.logn = logn;
+	sp.jobs = jobs;
+	sp.wtmp_len = FALCON_TMPSIZE_SIGNTREE(logn);
+	return sign_pipeline(rng, &sp, count, tmp, tmp_len,
+		nworkers, ring_size);
+}
+
 /* see falcon.h */
 int
 falcon_verify_start(shake256_context *hash_data,
@@ -763,37 +1912,30 @@ falcon_verify_start(shake256_context *hash_data,
 	return 0;
 }
 
-/* see falcon.h */
-int
-falcon_verify_finish(const void *sig, size_t sig_len, int sig_type,
-	const void *pubkey, size_t pubkey_len,
+/*
+ * Common part of falcon_verify_finish() and
+ * falcon_verify_prepared_finish(): the public key is given either
+ * encoded (pk, pubkey_len), or already decoded and converted with
+ * to_ntt_monty (h_ntt, with pk == NULL).
+ */
+static int
+verify_finish_inner(const void *sig, size_t sig_len, int sig_type,
+	unsigned logn, const uint8_t *pk, size_t pubkey_len,
+	const uint16_t *h_ntt,
 	shake256_context *hash_data,
 	void *tmp, size_t tmp_len)
 {
-	unsigned logn;
 	uint8_t *atmp;
-	const uint8_t *pk, *es;
+	const uint8_t *es;
 	size_t u, v, n;
-	uint16_t *h, *hm;
-	int16_t *sv;
+	uint16_t *h, *hm, *sv;
+	uint32_t sqn2;
 	int ct;
 
-	/*
-	 * Get Falcon degree from public key; verify consistency with
-	 * signature value, and check parameters.
-	 */
-	if (sig_len < 41 || pubkey_len == 0) {
+	if (sig_len < 41) {
 		return FALCON_ERR_FORMAT;
 	}
 	es = sig;
-	pk = pubkey;
-	if ((pk[0] & 0xF0) != 0x00) {
-		return FALCON_ERR_FORMAT;
-	}
-	logn = pk[0] & 0x0F;
-	if (logn < 1 || logn > 10) {
-		return FALCON_ERR_FORMAT;
-	}
 	if ((es[0] & 0x0F) != logn) {
 		return FALCON_ERR_BADSIG;
 	}
@@ -838,7 +1980,7 @@ falcon_verify_finish(const void *sig, size_t sig_len, int sig_type,
 	default:
 		return FALCON_ERR_BADARG;
 	}
-	if (pubkey_len != FALCON_PUBKEY_SIZE(logn)) {
+	if (pk != NULL && pubkey_len != FALCON_PUBKEY_SIZE(logn)) {
 		return FALCON_ERR_FORMAT;
 	}
 	if (tmp_len < FALCON_TMPSIZE_VERIFY(logn)) {
@@ -848,27 +1990,32 @@ falcon_verify_finish(const void *sig, size_t sig_len, int sig_type,
 	n = (size_t)1 << logn;
 	h = (uint16_t *)align_u16(tmp);
 	hm = h + n;
-	sv = (int16_t *)(hm + n);
+	sv = hm + n;
 	atmp = (uint8_t *)(sv + n);
 
 	/*
 	 * Decode public key.
 	 */
-	if (Zf(modq_decode)(h, logn, pk + 1, pubkey_len - 1)
-		!= pubkey_len - 1)
-	{
-		return FALCON_ERR_FORMAT;
+	if (pk != NULL) {
+		if (Zf(modq_decode)(h, logn, pk + 1, pubkey_len - 1)
+			!= pubkey_len - 1)
+		{
+			return FALCON_ERR_FORMAT;
+		}
 	}
 
 	/*
-	 * Decode signature value.
+	 * Decode signature value. Coefficients are written directly
+	 * in the [0..q-1] range, and the squared norm of the signature
+	 * is accumulated while decoding.
 	 */
 	u = 41;
 	if (ct) {
-		v = Zf(trim_i16_decode)(sv, logn,
+		v = Zf(trim_i16_decode_modq)(sv, &sqn2, logn,
 			Zf(max_sig_bits)[logn], es + u, sig_len - u);
 	} else {
-		v = Zf(comp_decode)(sv, logn, es + u, sig_len - u);
+		v = Zf(comp_decode_modq)(sv, &sqn2, logn,
+			es + u, sig_len - u);
 	}
 	if (v == 0) {
 		return FALCON_ERR_FORMAT;
@@ -907,8 +2054,11 @@ falcon_verify_finish(const void *sig, size_t sig_len, int sig_type,
 	/*
 	 * Verify signature.
 	 */
-	Zf(to_ntt_monty)(h, logn);
-	if (!Zf(verify_raw)(hm, sv, h, logn, atmp)) {
+	if (pk != NULL) {
+		Zf(to_ntt_monty)(h, logn);
+		h_ntt = h;
+	}
+	if (!Zf(verify_raw_modq)(hm, sv, sqn2, h_ntt, logn)) {
 		return FALCON_ERR_BADSIG;
 	}
 	return 0;
@@ -916,19 +2066,659 @@ falcon_verify_finish(const void *sig, size_t sig_len, int sig_type,
 
 /* see falcon.h */
 int
-falcon_verify(const void *sig, size_t sig_len, int sig_type,
+falcon_verify_finish(const void *sig, size_t sig_len, int sig_type,
 	const void *pubkey, size_t pubkey_len,
-	const void *data, size_t data_len,
+	shake256_context *hash_data,
 	void *tmp, size_t tmp_len)
 {
-	shake256_context hd;
-	int r;
+	const uint8_t *pk;
+	unsigned logn;
 
-	r = falcon_verify_start(&hd, sig, sig_len);
-	if (r < 0) {
-		return r;
-	}
-	shake256_inject(&hd, data, data_len);
-	return falcon_verify_finish(sig, sig_len, sig_type,
+	/*
+	 * Get Falcon degree from public key; verify consistency with
+	 * signature value, and check parameters.
+	 */
+	if (sig_len < 41 || pubkey_len == 0) {
+		return FALCON_ERR_FORMAT;
+	}
+	pk = pubkey;
+	if ((pk[0] & 0xF0) != 0x00) {
+		return FALCON_ERR_FORMAT;
+	}
+	logn = pk[0] & 0x0F;
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_FORMAT;
+	}
+	return verify_finish_inner(sig, sig_len, sig_type,
+		logn, pk, pubkey_len, NULL, hash_data, tmp, tmp_len);
+}
+
+/* see falcon.h */
+int
+falcon_verify_key_prepare(void *vkey, size_t vkey_len,
+	const void *pubkey, size_t pubkey_len)
+{
+	const uint8_t *pk;
+	uint16_t *h;
+	unsigned logn;
+
+	if (pubkey_len == 0) {
+		return FALCON_ERR_FORMAT;
+	}
+	pk = pubkey;
+	if ((pk[0] & 0xF0) != 0x00) {
+		return FALCON_ERR_FORMAT;
+	}
+	logn = pk[0] & 0x0F;
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_FORMAT;
+	}
+	if (pubkey_len != FALCON_PUBKEY_SIZE(logn)) {
+		return FALCON_ERR_FORMAT;
+	}
+	if (vkey_len < FALCON_VERIFYKEY_SIZE(logn)) {
+		return FALCON_ERR_SIZE;
+	}
+	h = (uint16_t *)align_u16((uint8_t *)vkey + 1);
+	if (Zf(modq_decode)(h, logn, pk + 1, pubkey_len - 1)
+		!= pubkey_len - 1)
+	{
+		return FALCON_ERR_FORMAT;
+	}
+	Zf(to_ntt_monty)(h, logn);
+	*(uint8_t *)vkey = logn;
+	return 0;
+}
+
+/* see falcon.h */
+int
+falcon_verify_prepared_finish(const void *sig, size_t sig_len,
+	int sig_type, const void *vkey, shake256_context *hash_data,
+	void *tmp, size_t tmp_len)
+{
+	unsigned logn;
+
+	logn = *(const uint8_t *)vkey;
+	if (logn < 1 || logn > 10) {
+		return FALCON_ERR_FORMAT;
+	}
+	return verify_finish_inner(sig, sig_len, sig_type, logn, NULL, 0,
+		(const uint16_t *)align_u16((uint8_t *)vkey + 1),
+		hash_data, tmp, tmp_len);
+}
+
+
+/* see falcon.h */
+int
+falcon_verify(const void *sig, size_t sig_len, int sig_type,
+	const void *pubkey, size_t pubkey_len,
+	const void *data, size_t data_len,
+	void *tmp, size_t tmp_len)
+{
+	shake256_context hd;
+	int r;
+
+	r = falcon_verify_start(&hd, sig, sig_len);
+	if (r < 0) {
+		return r;
+	}
+	shake256_inject(&hd, data, data_len);
+	return falcon_verify_finish(sig, sig_len, sig_type,
 		pubkey, pubkey_len, &hd, tmp, tmp_len);
 }
+
+/* see falcon.h */
+int
+falcon_verify_prepared(const void *sig, size_t sig_len, int sig_type,
+	const void *vkey, const void *data, size_t data_len,
+	void *tmp, size_t tmp_len)
+{
+	shake256_context hd;
+	int r;
+
+	r = falcon_verify_start(&hd, sig, sig_len);
+	if (r < 0) {
+		return r;
+	}
+	shake256_inject(&hd, data, data_len);
+	return falcon_verify_prepared_finish(sig, sig_len, sig_type,
+		vkey, &hd, tmp, tmp_len);
+}
+
+/*
+ * Batch context. Items of a batch call are split into one contiguous
+ * index range per thread; a thread works through its own range from
+ * the front, and when it is empty, steals the upper half of another
+ * thread's range. A range is a single 64-bit word (low and high bounds),
+ * updated with compare-and-swap by its owner and by thieves alike.
+ * Items only ever move from one range to another, and a thread only
+ * adds items to its own range, so a thread may stop as soon as it
+ * finds all ranges empty: the remaining items belong to threads that
+ * are still running.
+ */
+
+/*
+ * Maximum number of threads in a batch context.
+ */
+#define BATCH_THREADS_MAX   64
+
+typedef struct batch_task_ batch_task;
+
+struct batch_task_ {
+	void (*run)(const batch_task *t, size_t i, uint8_t *tmp);
+	size_t count;
+	int wipe;               /* tmp holds secret values after run() */
+	unsigned logn;
+	size_t tmp_len;
+	int sig_type;
+	const void *key;
+	const falcon_verify_item *vitems;
+	falcon_sign_job *jobs;
+	uint8_t *privkeys, *pubkeys;
+	int *results;
+	uint8_t seed[48];
+};
+
+#if FALCON_THREADS  // yyyTHREADS+1
+typedef struct {
+	_Alignas(64) atomic_uint_least64_t range;
+	falcon_batch_ctx *ctx;
+	unsigned index;
+} batch_worker;
+#endif  // yyyTHREADS-
+
+struct falcon_batch_ctx_ {
+	unsigned logn;
+	unsigned nthreads;      /* threads with an arena, caller included */
+	size_t tmp_len;
+	uint8_t *tmp;
+#if FALCON_THREADS  // yyyTHREADS+1
+	unsigned started;       /* running worker threads */
+	pthread_mutex_t lock;
+	pthread_cond_t wake, done;
+	unsigned generation, active;
+	int stop;
+	const batch_task *task;
+	pthread_t th[BATCH_THREADS_MAX];
+	batch_worker w[BATCH_THREADS_MAX];
+#endif  // yyyTHREADS-
+};
+
+static size_t
+batch_tmp_len(unsigned logn)
+{
+	size_t len;
+
+	len = FALCON_TMPSIZE_SIGNTREE(logn);
+	if (len < FALCON_TMPSIZE_KEYGEN(logn)) {
+		len = FALCON_TMPSIZE_KEYGEN(logn);
+	}
+	if (len < FALCON_TMPSIZE_VERIFY(logn)) {
+		len = FALCON_TMPSIZE_VERIFY(logn);
+	}
+	return (len + 7) & ~(size_t)7;
+}
+
+/* see falcon.h */
+size_t
+falcon_batch_ctx_size(unsigned logn, unsigned nthreads)
+{
+	if (logn < 1 || logn > 10
+		|| nthreads < 1 || nthreads > BATCH_THREADS_MAX)
+	{
+		return 0;
+	}
+#if !FALCON_THREADS  // yyyTHREADS+0
+	nthreads = 1;
+#endif  // yyyTHREADS-
+	return sizeof(falcon_batch_ctx) + 63
+		+ (size_t)nthreads * batch_tmp_len(logn);
+}
+
+/*
+ * RNG of item i of a batch call: SHAKE256 over the batch seed followed
+ * by i (64 bits, little-endian), in output mode.
+ */
+static void
+batch_item_rng(shake256_context *rng, const uint8_t *seed, size_t i)
+{
+	uint8_t buf[56];
+	unsigned k;
+
+	memcpy(buf, seed, 48);
+	for (k = 0; k < 8; k ++) {
+		buf[48 + k] = (uint8_t)((uint64_t)i >> (8 * k));
+	}
+	shake256_init_prng_from_seed(rng, buf, sizeof buf);
+	shake256_flip(rng);
+	memset(buf, 0, sizeof buf);
+}
+
+static void
+batch_verify_run(const batch_task *t, size_t i, uint8_t *tmp)
+{
+	const falcon_verify_item *it;
+
+	it = &t->vitems[i];
+	if (it->pubkey_len == 0) {
+		t->results[i] = falcon_verify_prepared(it->sig, it->sig_len,
+			t->sig_type, it->pubkey, it->data, it->data_len,
+			tmp, t->tmp_len);
+	} else {
+		t->results[i] = falcon_verify(it->sig, it->sig_len,
+			t->sig_type, it->pubkey, it->pubkey_len,
+			it->data, it->data_len, tmp, t->tmp_len);
+	}
+}
+
+static void
+batch_sign_tree_run(const batch_task *t, size_t i, uint8_t *tmp)
+{
+	falcon_sign_job *job;
+	shake256_context rng;
+
+	job = &t->jobs[i];
+	batch_item_rng(&rng, t->seed, i);
+	job->status = falcon_sign_tree(&rng, job->sig, &job->sig_len,
+		t->sig_type, t->key, job->data, job->data_len,
+		tmp, t->tmp_len);
+	memset(&rng, 0, sizeof rng);
+}
+
+static void
+batch_keygen_run(const batch_task *t, size_t i, uint8_t *tmp)
+{
+	shake256_context rng;
+	size_t sk_len, pk_len;
+
+	sk_len = FALCON_PRIVKEY_SIZE(t->logn);
+	pk_len = FALCON_PUBKEY_SIZE(t->logn);
+	batch_item_rng(&rng, t->seed, i);
+	t->results[i] = falcon_keygen_make(&rng, t->logn,
+		t->privkeys + i * sk_len, sk_len,
+		t->pubkeys == NULL ? NULL : t->pubkeys + i * pk_len, pk_len,
+		tmp, t->tmp_len);
+	memset(&rng, 0, sizeof rng);
+}
+
+#if FALCON_THREADS  // yyyTHREADS+1
+
+#define BATCH_RANGE(lo, hi)   ((uint_least64_t)(lo) \
+	| ((uint_least64_t)(hi) << 32))
+
+/*
+ * Take the first item of worker k's range; returns 0 if it is empty.
+ */
+static int
+batch_take(batch_worker *w, size_t *i)
+{
+	uint_least64_t r;
+	size_t lo, hi;
+
+	r = atomic_load_explicit(&w->range, memory_order_relaxed);
+	for (;;) {
+		lo = (size_t)(r & 0xFFFFFFFF);
+		hi = (size_t)(r >> 32);
+		if (lo >= hi) {
+			return 0;
+		}
+		if (atomic_compare_exchange_weak_explicit(&w->range,
+			&r, BATCH_RANGE(lo + 1, hi),
+			memory_order_relaxed, memory_order_relaxed))
+		{
+			*i = lo;
+			return 1;
+		}
+	}
+}
+
+/*
+ * Move the upper half of another worker's range (the whole range if
+ * it has a single item) into worker k's empty range; returns 0 if all
+ * other ranges are empty.
+ */
+static int
+batch_steal(falcon_batch_ctx *ctx, unsigned k)
+{
+	unsigned j, nw;
+
+	nw = ctx->started + 1;
+	for (j = 1; j < nw; j ++) {
+		batch_worker *v;
+		uint_least64_t r;
+
+		v = &ctx->w[(k + j) % nw];
+		r = atomic_load_explicit(&v->range, memory_order_relaxed);
+		for (;;) {
+			size_t lo, hi, mid;
+
+			lo = (size_t)(r & 0xFFFFFFFF);
+			hi = (size_t)(r >> 32);
+			if (lo >= hi) {
+				break;
+			}
+			mid = lo + ((hi - lo) >> 1);
+			if (atomic_compare_exchange_weak_explicit(&v->range,
+				&r, BATCH_RANGE(lo, mid),
+				memory_order_relaxed, memory_order_relaxed))
+			{
+				atomic_store_explicit(&ctx->w[k].range,
+					BATCH_RANGE(mid, hi),
+					memory_order_relaxed);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/*
+ * Work loop of worker k (worker 0 is the calling thread) for one task.
+ */
+static void
+batch_work(falcon_batch_ctx *ctx, const batch_task *t, unsigned k)
+{
+	uint8_t *tmp;
+	size_t i;
+
+	tmp = ctx->tmp + (size_t)k * ctx->tmp_len;
+	for (;;) {
+		if (batch_take(&ctx->w[k], &i)) {
+			t->run(t, i, tmp);
+		} else if (!batch_steal(ctx, k)) {
+			break;
+		}
+	}
+	if (t->wipe) {
+		memset(tmp, 0, ctx->tmp_len);
+	}
+}
+
+static void *
+batch_thread(void *arg)
+{
+	batch_worker *w;
+	falcon_batch_ctx *ctx;
+	unsigned seen;
+
+	w = arg;
+	ctx = w->ctx;
+	/*
+	 * The context is created with generation 0; a thread that starts
+	 * late must still see the first task.
+	 */
+	seen = 0;
+	pthread_mutex_lock(&ctx->lock);
+	for (;;) {
+		const batch_task *t;
+
+		while (!ctx->stop && ctx->generation == seen) {
+			pthread_cond_wait(&ctx->wake, &ctx->lock);
+		}
+		if (ctx->stop) {
+			break;
+		}
+		seen = ctx->generation;
+		t = ctx->task;
+		pthread_mutex_unlock(&ctx->lock);
+		batch_work(ctx, t, w->index);
+		pthread_mutex_lock(&ctx->lock);
+		if (-- ctx->active == 0) {
+			pthread_cond_signal(&ctx->done);
+		}
+	}
+	pthread_mutex_unlock(&ctx->lock);
+	return NULL;
+}
+
+#endif  // yyyTHREADS-
+
+/*
+ * Run all items of a task on the context threads.
+ */
+static void
+batch_run(falcon_batch_ctx *ctx, const batch_task *t)
+{
+	size_t u;
+
+#if FALCON_THREADS  // yyyTHREADS+1
+	if (ctx->started > 0 && t->count > 1) {
+		unsigned k, nw;
+		size_t start;
+
+		nw = ctx->started + 1;
+		start = 0;
+		for (k = 0; k < nw; k ++) {
+			size_t end;
+
+			end = t->count * (k + 1) / nw;
+			atomic_store_explicit(&ctx->w[k].range,
+				BATCH_RANGE(start, end), memory_order_relaxed);
+			start = end;
+		}
+		pthread_mutex_lock(&ctx->lock);
+		ctx->task = t;
+		ctx->active = ctx->started;
+		ctx->generation ++;
+		pthread_cond_broadcast(&ctx->wake);
+		pthread_mutex_unlock(&ctx->lock);
+
+		batch_work(ctx, t, 0);
+
+		pthread_mutex_lock(&ctx->lock);
+		while (ctx->active > 0) {
+			pthread_cond_wait(&ctx->done, &ctx->lock);
+		}
+		pthread_mutex_unlock(&ctx->lock);
+		return;
+	}
+#endif  // yyyTHREADS-
+
+	for (u = 0; u < t->count; u ++) {
+		t->run(t, u, ctx->tmp);
+	}
+	if (t->wipe) {
+		memset(ctx->tmp, 0, ctx->tmp_len);
+	}
+}
+
+/* see falcon.h */
+int
+falcon_batch_ctx_init(falcon_batch_ctx **ctx_out,
+	void *mem, size_t mem_len, unsigned logn, unsigned nthreads)
+{
+	falcon_batch_ctx *ctx;
+	size_t size;
+
+	size = falcon_batch_ctx_size(logn, nthreads);
+	if (size == 0) {
+		return FALCON_ERR_BADARG;
+	}
+	if (mem_len < size) {
+		return FALCON_ERR_SIZE;
+	}
+	ctx = (falcon_batch_ctx *)(void *)(((uintptr_t)mem + 63)
+		& ~(uintptr_t)63);
+	memset(ctx, 0, sizeof *ctx);
+	ctx->logn = logn;
+	ctx->tmp_len = batch_tmp_len(logn);
+	ctx->tmp = (uint8_t *)(ctx + 1);
+
+#if FALCON_THREADS  // yyyTHREADS+1
+	ctx->nthreads = nthreads;
+	ctx->started = 0;
+	if (nthreads > 1 && pthread_mutex_init(&ctx->lock, NULL) == 0) {
+		if (pthread_cond_init(&ctx->wake, NULL) == 0) {
+			if (pthread_cond_init(&ctx->done, NULL) == 0) {
+				/*
+				 * Worker k runs with index k; if a thread
+				 * cannot be started, the batch is shared by
+				 * those that could.
+				 */
+				while (ctx->started + 1 < nthreads) {
+					batch_worker *w;
+
+					w = &ctx->w[ctx->started + 1];
+					w->ctx = ctx;
+					w->index = ctx->started + 1;
+					if (pthread_create(
+						&ctx->th[ctx->started], NULL,
+						batch_thread, w) != 0)
+					{
+						break;
+					}
+					ctx->started ++;
+				}
+				if (ctx->started > 0) {
+					*ctx_out = ctx;
+					return 0;
+				}
+				pthread_cond_destroy(&ctx->done);
+			}
+			pthread_cond_destroy(&ctx->wake);
+		}
+		pthread_mutex_destroy(&ctx->lock);
+	}
+#else  // yyyTHREADS+0
+	ctx->nthreads = 1;
+#endif  // yyyTHREADS-
+
+	*ctx_out = ctx;
+	return 0;
+}
+
+/* see falcon.h */
+unsigned
+falcon_batch_ctx_threads(const falcon_batch_ctx *ctx)
+{
+#if FALCON_THREADS  // yyyTHREADS+1
+	return ctx->started + 1;
+#else  // yyyTHREADS+0
+	(void)ctx;
+	return 1;
+#endif  // yyyTHREADS-
+}
+
+/* see falcon.h */
+void
+falcon_batch_ctx_release(falcon_batch_ctx *ctx)
+{
+#if FALCON_THREADS  // yyyTHREADS+1
+	unsigned k;
+
+	if (ctx->started > 0) {
+		pthread_mutex_lock(&ctx->lock);
+		ctx->stop = 1;
+		pthread_cond_broadcast(&ctx->wake);
+		pthread_mutex_unlock(&ctx->lock);
+		for (k = 0; k < ctx->started; k ++) {
+			pthread_join(ctx->th[k], NULL);
+		}
+		pthread_cond_destroy(&ctx->done);
+		pthread_cond_destroy(&ctx->wake);
+		pthread_mutex_destroy(&ctx->lock);
+		ctx->started = 0;
+	}
+#endif  // yyyTHREADS-
+	memset(ctx->tmp, 0, (size_t)ctx->nthreads * ctx->tmp_len);
+}
+
+/*
+ * Check the item count of a batch call (ranges hold 32-bit indices,
+ * and falcon_batch_verify() returns a count as an int).
+ */
+static int
+batch_check_count(size_t count)
+{
+	return (uint64_t)count <= 0x7FFFFFFF;
+}
+
+/* see falcon.h */
+int
+falcon_batch_verify(falcon_batch_ctx *ctx, int sig_type,
+	const falcon_verify_item *items, int *results, size_t count)
+{
+	batch_task t;
+	size_t u;
+	int valid;
+
+	if (!batch_check_count(count)) {
+		return FALCON_ERR_BADARG;
+	}
+	memset(&t, 0, sizeof t);
+	t.run = batch_verify_run;
+	t.count = count;
+	t.tmp_len = ctx->tmp_len;
+	t.sig_type = sig_type;
+	t.vitems = items;
+	t.results = results;
+	batch_run(ctx, &t);
+
+	valid = 0;
+	for (u = 0; u < count; u ++) {
+		valid += (results[u] == 0);
+	}
+	return valid;
+}
+
+/* see falcon.h */
+int
+falcon_batch_sign_tree(falcon_batch_ctx *ctx, shake256_context *rng,
+	int sig_type, const void *expanded_key,
+	falcon_sign_job *jobs, size_t count)
+{
+	batch_task t;
+
+	if (!batch_check_count(count)) {
+		return FALCON_ERR_BADARG;
+	}
+	switch (sig_type) {
+	case FALCON_SIG_COMPRESSED:
+	case FALCON_SIG_PADDED:
+	case FALCON_SIG_CT:
+		break;
+	default:
+		return FALCON_ERR_BADARG;
+	}
+	if (*(const uint8_t *)expanded_key != ctx->logn) {
+		return FALCON_ERR_FORMAT;
+	}
+	memset(&t, 0, sizeof t);
+	t.run = batch_sign_tree_run;
+	t.count = count;
+	t.wipe = 1;
+	t.logn = ctx->logn;
+	t.tmp_len = ctx->tmp_len;
+	t.sig_type = sig_type;
+	t.key = expanded_key;
+	t.jobs = jobs;
+	shake256_extract(rng, t.seed, sizeof t.seed);
+	batch_run(ctx, &t);
+	memset(t.seed, 0, sizeof t.seed);
+	return 0;
+}
+
+/* see falcon.h */
+int
+falcon_batch_keygen(falcon_batch_ctx *ctx, shake256_context *rng,
+	void *privkeys, void *pubkeys, int *results, size_t count)
+{
+	batch_task t;
+
+	if (!batch_check_count(count)) {
+		return FALCON_ERR_BADARG;
+	}
+	memset(&t, 0, sizeof t);
+	t.run = batch_keygen_run;
+	t.count = count;
+	t.wipe = 1;
+	t.logn = ctx->logn;
+	t.tmp_len = ctx->tmp_len;
+	t.privkeys = privkeys;
+	t.pubkeys = pubkeys;
+	t.results = results;
+	shake256_extract(rng, t.seed, sizeof t.seed);
+	batch_run(ctx, &t);
+	memset(t.seed, 0, sizeof t.seed);
+	return 0;
+}
@@ -184,6 +184,10 @@ extern "C" {
  * to be computed with the same private key: amortized cost per signature
  * is about halved when using expanded private keys (for short messages,
  * and depending on underlying architecture and implementation choices).
+ * An expanded private key can be serialized with falcon_expanded_key_save()
+ * and loaded back with falcon_expanded_key_open() (in place, without any
+ * copy) or falcon_expanded_key_load(), e.g. to avoid expanding keys again
+ * when an application restarts.
  *
  *
  * USE OF SHAKE256
@@ -252,6 +256,12 @@ extern "C" {
  */
 #define FALCON_ERR_INTERNAL   -6
 
+/*
+ * FALCON_ERR_MISMATCH is returned when a private key and a public key
+ * are both validly encoded, but do not belong to the same key pair.
+ */
+#define FALCON_ERR_MISMATCH   -7
+
 /* ==================================================================== */
 /*
  * Signature formats.
@@ -349,18 +359,50 @@ extern "C" {
 #define FALCON_TMPSIZE_KEYGEN(logn) \
 	(((logn) <= 3 ? 272u : (28u << (logn))) + (3u << (logn)) + 7)
 
+/*
+ * Temporary buffer size for key pair generation with an expanded private
+ * key (falcon_keygen_make_expanded()).
+ */
+#define FALCON_TMPSIZE_KEYGEN_EXPANDED(logn) \
+	(((logn) <= 2 ? 272u : (48u << (logn))) + (6u << (logn)) + 8)
+
+/*
+ * Temporary buffer size for key pair generation with
+ * falcon_keygen_make_batch(), for 'batch' candidates per group.
+ */
+#define FALCON_TMPSIZE_KEYGEN_BATCH(logn, batch) \
+	(FALCON_TMPSIZE_KEYGEN(logn) + (batch) * ((28u << (logn)) + 1024u))
+
 /*
  * Temporary buffer size for computing the pubic key from the private key.
  */
 #define FALCON_TMPSIZE_MAKEPUB(logn) \
 	((6u << (logn)) + 1)
 
+/*
+ * Temporary buffer size for checking key pairs with falcon_import_keys(),
+ * per thread.
+ */
+#define FALCON_TMPSIZE_IMPORT(logn) \
+	((9u << (logn)) + 1)
+
 /*
  * Temporary buffer size for generating a signature ("dynamic" variant).
  */
 #define FALCON_TMPSIZE_SIGNDYN(logn) \
 	((78u << (logn)) + 7)
 
+/*
+ * Minimal temporary buffer size for generating a signature with the
+ * "dynamic" variant in low-memory mode: falcon_sign_dyn() and
+ * falcon_sign_dyn_finish() accept any tmp_len from this value, and
+ * recompute some intermediate values (about 10-15% slower) when tmp_len
+ * is lower than FALCON_TMPSIZE_SIGNDYN(logn). Signatures are the same
+ * in both modes.
+ */
+#define FALCON_TMPSIZE_SIGNDYN_LOWMEM(logn) \
+	((50u << (logn)) + 7)
+
 /*
  * Temporary buffer size for generating a signature ("tree" variant, with
  * an expanded key).
@@ -368,6 +410,24 @@ extern "C" {
 #define FALCON_TMPSIZE_SIGNTREE(logn) \
 	((50u << (logn)) + 7)
 
+/*
+ * Temporary buffer size for falcon_hash_to_point().
+ */
+#define FALCON_TMPSIZE_HASHTOPOINT(logn) \
+	((2u << (logn)) + 1)
+
+/*
+ * Temporary buffer sizes for pipelined signing, with 'nworkers' sampling
+ * workers and a ring of 'ring_size' slots (falcon_sign_dyn_pipeline() and
+ * falcon_sign_tree_pipeline(), respectively).
+ */
+#define FALCON_TMPSIZE_SIGNPIPE_DYN(logn, nworkers, ring_size) \
+	((nworkers) * (FALCON_TMPSIZE_SIGNDYN(logn) + (2u << (logn)) + 8) \
+	+ (ring_size) * ((2u << (logn)) + 128u) + (2u << (logn)) + 16)
+#define FALCON_TMPSIZE_SIGNPIPE_TREE(logn, nworkers, ring_size) \
+	((nworkers) * (FALCON_TMPSIZE_SIGNTREE(logn) + (2u << (logn)) + 8) \
+	+ (ring_size) * ((2u << (logn)) + 128u) + (2u << (logn)) + 16)
+
 /*
  * Temporary buffer size for expanding a private key.
  */
@@ -380,12 +440,24 @@ extern "C" {
 #define FALCON_EXPANDEDKEY_SIZE(logn) \
 	(((8u * (logn) + 40) << (logn)) + 8)
 
+/*
+ * Size of a serialized expanded private key (see falcon_expanded_key_save()).
+ */
+#define FALCON_EXPANDEDKEY_BLOB_SIZE(logn) \
+	(((8u * (logn) + 40) << (logn)) + 32)
+
 /*
  * Temporary buffer size for verifying a signature.
  */
 #define FALCON_TMPSIZE_VERIFY(logn) \
 	((8u << (logn)) + 1)
 
+/*
+ * Size of a prepared public key (see falcon_verify_key_prepare()).
+ */
+#define FALCON_VERIFYKEY_SIZE(logn) \
+	((2u << (logn)) + 2)
+
 /* ==================================================================== */
 /*
  * SHAKE256.
@@ -498,6 +570,79 @@ int falcon_keygen_make(
 	void *pubkey, size_t pubkey_len,
 	void *tmp, size_t tmp_len);
 
+/*
+ * Same as falcon_keygen_make(), but the expanded private key (as computed
+ * by falcon_expand_privkey() on the new private key) is also written into
+ * expanded_key[], of size expanded_key_len bytes, which MUST be at least
+ * FALCON_EXPANDEDKEY_SIZE(logn) bytes. This is faster than generating,
+ * then expanding the key, since the key generation already has the G
+ * polynomial and the public key that the expansion and the encoding need.
+ * For a given RNG state, the key pair is the same as with
+ * falcon_keygen_make().
+ *
+ * The tmp[] buffer size tmp_len MUST be at least
+ * FALCON_TMPSIZE_KEYGEN_EXPANDED(logn) bytes.
+ *
+ * Returned value: 0 on success, or a negative error code.
+ */
+int falcon_keygen_make_expanded(
+	shake256_context *rng,
+	unsigned logn,
+	void *privkey, size_t privkey_len,
+	void *pubkey, size_t pubkey_len,
+	void *expanded_key, size_t expanded_key_len,
+	void *tmp, size_t tmp_len);
+
+/*
+ * Same as falcon_keygen_make(), but (f,g) candidates are drawn by
+ * groups of 'batch' (1 to 16), and all candidates of a group go through
+ * the cheap rejection tests (norm bounds, invertibility of f) before the
+ * expensive NTRU equation solving is attempted. When the library is
+ * compiled with FALCON_KG_THREADS, these tests run on one thread per
+ * candidate.
+ *
+ * Candidates are still accepted in generation order, and the RNG is left
+ * in the same state as with falcon_keygen_make(): for a given seed, the
+ * key pair is identical to the one falcon_keygen_make() returns,
+ * whatever the batch size.
+ *
+ * The tmp[] buffer size tmp_len MUST be at least
+ * FALCON_TMPSIZE_KEYGEN_BATCH(logn, batch) bytes.
+ *
+ * Returned value: 0 on success, or a negative error code.
+ */
+int falcon_keygen_make_batch(
+	shake256_context *rng,
+	unsigned logn,
+	void *privkey, size_t privkey_len,
+	void *pubkey, size_t pubkey_len,
+	void *tmp, size_t tmp_len, unsigned batch);
+
+/*
+ * Number of NTRU solver depths for which falcon_keygen_profile()
+ * reports times (depths 0 to 10).
+ */
+#define FALCON_KG_PROFILE_DEPTHS   11
+
+/*
+ * Key generation profiling. When the library is compiled with
+ * FALCON_KG_PROFILE (see config.h), key pair generation accumulates the
+ * processor time spent at each depth of the NTRU equation solver: depth
+ * d works on polynomials of degree 2^(logn-d), depth 0 being the final
+ * one, and depth logn the resultant computation. Most of the key pair
+ * generation time is spent there.
+ *
+ * This function writes the accumulated times, in nanoseconds, for
+ * depths 0 to num-1 into ns[] (entries beyond the last depth are set
+ * to 0); if 'reset' is non-zero, counters are then cleared. Counters
+ * are global to the process and not protected against concurrent
+ * key pair generations.
+ *
+ * Returned value: 1 if profiling is compiled in, 0 otherwise (in which
+ * case ns[] is filled with zeros).
+ */
+int falcon_keygen_profile(uint64_t *ns, size_t num, int reset);
+
 /*
  * Recompute the public key from the private key.
  *
@@ -522,6 +667,36 @@ int falcon_make_public(
 	const void *privkey, size_t privkey_len,
 	void *tmp, size_t tmp_len);
 
+/*
+ * Check 'count' key pairs in one call, e.g. when importing keys generated
+ * elsewhere. privkeys[] holds count encoded private keys, back to back,
+ * each of exactly FALCON_PRIVKEY_SIZE(logn) bytes; pubkeys[] holds count
+ * encoded public keys of FALCON_PUBKEY_SIZE(logn) bytes each.
+ *
+ * For each pair, the private key is decoded (f, g and F), the public key
+ * h = g/f mod phi mod q is recomputed and compared with the decoded public
+ * key. results[i] receives 0 if pair i matches, FALCON_ERR_FORMAT if
+ * either key cannot be decoded, or FALCON_ERR_MISMATCH if both decode but
+ * the public key does not belong to the private key.
+ *
+ * If h_ntt is not NULL, it receives count blocks of 2^logn values: block
+ * i is public key i in NTT and Montgomery representation, as used
+ * internally for signature verification. It is written for every pair
+ * whose public key decodes.
+ *
+ * Up to 'nthreads' threads (1 to 64) are used when the library is
+ * compiled with FALCON_THREADS; otherwise, pairs are checked one after
+ * the other and nthreads only sizes tmp[]. The tmp[] buffer size tmp_len
+ * MUST be at least nthreads * FALCON_TMPSIZE_IMPORT(logn) bytes.
+ *
+ * Returned value: the number of matching pairs, or a negative error code
+ * if the parameters are invalid.
+ */
+int falcon_import_keys(unsigned logn,
+	const void *privkeys, const void *pubkeys, size_t count,
+	uint16_t *h_ntt, int *results,
+	void *tmp, size_t tmp_len, unsigned nthreads);
+
 /*
  * Get the Falcon degree from an encoded private key, public key or
  * signature. Returned value is the logarithm of the degree (1 to 10),
@@ -558,7 +733,9 @@ int falcon_get_logn(void *obj, size_t len);
  * from timing-related side channels.
  *
  * The tmp[] buffer is used to hold temporary values. Its size tmp_len
- * MUST be at least FALCON_TMPSIZE_SIGNDYN(logn) bytes.
+ * MUST be at least FALCON_TMPSIZE_SIGNDYN_LOWMEM(logn) bytes; with less
+ * than FALCON_TMPSIZE_SIGNDYN(logn) bytes, the slower low-memory mode
+ * is used.
  *
  * Returned value: 0 on success, or a negative error code.
  */
@@ -623,6 +800,74 @@ int falcon_sign_tree(shake256_context *rng,
 	const void *data, size_t data_len,
 	void *tmp, size_t tmp_len);
 
+/*
+ * Serialize an expanded private key (as computed by falcon_expand_privkey())
+ * into blob[], of size blob_len bytes, which MUST be at least
+ * FALCON_EXPANDEDKEY_BLOB_SIZE(logn) bytes. The blob can be written to
+ * storage and later loaded with falcon_expanded_key_open() or
+ * falcon_expanded_key_load(), which is much faster than expanding the
+ * private key again.
+ *
+ * The blob is a 32-byte header followed by the expanded key values:
+ *
+ *   offset  size  contents
+ *      0      4   magic: "FXK" followed by a byte of value 0x1A
+ *      4      1   layout version (currently 1)
+ *      5      1   logn
+ *      6      1   byte order of the values (1 = little-endian,
+ *                 2 = big-endian)
+ *      7      1   0
+ *      8      8   length of the values, in bytes (little-endian)
+ *     16      8   checksum (little-endian), over bytes 0 to 15, 24 to 31,
+ *                 and the values
+ *     24      7   0
+ *     31      1   logn
+ *     32      -   expanded key values (64-bit floating-point)
+ *
+ * The checksum detects storage corruption; it is not a MAC. The values
+ * are written in the byte order of the current platform, and blobs are
+ * accepted only on platforms with the same byte order. Expanded keys
+ * computed by different builds of this library may differ slightly (e.g.
+ * with or without FMA) but are all usable.
+ *
+ * expanded_key may lie within blob[]. In particular, a key expanded at
+ * blob + 31 (with blob[] 8-byte aligned, and FALCON_EXPANDEDKEY_SIZE(logn)
+ * bytes available from that offset) is serialized in place.
+ *
+ * Returned value: 0 on success, or a negative error code.
+ */
+int falcon_expanded_key_save(void *blob, size_t blob_len,
+	const void *expanded_key);
+
+/*
+ * Check a serialized expanded private key (blob[], of size blob_len
+ * bytes) and set *expanded_key to an expanded private key that lies
+ * within blob[]; nothing is copied, so that a blob mapped in memory
+ * (e.g. with mmap()) can be used for signing directly. blob[] MUST be
+ * 8-byte aligned, and MUST NOT be modified or moved while the returned
+ * expanded key is in use. The whole blob is read once, to verify the
+ * checksum.
+ *
+ * Returned value: 0 on success, or a negative error code:
+ *   FALCON_ERR_BADARG   blob[] is not 8-byte aligned
+ *   FALCON_ERR_FORMAT   wrong header, length or checksum, or a byte
+ *                       order that does not match the platform
+ */
+int falcon_expanded_key_open(const void **expanded_key,
+	const void *blob, size_t blob_len);
+
+/*
+ * Check a serialized expanded private key (blob[], of size blob_len
+ * bytes) and copy it into expanded_key[], of size expanded_key_len
+ * bytes, which MUST be at least FALCON_EXPANDEDKEY_SIZE(logn) bytes.
+ * This function has no alignment requirement on blob[]; the result is
+ * the same as falcon_expand_privkey() on the original private key.
+ *
+ * Returned value: 0 on success, or a negative error code.
+ */
+int falcon_expanded_key_load(void *expanded_key, size_t expanded_key_len,
+	const void *blob, size_t blob_len);
+
 /* ==================================================================== */
 /*
  * Signature generation, streamed API.
@@ -683,7 +928,9 @@ int falcon_sign_start(shake256_context *rng,
  * from timing-related side channels.
  *
  * The tmp[] buffer is used to hold temporary values. Its size tmp_len
- * MUST be at least FALCON_TMPSIZE_SIGNDYN(logn) bytes.
+ * MUST be at least FALCON_TMPSIZE_SIGNDYN_LOWMEM(logn) bytes; with less
+ * than FALCON_TMPSIZE_SIGNDYN(logn) bytes, the slower low-memory mode
+ * is used.
  *
  * Returned value: 0 on success, or a negative error code.
  */
@@ -735,6 +982,99 @@ int falcon_sign_tree_finish(shake256_context *rng,
 	shake256_context *hash_data, const void *nonce,
 	void *tmp, size_t tmp_len);
 
+/*
+ * Hash the nonce + message held in the SHAKE256 context *hash_data (in
+ * input mode; it is flipped and modified in the process) to the point
+ * hm[] (2^logn values modulo q). This is the first step of
+ * falcon_sign_dyn_finish() and falcon_sign_tree_finish(); the constant-
+ * time variant is used if sig_type is FALCON_SIG_CT.
+ *
+ * The tmp[] buffer size tmp_len MUST be at least
+ * FALCON_TMPSIZE_HASHTOPOINT(logn) bytes.
+ *
+ * Returned value: 0 on success, or a negative error code.
+ */
+int falcon_hash_to_point(shake256_context *hash_data, unsigned logn,
+	int sig_type, uint16_t *hm, void *tmp, size_t tmp_len);
+
+/*
+ * Same as falcon_sign_dyn_finish() and falcon_sign_tree_finish(), but
+ * the message is provided already hashed to the point hm[] (as computed
+ * by falcon_hash_to_point(), with the same sig_type). With the same RNG
+ * state, the signature is identical to the one the _finish() variant
+ * produces from the matching hash_data context.
+ */
+int falcon_sign_dyn_hm(shake256_context *rng,
+	void *sig, size_t *sig_len, int sig_type,
+	const void *privkey, size_t privkey_len,
+	const uint16_t *hm, const void *nonce,
+	void *tmp, size_t tmp_len);
+int falcon_sign_tree_hm(shake256_context *rng,
+	void *sig, size_t *sig_len, int sig_type,
+	const void *expanded_key,
+	const uint16_t *hm, const void *nonce,
+	void *tmp, size_t tmp_len);
+
+/* ==================================================================== */
+/*
+ * Pipelined signature generation.
+ *
+ * Many messages are signed with the same key; the calling thread hashes
+ * each message (nonce, message data, hash-to-point) and hands the point
+ * over to a pool of sampling workers through a bounded lock-free ring,
+ * so that hashing of large messages overlaps with lattice sampling.
+ * Threads that wait on the ring (workers while a long message is being
+ * hashed, the hash stage while all slots are busy) yield a few times,
+ * then block until the other side makes progress.
+ * Worker threads are used only if the library is compiled with
+ * FALCON_THREADS; otherwise, the same steps run one after the other.
+ */
+
+/*
+ * One message to sign. data[] (data_len bytes) is the message; the
+ * signature is written in sig[], whose size must be set in sig_len (it
+ * is updated to the actual signature length). status receives 0 on
+ * success, or a negative error code, as with falcon_sign_dyn().
+ */
+typedef struct {
+	const void *data;
+	size_t data_len;
+	void *sig;
+	size_t sig_len;
+	int status;
+} falcon_sign_job;
+
+/*
+ * Sign count messages with the private key privkey[] (or, for
+ * falcon_sign_tree_pipeline(), the expanded key expanded_key[]), using
+ * up to nworkers sampling threads (1 to 64) and a ring of ring_size
+ * slots (a power of two, 2 to 4096).
+ *
+ * The nonce and a 48-byte sampling seed of each job are drawn from *rng
+ * (in output mode) by the hash stage, in job order. Signatures are
+ * therefore deterministic for a given RNG state, whatever the number of
+ * workers, but differ from those of falcon_sign_dyn() with the same
+ * RNG state. The signature of job i is the one falcon_sign_dyn_hm()
+ * computes with an RNG initialized with shake256_init_prng_from_seed()
+ * on the job's seed, then flipped.
+ *
+ * The tmp[] buffer size tmp_len MUST be at least
+ * FALCON_TMPSIZE_SIGNPIPE_DYN(logn, nworkers, ring_size) bytes
+ * (FALCON_TMPSIZE_SIGNPIPE_TREE for the expanded key variant).
+ *
+ * Returned value: 0 if all jobs were processed (their individual status
+ * may still be an error), or a negative error code if the parameters or
+ * the key are invalid (no job was processed).
+ */
+int falcon_sign_dyn_pipeline(shake256_context *rng, int sig_type,
+	const void *privkey, size_t privkey_len,
+	falcon_sign_job *jobs, size_t count,
+	void *tmp, size_t tmp_len, unsigned nworkers, unsigned ring_size);
+int falcon_sign_tree_pipeline(shake256_context *rng, int sig_type,
+	const void *expanded_key,
+	falcon_sign_job *jobs, size_t count,
+	void *tmp, size_t tmp_len, unsigned nworkers, unsigned ring_size);
+
 /* ==================================================================== */
 /*
  * Signature verification.
@@ -802,6 +1142,145 @@ int falcon_verify_finish(const void *sig, size_t sig_len, int sig_type,
 	shake256_context *hash_data,
 	void *tmp, size_t tmp_len);
 
+/*
+ * Prepare a public key for repeated verifications: the key is decoded
+ * and converted to the NTT representation used by the verification
+ * equation, which falcon_verify() and falcon_verify_finish() otherwise
+ * do on each call. The prepared key is written in vkey[], of size
+ * vkey_len bytes, which MUST be at least FALCON_VERIFYKEY_SIZE(logn).
+ *
+ * The prepared key is meant for the local system only (it uses the
+ * native byte order); it is not a serialization format. It may be
+ * shared by several threads.
+ *
+ * Returned value: 0 on success, or a negative error code.
+ */
+int falcon_verify_key_prepare(void *vkey, size_t vkey_len,
+	const void *pubkey, size_t pubkey_len);
+
+/*
+ * Same as falcon_verify() and falcon_verify_finish(), with a public key
+ * prepared by falcon_verify_key_prepare(). Results are the same; the
+ * tmp[] buffer has the same minimal size FALCON_TMPSIZE_VERIFY(logn).
+ */
+int falcon_verify_prepared(const void *sig, size_t sig_len, int sig_type,
+	const void *vkey, const void *data, size_t data_len,
+	void *tmp, size_t tmp_len);
+int falcon_verify_prepared_finish(const void *sig, size_t sig_len,
+	int sig_type, const void *vkey, shake256_context *hash_data,
+	void *tmp, size_t tmp_len);
+
+/* ==================================================================== */
+/*
+ * Batch context.
+ *
+ * A batch context holds a pool of threads and one temporary buffer per
+ * thread, for a given Falcon degree; the batch functions below take
+ * arrays of items and spread them over the threads. Each thread starts
+ * with a contiguous range of items and, once done with it, takes over
+ * half of the remaining items of a busier thread (work stealing), so
+ * that items of uneven cost (long messages, signature retries) keep all
+ * threads busy. The calling thread processes items as well.
+ *
+ * Worker threads exist only if the library is compiled with
+ * FALCON_THREADS; otherwise, the calling thread processes all items, with
+ * the same results. Results never depend on the number of threads.
+ *
+ * The context lives in a caller-provided memory area, as the other
+ * buffers of this API. A context may be used by one batch call at a
+ * time; the calls themselves are not thread-safe.
+ */
+
+typedef struct falcon_batch_ctx_ falcon_batch_ctx;
+
+/*
+ * Size (in bytes) of the memory area for a context of degree logn with
+ * nthreads threads (1 to 64, the calling thread included). Returned
+ * value is 0 if the parameters are invalid.
+ */
+size_t falcon_batch_ctx_size(unsigned logn, unsigned nthreads);
+
+/*
+ * Initialize a context in mem[] (mem_len bytes, at least
+ * falcon_batch_ctx_size(logn, nthreads)) and start its threads; *ctx is
+ * set to the context, which is somewhere within mem[]. If some threads
+ * cannot be started, the context works with those that could (see
+ * falcon_batch_ctx_threads()). The context must be released with
+ * falcon_batch_ctx_release() before mem[] is freed.
+ *
+ * Returned value: 0 on success, or a negative error code.
+ */
+int falcon_batch_ctx_init(falcon_batch_ctx **ctx,
+	void *mem, size_t mem_len, unsigned logn, unsigned nthreads);
+
+/*
+ * Number of threads (the calling thread included) that process items.
+ */
+unsigned falcon_batch_ctx_threads(const falcon_batch_ctx *ctx);
+
+/*
+ * Stop the context threads and wipe its temporary buffers.
+ */
+void falcon_batch_ctx_release(falcon_batch_ctx *ctx);
+
+/*
+ * One signature to verify. The public key is either encoded (pubkey[],
+ * pubkey_len bytes), or prepared with falcon_verify_key_prepare(): in
+ * that case, pubkey_len is 0. Several items may share a public key.
+ */
+typedef struct {
+	const void *sig;
+	size_t sig_len;
+	const void *data;
+	size_t data_len;
+	const void *pubkey;
+	size_t pubkey_len;
+} falcon_verify_item;
+
+/*
+ * Verify count signatures (at most 2^31-1). results[i] receives what
+ * falcon_verify() (or falcon_verify_prepared()) returns for item i, with
+ * the given sig_type. Public keys of a degree larger than that of the
+ * context get FALCON_ERR_SIZE.
+ *
+ * Returned value: the number of valid signatures, or a negative error
+ * code.
+ */
+int falcon_batch_verify(falcon_batch_ctx *ctx, int sig_type,
+	const falcon_verify_item *items, int *results, size_t count);
+
+/*
+ * Sign count messages (at most 2^31-1) with an expanded key of the
+ * context degree; jobs are as for the pipelined signing functions.
+ *
+ * A 48-byte batch seed is drawn from *rng (in output mode). Job i is
+ * then signed with falcon_sign_tree() and its own RNG: SHAKE256 over
+ * the batch seed followed by i as a 64-bit little-endian integer
+ * (shake256_init_prng_from_seed() on these 56 bytes, then
+ * shake256_flip()). Signatures are thus deterministic for a given RNG
+ * state, whatever the number of threads.
+ *
+ * Returned value: 0 if all jobs were processed (their individual status
+ * may still be an error), or a negative error code.
+ */
+int falcon_batch_sign_tree(falcon_batch_ctx *ctx, shake256_context *rng,
+	int sig_type, const void *expanded_key,
+	falcon_sign_job *jobs, size_t count);
+
+/*
+ * Generate count key pairs (at most 2^31-1) of the context degree.
+ * Private key i is written at offset i * FALCON_PRIVKEY_SIZE(logn) in
+ * privkeys[], and its public key at offset i * FALCON_PUBKEY_SIZE(logn)
+ * in pubkeys[] (unless pubkeys is NULL). results[i] receives the
+ * falcon_keygen_make() result for pair i. Pair i is generated with its
+ * own RNG, derived from a batch seed as in falcon_batch_sign_tree().
+ *
+ * Returned value: 0 if all pairs were processed, or a negative error
+ * code.
+ */
+int falcon_batch_keygen(falcon_batch_ctx *ctx, shake256_context *rng,
+	void *privkeys, void *pubkeys, int *results, size_t count);
+
 /* ==================================================================== */
 
 #ifdef __cplusplus
@@ -0,0 +1,390 @@
+#ifndef FALCON_HPP__
+#define FALCON_HPP__
+
+/*
+ * Header-only C++20 API on top of falcon.h.
+ *
+ * The degree is a template parameter: Falcon<9> is Falcon-512,
+ * Falcon<10> is Falcon-1024. All key, signature and temporary buffer
+ * sizes are then compile-time constants, keys and signatures are passed
+ * as std::span over caller-owned memory, and the temporary buffers come
+ * from a Scratch area that is allocated once per thread and reused by
+ * every call:
+ *
+ *   using F = falcon::Falcon<9>;
+ *
+ *   falcon::Rng rng;                        // seeded from the system
+ *   auto [sk, vk, pub] = F::generate(rng);
+ *   F::Signature sig;
+ *   auto s = sk.sign(rng, msg, sig);        // subspan of sig
+ *   bool ok = vk.verify(s, msg);
+ *
+ * SigningKey holds an expanded private key (signing uses
+ * falcon_sign_tree()); VerifyingKey holds the public key decoded and
+ * converted to NTT representation (falcon_verify_key_prepare()). Both
+ * are move-only, and may be used by several threads at once (each
+ * thread with its own Rng).
+ *
+ * Errors are reported with falcon::error exceptions, except for
+ * signatures that do not verify: VerifyingKey::verify() returns false
+ * for those (and for signatures that cannot be decoded).
+ *
+ * ==========================(LICENSE BEGIN)============================
+ *
+ * Copyright (c) 2025  Falcon QONE WASM Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ===========================(LICENSE END)=============================
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "falcon.h"
+
+namespace falcon {
+
+/*
+ * Error raised for a negative FALCON_ERR_* code; code() returns it.
+ */
+class error : public std::runtime_error {
+public:
+	explicit error(int code)
+		: std::runtime_error(message(code)), code_(code)
+	{
+	}
+
+	int code() const noexcept { return code_; }
+
+private:
+	static std::string message(int code)
+	{
+		switch (code) {
+		case FALCON_ERR_RANDOM:   return "falcon: no random source";
+		case FALCON_ERR_SIZE:     return "falcon: buffer too small";
+		case FALCON_ERR_FORMAT:   return "falcon: invalid encoding";
+		case FALCON_ERR_BADSIG:   return "falcon: invalid signature";
+		case FALCON_ERR_BADARG:   return "falcon: invalid argument";
+		case FALCON_ERR_INTERNAL: return "falcon: internal error";
+		case FALCON_ERR_MISMATCH: return "falcon: keys do not match";
+		default:
+			return "falcon: error " + std::to_string(code);
+		}
+	}
+
+	int code_;
+};
+
+namespace detail {
+
+inline void
+check(int r)
+{
+	if (r < 0) {
+		throw error(r);
+	}
+}
+
+/*
+ * memset() that the compiler may not remove, for key material.
+ */
+inline void
+wipe(void *p, std::size_t len) noexcept
+{
+	volatile unsigned char *b = static_cast<volatile unsigned char *>(p);
+
+	while (len -- > 0) {
+		*b ++ = 0;
+	}
+}
+
+}
+
+/*
+ * Signature encodings (see falcon.h). Verification also accepts
+ * 'any', where the type is taken from the signature header.
+ */
+enum class SigType : int {
+	any        = 0,
+	compressed = FALCON_SIG_COMPRESSED,
+	padded     = FALCON_SIG_PADDED,
+	ct         = FALCON_SIG_CT
+};
+
+/*
+ * SHAKE256-based PRNG, in output mode. It must not be used by two
+ * threads at once.
+ */
+class Rng {
+public:
+	/* Seeded from the system RNG. */
+	Rng()
+	{
+		detail::check(shake256_init_prng_from_system(&sc_));
+	}
+
+	/* Seeded from the provided bytes (deterministic). */
+	explicit Rng(std::span<const std::uint8_t> seed) noexcept
+	{
+		shake256_init_prng_from_seed(&sc_, seed.data(), seed.size());
+	}
+
+	Rng(const Rng &) = delete;
+	Rng &operator=(const Rng &) = delete;
+
+	~Rng() { detail::wipe(&sc_, sizeof sc_); }
+
+	shake256_context *get() noexcept { return &sc_; }
+
+private:
+	shake256_context sc_;
+};
+
+/* Coroutine API (falcon_async.hpp). */
+template<unsigned LOGN>
+class ComputePool;
+
+template<unsigned LOGN>
+class Falcon {
+	static_assert(LOGN >= 1 && LOGN <= 10, "logn must be in 1..10");
+
+public:
+	static constexpr unsigned logn = LOGN;
+	static constexpr std::size_t n = std::size_t(1) << LOGN;
+
+	static constexpr std::size_t privkey_size = FALCON_PRIVKEY_SIZE(LOGN);
+	static constexpr std::size_t pubkey_size = FALCON_PUBKEY_SIZE(LOGN);
+	static constexpr std::size_t sig_compressed_max_size =
+		FALCON_SIG_COMPRESSED_MAXSIZE(LOGN);
+	static constexpr std::size_t sig_padded_size =
+		FALCON_SIG_PADDED_SIZE(LOGN);
+	static constexpr std::size_t sig_ct_size = FALCON_SIG_CT_SIZE(LOGN);
+	/* Large enough for a signature of any type. */
+	static constexpr std::size_t sig_max_size =
+		std::max(sig_compressed_max_size, sig_ct_size);
+	static constexpr std::size_t expanded_key_size =
+		FALCON_EXPANDEDKEY_SIZE(LOGN);
+	static constexpr std::size_t verify_key_size =
+		FALCON_VERIFYKEY_SIZE(LOGN);
+
+	/* Largest temporary buffer needed by the operations below. */
+	static constexpr std::size_t tmp_size = std::max({
+		std::size_t(FALCON_TMPSIZE_KEYGEN_EXPANDED(LOGN)),
+		std::size_t(FALCON_TMPSIZE_EXPANDPRIV(LOGN)),
+		std::size_t(FALCON_TMPSIZE_MAKEPUB(LOGN)),
+		std::size_t(FALCON_TMPSIZE_SIGNTREE(LOGN)),
+		std::size_t(FALCON_TMPSIZE_VERIFY(LOGN))
+	});
+
+	using PrivateKey = std::array<std::uint8_t, privkey_size>;
+	using PublicKey = std::array<std::uint8_t, pubkey_size>;
+	using Signature = std::array<std::uint8_t, sig_max_size>;
+
+	/*
+	 * Temporary buffer for one call at a time. Scratch::local() is the
+	 * buffer of the calling thread, used when no Scratch is passed.
+	 */
+	class Scratch {
+	public:
+		Scratch() : buf_(new std::uint8_t[tmp_size]) {}
+
+		static Scratch &local()
+		{
+			thread_local Scratch s;
+			return s;
+		}
+
+		std::uint8_t *data() noexcept { return buf_.get(); }
+		static constexpr std::size_t size() noexcept { return tmp_size; }
+
+	private:
+		std::unique_ptr<std::uint8_t[]> buf_;
+	};
+
+	class VerifyingKey {
+	public:
+		static VerifyingKey from_public_key(
+			std::span<const std::uint8_t, pubkey_size> pub)
+		{
+			VerifyingKey vk;
+
+			detail::check(falcon_verify_key_prepare(vk.key_.get(),
+				verify_key_size, pub.data(), pub.size()));
+			return vk;
+		}
+
+		VerifyingKey(VerifyingKey &&) noexcept = default;
+		VerifyingKey &operator=(VerifyingKey &&) noexcept = default;
+
+		/*
+		 * Returns true if sig is a valid signature of msg, false
+		 * if it is not (or cannot be decoded, or is not of type
+		 * 'type').
+		 */
+		bool verify(std::span<const std::uint8_t> sig,
+			std::span<const std::uint8_t> msg,
+			SigType type = SigType::any,
+			Scratch &scratch = Scratch::local()) const
+		{
+			int r;
+
+			r = falcon_verify_prepared(sig.data(), sig.size(),
+				static_cast<int>(type), key_.get(),
+				msg.data(), msg.size(),
+				scratch.data(), scratch.size());
+			if (r == FALCON_ERR_BADSIG || r == FALCON_ERR_FORMAT) {
+				return false;
+			}
+			detail::check(r);
+			return true;
+		}
+
+	private:
+		VerifyingKey() : key_(new std::uint8_t[verify_key_size]) {}
+
+		std::unique_ptr<std::uint8_t[]> key_;
+
+		friend class Falcon;
+		friend class ComputePool<LOGN>;
+	};
+
+	class SigningKey {
+	public:
+		static SigningKey from_private_key(
+			std::span<const std::uint8_t, privkey_size> priv,
+			Scratch &scratch = Scratch::local())
+		{
+			SigningKey sk;
+
+			detail::check(falcon_expand_privkey(sk.key_.get(),
+				expanded_key_size, priv.data(), priv.size(),
+				scratch.data(), scratch.size()));
+			return sk;
+		}
+
+		SigningKey(SigningKey &&) noexcept = default;
+
+		SigningKey &operator=(SigningKey &&other) noexcept
+		{
+			if (this != &other) {
+				clear();
+				key_ = std::move(other.key_);
+			}
+			return *this;
+		}
+
+		~SigningKey() { clear(); }
+
+		/*
+		 * Sign msg into out[], which must have room for the
+		 * signature type (sig_max_size is always enough). Returns
+		 * the part of out[] that holds the signature.
+		 */
+		std::span<std::uint8_t> sign(Rng &rng,
+			std::span<const std::uint8_t> msg,
+			std::span<std::uint8_t> out,
+			SigType type = SigType::compressed,
+			Scratch &scratch = Scratch::local()) const
+		{
+			std::size_t len = out.size();
+
+			detail::check(falcon_sign_tree(rng.get(),
+				out.data(), &len, static_cast<int>(type),
+				key_.get(), msg.data(), msg.size(),
+				scratch.data(), scratch.size()));
+			return out.first(len);
+		}
+
+	private:
+		SigningKey() : key_(new std::uint8_t[expanded_key_size]) {}
+
+		void clear() noexcept
+		{
+			if (key_) {
+				detail::wipe(key_.get(), expanded_key_size);
+			}
+		}
+
+		std::unique_ptr<std::uint8_t[]> key_;
+
+		friend class Falcon;
+		friend class ComputePool<LOGN>;
+	};
+
+	struct KeyPair {
+		SigningKey signing_key;
+		VerifyingKey verifying_key;
+		PublicKey public_key;
+	};
+
+	/*
+	 * Generate a new key pair. The encoded private key is written in
+	 * *priv if priv is not null; otherwise it is wiped.
+	 */
+	static KeyPair generate(Rng &rng, PrivateKey *priv = nullptr,
+		Scratch &scratch = Scratch::local())
+	{
+		KeyPair kp{ SigningKey(), VerifyingKey(), {} };
+		PrivateKey tmp_priv;
+		PrivateKey &p = priv != nullptr ? *priv : tmp_priv;
+		int r;
+
+		r = falcon_keygen_make_expanded(rng.get(), LOGN,
+			p.data(), p.size(),
+			kp.public_key.data(), kp.public_key.size(),
+			kp.signing_key.key_.get(), expanded_key_size,
+			scratch.data(), scratch.size());
+		detail::wipe(tmp_priv.data(), tmp_priv.size());
+		detail::check(r);
+		detail::check(falcon_verify_key_prepare(
+			kp.verifying_key.key_.get(), verify_key_size,
+			kp.public_key.data(), kp.public_key.size()));
+		return kp;
+	}
+
+	/*
+	 * Recompute the public key of an encoded private key.
+	 */
+	static PublicKey public_key(
+		std::span<const std::uint8_t, privkey_size> priv,
+		Scratch &scratch = Scratch::local())
+	{
+		PublicKey pub;
+
+		detail::check(falcon_make_public(pub.data(), pub.size(),
+			priv.data(), priv.size(),
+			scratch.data(), scratch.size()));
+		return pub;
+	}
+};
+
+using Falcon512 = Falcon<9>;
+using Falcon1024 = Falcon<10>;
+
+}
+
+#endif
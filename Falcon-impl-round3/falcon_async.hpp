@@ -0,0 +1,516 @@
+#ifndef FALCON_ASYNC_HPP__
+#define FALCON_ASYNC_HPP__
+
+/*
+ * C++20 coroutine API on top of falcon.hpp and the batch context of
+ * falcon.h.
+ *
+ * A ComputePool owns a batch context and a dispatcher thread. Signing and
+ * verification requests are awaitables: co_await queues the request and
+ * suspends the coroutine; the dispatcher takes all queued requests (up to
+ * max_batch) and processes them with one falcon_batch_verify() call, and
+ * one falcon_batch_sign_tree() call per signing key, spread over the
+ * context threads. Each coroutine is then resumed through the executor it
+ * passed, so that an I/O thread is never blocked by the computation:
+ *
+ *   falcon::ComputePool<9> pool({ .threads = 4 });
+ *
+ *   bool ok = co_await pool.verify(ex, vk, sig, msg);
+ *   auto s = co_await pool.sign(ex, sk, msg, buf);   // subspan of buf
+ *
+ * An executor is any object with an execute(f) member that eventually
+ * calls f() (e.g. an Asio io_context executor). Without an executor, the
+ * coroutine resumes on the dispatcher thread (InlineExecutor), which
+ * then runs the coroutine up to its next suspension before it processes
+ * the next batch. Such a coroutine must not destroy the pool: the
+ * destructor joins the dispatcher thread, which cannot join itself.
+ *
+ * Requests queued while a batch runs form the next batch, so batches grow
+ * with the load. With max_delay > 0, the dispatcher also waits up to that
+ * long for a batch to fill, trading latency for throughput.
+ *
+ * Worker threads exist only if the C library is compiled with
+ * FALCON_THREADS; otherwise the dispatcher thread alone processes the
+ * batches. Keys, signature buffers and messages must stay valid until the
+ * coroutine resumes. Results and errors are those of falcon.hpp:
+ * verify() yields false for signatures that do not verify, and other
+ * failures raise falcon::error when the coroutine resumes.
+ *
+ * ==========================(LICENSE BEGIN)============================
+ *
+ * Copyright (c) 2025  Falcon QONE WASM Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ===========================(LICENSE END)=============================
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "falcon.hpp"
+
+namespace falcon {
+
+namespace detail {
+
+/*
+ * Task given to an executor to resume a coroutine.
+ */
+struct Resume {
+	std::coroutine_handle<> handle;
+
+	void operator()() const { handle.resume(); }
+};
+
+/*
+ * A queued request; it lives in the awaitable, in the coroutine frame.
+ * For signing, sig[] is the output buffer and sig_len is updated.
+ */
+struct AsyncRequest {
+	AsyncRequest *next = nullptr;
+	bool signing = false;
+	int sig_type = 0;
+	const void *key = nullptr;
+	void *sig = nullptr;
+	std::size_t sig_len = 0;
+	const void *data = nullptr;
+	std::size_t data_len = 0;
+	int result = 0;
+	void (*complete)(AsyncRequest *) = nullptr;
+};
+
+}
+
+template<typename E>
+concept Executor = std::copy_constructible<E>
+	&& requires(const E &ex, detail::Resume r) { ex.execute(r); };
+
+/*
+ * Resumes coroutines on the thread that completes the request.
+ */
+struct InlineExecutor {
+	template<typename F>
+	void execute(F &&f) const { std::forward<F>(f)(); }
+};
+
+template<unsigned LOGN>
+class ComputePool {
+	using F = Falcon<LOGN>;
+
+public:
+	struct Options {
+		/* Threads that process batches, the dispatcher included
+		   (1 to 64); 0 for the number of hardware threads. */
+		unsigned threads = 0;
+		/* Maximum number of requests per batch. */
+		std::size_t max_batch = 256;
+		/* How long a partial batch may wait for more requests. */
+		std::chrono::microseconds max_delay{0};
+	};
+
+	/* Batches processed so far, and the requests in them. */
+	struct Stats {
+		std::uint64_t batches = 0;
+		std::uint64_t requests = 0;
+	};
+
+	/*
+	 * Awaitable of a request; it yields bool (verify) or the
+	 * written part of the output buffer (sign).
+	 */
+	template<Executor E, bool SIGN>
+	class Op : detail::AsyncRequest {
+	public:
+		Op(const Op &) = delete;
+		Op &operator=(const Op &) = delete;
+
+		bool await_ready() const noexcept { return false; }
+
+		void await_suspend(std::coroutine_handle<> h)
+		{
+			handle_ = h;
+			pool_->submit(this);
+		}
+
+		auto await_resume() const
+		{
+			if constexpr (SIGN) {
+				detail::check(result);
+				return std::span<std::uint8_t>(
+					static_cast<std::uint8_t *>(sig),
+					sig_len);
+			} else {
+				if (result == FALCON_ERR_BADSIG
+					|| result == FALCON_ERR_FORMAT)
+				{
+					return false;
+				}
+				detail::check(result);
+				return true;
+			}
+		}
+
+	private:
+		Op(ComputePool *pool, E ex, SigType type, const void *k,
+			void *sig_buf, std::size_t len,
+			std::span<const std::uint8_t> msg)
+			: pool_(pool), ex_(std::move(ex))
+		{
+			signing = SIGN;
+			sig_type = static_cast<int>(type);
+			key = k;
+			sig = sig_buf;
+			sig_len = len;
+			data = msg.data();
+			data_len = msg.size();
+			complete = &Op::finish;
+		}
+
+		/*
+		 * The coroutine may run (and destroy this object) as soon
+		 * as the executor has the task, so it is given copies.
+		 */
+		static void finish(detail::AsyncRequest *r)
+		{
+			Op *op = static_cast<Op *>(r);
+			E ex = op->ex_;
+
+			ex.execute(detail::Resume{ op->handle_ });
+		}
+
+		ComputePool *pool_;
+		E ex_;
+		std::coroutine_handle<> handle_;
+
+		friend class ComputePool;
+	};
+
+	/* The signing RNG is seeded from the system RNG. */
+	ComputePool() : ComputePool(Options()) {}
+
+	explicit ComputePool(const Options &opt)
+	{
+		start(opt);
+	}
+
+	/* Deterministic signing RNG (for tests). */
+	ComputePool(const Options &opt, std::span<const std::uint8_t> seed)
+		: rng_(seed)
+	{
+		start(opt);
+	}
+
+	ComputePool(const ComputePool &) = delete;
+	ComputePool &operator=(const ComputePool &) = delete;
+
+	/*
+	 * Requests still queued are processed before the threads stop;
+	 * no request may be made once destruction has begun. This joins
+	 * the dispatcher thread, so it must not run on that thread (e.g.
+	 * from a coroutine resumed by InlineExecutor).
+	 */
+	~ComputePool()
+	{
+		{
+			std::lock_guard<std::mutex> lk(mu_);
+			stop_ = true;
+		}
+		cv_.notify_one();
+		dispatcher_.join();
+		falcon_batch_ctx_release(ctx_);
+	}
+
+	/* Threads that process batches, the dispatcher included. */
+	unsigned threads() const noexcept
+	{
+		return falcon_batch_ctx_threads(ctx_);
+	}
+
+	Stats stats() const
+	{
+		std::lock_guard<std::mutex> lk(mu_);
+		return stats_;
+	}
+
+	template<Executor E>
+	[[nodiscard]] Op<E, false> verify(E ex,
+		const typename F::VerifyingKey &vk,
+		std::span<const std::uint8_t> sig,
+		std::span<const std::uint8_t> msg,
+		SigType type = SigType::any)
+	{
+		return Op<E, false>(this, std::move(ex), type, vk.key_.get(),
+			const_cast<std::uint8_t *>(sig.data()), sig.size(),
+			msg);
+	}
+
+	[[nodiscard]] Op<InlineExecutor, false> verify(
+		const typename F::VerifyingKey &vk,
+		std::span<const std::uint8_t> sig,
+		std::span<const std::uint8_t> msg,
+		SigType type = SigType::any)
+	{
+		return verify(InlineExecutor(), vk, sig, msg, type);
+	}
+
+	template<Executor E>
+	[[nodiscard]] Op<E, true> sign(E ex,
+		const typename F::SigningKey &sk,
+		std::span<const std::uint8_t> msg,
+		std::span<std::uint8_t> out,
+		SigType type = SigType::compressed)
+	{
+		return Op<E, true>(this, std::move(ex), type, sk.key_.get(),
+			out.data(), out.size(), msg);
+	}
+
+	[[nodiscard]] Op<InlineExecutor, true> sign(
+		const typename F::SigningKey &sk,
+		std::span<const std::uint8_t> msg,
+		std::span<std::uint8_t> out,
+		SigType type = SigType::compressed)
+	{
+		return sign(InlineExecutor(), sk, msg, out, type);
+	}
+
+private:
+	void start(const Options &opt)
+	{
+		unsigned nt;
+		std::size_t len;
+
+		max_batch_ = std::max<std::size_t>(opt.max_batch, 1);
+		max_delay_ = opt.max_delay;
+		nt = opt.threads;
+		if (nt == 0) {
+			nt = std::clamp(std::thread::hardware_concurrency(),
+				1u, 64u);
+		}
+		len = falcon_batch_ctx_size(LOGN, nt);
+		if (len == 0) {
+			throw error(FALCON_ERR_BADARG);
+		}
+		mem_.reset(new std::uint8_t[len]);
+		detail::check(falcon_batch_ctx_init(&ctx_,
+			mem_.get(), len, LOGN, nt));
+		try {
+			dispatcher_ = std::thread([this] { run(); });
+		} catch (...) {
+			falcon_batch_ctx_release(ctx_);
+			throw;
+		}
+	}
+
+	void submit(detail::AsyncRequest *r)
+	{
+		{
+			std::lock_guard<std::mutex> lk(mu_);
+			if (tail_ != nullptr) {
+				tail_->next = r;
+			} else {
+				head_ = r;
+			}
+			tail_ = r;
+			pending_ ++;
+		}
+		cv_.notify_one();
+	}
+
+	/*
+	 * Dispatcher loop: each batch is cut from the front of the queue
+	 * and processed with the lock released.
+	 */
+	void run()
+	{
+		std::unique_lock<std::mutex> lk(mu_);
+
+		for (;;) {
+			detail::AsyncRequest *first, *r;
+			std::size_t n;
+
+			cv_.wait(lk, [this] {
+				return pending_ != 0 || stop_;
+			});
+			if (pending_ == 0) {
+				return;
+			}
+			if (pending_ < max_batch_ && max_delay_.count() > 0) {
+				cv_.wait_for(lk, max_delay_, [this] {
+					return pending_ >= max_batch_ || stop_;
+				});
+			}
+			first = head_;
+			for (n = 1, r = first; n < max_batch_
+				&& r->next != nullptr; n ++, r = r->next);
+			head_ = r->next;
+			r->next = nullptr;
+			if (head_ == nullptr) {
+				tail_ = nullptr;
+			}
+			pending_ -= n;
+			stats_.batches ++;
+			stats_.requests += n;
+			lk.unlock();
+
+			process(first);
+			while (first != nullptr) {
+				r = first;
+				first = r->next;
+				r->complete(r);
+			}
+			lk.lock();
+		}
+	}
+
+	/*
+	 * Requests are grouped by kind, signature type and (for signing)
+	 * key, with one batch call per group.
+	 */
+	void process(detail::AsyncRequest *first)
+	{
+		std::vector<detail::AsyncRequest *> &batch = batch_;
+		std::size_t i, j;
+
+		try {
+			batch.clear();
+			for (detail::AsyncRequest *r = first; r != nullptr;
+				r = r->next)
+			{
+				batch.push_back(r);
+			}
+			std::stable_sort(batch.begin(), batch.end(),
+				[](const detail::AsyncRequest *a,
+				const detail::AsyncRequest *b)
+				{
+					if (a->signing != b->signing) {
+						return b->signing;
+					}
+					if (a->sig_type != b->sig_type) {
+						return a->sig_type < b->sig_type;
+					}
+					return a->signing && std::less<>()(
+						a->key, b->key);
+				});
+			for (i = 0; i < batch.size(); i = j) {
+				for (j = i + 1; j < batch.size()
+					&& batch[j]->signing == batch[i]->signing
+					&& batch[j]->sig_type == batch[i]->sig_type
+					&& (!batch[i]->signing
+					|| batch[j]->key == batch[i]->key);
+					j ++);
+				std::span<detail::AsyncRequest *> group(
+					batch.data() + i, j - i);
+				if (batch[i]->signing) {
+					sign_group(group);
+				} else {
+					verify_group(group);
+				}
+			}
+		} catch (...) {
+			for (detail::AsyncRequest *r = first; r != nullptr;
+				r = r->next)
+			{
+				r->result = FALCON_ERR_INTERNAL;
+			}
+		}
+	}
+
+	void verify_group(std::span<detail::AsyncRequest *> group)
+	{
+		int r;
+
+		items_.resize(group.size());
+		results_.resize(group.size());
+		for (std::size_t i = 0; i < group.size(); i ++) {
+			items_[i] = falcon_verify_item{
+				group[i]->sig, group[i]->sig_len,
+				group[i]->data, group[i]->data_len,
+				group[i]->key, 0
+			};
+		}
+		r = falcon_batch_verify(ctx_, group[0]->sig_type,
+			items_.data(), results_.data(), group.size());
+		for (std::size_t i = 0; i < group.size(); i ++) {
+			group[i]->result = r < 0 ? r : results_[i];
+		}
+	}
+
+	void sign_group(std::span<detail::AsyncRequest *> group)
+	{
+		int r;
+
+		jobs_.resize(group.size());
+		for (std::size_t i = 0; i < group.size(); i ++) {
+			jobs_[i] = falcon_sign_job{
+				group[i]->data, group[i]->data_len,
+				group[i]->sig, group[i]->sig_len, 0
+			};
+		}
+		r = falcon_batch_sign_tree(ctx_, rng_.get(),
+			group[0]->sig_type, group[0]->key,
+			jobs_.data(), group.size());
+		for (std::size_t i = 0; i < group.size(); i ++) {
+			group[i]->result = r < 0 ? r : jobs_[i].status;
+			group[i]->sig_len = jobs_[i].sig_len;
+		}
+	}
+
+	std::size_t max_batch_ = 1;
+	std::chrono::microseconds max_delay_{0};
+	std::unique_ptr<std::uint8_t[]> mem_;
+	falcon_batch_ctx *ctx_ = nullptr;
+
+	mutable std::mutex mu_;
+	std::condition_variable cv_;
+	detail::AsyncRequest *head_ = nullptr;
+	detail::AsyncRequest *tail_ = nullptr;
+	std::size_t pending_ = 0;
+	bool stop_ = false;
+	Stats stats_;
+
+	/* Used by the dispatcher thread only. */
+	Rng rng_;
+	std::vector<detail::AsyncRequest *> batch_;
+	std::vector<falcon_verify_item> items_;
+	std::vector<int> results_;
+	std::vector<falcon_sign_job> jobs_;
+
+	std::thread dispatcher_;
+};
+
+using ComputePool512 = ComputePool<9>;
+using ComputePool1024 = ComputePool<10>;
+
+}
+
+#endif
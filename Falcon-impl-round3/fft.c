@@ -258,6 +258,55 @@ Zf(FFT)(fpr *f, unsigned logn)
 			} else {
 				fpr s_re, s_im;
 
+				s_re = fpr_gm_tab[((m + i1) << 1) + 0];
+				s_im = fpr_gm_tab[((m + i1) << 1) + 1];
+				for (j = j1; j < j2; j ++) {
+					fpr x_re, x_im, y_re, y_im;
+
+					x_re = f[j];
+					x_im = f[j + hn];
+					y_re = f[j + ht];
+					y_im = f[j + ht + hn];
+					FPC_MUL(y_re, y_im,
+						y_re, y_im, s_re, s_im);
+					FPC_ADD(f[j], f[j + hn],
+						x_re, x_im, y_re, y_im);
+					FPC_SUB(f[j + ht], f[j + ht + hn],
+						x_re, x_im, y_re, y_im);
+				}
+			}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+			if (ht >= 2) {
+				v128_t s_re, s_im;
+
+				s_re = wasm_f64x2_splat(
+					fpr_gm_tab[((m + i1) << 1) + 0].v);
+				s_im = wasm_f64x2_splat(
+					fpr_gm_tab[((m + i1) << 1) + 1].v);
+				for (j = j1; j < j2; j += 2) {
+					v128_t x_re, x_im, y_re, y_im;
+					v128_t z_re, z_im;
+
+					x_re = wasm_v128_load(&f[j].v);
+					x_im = wasm_v128_load(&f[j + hn].v);
+					z_re = wasm_v128_load(&f[j+ht].v);
+					z_im = wasm_v128_load(&f[j+ht + hn].v);
+					y_re = WFMSUB(z_re, s_re,
+						wasm_f64x2_mul(z_im, s_im));
+					y_im = WFMADD(z_re, s_im,
+						wasm_f64x2_mul(z_im, s_re));
+					wasm_v128_store(&f[j].v,
+						wasm_f64x2_add(x_re, y_re));
+					wasm_v128_store(&f[j + hn].v,
+						wasm_f64x2_add(x_im, y_im));
+					wasm_v128_store(&f[j + ht].v,
+						wasm_f64x2_sub(x_re, y_re));
+					wasm_v128_store(&f[j + ht + hn].v,
+						wasm_f64x2_sub(x_im, y_im));
+				}
+			} else {
+				fpr s_re, s_im;
+
 				s_re = fpr_gm_tab[((m + i1) << 1) + 0];
 				s_im = fpr_gm_tab[((m + i1) << 1) + 1];
 				for (j = j1; j < j2; j ++) {
@@ -393,6 +442,55 @@ Zf(iFFT)(fpr *f, unsigned logn)
 			} else {
 				fpr s_re, s_im;
 
+				s_re = fpr_gm_tab[((hm + i1) << 1)+0];
+				s_im = fpr_neg(fpr_gm_tab[((hm + i1) << 1)+1]);
+				for (j = j1; j < j2; j ++) {
+					fpr x_re, x_im, y_re, y_im;
+
+					x_re = f[j];
+					x_im = f[j + hn];
+					y_re = f[j + t];
+					y_im = f[j + t + hn];
+					FPC_ADD(f[j], f[j + hn],
+						x_re, x_im, y_re, y_im);
+					FPC_SUB(x_re, x_im,
+						x_re, x_im, y_re, y_im);
+					FPC_MUL(f[j + t], f[j + t + hn],
+						x_re, x_im, s_re, s_im);
+				}
+			}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+			if (t >= 2) {
+				v128_t s_re, s_im;
+
+				s_re = wasm_f64x2_splat(
+					fpr_gm_tab[((hm + i1) << 1) + 0].v);
+				s_im = wasm_f64x2_splat(
+					fpr_gm_tab[((hm + i1) << 1) + 1].v);
+				for (j = j1; j < j2; j += 2) {
+					v128_t x_re, x_im, y_re, y_im;
+					v128_t z_re, z_im;
+
+					x_re = wasm_v128_load(&f[j].v);
+					x_im = wasm_v128_load(&f[j + hn].v);
+					y_re = wasm_v128_load(&f[j+t].v);
+					y_im = wasm_v128_load(&f[j+t + hn].v);
+					wasm_v128_store(&f[j].v,
+						wasm_f64x2_add(x_re, y_re));
+					wasm_v128_store(&f[j + hn].v,
+						wasm_f64x2_add(x_im, y_im));
+					x_re = wasm_f64x2_sub(y_re, x_re);
+					x_im = wasm_f64x2_sub(x_im, y_im);
+					z_re = WFMSUB(x_im, s_im,
+						wasm_f64x2_mul(x_re, s_re));
+					z_im = WFMADD(x_re, s_im,
+						wasm_f64x2_mul(x_im, s_re));
+					wasm_v128_store(&f[j+t].v, z_re);
+					wasm_v128_store(&f[j+t + hn].v, z_im);
+				}
+			} else {
+				fpr s_re, s_im;
+
 				s_re = fpr_gm_tab[((hm + i1) << 1)+0];
 				s_im = fpr_neg(fpr_gm_tab[((hm + i1) << 1)+1]);
 				for (j = j1; j < j2; j ++) {
@@ -470,6 +568,19 @@ Zf(poly_add)(
 			a[u] = fpr_add(a[u], b[u]);
 		}
 	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 2) {
+		for (u = 0; u < n; u += 2) {
+			wasm_v128_store(&a[u].v,
+				wasm_f64x2_add(
+					wasm_v128_load(&a[u].v),
+					wasm_v128_load(&b[u].v)));
+		}
+	} else {
+		for (u = 0; u < n; u ++) {
+			a[u] = fpr_add(a[u], b[u]);
+		}
+	}
 #else // yyyAVX2+0
 	for (u = 0; u < n; u ++) {
 		a[u] = fpr_add(a[u], b[u]);
@@ -499,6 +610,19 @@ Zf(poly_sub)(
 			a[u] = fpr_sub(a[u], b[u]);
 		}
 	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 2) {
+		for (u = 0; u < n; u += 2) {
+			wasm_v128_store(&a[u].v,
+				wasm_f64x2_sub(
+					wasm_v128_load(&a[u].v),
+					wasm_v128_load(&b[u].v)));
+		}
+	} else {
+		for (u = 0; u < n; u ++) {
+			a[u] = fpr_sub(a[u], b[u]);
+		}
+	}
 #else // yyyAVX2+0
 	for (u = 0; u < n; u ++) {
 		a[u] = fpr_sub(a[u], b[u]);
@@ -594,6 +718,33 @@ Zf(poly_mul_fft)(
 		for (u = 0; u < hn; u ++) {
 			fpr a_re, a_im, b_re, b_im;
 
+			a_re = a[u];
+			a_im = a[u + hn];
+			b_re = b[u];
+			b_im = b[u + hn];
+			FPC_MUL(a[u], a[u + hn], a_re, a_im, b_re, b_im);
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		for (u = 0; u < hn; u += 2) {
+			v128_t a_re, a_im, b_re, b_im, c_re, c_im;
+
+			a_re = wasm_v128_load(&a[u].v);
+			a_im = wasm_v128_load(&a[u + hn].v);
+			b_re = wasm_v128_load(&b[u].v);
+			b_im = wasm_v128_load(&b[u + hn].v);
+			c_re = WFMSUB(
+				a_re, b_re, wasm_f64x2_mul(a_im, b_im));
+			c_im = WFMADD(
+				a_re, b_im, wasm_f64x2_mul(a_im, b_re));
+			wasm_v128_store(&a[u].v, c_re);
+			wasm_v128_store(&a[u + hn].v, c_im);
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr a_re, a_im, b_re, b_im;
+
 			a_re = a[u];
 			a_im = a[u + hn];
 			b_re = b[u];
@@ -644,6 +795,33 @@ Zf(poly_muladj_fft)(
 		for (u = 0; u < hn; u ++) {
 			fpr a_re, a_im, b_re, b_im;
 
+			a_re = a[u];
+			a_im = a[u + hn];
+			b_re = b[u];
+			b_im = fpr_neg(b[u + hn]);
+			FPC_MUL(a[u], a[u + hn], a_re, a_im, b_re, b_im);
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		for (u = 0; u < hn; u += 2) {
+			v128_t a_re, a_im, b_re, b_im, c_re, c_im;
+
+			a_re = wasm_v128_load(&a[u].v);
+			a_im = wasm_v128_load(&a[u + hn].v);
+			b_re = wasm_v128_load(&b[u].v);
+			b_im = wasm_v128_load(&b[u + hn].v);
+			c_re = WFMADD(
+				a_re, b_re, wasm_f64x2_mul(a_im, b_im));
+			c_im = WFMSUB(
+				a_im, b_re, wasm_f64x2_mul(a_re, b_im));
+			wasm_v128_store(&a[u].v, c_re);
+			wasm_v128_store(&a[u + hn].v, c_im);
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr a_re, a_im, b_re, b_im;
+
 			a_re = a[u];
 			a_im = a[u + hn];
 			b_re = b[u];
@@ -696,6 +874,31 @@ Zf(poly_mulselfadj_fft)(fpr *a, unsigned logn)
 		for (u = 0; u < hn; u ++) {
 			fpr a_re, a_im;
 
+			a_re = a[u];
+			a_im = a[u + hn];
+			a[u] = fpr_add(fpr_sqr(a_re), fpr_sqr(a_im));
+			a[u + hn] = fpr_zero;
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		v128_t zero;
+
+		zero = wasm_f64x2_splat(0.0);
+		for (u = 0; u < hn; u += 2) {
+			v128_t a_re, a_im;
+
+			a_re = wasm_v128_load(&a[u].v);
+			a_im = wasm_v128_load(&a[u + hn].v);
+			wasm_v128_store(&a[u].v,
+				WFMADD(a_re, a_re,
+					wasm_f64x2_mul(a_im, a_im)));
+			wasm_v128_store(&a[u + hn].v, zero);
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr a_re, a_im;
+
 			a_re = a[u];
 			a_im = a[u + hn];
 			a[u] = fpr_add(fpr_sqr(a_re), fpr_sqr(a_im));
@@ -736,6 +939,20 @@ Zf(poly_mulconst)(fpr *a, fpr x, unsigned logn)
 			a[u] = fpr_mul(a[u], x);
 		}
 	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 2) {
+		v128_t x2;
+
+		x2 = wasm_f64x2_splat(x.v);
+		for (u = 0; u < n; u += 2) {
+			wasm_v128_store(&a[u].v,
+				wasm_f64x2_mul(x2, wasm_v128_load(&a[u].v)));
+		}
+	} else {
+		for (u = 0; u < n; u ++) {
+			a[u] = fpr_mul(a[u], x);
+		}
+	}
 #else // yyyAVX2+0
 	for (u = 0; u < n; u ++) {
 		a[u] = fpr_mul(a[u], x);
@@ -781,6 +998,41 @@ Zf(poly_div_fft)(
 		for (u = 0; u < hn; u ++) {
 			fpr a_re, a_im, b_re, b_im;
 
+			a_re = a[u];
+			a_im = a[u + hn];
+			b_re = b[u];
+			b_im = b[u + hn];
+			FPC_DIV(a[u], a[u + hn], a_re, a_im, b_re, b_im);
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		v128_t one;
+
+		one = wasm_f64x2_splat(1.0);
+		for (u = 0; u < hn; u += 2) {
+			v128_t a_re, a_im, b_re, b_im, c_re, c_im, t;
+
+			a_re = wasm_v128_load(&a[u].v);
+			a_im = wasm_v128_load(&a[u + hn].v);
+			b_re = wasm_v128_load(&b[u].v);
+			b_im = wasm_v128_load(&b[u + hn].v);
+			t = wasm_f64x2_div(one,
+				WFMADD(b_re, b_re,
+					wasm_f64x2_mul(b_im, b_im)));
+			b_re = wasm_f64x2_mul(b_re, t);
+			b_im = wasm_f64x2_mul(b_im, t);
+			c_re = WFMADD(
+				a_re, b_re, wasm_f64x2_mul(a_im, b_im));
+			c_im = WFMSUB(
+				a_im, b_re, wasm_f64x2_mul(a_re, b_im));
+			wasm_v128_store(&a[u].v, c_re);
+			wasm_v128_store(&a[u + hn].v, c_im);
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr a_re, a_im, b_re, b_im;
+
 			a_re = a[u];
 			a_im = a[u + hn];
 			b_re = b[u];
@@ -836,6 +1088,40 @@ Zf(poly_invnorm2_fft)(fpr *restrict d,
 			fpr a_re, a_im;
 			fpr b_re, b_im;
 
+			a_re = a[u];
+			a_im = a[u + hn];
+			b_re = b[u];
+			b_im = b[u + hn];
+			d[u] = fpr_inv(fpr_add(
+				fpr_add(fpr_sqr(a_re), fpr_sqr(a_im)),
+				fpr_add(fpr_sqr(b_re), fpr_sqr(b_im))));
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		v128_t one;
+
+		one = wasm_f64x2_splat(1.0);
+		for (u = 0; u < hn; u += 2) {
+			v128_t a_re, a_im, b_re, b_im, dv;
+
+			a_re = wasm_v128_load(&a[u].v);
+			a_im = wasm_v128_load(&a[u + hn].v);
+			b_re = wasm_v128_load(&b[u].v);
+			b_im = wasm_v128_load(&b[u + hn].v);
+			dv = wasm_f64x2_div(one,
+				wasm_f64x2_add(
+					WFMADD(a_re, a_re,
+						wasm_f64x2_mul(a_im, a_im)),
+					WFMADD(b_re, b_re,
+						wasm_f64x2_mul(b_im, b_im))));
+			wasm_v128_store(&d[u].v, dv);
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr a_re, a_im;
+			fpr b_re, b_im;
+
 			a_re = a[u];
 			a_im = a[u + hn];
 			b_re = b[u];
@@ -916,6 +1202,56 @@ Zf(poly_add_muladj_fft)(fpr *restrict d,
 			g_re = g[u];
 			g_im = g[u + hn];
 
+			FPC_MUL(a_re, a_im, F_re, F_im, f_re, fpr_neg(f_im));
+			FPC_MUL(b_re, b_im, G_re, G_im, g_re, fpr_neg(g_im));
+			d[u] = fpr_add(a_re, b_re);
+			d[u + hn] = fpr_add(a_im, b_im);
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		for (u = 0; u < hn; u += 2) {
+			v128_t F_re, F_im, G_re, G_im;
+			v128_t f_re, f_im, g_re, g_im;
+			v128_t a_re, a_im, b_re, b_im;
+
+			F_re = wasm_v128_load(&F[u].v);
+			F_im = wasm_v128_load(&F[u + hn].v);
+			G_re = wasm_v128_load(&G[u].v);
+			G_im = wasm_v128_load(&G[u + hn].v);
+			f_re = wasm_v128_load(&f[u].v);
+			f_im = wasm_v128_load(&f[u + hn].v);
+			g_re = wasm_v128_load(&g[u].v);
+			g_im = wasm_v128_load(&g[u + hn].v);
+
+			a_re = WFMADD(F_re, f_re,
+				wasm_f64x2_mul(F_im, f_im));
+			a_im = WFMSUB(F_im, f_re,
+				wasm_f64x2_mul(F_re, f_im));
+			b_re = WFMADD(G_re, g_re,
+				wasm_f64x2_mul(G_im, g_im));
+			b_im = WFMSUB(G_im, g_re,
+				wasm_f64x2_mul(G_re, g_im));
+			wasm_v128_store(&d[u].v,
+				wasm_f64x2_add(a_re, b_re));
+			wasm_v128_store(&d[u + hn].v,
+				wasm_f64x2_add(a_im, b_im));
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr F_re, F_im, G_re, G_im;
+			fpr f_re, f_im, g_re, g_im;
+			fpr a_re, a_im, b_re, b_im;
+
+			F_re = F[u];
+			F_im = F[u + hn];
+			G_re = G[u];
+			G_im = G[u + hn];
+			f_re = f[u];
+			f_im = f[u + hn];
+			g_re = g[u];
+			g_im = g[u + hn];
+
 			FPC_MUL(a_re, a_im, F_re, F_im, f_re, fpr_neg(f_im));
 			FPC_MUL(b_re, b_im, G_re, G_im, g_re, fpr_neg(g_im));
 			d[u] = fpr_add(a_re, b_re);
@@ -974,6 +1310,25 @@ Zf(poly_mul_autoadj_fft)(
 			a[u + hn] = fpr_mul(a[u + hn], b[u]);
 		}
 	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		for (u = 0; u < hn; u += 2) {
+			v128_t a_re, a_im, bv;
+
+			a_re = wasm_v128_load(&a[u].v);
+			a_im = wasm_v128_load(&a[u + hn].v);
+			bv = wasm_v128_load(&b[u].v);
+			wasm_v128_store(&a[u].v,
+				wasm_f64x2_mul(a_re, bv));
+			wasm_v128_store(&a[u + hn].v,
+				wasm_f64x2_mul(a_im, bv));
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			a[u] = fpr_mul(a[u], b[u]);
+			a[u + hn] = fpr_mul(a[u + hn], b[u]);
+		}
+	}
 #else // yyyAVX2+0
 	for (u = 0; u < hn; u ++) {
 		a[u] = fpr_mul(a[u], b[u]);
@@ -1010,6 +1365,29 @@ Zf(poly_div_autoadj_fft)(
 		for (u = 0; u < hn; u ++) {
 			fpr ib;
 
+			ib = fpr_inv(b[u]);
+			a[u] = fpr_mul(a[u], ib);
+			a[u + hn] = fpr_mul(a[u + hn], ib);
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		v128_t one;
+
+		one = wasm_f64x2_splat(1.0);
+		for (u = 0; u < hn; u += 2) {
+			v128_t ib, a_re, a_im;
+
+			ib = wasm_f64x2_div(one, wasm_v128_load(&b[u].v));
+			a_re = wasm_v128_load(&a[u].v);
+			a_im = wasm_v128_load(&a[u + hn].v);
+			wasm_v128_store(&a[u].v, wasm_f64x2_mul(a_re, ib));
+			wasm_v128_store(&a[u + hn].v, wasm_f64x2_mul(a_im, ib));
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr ib;
+
 			ib = fpr_inv(b[u]);
 			a[u] = fpr_mul(a[u], ib);
 			a[u + hn] = fpr_mul(a[u + hn], ib);
@@ -1078,6 +1456,62 @@ Zf(poly_LDL_fft)(
 			fpr g00_re, g00_im, g01_re, g01_im, g11_re, g11_im;
 			fpr mu_re, mu_im;
 
+			g00_re = g00[u];
+			g00_im = g00[u + hn];
+			g01_re = g01[u];
+			g01_im = g01[u + hn];
+			g11_re = g11[u];
+			g11_im = g11[u + hn];
+			FPC_DIV(mu_re, mu_im, g01_re, g01_im, g00_re, g00_im);
+			FPC_MUL(g01_re, g01_im,
+				mu_re, mu_im, g01_re, fpr_neg(g01_im));
+			FPC_SUB(g11[u], g11[u + hn],
+				g11_re, g11_im, g01_re, g01_im);
+			g01[u] = mu_re;
+			g01[u + hn] = fpr_neg(mu_im);
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		v128_t one;
+
+		one = wasm_f64x2_splat(1.0);
+		for (u = 0; u < hn; u += 2) {
+			v128_t g00_re, g00_im, g01_re, g01_im, g11_re, g11_im;
+			v128_t t, mu_re, mu_im, xi_re, xi_im;
+
+			g00_re = wasm_v128_load(&g00[u].v);
+			g00_im = wasm_v128_load(&g00[u + hn].v);
+			g01_re = wasm_v128_load(&g01[u].v);
+			g01_im = wasm_v128_load(&g01[u + hn].v);
+			g11_re = wasm_v128_load(&g11[u].v);
+			g11_im = wasm_v128_load(&g11[u + hn].v);
+
+			t = wasm_f64x2_div(one,
+				WFMADD(g00_re, g00_re,
+					wasm_f64x2_mul(g00_im, g00_im)));
+			g00_re = wasm_f64x2_mul(g00_re, t);
+			g00_im = wasm_f64x2_mul(g00_im, t);
+			mu_re = WFMADD(g01_re, g00_re,
+				wasm_f64x2_mul(g01_im, g00_im));
+			mu_im = WFMSUB(g01_re, g00_im,
+				wasm_f64x2_mul(g01_im, g00_re));
+			xi_re = WFMSUB(mu_re, g01_re,
+				wasm_f64x2_mul(mu_im, g01_im));
+			xi_im = WFMADD(mu_im, g01_re,
+				wasm_f64x2_mul(mu_re, g01_im));
+			wasm_v128_store(&g11[u].v,
+				wasm_f64x2_sub(g11_re, xi_re));
+			wasm_v128_store(&g11[u + hn].v,
+				wasm_f64x2_add(g11_im, xi_im));
+			wasm_v128_store(&g01[u].v, mu_re);
+			wasm_v128_store(&g01[u + hn].v, mu_im);
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr g00_re, g00_im, g01_re, g01_im, g11_re, g11_im;
+			fpr mu_re, mu_im;
+
 			g00_re = g00[u];
 			g00_im = g00[u + hn];
 			g01_re = g01[u];
@@ -1166,6 +1600,62 @@ Zf(poly_LDLmv_fft)(
 			fpr g00_re, g00_im, g01_re, g01_im, g11_re, g11_im;
 			fpr mu_re, mu_im;
 
+			g00_re = g00[u];
+			g00_im = g00[u + hn];
+			g01_re = g01[u];
+			g01_im = g01[u + hn];
+			g11_re = g11[u];
+			g11_im = g11[u + hn];
+			FPC_DIV(mu_re, mu_im, g01_re, g01_im, g00_re, g00_im);
+			FPC_MUL(g01_re, g01_im,
+				mu_re, mu_im, g01_re, fpr_neg(g01_im));
+			FPC_SUB(d11[u], d11[u + hn],
+				g11_re, g11_im, g01_re, g01_im);
+			l10[u] = mu_re;
+			l10[u + hn] = fpr_neg(mu_im);
+		}
+	}
+#elif FALCON_WASM_SIMD // yyyWASM+1
+	if (n >= 4) {
+		v128_t one;
+
+		one = wasm_f64x2_splat(1.0);
+		for (u = 0; u < hn; u += 2) {
+			v128_t g00_re, g00_im, g01_re, g01_im, g11_re, g11_im;
+			v128_t t, mu_re, mu_im, xi_re, xi_im;
+
+			g00_re = wasm_v128_load(&g00[u].v);
+			g00_im = wasm_v128_load(&g00[u + hn].v);
+			g01_re = wasm_v128_load(&g01[u].v);
+			g01_im = wasm_v128_load(&g01[u + hn].v);
+			g11_re = wasm_v128_load(&g11[u].v);
+			g11_im = wasm_v128_load(&g11[u + hn].v);
+
+			t = wasm_f64x2_div(one,
+				WFMADD(g00_re, g00_re,
+					wasm_f64x2_mul(g00_im, g00_im)));
+			g00_re = wasm_f64x2_mul(g00_re, t);
+			g00_im = wasm_f64x2_mul(g00_im, t);
+			mu_re = WFMADD(g01_re, g00_re,
+				wasm_f64x2_mul(g01_im, g00_im));
+			mu_im = WFMSUB(g01_re, g00_im,
+				wasm_f64x2_mul(g01_im, g00_re));
+			xi_re = WFMSUB(mu_re, g01_re,
+				wasm_f64x2_mul(mu_im, g01_im));
+			xi_im = WFMADD(mu_im, g01_re,
+				wasm_f64x2_mul(mu_re, g01_im));
+			wasm_v128_store(&d11[u].v,
+				wasm_f64x2_sub(g11_re, xi_re));
+			wasm_v128_store(&d11[u + hn].v,
+				wasm_f64x2_add(g11_im, xi_im));
+			wasm_v128_store(&l10[u].v, mu_re);
+			wasm_v128_store(&l10[u + hn].v, mu_im);
+		}
+	} else {
+		for (u = 0; u < hn; u ++) {
+			fpr g00_re, g00_im, g01_re, g01_im, g11_re, g11_im;
+			fpr mu_re, mu_im;
+
 			g00_re = g00[u];
 			g00_im = g00[u + hn];
 			g01_re = g01[u];
@@ -113,6 +113,23 @@
 #endif
 #endif // yyyAVX2-
 
+#if defined FALCON_WASM_SIMD && FALCON_WASM_SIMD // yyyWASM+1
+/*
+ * This implementation uses WebAssembly SIMD128 and optionally
+ * relaxed-SIMD intrinsics. WFMSUB(a, b, c) computes a*b-c; negation
+ * is exact, so with relaxed_madd this is a single (possibly fused)
+ * operation too.
+ */
+#include <wasm_simd128.h>
+#if defined FALCON_WASM_RELAXED && FALCON_WASM_RELAXED
+#define WFMADD(a, b, c)   wasm_f64x2_relaxed_madd(a, b, c)
+#define WFMSUB(a, b, c)   wasm_f64x2_relaxed_madd(a, b, wasm_f64x2_neg(c))
+#else
+#define WFMADD(a, b, c)   wasm_f64x2_add(wasm_f64x2_mul(a, b), c)
+#define WFMSUB(a, b, c)   wasm_f64x2_sub(wasm_f64x2_mul(a, b), c)
+#endif
+#endif // yyyWASM-
+
 // yyyNIST+0 yyyPQCLEAN+0
 /*
  * On MSVC, disable warning about applying unary minus on an unsigned
@@ -222,6 +239,12 @@
 #error Exactly one of FALCON_FPEMU and FALCON_FPNATIVE must be selected
 #endif
 
+#if defined FALCON_WASM_SIMD && FALCON_WASM_SIMD
+#if FALCON_FPEMU || (defined FALCON_AVX2 && FALCON_AVX2)
+#error FALCON_WASM_SIMD requires FALCON_FPNATIVE and excludes FALCON_AVX2
+#endif
+#endif
+
 // yyySUPERCOP+0
 /*
  * For seed generation from the operating system:
@@ -277,9 +300,24 @@
 #ifndef FALCON_FMA
 #define FALCON_FMA   0
 #endif
+#ifndef FALCON_WASM_SIMD
+#define FALCON_WASM_SIMD   0
+#endif
+#ifndef FALCON_WASM_RELAXED
+#define FALCON_WASM_RELAXED   0
+#endif
 #ifndef FALCON_KG_CHACHA20
 #define FALCON_KG_CHACHA20   0
 #endif
+#ifndef FALCON_THREADS
+#define FALCON_THREADS   0
+#endif
+#ifndef FALCON_KG_THREADS
+#define FALCON_KG_THREADS   FALCON_THREADS
+#endif
+#ifndef FALCON_KG_PROFILE
+#define FALCON_KG_PROFILE   0
+#endif
 // yyyNIST- yyyPQCLEAN-
 
 // yyyPQCLEAN+0 yyySUPERCOP+0
@@ -507,6 +545,19 @@ size_t Zf(trim_i8_decode)(int8_t *x, unsigned logn, unsigned bits,
 size_t Zf(comp_decode)(int16_t *x, unsigned logn,
 	const void *in, size_t max_in_len);
 
+/*
+ * Variants of Zf(trim_i16_decode)() and Zf(comp_decode)() for signature
+ * verification: values are written reduced modulo q (0..q-1 range,
+ * i.e. as uint16_t), and the saturated squared norm of the signed
+ * values (see Zf(is_short_half)()) is computed along the way and
+ * written in *sqn. Both functions accept and reject exactly the same
+ * inputs as the plain variants.
+ */
+size_t Zf(trim_i16_decode_modq)(uint16_t *x, uint32_t *sqn,
+	unsigned logn, unsigned bits, const void *in, size_t max_in_len);
+size_t Zf(comp_decode_modq)(uint16_t *x, uint32_t *sqn, unsigned logn,
+	const void *in, size_t max_in_len);
+
 /*
  * Number of bits for key elements, indexed by logn (1 to 10). This
  * is at most 8 bits for all degrees, but some degrees may have shorter
@@ -567,6 +618,12 @@ int Zf(is_short)(const int16_t *s1, const int16_t *s2, unsigned logn);
  */
 int Zf(is_short_half)(uint32_t sqn, const int16_t *s2, unsigned logn);
 
+/*
+ * Tell whether a vector is acceptable as a signature, given the
+ * saturated squared norms of its two halves.
+ */
+int Zf(is_short_sqn)(uint32_t sqn1, uint32_t sqn2, unsigned logn);
+
 /* ==================================================================== */
 /*
  * Signature verification functions (vrfy.c).
@@ -592,6 +649,41 @@ void Zf(to_ntt_monty)(uint16_t *h, unsigned logn);
 int Zf(verify_raw)(const uint16_t *c0, const int16_t *s2,
 	const uint16_t *h, unsigned logn, uint8_t *tmp);
 
+/*
+ * Same as Zf(verify_raw)(), but the signature is provided already
+ * reduced modulo q, with the saturated squared norm of its signed
+ * values (as produced by Zf(comp_decode_modq)() and
+ * Zf(trim_i16_decode_modq)()):
+ *   c0[]      contains the hashed nonce+message
+ *   s2[]      is the decoded signature, modulo q (modified)
+ *   sqn2      is the saturated squared norm of the signature
+ *   h[]       contains the public key, in NTT + Montgomery format
+ *   logn      is the degree log
+ * The norm of the first half is computed within the last pass of the
+ * inverse NTT, so that s2[] is read and written only by the NTT passes.
+ * Returned value is 1 on success, 0 on error.
+ */
+int Zf(verify_raw_modq)(const uint16_t *c0, uint16_t *s2, uint32_t sqn2,
+	const uint16_t *h, unsigned logn);
+
+/*
+ * Recover the first signature half from the second one:
+ *   s1[]      receives s1 = c0 - s2*h mod phi mod q, normalized to
+ *             the [-q/2..q/2] range
+ *   c0[]      contains the hashed nonce+message
+ *   s2[]      is the decoded signature
+ *   h[]       contains the public key, in NTT + Montgomery format
+ *   logn      is the degree log
+ *   tmp[]     temporary, must have at least 2*2^logn bytes
+ * This is the computation performed by Zf(verify_raw)() before the norm
+ * check. s1[] may be the start of tmp[], but MUST NOT overlap with the
+ * other arrays.
+ *
+ * tmp[] must have 16-bit alignment.
+ */
+void Zf(compute_s1)(int16_t *s1, const uint16_t *c0, const int16_t *s2,
+	const uint16_t *h, unsigned logn, uint8_t *tmp);
+
 /*
  * Compute the public key h[], given the private key elements f[] and
  * g[]. This computes h = g/f mod phi mod q, where phi is the polynomial
@@ -660,6 +752,40 @@ int Zf(verify_recover)(uint16_t *h,
 	const uint16_t *c0, const int16_t *s1, const int16_t *s2,
 	unsigned logn, uint8_t *tmp);
 
+/*
+ * Arithmetic in Z_q[X]/(X^n+1), for callers that work on the same ring
+ * elements as the signature scheme (hashed messages, public keys,
+ * signature halves). All values are in the 0..q-1 range and in plain
+ * (not Montgomery) representation; "NTT" values are the NTT
+ * representation used by the verification code. Operations are in
+ * place, on f[].
+ *
+ *   mq_poly_ntt        f <- NTT(f)
+ *   mq_poly_intt       f <- NTT^-1(f)
+ *   mq_poly_add        f <- f + g
+ *   mq_poly_sub        f <- f - g
+ *   mq_poly_mul_ntt    f <- f * g, coefficient-wise (f and g in NTT)
+ *   mq_poly_mul        f <- f * g mod X^n+1 (tmp[]: 2*2^logn bytes,
+ *                      16-bit aligned)
+ *   mq_poly_mul_public f <- f * h mod X^n+1, with h[] in the NTT +
+ *                      Montgomery format of Zf(to_ntt_monty)()
+ */
+void Zf(mq_poly_ntt)(uint16_t *f, unsigned logn);
+void Zf(mq_poly_intt)(uint16_t *f, unsigned logn);
+void Zf(mq_poly_add)(uint16_t *f, const uint16_t *g, unsigned logn);
+void Zf(mq_poly_sub)(uint16_t *f, const uint16_t *g, unsigned logn);
+void Zf(mq_poly_mul_ntt)(uint16_t *f, const uint16_t *g, unsigned logn);
+void Zf(mq_poly_mul)(uint16_t *f, const uint16_t *g,
+	unsigned logn, uint8_t *tmp);
+void Zf(mq_poly_mul_public)(uint16_t *f, const uint16_t *h, unsigned logn);
+
+/*
+ * Squared Euclidean norm of f[], with each coefficient taken in the
+ * -(q-1)/2..+(q-1)/2 range. The result does not overflow for any
+ * degree up to 1024.
+ */
+uint64_t Zf(mq_poly_sqnorm)(const uint16_t *f, unsigned logn);
+
 /* ==================================================================== */
 /*
  * Implementation of floating-point real numbers (fpr.h, fpr.c).
@@ -1071,6 +1197,37 @@ void Zf(keygen)(inner_shake256_context *rng,
 	int8_t *f, int8_t *g, int8_t *F, int8_t *G, uint16_t *h,
 	unsigned logn, uint8_t *tmp);
 
+/*
+ * Maximum number of (f,g) candidates handled at once by
+ * Zf(keygen_batch)().
+ */
+#define FALCON_KEYGEN_BATCH_MAX   16
+
+/*
+ * Same as Zf(keygen)(), but (f,g) candidates are drawn by groups of
+ * 'batch' (clamped to 1..FALCON_KEYGEN_BATCH_MAX). All candidates of a
+ * group are checked (norm bounds, invertibility of f) before the NTRU
+ * equation is solved; when FALCON_KG_THREADS is enabled, these checks
+ * run concurrently on one thread per candidate. Candidates are then
+ * tried in generation order, and the RNG state is rewound to just
+ * after the accepted candidate: the key pair, and the RNG state on
+ * output, are identical to what Zf(keygen)() produces from the same
+ * RNG state, whatever the batch size.
+ *
+ * tmp[] must have room for FALCON_KEYGEN_TEMP_* bytes, plus
+ * batch*(28*2^logn + 1024) bytes, and have 64-bit alignment.
+ * This function uses floating-point rounding (see set_fpu_cw()).
+ */
+void Zf(keygen_batch)(inner_shake256_context *rng,
+	int8_t *f, int8_t *g, int8_t *F, int8_t *G, uint16_t *h,
+	unsigned logn, uint8_t *tmp, unsigned batch);
+
+/*
+ * Get the time spent at each depth of the NTRU solver (see
+ * falcon_keygen_profile()).
+ */
+int Zf(keygen_profile)(uint64_t *ns, size_t num, int reset);
+
 /* ==================================================================== */
 /*
  * Signature generation.
@@ -1131,6 +1288,23 @@ void Zf(sign_dyn)(int16_t *sig, inner_shake256_context *rng,
 	const int8_t *restrict F, const int8_t *restrict G,
 	const uint16_t *hm, unsigned logn, uint8_t *tmp);
 
+/*
+ * Same as Zf(sign_dyn)(), with a smaller tmp[] buffer: the Gram matrix
+ * and target vector of the top level are recomputed when needed instead
+ * of being kept, which costs a few extra FFTs per signature. For the
+ * same rng state, the output (signature, and s1 at the start of tmp[])
+ * is identical to that of Zf(sign_dyn)().
+ *
+ * The minimal size (in bytes) of tmp[] is 44*2^logn bytes.
+ *
+ * tmp[] must have 64-bit alignment.
+ * This function uses floating-point rounding (see set_fpu_cw()).
+ */
+void Zf(sign_dyn_lowmem)(int16_t *sig, inner_shake256_context *rng,
+	const int8_t *restrict f, const int8_t *restrict g,
+	const int8_t *restrict F, const int8_t *restrict G,
+	const uint16_t *hm, unsigned logn, uint8_t *tmp);
+
 /*
  * Internal sampler engine. Exported for tests.
  *
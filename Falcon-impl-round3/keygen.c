@@ -31,6 +31,14 @@
 
 #include "inner.h"
 
+#if FALCON_KG_THREADS  // yyyKG_THREADS+1
+#include <pthread.h>
+#endif  // yyyKG_THREADS-
+
+#if FALCON_KG_PROFILE  // yyyKG_PROFILE+1
+#include <time.h>
+#endif  // yyyKG_PROFILE-
+
 #define MKN(logn)   ((size_t)1 << (logn))
 
 /* ==================================================================== */
@@ -731,6 +739,60 @@ modp_montymul(uint32_t a, uint32_t b, uint32_t p, uint32_t p0i)
 	return d;
 }
 
+#if FALCON_AVX2  // yyyAVX2+1
+/*
+ * AVX2 versions of modp_add(), modp_sub() and modp_montymul(), over
+ * eight values at once. xp and xp0i contain p and p0i in all 32-bit
+ * lanes.
+ */
+TARGET_AVX2
+static inline __m256i
+modp_add_x8(__m256i a, __m256i b, __m256i xp)
+{
+	__m256i d;
+
+	d = _mm256_sub_epi32(_mm256_add_epi32(a, b), xp);
+	return _mm256_add_epi32(d,
+		_mm256_and_si256(xp, _mm256_srai_epi32(d, 31)));
+}
+
+TARGET_AVX2
+static inline __m256i
+modp_sub_x8(__m256i a, __m256i b, __m256i xp)
+{
+	__m256i d;
+
+	d = _mm256_sub_epi32(a, b);
+	return _mm256_add_epi32(d,
+		_mm256_and_si256(xp, _mm256_srai_epi32(d, 31)));
+}
+
+TARGET_AVX2
+static inline __m256i
+modp_montymul_x8(__m256i a, __m256i b, __m256i xp, __m256i xp0i)
+{
+	__m256i m31, z0, z1, w0, w1, d;
+
+	/*
+	 * Even lanes are processed in z0/w0, odd lanes in z1/w1.
+	 */
+	m31 = _mm256_set1_epi64x(0x7FFFFFFF);
+	z0 = _mm256_mul_epu32(a, b);
+	z1 = _mm256_mul_epu32(
+		_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	w0 = _mm256_mul_epu32(
+		_mm256_and_si256(_mm256_mul_epu32(z0, xp0i), m31), xp);
+	w1 = _mm256_mul_epu32(
+		_mm256_and_si256(_mm256_mul_epu32(z1, xp0i), m31), xp);
+	z0 = _mm256_srli_epi64(_mm256_add_epi64(z0, w0), 31);
+	z1 = _mm256_slli_epi64(
+		_mm256_srli_epi64(_mm256_add_epi64(z1, w1), 31), 32);
+	d = _mm256_sub_epi32(_mm256_blend_epi32(z0, z1, 0xAA), xp);
+	return _mm256_add_epi32(d,
+		_mm256_and_si256(xp, _mm256_srai_epi32(d, 31)));
+}
+#endif  // yyyAVX2-
+
 /*
  * Compute R2 = 2^62 mod p.
  */
@@ -975,11 +1037,18 @@ modp_mkgm2(uint32_t *restrict gm, uint32_t *restrict igm, unsigned logn,
  * Compute the NTT over a polynomial (binary case). Polynomial elements
  * are a[0], a[stride], a[2 * stride]...
  */
+TARGET_AVX2
 static void
 modp_NTT2_ext(uint32_t *a, size_t stride, const uint32_t *gm, unsigned logn,
 	uint32_t p, uint32_t p0i)
 {
 	size_t t, m, n;
+#if FALCON_AVX2  // yyyAVX2+1
+	__m256i xp, xp0i;
+
+	xp = _mm256_set1_epi32((int)p);
+	xp0i = _mm256_set1_epi32((int)p0i);
+#endif  // yyyAVX2-
 
 	if (logn == 0) {
 		return;
@@ -998,6 +1067,27 @@ modp_NTT2_ext(uint32_t *a, size_t stride, const uint32_t *gm, unsigned logn,
 			s = gm[m + u];
 			r1 = a + v1 * stride;
 			r2 = r1 + ht * stride;
+#if FALCON_AVX2  // yyyAVX2+1
+			if (stride == 1 && ht >= 8) {
+				__m256i xs;
+
+				xs = _mm256_set1_epi32((int)s);
+				for (v = 0; v < ht; v += 8) {
+					__m256i x, y;
+
+					x = _mm256_loadu_si256(
+						(const __m256i *)(r1 + v));
+					y = _mm256_loadu_si256(
+						(const __m256i *)(r2 + v));
+					y = modp_montymul_x8(y, xs, xp, xp0i);
+					_mm256_storeu_si256((__m256i *)(r1 + v),
+						modp_add_x8(x, y, xp));
+					_mm256_storeu_si256((__m256i *)(r2 + v),
+						modp_sub_x8(x, y, xp));
+				}
+				continue;
+			}
+#endif  // yyyAVX2-
 			for (v = 0; v < ht; v ++, r1 += stride, r2 += stride) {
 				uint32_t x, y;
 
@@ -1014,6 +1104,7 @@ modp_NTT2_ext(uint32_t *a, size_t stride, const uint32_t *gm, unsigned logn,
 /*
  * Compute the inverse NTT over a polynomial (binary case).
  */
+TARGET_AVX2
 static void
 modp_iNTT2_ext(uint32_t *a, size_t stride, const uint32_t *igm, unsigned logn,
 	uint32_t p, uint32_t p0i)
@@ -1021,6 +1112,12 @@ modp_iNTT2_ext(uint32_t *a, size_t stride, const uint32_t *igm, unsigned logn,
 	size_t t, m, n, k;
 	uint32_t ni;
 	uint32_t *r;
+#if FALCON_AVX2  // yyyAVX2+1
+	__m256i xp, xp0i;
+
+	xp = _mm256_set1_epi32((int)p);
+	xp0i = _mm256_set1_epi32((int)p0i);
+#endif  // yyyAVX2-
 
 	if (logn == 0) {
 		return;
@@ -1040,6 +1137,28 @@ modp_iNTT2_ext(uint32_t *a, size_t stride, const uint32_t *igm, unsigned logn,
 			s = igm[hm + u];
 			r1 = a + v1 * stride;
 			r2 = r1 + t * stride;
+#if FALCON_AVX2  // yyyAVX2+1
+			if (stride == 1 && t >= 8) {
+				__m256i xs;
+
+				xs = _mm256_set1_epi32((int)s);
+				for (v = 0; v < t; v += 8) {
+					__m256i x, y;
+
+					x = _mm256_loadu_si256(
+						(const __m256i *)(r1 + v));
+					y = _mm256_loadu_si256(
+						(const __m256i *)(r2 + v));
+					_mm256_storeu_si256((__m256i *)(r1 + v),
+						modp_add_x8(x, y, xp));
+					_mm256_storeu_si256((__m256i *)(r2 + v),
+						modp_montymul_x8(
+							modp_sub_x8(x, y, xp),
+							xs, xp, xp0i));
+				}
+				continue;
+			}
+#endif  // yyyAVX2-
 			for (v = 0; v < t; v ++, r1 += stride, r2 += stride) {
 				uint32_t x, y;
 
@@ -1059,7 +1178,21 @@ modp_iNTT2_ext(uint32_t *a, size_t stride, const uint32_t *igm, unsigned logn,
 	 * thus a simple shift will do.
 	 */
 	ni = (uint32_t)1 << (31 - logn);
-	for (k = 0, r = a; k < n; k ++, r += stride) {
+	k = 0;
+	r = a;
+#if FALCON_AVX2  // yyyAVX2+1
+	if (stride == 1) {
+		__m256i xni;
+
+		xni = _mm256_set1_epi32((int)ni);
+		for (; k + 8 <= n; k += 8, r += 8) {
+			_mm256_storeu_si256((__m256i *)r, modp_montymul_x8(
+				_mm256_loadu_si256((const __m256i *)r),
+				xni, xp, xp0i));
+		}
+	}
+#endif  // yyyAVX2-
+	for (; k < n; k ++, r += stride) {
 		*r = modp_montymul(*r, ni, p, p0i);
 	}
 }
@@ -1237,6 +1370,68 @@ zint_mod_small_signed(const uint32_t *d, size_t dlen,
 	return z;
 }
 
+/*
+ * Apply zint_mod_small_signed() to 'num' integers of 'dlen' words each;
+ * the integers start at s, s + sstride, s + 2*sstride... and results
+ * are written at d[0], d[dstride], d[2*dstride]...
+ */
+TARGET_AVX2
+static void
+zint_mod_small_signed_multi(uint32_t *d, size_t dstride,
+	const uint32_t *s, size_t sstride, size_t num, size_t dlen,
+	uint32_t p, uint32_t p0i, uint32_t R2, uint32_t Rx)
+{
+	size_t u;
+
+	u = 0;
+#if FALCON_AVX2  // yyyAVX2+1
+	if (dlen > 0) {
+		__m256i xp, xp0i, xR2, xRx, idx;
+
+		/*
+		 * Eight integers at a time, with the words of each
+		 * obtained through gathers.
+		 */
+		xp = _mm256_set1_epi32((int)p);
+		xp0i = _mm256_set1_epi32((int)p0i);
+		xR2 = _mm256_set1_epi32((int)R2);
+		xRx = _mm256_set1_epi32((int)Rx);
+		idx = _mm256_mullo_epi32(
+			_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+			_mm256_set1_epi32((int)sstride));
+		for (; u + 8 <= num; u += 8, s += 8 * sstride) {
+			__m256i x, w;
+			union {
+				uint32_t w[8];
+				__m256i y;
+			} r;
+			size_t v, j;
+
+			x = _mm256_setzero_si256();
+			v = dlen;
+			while (v -- > 0) {
+				x = modp_montymul_x8(x, xR2, xp, xp0i);
+				w = _mm256_i32gather_epi32(
+					(const int *)(s + v), idx, 4);
+				x = modp_add_x8(x,
+					modp_sub_x8(w, xp, xp), xp);
+			}
+			w = _mm256_i32gather_epi32(
+				(const int *)(s + dlen - 1), idx, 4);
+			w = _mm256_srai_epi32(_mm256_slli_epi32(w, 1), 31);
+			r.y = modp_sub_x8(x, _mm256_and_si256(xRx, w), xp);
+			for (j = 0; j < 8; j ++) {
+				d[(u + j) * dstride] = r.w[j];
+			}
+		}
+	}
+#endif  // yyyAVX2-
+	for (; u < num; u ++, s += sstride) {
+		d[u * dstride] = zint_mod_small_signed(s, dlen,
+			p, p0i, R2, Rx);
+	}
+}
+
 /*
  * Add y*s to x. x and y initially have length 'len' words; the new x
  * has length 'len+1' words. 's' must fit on 31 bits. x[] and y[] must
@@ -2023,7 +2218,12 @@ zint_one_to_plain(const uint32_t *x)
  * roughly 2^(-1023) to 2^(+1023); thus, if coefficients are too large,
  * they should be "trimmed" by pointing not to the lowest word of each,
  * but upper.
+ *
+ * With SIMD, several coefficients are converted in parallel; word
+ * conversions and multiplications by powers of 2^31 are exact, and
+ * additions are done in the same order, so the results are the same.
  */
+TARGET_AVX2
 static void
 poly_big_to_fp(fpr *d, const uint32_t *f, size_t flen, size_t fstride,
 	unsigned logn)
@@ -2037,7 +2237,94 @@ poly_big_to_fp(fpr *d, const uint32_t *f, size_t flen, size_t fstride,
 		}
 		return;
 	}
-	for (u = 0; u < n; u ++, f += fstride) {
+	u = 0;
+#if FALCON_AVX2  // yyyAVX2+1
+	{
+		__m128i idx, m31, one;
+
+		idx = _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3),
+			_mm_set1_epi32((int)fstride));
+		m31 = _mm_set1_epi32(0x7FFFFFFF);
+		one = _mm_set1_epi32(1);
+		for (; u + 4 <= n; u += 4, f += 4 * fstride) {
+			__m128i neg, xm, cc;
+			__m256d x;
+			double fsc;
+			size_t v;
+
+			neg = _mm_i32gather_epi32(
+				(const int *)(f + flen - 1), idx, 4);
+			neg = _mm_srai_epi32(_mm_slli_epi32(neg, 1), 31);
+			xm = _mm_srli_epi32(neg, 1);
+			cc = _mm_and_si128(neg, one);
+			x = _mm256_setzero_pd();
+			fsc = 1.0;
+			for (v = 0; v < flen; v ++, fsc *= 2147483648.0) {
+				__m128i w;
+
+				w = _mm_i32gather_epi32(
+					(const int *)(f + v), idx, 4);
+				w = _mm_add_epi32(_mm_xor_si128(w, xm), cc);
+				cc = _mm_srli_epi32(w, 31);
+				w = _mm_and_si128(w, m31);
+				w = _mm_sub_epi32(w, _mm_and_si128(
+					_mm_slli_epi32(w, 1), neg));
+				x = _mm256_add_pd(x, _mm256_mul_pd(
+					_mm256_cvtepi32_pd(w),
+					_mm256_set1_pd(fsc)));
+			}
+			_mm256_storeu_pd(&d[u].v, x);
+		}
+	}
+#elif FALCON_WASM_SIMD  // yyyWASM+1
+	{
+		v128_t m31, one;
+
+		m31 = wasm_i32x4_splat(0x7FFFFFFF);
+		one = wasm_i32x4_splat(1);
+		for (; u + 4 <= n; u += 4, f += 4 * fstride) {
+			v128_t neg, xm, cc, x0, x1;
+			double fsc;
+			size_t v;
+
+			neg = wasm_i32x4_make(
+				(int32_t)f[flen - 1],
+				(int32_t)f[fstride + flen - 1],
+				(int32_t)f[2 * fstride + flen - 1],
+				(int32_t)f[3 * fstride + flen - 1]);
+			neg = wasm_i32x4_shr(wasm_i32x4_shl(neg, 1), 31);
+			xm = wasm_u32x4_shr(neg, 1);
+			cc = wasm_v128_and(neg, one);
+			x0 = wasm_f64x2_splat(0.0);
+			x1 = wasm_f64x2_splat(0.0);
+			fsc = 1.0;
+			for (v = 0; v < flen; v ++, fsc *= 2147483648.0) {
+				v128_t w, sc;
+
+				w = wasm_i32x4_make(
+					(int32_t)f[v],
+					(int32_t)f[fstride + v],
+					(int32_t)f[2 * fstride + v],
+					(int32_t)f[3 * fstride + v]);
+				w = wasm_i32x4_add(wasm_v128_xor(w, xm), cc);
+				cc = wasm_u32x4_shr(w, 31);
+				w = wasm_v128_and(w, m31);
+				w = wasm_i32x4_sub(w, wasm_v128_and(
+					wasm_i32x4_shl(w, 1), neg));
+				sc = wasm_f64x2_splat(fsc);
+				x0 = wasm_f64x2_add(x0, wasm_f64x2_mul(
+					wasm_f64x2_convert_low_i32x4(w), sc));
+				x1 = wasm_f64x2_add(x1, wasm_f64x2_mul(
+					wasm_f64x2_convert_low_i32x4(
+						wasm_i32x4_shuffle(w, w,
+							2, 3, 0, 1)), sc));
+			}
+			wasm_v128_store(&d[u].v, x0);
+			wasm_v128_store(&d[u + 2].v, x1);
+		}
+	}
+#endif  // yyyAVX2-
+	for (; u < n; u ++, f += fstride) {
 		size_t v;
 		uint32_t neg, cc, xm;
 		fpr x, fsc;
@@ -2065,6 +2352,84 @@ poly_big_to_fp(fpr *d, const uint32_t *f, size_t flen, size_t fstride,
 	}
 }
 
+/*
+ * Compute the Babai reduction coefficients k[u] = rint(x[u]*sc). This
+ * fails (returning 0) if any scaled value is not in the
+ * -(2^31-1)..+(2^31-1) range; on success, 1 is returned.
+ *
+ * Rounding is to nearest, ties to even, as with fpr_rint(). The range
+ * test does not break constant-time discipline, since any failure
+ * implies that the current secret key (f,g) is discarded.
+ */
+TARGET_AVX2
+static int
+poly_fp_to_k(int32_t *k, const fpr *x, fpr sc, unsigned logn)
+{
+	size_t n, u;
+
+	n = MKN(logn);
+	u = 0;
+#if FALCON_AVX2  // yyyAVX2+1
+	{
+		__m256d xsc, xlo, xhi;
+
+		/*
+		 * With the default rounding mode, _mm256_cvtpd_epi32()
+		 * rounds to nearest-even.
+		 */
+		xsc = _mm256_set1_pd(sc.v);
+		xlo = _mm256_set1_pd(fpr_mtwo31m1.v);
+		xhi = _mm256_set1_pd(fpr_ptwo31m1.v);
+		for (; u + 4 <= n; u += 4) {
+			__m256d xv;
+
+			xv = _mm256_mul_pd(_mm256_loadu_pd(&x[u].v), xsc);
+			if (_mm256_movemask_pd(_mm256_and_pd(
+				_mm256_cmp_pd(xlo, xv, _CMP_LT_OQ),
+				_mm256_cmp_pd(xv, xhi, _CMP_LT_OQ))) != 0x0F)
+			{
+				return 0;
+			}
+			_mm_storeu_si128((__m128i *)(k + u),
+				_mm256_cvtpd_epi32(xv));
+		}
+	}
+#elif FALCON_WASM_SIMD  // yyyWASM+1
+	{
+		v128_t xsc, xlo, xhi;
+
+		xsc = wasm_f64x2_splat(sc.v);
+		xlo = wasm_f64x2_splat(fpr_mtwo31m1.v);
+		xhi = wasm_f64x2_splat(fpr_ptwo31m1.v);
+		for (; u + 2 <= n; u += 2) {
+			v128_t xv, xk;
+
+			xv = wasm_f64x2_mul(wasm_v128_load(&x[u].v), xsc);
+			if (!wasm_i64x2_all_true(wasm_v128_and(
+				wasm_f64x2_lt(xlo, xv),
+				wasm_f64x2_lt(xv, xhi))))
+			{
+				return 0;
+			}
+			xk = wasm_i32x4_trunc_sat_f64x2_zero(
+				wasm_f64x2_nearest(xv));
+			k[u] = wasm_i32x4_extract_lane(xk, 0);
+			k[u + 1] = wasm_i32x4_extract_lane(xk, 1);
+		}
+	}
+#endif  // yyyAVX2-
+	for (; u < n; u ++) {
+		fpr xv;
+
+		xv = fpr_mul(x[u], sc);
+		if (!fpr_lt(fpr_mtwo31m1, xv) || !fpr_lt(xv, fpr_ptwo31m1)) {
+			return 0;
+		}
+		k[u] = (int32_t)fpr_rint(xv);
+	}
+	return 1;
+}
+
 /*
  * Convert a polynomial to small integers. Source values are supposed
  * to be one-word integers, signed over 31 bits. Returned value is 0
@@ -2134,6 +2499,54 @@ poly_sub_scaled(uint32_t *restrict F, size_t Flen, size_t Fstride,
 	}
 }
 
+/*
+ * Multiply a[0], a[stride], a[2*stride]... by b[0], b[1], b[2]...
+ * (Montgomery multiplication, then conversion back with R2 = 2^62 mod p),
+ * modulo p; n = 2^logn values are processed.
+ */
+TARGET_AVX2
+static void
+poly_mul_ntt_ext(uint32_t *a, size_t stride, const uint32_t *b,
+	uint32_t R2, uint32_t p, uint32_t p0i, unsigned logn)
+{
+	size_t n, u;
+
+	n = MKN(logn);
+	u = 0;
+#if FALCON_AVX2  // yyyAVX2+1
+	{
+		__m256i xp, xp0i, xR2, idx;
+
+		xp = _mm256_set1_epi32((int)p);
+		xp0i = _mm256_set1_epi32((int)p0i);
+		xR2 = _mm256_set1_epi32((int)R2);
+		idx = _mm256_mullo_epi32(
+			_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+			_mm256_set1_epi32((int)stride));
+		for (; u + 8 <= n; u += 8) {
+			union {
+				uint32_t w[8];
+				__m256i y;
+			} r;
+			size_t j;
+
+			r.y = _mm256_i32gather_epi32(
+				(const int *)(a + u * stride), idx, 4);
+			r.y = modp_montymul_x8(modp_montymul_x8(
+				_mm256_loadu_si256((const __m256i *)(b + u)),
+				r.y, xp, xp0i), xR2, xp, xp0i);
+			for (j = 0; j < 8; j ++) {
+				a[(u + j) * stride] = r.w[j];
+			}
+		}
+	}
+#endif  // yyyAVX2-
+	for (; u < n; u ++) {
+		a[u * stride] = modp_montymul(
+			modp_montymul(b[u], a[u * stride], p, p0i), R2, p, p0i);
+	}
+}
+
 /*
  * Subtract k*f from F. Coefficients of polynomial k are small integers
  * (signed values in the -2^31..2^31 range) scaled by 2^sc. This function
@@ -2177,16 +2590,10 @@ poly_sub_scaled_ntt(uint32_t *restrict F, size_t Flen, size_t Fstride,
 			t1[v] = modp_set(k[v], p);
 		}
 		modp_NTT2(t1, gm, logn, p, p0i);
-		for (v = 0, y = f, x = fk + u;
-			v < n; v ++, y += fstride, x += tlen)
-		{
-			*x = zint_mod_small_signed(y, flen, p, p0i, R2, Rx);
-		}
+		zint_mod_small_signed_multi(fk + u, tlen, f, fstride, n, flen,
+			p, p0i, R2, Rx);
 		modp_NTT2_ext(fk + u, tlen, gm, logn, p, p0i);
-		for (v = 0, x = fk + u; v < n; v ++, x += tlen) {
-			*x = modp_montymul(
-				modp_montymul(t1[v], *x, p, p0i), R2, p, p0i);
-		}
+		poly_mul_ntt_ext(fk + u, tlen, t1, R2, p, p0i, logn);
 		modp_iNTT2_ext(fk + u, tlen, igm, logn, p, p0i);
 	}
 
@@ -2255,6 +2662,44 @@ get_rng_u64(inner_shake256_context *rng)
 
 #endif  // yyyKG_CHACHA20-
 
+/*
+ * Fill w[] with 'num' random 64-bit words, with the same values (and
+ * leaving the RNG in the same state) as 'num' successive calls to
+ * get_rng_u64(). With SHAKE256, this is a single extraction.
+ */
+static void
+get_rng_u64_bulk(RNG_CONTEXT *rng, uint64_t *w, size_t num)
+{
+#if FALCON_KG_CHACHA20  // yyyKG_CHACHA20+1
+	size_t u;
+
+	for (u = 0; u < num; u ++) {
+		w[u] = get_rng_u64(rng);
+	}
+#else  // yyyKG_CHACHA20+0
+	inner_shake256_extract(rng, (uint8_t *)w, num << 3);
+#if !FALCON_LE  // yyyLE+0
+	{
+		size_t u;
+
+		for (u = 0; u < num; u ++) {
+			const uint8_t *b;
+
+			b = (const uint8_t *)&w[u];
+			w[u] = (uint64_t)b[0]
+				| ((uint64_t)b[1] << 8)
+				| ((uint64_t)b[2] << 16)
+				| ((uint64_t)b[3] << 24)
+				| ((uint64_t)b[4] << 32)
+				| ((uint64_t)b[5] << 40)
+				| ((uint64_t)b[6] << 48)
+				| ((uint64_t)b[7] << 56);
+		}
+	}
+#endif  // yyyLE-
+#endif  // yyyKG_CHACHA20-
+}
+
 /*
  * Table below incarnates a discrete Gaussian distribution:
  *    D(x) = exp(-(x^2)/(2*sigma^2))
@@ -2355,6 +2800,156 @@ mkgauss(RNG_CONTEXT *rng, unsigned logn)
 	return val;
 }
 
+/*
+ * Number of random 64-bit words processed at once by mkgauss_bulk().
+ */
+#define MKGAUSS_WORDS   256
+
+/*
+ * Compute 'num' successive mkgauss() outputs from the random words in
+ * w[] (2*2^(10-logn) words per output, in the order mkgauss() reads
+ * them); num*2^(10-logn) must not exceed MKGAUSS_WORDS/2. Results are
+ * identical to those of mkgauss().
+ *
+ * Entry 0 of the table is only compared with the first word of each
+ * pair. Entries 1 and onwards are non-increasing and the last one is
+ * 0, so the elements k >= 1 such that r < gauss_1024_12289[k] form a
+ * prefix of that range, and the index that mkgauss() finds with its
+ * scan is 1 plus their number; this count is evaluated for several
+ * random words in parallel.
+ */
+TARGET_AVX2
+static void
+mkgauss_bulk(int *s, const uint64_t *w, size_t num, unsigned logn)
+{
+	uint32_t pv[MKGAUSS_WORDS / 2];
+	uint64_t m63;
+	size_t np, g, j, u, tlen;
+
+	tlen = (sizeof gauss_1024_12289) / (sizeof gauss_1024_12289[0]);
+	g = (size_t)1 << (10 - logn);
+	np = num * g;
+	m63 = ~((uint64_t)1 << 63);
+	j = 0;
+
+#if FALCON_AVX2  // yyyAVX2+1
+	{
+		__m256i xm, xt0;
+
+		/*
+		 * Four word pairs per iteration; unpacking puts them in
+		 * lane order 0, 2, 1, 3.
+		 */
+		xm = _mm256_set1_epi64x((long long)m63);
+		xt0 = _mm256_set1_epi64x((long long)gauss_1024_12289[0]);
+		for (; j + 4 <= np; j += 4) {
+			__m256i xa, xb, x0, x1, xc, xz;
+			union {
+				uint64_t w[4];
+				__m256i y;
+			} c, z, ng;
+			size_t k;
+
+			xa = _mm256_loadu_si256((const __m256i *)(w + 2 * j));
+			xb = _mm256_loadu_si256(
+				(const __m256i *)(w + 2 * j + 4));
+			x0 = _mm256_unpacklo_epi64(xa, xb);
+			x1 = _mm256_and_si256(_mm256_unpackhi_epi64(xa, xb), xm);
+			xz = _mm256_cmpgt_epi64(xt0, _mm256_and_si256(x0, xm));
+			xc = _mm256_setzero_si256();
+			for (k = 1; k < tlen; k ++) {
+				xc = _mm256_sub_epi64(xc, _mm256_cmpgt_epi64(
+					_mm256_set1_epi64x((long long)
+						gauss_1024_12289[k]), x1));
+			}
+			c.y = xc;
+			z.y = xz;
+			ng.y = _mm256_srli_epi64(x0, 63);
+			for (k = 0; k < 4; k ++) {
+				uint32_t v, neg;
+				size_t d;
+
+				d = j + ((k >> 1) | ((k & 1) << 1));
+				neg = (uint32_t)ng.w[k];
+				v = (1 + (uint32_t)c.w[k]) & ~(uint32_t)z.w[k];
+				pv[d] = (v ^ -neg) + neg;
+			}
+		}
+	}
+#elif FALCON_WASM_SIMD  // yyyWASM+1
+	{
+		v128_t xm, xt0;
+
+		/*
+		 * Two word pairs per iteration.
+		 */
+		xm = wasm_i64x2_splat((int64_t)m63);
+		xt0 = wasm_i64x2_splat((int64_t)gauss_1024_12289[0]);
+		for (; j + 2 <= np; j += 2) {
+			v128_t xa, xb, x0, x1, xc, xz;
+			size_t k;
+
+			xa = wasm_v128_load(w + 2 * j);
+			xb = wasm_v128_load(w + 2 * j + 2);
+			x0 = wasm_i64x2_shuffle(xa, xb, 0, 2);
+			x1 = wasm_v128_and(wasm_i64x2_shuffle(xa, xb, 1, 3), xm);
+			xz = wasm_i64x2_gt(xt0, wasm_v128_and(x0, xm));
+			xc = wasm_i64x2_splat(0);
+			for (k = 1; k < tlen; k ++) {
+				xc = wasm_i64x2_sub(xc, wasm_i64x2_gt(
+					wasm_i64x2_splat((int64_t)
+						gauss_1024_12289[k]), x1));
+			}
+			for (k = 0; k < 2; k ++) {
+				uint32_t v, neg;
+				uint64_t c, z, r0;
+
+				c = (uint64_t)(k == 0
+					? wasm_i64x2_extract_lane(xc, 0)
+					: wasm_i64x2_extract_lane(xc, 1));
+				z = (uint64_t)(k == 0
+					? wasm_i64x2_extract_lane(xz, 0)
+					: wasm_i64x2_extract_lane(xz, 1));
+				r0 = w[2 * (j + k)];
+				neg = (uint32_t)(r0 >> 63);
+				v = (1 + (uint32_t)c) & ~(uint32_t)z;
+				pv[j + k] = (v ^ -neg) + neg;
+			}
+		}
+	}
+#endif  // yyyAVX2-
+
+	for (; j < np; j ++) {
+		uint64_t r0, r1;
+		uint32_t v, z, neg;
+		size_t k;
+
+		r0 = w[2 * j];
+		r1 = w[2 * j + 1] & m63;
+		neg = (uint32_t)(r0 >> 63);
+		z = (uint32_t)(((r0 & m63) - gauss_1024_12289[0]) >> 63);
+		v = 1;
+		for (k = 1; k < tlen; k ++) {
+			v += (uint32_t)((r1 - gauss_1024_12289[k]) >> 63);
+		}
+		v &= z - 1;
+		pv[j] = (v ^ -neg) + neg;
+	}
+
+	/*
+	 * Each output is the sum of g consecutive values.
+	 */
+	for (u = 0; u < num; u ++) {
+		int val;
+
+		val = 0;
+		for (j = 0; j < g; j ++) {
+			val += *(int32_t *)&pv[u * g + j];
+		}
+		s[u] = val;
+	}
+}
+
 /*
  * The MAX_BL_SMALL[] and MAX_BL_LARGE[] contain the lengths, in 31-bit
  * words, of intermediate values in the computation:
@@ -2865,20 +3460,15 @@ solve_NTRU_intermediate(unsigned logn_top,
 	 */
 	for (u = 0; u < llen; u ++) {
 		uint32_t p, p0i, R2, Rx;
-		size_t v;
-		uint32_t *xs, *ys, *xd, *yd;
 
 		p = primes[u].p;
 		p0i = modp_ninv31(p);
 		R2 = modp_R2(p, p0i);
 		Rx = modp_Rx((unsigned)dlen, p, p0i, R2);
-		for (v = 0, xs = Fd, ys = Gd, xd = Ft + u, yd = Gt + u;
-			v < hn;
-			v ++, xs += dlen, ys += dlen, xd += llen, yd += llen)
-		{
-			*xd = zint_mod_small_signed(xs, dlen, p, p0i, R2, Rx);
-			*yd = zint_mod_small_signed(ys, dlen, p, p0i, R2, Rx);
-		}
+		zint_mod_small_signed_multi(Ft + u, llen, Fd, dlen, hn, dlen,
+			p, p0i, R2, Rx);
+		zint_mod_small_signed_multi(Gt + u, llen, Gd, dlen, hn, dlen,
+			p, p0i, R2, Rx);
 	}
 
 	/*
@@ -2929,14 +3519,10 @@ solve_NTRU_intermediate(unsigned logn_top,
 			uint32_t Rx;
 
 			Rx = modp_Rx((unsigned)slen, p, p0i, R2);
-			for (v = 0, x = ft, y = gt;
-				v < n; v ++, x += slen, y += slen)
-			{
-				fx[v] = zint_mod_small_signed(x, slen,
-					p, p0i, R2, Rx);
-				gx[v] = zint_mod_small_signed(y, slen,
-					p, p0i, R2, Rx);
-			}
+			zint_mod_small_signed_multi(fx, 1, ft, slen, n, slen,
+				p, p0i, R2, Rx);
+			zint_mod_small_signed_multi(gx, 1, gt, slen, n, slen,
+				p, p0i, R2, Rx);
 			modp_NTT2(fx, gm, logn, p, p0i);
 			modp_NTT2(gx, gm, logn, p, p0i);
 		}
@@ -3227,26 +3813,13 @@ solve_NTRU_intermediate(unsigned logn_top,
 			pt = fpr_sqr(pt);
 		}
 
-		for (u = 0; u < n; u ++) {
-			fpr xv;
-
-			xv = fpr_mul(rt2[u], pdc);
-
-			/*
-			 * Sometimes the values can be out-of-bounds if
-			 * the algorithm fails; we must not call
-			 * fpr_rint() (and cast to int32_t) if the value
-			 * is not in-bounds. Note that the test does not
-			 * break constant-time discipline, since any
-			 * failure here implies that we discard the current
-			 * secret key (f,g).
-			 */
-			if (!fpr_lt(fpr_mtwo31m1, xv)
-				|| !fpr_lt(xv, fpr_ptwo31m1))
-			{
-				return 0;
-			}
-			k[u] = (int32_t)fpr_rint(xv);
+		/*
+		 * Sometimes the values can be out-of-bounds if the
+		 * algorithm fails; poly_fp_to_k() then reports the
+		 * failure.
+		 */
+		if (!poly_fp_to_k(k, rt2, pdc, logn)) {
+			return 0;
 		}
 
 		/*
@@ -3974,6 +4547,68 @@ solve_NTRU_binary_depth0(unsigned logn,
 	return 1;
 }
 
+#if FALCON_KG_PROFILE  // yyyKG_PROFILE+1
+/*
+ * Processor time spent at each depth of solve_NTRU(), in clock() ticks,
+ * accumulated over all calls. Depths go from 0 to 10 (this matches
+ * FALCON_KG_PROFILE_DEPTHS in falcon.h).
+ */
+#define KG_PROFILE_DEPTHS   11
+static uint64_t kg_profile_ticks[KG_PROFILE_DEPTHS];
+#endif  // yyyKG_PROFILE-
+
+static inline uint64_t
+kg_profile_now(void)
+{
+#if FALCON_KG_PROFILE  // yyyKG_PROFILE+1
+	return (uint64_t)clock();
+#else  // yyyKG_PROFILE+0
+	return 0;
+#endif  // yyyKG_PROFILE-
+}
+
+static inline void
+kg_profile_add(unsigned depth, uint64_t t0)
+{
+#if FALCON_KG_PROFILE  // yyyKG_PROFILE+1
+	kg_profile_ticks[depth] += (uint64_t)clock() - t0;
+#else  // yyyKG_PROFILE+0
+	(void)depth;
+	(void)t0;
+#endif  // yyyKG_PROFILE-
+}
+
+/* see inner.h */
+int
+Zf(keygen_profile)(uint64_t *ns, size_t num, int reset)
+{
+	size_t u;
+
+	for (u = 0; u < num; u ++) {
+#if FALCON_KG_PROFILE  // yyyKG_PROFILE+1
+		uint64_t t;
+
+		if (u < KG_PROFILE_DEPTHS) {
+			t = kg_profile_ticks[u];
+			ns[u] = (t / CLOCKS_PER_SEC) * 1000000000u
+				+ (t % CLOCKS_PER_SEC) * 1000000000u
+				/ CLOCKS_PER_SEC;
+			continue;
+		}
+#endif  // yyyKG_PROFILE-
+		ns[u] = 0;
+	}
+#if FALCON_KG_PROFILE  // yyyKG_PROFILE+1
+	if (reset) {
+		memset(kg_profile_ticks, 0, sizeof kg_profile_ticks);
+	}
+	return 1;
+#else  // yyyKG_PROFILE+0
+	(void)reset;
+	return 0;
+#endif  // yyyKG_PROFILE-
+}
+
 /*
  * Solve the NTRU equation. Returned value is 1 on success, 0 on error.
  * G can be NULL, in which case that value is computed but not returned.
@@ -3988,12 +4623,19 @@ solve_NTRU(unsigned logn, int8_t *F, int8_t *G,
 	uint32_t *ft, *gt, *Ft, *Gt, *gm;
 	uint32_t p, p0i, r;
 	const small_prime *primes;
+	uint64_t t0;
 
 	n = MKN(logn);
 
+	/*
+	 * With FALCON_KG_PROFILE, time spent at each depth is recorded
+	 * (on failure, the time of the failed depth is dropped).
+	 */
+	t0 = kg_profile_now();
 	if (!solve_NTRU_deepest(logn, f, g, tmp)) {
 		return 0;
 	}
+	kg_profile_add(logn, t0);
 
 	/*
 	 * For logn <= 2, we need to use solve_NTRU_intermediate()
@@ -4005,25 +4647,33 @@ solve_NTRU(unsigned logn, int8_t *F, int8_t *G,
 
 		depth = logn;
 		while (depth -- > 0) {
+			t0 = kg_profile_now();
 			if (!solve_NTRU_intermediate(logn, f, g, depth, tmp)) {
 				return 0;
 			}
+			kg_profile_add(depth, t0);
 		}
 	} else {
 		unsigned depth;
 
 		depth = logn;
 		while (depth -- > 2) {
+			t0 = kg_profile_now();
 			if (!solve_NTRU_intermediate(logn, f, g, depth, tmp)) {
 				return 0;
 			}
+			kg_profile_add(depth, t0);
 		}
+		t0 = kg_profile_now();
 		if (!solve_NTRU_binary_depth1(logn, f, g, tmp)) {
 			return 0;
 		}
+		kg_profile_add(1, t0);
+		t0 = kg_profile_now();
 		if (!solve_NTRU_binary_depth0(logn, f, g, tmp)) {
 			return 0;
 		}
+		kg_profile_add(0, t0);
 	}
 
 	/*
@@ -4090,20 +4740,45 @@ solve_NTRU(unsigned logn, int8_t *F, int8_t *G,
 /*
  * Generate a random polynomial with a Gaussian distribution. This function
  * also makes sure that the resultant of the polynomial with phi is odd.
+ *
+ * For degrees 8 and more, random words are drawn by blocks and turned
+ * into Gaussian values with mkgauss_bulk(). A block never holds more
+ * values than the remaining coefficients need (a rejected value is
+ * replaced by the next one), so that the RNG ends up in the same state
+ * as with one mkgauss() call per value.
  */
 static void
 poly_small_mkgauss(RNG_CONTEXT *rng, int8_t *f, unsigned logn)
 {
-	size_t n, u;
+	uint64_t w[MKGAUSS_WORDS];
+	int sv[MKGAUSS_WORDS / 2];
+	size_t n, u, wpv, chunk, sp, sn;
 	unsigned mod2;
 
 	n = MKN(logn);
+	wpv = (size_t)2 << (10 - logn);
+	chunk = MKGAUSS_WORDS / wpv;
+	sp = 0;
+	sn = 0;
 	mod2 = 0;
 	for (u = 0; u < n; u ++) {
 		int s;
 
 	restart:
-		s = mkgauss(rng, logn);
+		if (sp < sn) {
+			s = sv[sp ++];
+		} else if (chunk == 0) {
+			s = mkgauss(rng, logn);
+		} else {
+			sn = n - u;
+			if (sn > chunk) {
+				sn = chunk;
+			}
+			get_rng_u64_bulk(rng, w, sn * wpv);
+			mkgauss_bulk(sv, w, sn, logn);
+			sp = 0;
+			s = sv[sp ++];
+		}
 
 		/*
 		 * We need the coefficient to fit within -127..+127;
@@ -4131,6 +4806,99 @@ poly_small_mkgauss(RNG_CONTEXT *rng, int8_t *f, unsigned logn)
 	}
 }
 
+/*
+ * Check whether a candidate (f,g) may be used for a key pair, before
+ * trying to solve the NTRU equation: all coefficients must be within
+ * the bounds defined in max_fg_bits, the norm of (g,-f) and of the
+ * orthogonalized vector must be small enough, and f must be invertible
+ * modulo phi and q. On success, the public key h = g/f mod phi mod q
+ * is written in h[] and 1 is returned; otherwise, 0 is returned.
+ *
+ * This function does not use any randomness, so that candidates may be
+ * checked in any order (or concurrently) without changing the outcome.
+ * tmp[] must have room for 24*2^logn bytes, with 64-bit alignment, and
+ * MUST NOT overlap with h[].
+ */
+static int
+keygen_prefilter(const int8_t *f, const int8_t *g, uint16_t *h,
+	unsigned logn, uint8_t *tmp)
+{
+	size_t n, u;
+	fpr *rt1, *rt2, *rt3;
+	fpr bnorm;
+	uint32_t normf, normg, norm;
+	int lim;
+
+	n = MKN(logn);
+
+	/*
+	 * Verify that all coefficients are within the bounds
+	 * defined in max_fg_bits. This is the case with
+	 * overwhelming probability; this guarantees that the
+	 * key will be encodable with FALCON_COMP_TRIM.
+	 */
+	lim = 1 << (Zf(max_fg_bits)[logn] - 1);
+	for (u = 0; u < n; u ++) {
+		/*
+		 * We can use non-CT tests since on any failure
+		 * we will discard f and g.
+		 */
+		if (f[u] >= lim || f[u] <= -lim
+			|| g[u] >= lim || g[u] <= -lim)
+		{
+			return 0;
+		}
+	}
+
+	/*
+	 * Bound is 1.17*sqrt(q). We compute the squared
+	 * norms. With q = 12289, the squared bound is:
+	 *   (1.17^2)* 12289 = 16822.4121
+	 * Since f and g are integral, the squared norm
+	 * of (g,-f) is an integer.
+	 */
+	normf = poly_small_sqnorm(f, logn);
+	normg = poly_small_sqnorm(g, logn);
+	norm = (normf + normg) | -((normf | normg) >> 31);
+	if (norm >= 16823) {
+		return 0;
+	}
+
+	/*
+	 * We compute the orthogonalized vector norm.
+	 */
+	rt1 = (fpr *)tmp;
+	rt2 = rt1 + n;
+	rt3 = rt2 + n;
+	poly_small_to_fp(rt1, f, logn);
+	poly_small_to_fp(rt2, g, logn);
+	Zf(FFT)(rt1, logn);
+	Zf(FFT)(rt2, logn);
+	Zf(poly_invnorm2_fft)(rt3, rt1, rt2, logn);
+	Zf(poly_adj_fft)(rt1, logn);
+	Zf(poly_adj_fft)(rt2, logn);
+	Zf(poly_mulconst)(rt1, fpr_q, logn);
+	Zf(poly_mulconst)(rt2, fpr_q, logn);
+	Zf(poly_mul_autoadj_fft)(rt1, rt3, logn);
+	Zf(poly_mul_autoadj_fft)(rt2, rt3, logn);
+	Zf(iFFT)(rt1, logn);
+	Zf(iFFT)(rt2, logn);
+	bnorm = fpr_zero;
+	for (u = 0; u < n; u ++) {
+		bnorm = fpr_add(bnorm, fpr_sqr(rt1[u]));
+		bnorm = fpr_add(bnorm, fpr_sqr(rt2[u]));
+	}
+	if (!fpr_lt(bnorm, fpr_bnorm_max)) {
+		return 0;
+	}
+
+	/*
+	 * Compute public key h = g/f mod X^N+1 mod q. If this
+	 * fails, we must restart.
+	 */
+	return Zf(compute_public)(h, f, g, logn, tmp);
+}
+
 /* see falcon.h */
 void
 Zf(keygen)(inner_shake256_context *rng,
@@ -4156,14 +4924,12 @@ Zf(keygen)(inner_shake256_context *rng,
 	 *    try again. Usual failure condition is when Res(f,phi)
 	 *    and Res(g,phi) are not prime to each other.
 	 */
-	size_t n, u;
-	uint16_t *h2, *tmp2;
+	uint16_t *h2;
 	RNG_CONTEXT *rc;
 #if FALCON_KG_CHACHA20  // yyyKG_CHACHA20+1
 	prng p;
 #endif  // yyyKG_CHACHA20-
 
-	n = MKN(logn);
 #if FALCON_KG_CHACHA20  // yyyKG_CHACHA20+1
 	Zf(prng_init)(&p, rng);
 	rc = &p;
@@ -4191,9 +4957,6 @@ Zf(keygen)(inner_shake256_context *rng,
 	 * NTRU equation solver requires it).
 	 */
 	for (;;) {
-		fpr *rt1, *rt2, *rt3;
-		fpr bnorm;
-		uint32_t normf, normg, norm;
 		int lim;
 
 		/*
@@ -4206,96 +4969,197 @@ Zf(keygen)(inner_shake256_context *rng,
 		poly_small_mkgauss(rc, g, logn);
 
 		/*
-		 * Verify that all coefficients are within the bounds
-		 * defined in max_fg_bits. This is the case with
-		 * overwhelming probability; this guarantees that the
-		 * key will be encodable with FALCON_COMP_TRIM.
+		 * Check the bounds on f and g, and compute the public
+		 * key h = g/f mod X^N+1 mod q. The pre-filter uses the
+		 * first 24*2^logn bytes of tmp[]; if the caller did not
+		 * provide h[], we store it right after that area.
 		 */
-		lim = 1 << (Zf(max_fg_bits)[logn] - 1);
-		for (u = 0; u < n; u ++) {
-			/*
-			 * We can use non-CT tests since on any failure
-			 * we will discard f and g.
-			 */
-			if (f[u] >= lim || f[u] <= -lim
-				|| g[u] >= lim || g[u] <= -lim)
-			{
-				lim = -1;
-				break;
-			}
+		if (h == NULL) {
+			h2 = (uint16_t *)(tmp + (24u << logn));
+		} else {
+			h2 = h;
 		}
-		if (lim < 0) {
+		if (!keygen_prefilter(f, g, h2, logn, tmp)) {
 			continue;
 		}
 
 		/*
-		 * Bound is 1.17*sqrt(q). We compute the squared
-		 * norms. With q = 12289, the squared bound is:
-		 *   (1.17^2)* 12289 = 16822.4121
-		 * Since f and g are integral, the squared norm
-		 * of (g,-f) is an integer.
+		 * Solve the NTRU equation to get F and G.
 		 */
-		normf = poly_small_sqnorm(f, logn);
-		normg = poly_small_sqnorm(g, logn);
-		norm = (normf + normg) | -((normf | normg) >> 31);
-		if (norm >= 16823) {
+		lim = (1 << (Zf(max_FG_bits)[logn] - 1)) - 1;
+		if (!solve_NTRU(logn, F, G, f, g, lim, (uint32_t *)tmp)) {
 			continue;
 		}
 
 		/*
-		 * We compute the orthogonalized vector norm.
+		 * Key pair is generated.
 		 */
-		rt1 = (fpr *)tmp;
-		rt2 = rt1 + n;
-		rt3 = rt2 + n;
-		poly_small_to_fp(rt1, f, logn);
-		poly_small_to_fp(rt2, g, logn);
-		Zf(FFT)(rt1, logn);
-		Zf(FFT)(rt2, logn);
-		Zf(poly_invnorm2_fft)(rt3, rt1, rt2, logn);
-		Zf(poly_adj_fft)(rt1, logn);
-		Zf(poly_adj_fft)(rt2, logn);
-		Zf(poly_mulconst)(rt1, fpr_q, logn);
-		Zf(poly_mulconst)(rt2, fpr_q, logn);
-		Zf(poly_mul_autoadj_fft)(rt1, rt3, logn);
-		Zf(poly_mul_autoadj_fft)(rt2, rt3, logn);
-		Zf(iFFT)(rt1, logn);
-		Zf(iFFT)(rt2, logn);
-		bnorm = fpr_zero;
-		for (u = 0; u < n; u ++) {
-			bnorm = fpr_add(bnorm, fpr_sqr(rt1[u]));
-			bnorm = fpr_add(bnorm, fpr_sqr(rt2[u]));
-		}
-		if (!fpr_lt(bnorm, fpr_bnorm_max)) {
-			continue;
-		}
+		break;
+	}
+}
+
+/*
+ * A (f,g) candidate for Zf(keygen_batch)(), with its pre-filter
+ * scratch area and result.
+ */
+typedef struct {
+	const int8_t *fg;
+	uint16_t *h;
+	uint8_t *tmp;
+	unsigned logn;
+	int ok;
+} keygen_candidate;
+
+static void
+keygen_candidate_check(keygen_candidate *kc)
+{
+	size_t n;
 
+	n = MKN(kc->logn);
+	kc->ok = keygen_prefilter(kc->fg, kc->fg + n,
+		kc->h, kc->logn, kc->tmp);
+}
+
+#if FALCON_KG_THREADS  // yyyKG_THREADS+1
+static void *
+keygen_candidate_thread(void *arg)
+{
+	unsigned oldcw;
+
+	/*
+	 * The FPU control word is per-thread.
+	 */
+	oldcw = set_fpu_cw(2);
+	keygen_candidate_check(arg);
+	set_fpu_cw(oldcw);
+	return NULL;
+}
+#endif  // yyyKG_THREADS-
+
+/* see inner.h */
+void
+Zf(keygen_batch)(inner_shake256_context *rng,
+	int8_t *f, int8_t *g, int8_t *F, int8_t *G, uint16_t *h,
+	unsigned logn, uint8_t *tmp, unsigned batch)
+{
+	keygen_candidate kc[FALCON_KEYGEN_BATCH_MAX];
+	size_t n, u, tlen;
+	int8_t *cfg;
+	uint16_t *ch;
+	RNG_CONTEXT *rc, *rs;
+	uint8_t *atmp;
+#if FALCON_KG_CHACHA20  // yyyKG_CHACHA20+1
+	prng p;
+#endif  // yyyKG_CHACHA20-
+#if FALCON_KG_THREADS  // yyyKG_THREADS+1
+	pthread_t th[FALCON_KEYGEN_BATCH_MAX];
+	int started[FALCON_KEYGEN_BATCH_MAX];
+#endif  // yyyKG_THREADS-
+
+	n = MKN(logn);
+	if (batch < 1) {
+		batch = 1;
+	} else if (batch > FALCON_KEYGEN_BATCH_MAX) {
+		batch = FALCON_KEYGEN_BATCH_MAX;
+	}
+#if FALCON_KG_CHACHA20  // yyyKG_CHACHA20+1
+	Zf(prng_init)(&p, rng);
+	rc = &p;
+#else // yyyKG_CHACHA20+0
+	rc = rng;
+#endif  // yyyKG_CHACHA20-
+
+	/*
+	 * Layout of tmp[]:
+	 *   scratch    max(batch*24*n, FALCON_KEYGEN_TEMP_*) bytes
+	 *   cfg[]      batch*2*n bytes (f and g of each candidate)
+	 *   ch[]       batch*n elements of 16 bits (public keys)
+	 *   rs[]       batch RNG states (aligned)
+	 * Each candidate gets its own 24*n bytes of scratch for the
+	 * pre-filter; the whole scratch area is then reused by
+	 * solve_NTRU(), which needs FALCON_KEYGEN_TEMP_* bytes (at most
+	 * 272 bytes for small degrees).
+	 */
+	tlen = (size_t)batch * (24u << logn);
+	if (tlen < (28u << logn)) {
+		tlen = 28u << logn;
+	}
+	if (tlen < 272) {
+		tlen = 272;
+	}
+	cfg = (int8_t *)(tmp + tlen);
+	ch = (uint16_t *)(cfg + (size_t)batch * (n << 1));
+	atmp = (uint8_t *)(ch + (size_t)batch * n);
+	atmp += (8 - ((uintptr_t)atmp & 7)) & 7;
+	rs = (RNG_CONTEXT *)atmp;
+
+	for (;;) {
 		/*
-		 * Compute public key h = g/f mod X^N+1 mod q. If this
-		 * fails, we must restart.
+		 * Draw all candidates of the group, in the same order as
+		 * Zf(keygen)(), and remember the RNG state after each of
+		 * them.
 		 */
-		if (h == NULL) {
-			h2 = (uint16_t *)tmp;
-			tmp2 = h2 + n;
-		} else {
-			h2 = h;
-			tmp2 = (uint16_t *)tmp;
-		}
-		if (!Zf(compute_public)(h2, f, g, logn, (uint8_t *)tmp2)) {
-			continue;
+		for (u = 0; u < batch; u ++) {
+			int8_t *cf;
+
+			cf = cfg + u * (n << 1);
+			poly_small_mkgauss(rc, cf, logn);
+			poly_small_mkgauss(rc, cf + n, logn);
+			rs[u] = *rc;
+			kc[u].fg = cf;
+			kc[u].h = ch + u * n;
+			kc[u].tmp = tmp + u * (24u << logn);
+			kc[u].logn = logn;
+			kc[u].ok = 0;
 		}
 
 		/*
-		 * Solve the NTRU equation to get F and G.
+		 * Pre-filter all candidates. The check does not use the
+		 * RNG, hence its outcome does not depend on the order in
+		 * which candidates are processed.
 		 */
-		lim = (1 << (Zf(max_FG_bits)[logn] - 1)) - 1;
-		if (!solve_NTRU(logn, F, G, f, g, lim, (uint32_t *)tmp)) {
-			continue;
+#if FALCON_KG_THREADS  // yyyKG_THREADS+1
+		for (u = 1; u < batch; u ++) {
+			started[u] = pthread_create(&th[u], NULL,
+				keygen_candidate_thread, &kc[u]) == 0;
+			if (!started[u]) {
+				keygen_candidate_check(&kc[u]);
+			}
 		}
+		keygen_candidate_check(&kc[0]);
+		for (u = 1; u < batch; u ++) {
+			if (started[u]) {
+				pthread_join(th[u], NULL);
+			}
+		}
+#else // yyyKG_THREADS+0
+		for (u = 0; u < batch; u ++) {
+			keygen_candidate_check(&kc[u]);
+		}
+#endif  // yyyKG_THREADS-
 
 		/*
-		 * Key pair is generated.
+		 * Try the surviving candidates in generation order; the
+		 * first one for which the NTRU equation can be solved is
+		 * the one Zf(keygen)() would have returned.
 		 */
-		break;
+		for (u = 0; u < batch; u ++) {
+			int lim;
+
+			if (!kc[u].ok) {
+				continue;
+			}
+			memcpy(f, kc[u].fg, n);
+			memcpy(g, kc[u].fg + n, n);
+			lim = (1 << (Zf(max_FG_bits)[logn] - 1)) - 1;
+			if (!solve_NTRU(logn, F, G, f, g, lim, (uint32_t *)tmp)) {
+				continue;
+			}
+			if (h != NULL) {
+				memcpy(h, kc[u].h, n * sizeof *h);
+			}
+			*rc = rs[u];
+			return;
+		}
 	}
 }
@@ -0,0 +1,222 @@
+#ifndef FALCON_PERFCTR_H__
+#define FALCON_PERFCTR_H__
+
+/*
+ * Hardware performance counters for the benchmark programs (speed.c,
+ * bench_kernels.c), read with perf_event_open() on Linux.
+ *
+ * Each counter is opened on its own (not as a group), so that events
+ * the CPU or the kernel does not support are simply left out; if the
+ * kernel multiplexes the counters, values are scaled by the fraction
+ * of time each counter actually ran. User-space events only are
+ * counted, which works with the default perf_event_paranoid setting
+ * (2). On other systems, or when perf_event_open() fails (containers,
+ * virtual machines without a PMU), no counter is available and the
+ * benchmarks report times only.
+ *
+ * ==========================(LICENSE BEGIN)============================
+ *
+ * Copyright (c) 2025  Falcon QONE WASM Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ===========================(LICENSE END)=============================
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined __linux__ && !defined __EMSCRIPTEN__
+#define PERFCTR_LINUX   1
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define PERFCTR_LINUX   0
+#endif
+
+/*
+ * Counted events, in output order.
+ */
+#define PERFCTR_CYCLES          0
+#define PERFCTR_INSTRUCTIONS    1
+#define PERFCTR_BRANCH_MISSES   2
+#define PERFCTR_L1D_MISSES      3
+#define PERFCTR_LLC_MISSES      4
+#define PERFCTR_NUM             5
+
+static const char *const perfctr_names[PERFCTR_NUM] = {
+	"cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"
+};
+
+/*
+ * fd[i] is -1 for an event that could not be opened. After
+ * perfctr_stop(), ok[i] tells whether val[i] holds a count.
+ */
+typedef struct {
+	int fd[PERFCTR_NUM];
+	int ok[PERFCTR_NUM];
+	uint64_t val[PERFCTR_NUM];
+} perfctr;
+
+/*
+ * Open the counters (initially stopped). Returned value is the number
+ * of available counters; if it is 0, *err is set to the errno value of
+ * the first failure (0 on systems without perf_event_open()).
+ */
+static int
+perfctr_open(perfctr *pc, int *err)
+{
+	int i, n;
+
+	n = 0;
+	*err = 0;
+	for (i = 0; i < PERFCTR_NUM; i ++) {
+		pc->fd[i] = -1;
+		pc->ok[i] = 0;
+		pc->val[i] = 0;
+	}
+#if PERFCTR_LINUX
+	for (i = 0; i < PERFCTR_NUM; i ++) {
+		struct perf_event_attr pe;
+		long fd;
+
+		memset(&pe, 0, sizeof pe);
+		pe.size = sizeof pe;
+		switch (i) {
+		case PERFCTR_CYCLES:
+			pe.type = PERF_TYPE_HARDWARE;
+			pe.config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case PERFCTR_INSTRUCTIONS:
+			pe.type = PERF_TYPE_HARDWARE;
+			pe.config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case PERFCTR_BRANCH_MISSES:
+			pe.type = PERF_TYPE_HARDWARE;
+			pe.config = PERF_COUNT_HW_BRANCH_MISSES;
+			break;
+		case PERFCTR_L1D_MISSES:
+			pe.type = PERF_TYPE_HW_CACHE;
+			pe.config = PERF_COUNT_HW_CACHE_L1D
+				| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+				| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		default:
+			pe.type = PERF_TYPE_HW_CACHE;
+			pe.config = PERF_COUNT_HW_CACHE_LL
+				| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+				| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		}
+		pe.disabled = 1;
+		pe.exclude_kernel = 1;
+		pe.exclude_hv = 1;
+		pe.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+			| PERF_FORMAT_TOTAL_TIME_RUNNING;
+		fd = syscall(SYS_perf_event_open, &pe, 0, -1, -1, 0);
+		if (fd < 0) {
+			if (*err == 0) {
+				*err = errno;
+			}
+			continue;
+		}
+		pc->fd[i] = (int)fd;
+		n ++;
+	}
+	if (n > 0) {
+		*err = 0;
+	}
+#endif
+	return n;
+}
+
+static void
+perfctr_start(perfctr *pc)
+{
+#if PERFCTR_LINUX
+	int i;
+
+	for (i = 0; i < PERFCTR_NUM; i ++) {
+		if (pc->fd[i] >= 0) {
+			ioctl(pc->fd[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(pc->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#else
+	(void)pc;
+#endif
+}
+
+static void
+perfctr_stop(perfctr *pc)
+{
+	int i;
+
+#if PERFCTR_LINUX
+	for (i = 0; i < PERFCTR_NUM; i ++) {
+		if (pc->fd[i] >= 0) {
+			ioctl(pc->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+#endif
+	for (i = 0; i < PERFCTR_NUM; i ++) {
+		pc->ok[i] = 0;
+		pc->val[i] = 0;
+#if PERFCTR_LINUX
+		if (pc->fd[i] >= 0) {
+			uint64_t r[3];
+
+			/*
+			 * r[0] = count, r[1] = time enabled,
+			 * r[2] = time running.
+			 */
+			if (read(pc->fd[i], r, sizeof r) == (ssize_t)sizeof r
+				&& r[2] != 0)
+			{
+				pc->ok[i] = 1;
+				pc->val[i] = r[2] < r[1]
+					? (uint64_t)((double)r[0]
+						* (double)r[1] / (double)r[2])
+					: r[0];
+			}
+		}
+#endif
+	}
+}
+
+static void
+perfctr_close(perfctr *pc)
+{
+	int i;
+
+	for (i = 0; i < PERFCTR_NUM; i ++) {
+#if PERFCTR_LINUX
+		if (pc->fd[i] >= 0) {
+			close(pc->fd[i]);
+		}
+#endif
+		pc->fd[i] = -1;
+	}
+}
+
+#endif
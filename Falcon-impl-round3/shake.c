@@ -1084,6 +1084,40 @@ Zf(i_shake256_init)(inner_shake256_context *sc)
 	memset(sc->st.A, 0, sizeof sc->st.A);
 }
 
+/*
+ * XOR a full 136-byte input block into the state, as 17 64-bit lanes.
+ * The input need not be aligned.
+ */
+static inline void
+absorb_block(uint64_t *A, const uint8_t *in)
+{
+	size_t u;
+
+	/*
+	 * On systems that use little-endian encoding and allow
+	 * unaligned accesses, we can read the lanes where they are.
+	 */
+#if FALCON_LE && FALCON_UNALIGNED  // yyyLEU+1
+	for (u = 0; u < 17; u ++) {
+		A[u] ^= *(const uint64_t *)(in + (u << 3));
+	}
+#else  // yyyLEU+0
+	for (u = 0; u < 17; u ++) {
+		const uint8_t *b;
+
+		b = in + (u << 3);
+		A[u] ^= (uint64_t)b[0]
+			| ((uint64_t)b[1] << 8)
+			| ((uint64_t)b[2] << 16)
+			| ((uint64_t)b[3] << 24)
+			| ((uint64_t)b[4] << 32)
+			| ((uint64_t)b[5] << 40)
+			| ((uint64_t)b[6] << 48)
+			| ((uint64_t)b[7] << 56);
+	}
+#endif  // yyyLEU-
+}
+
 /* see inner.h */
 void
 Zf(i_shake256_inject)(inner_shake256_context *sc, const uint8_t *in, size_t len)
@@ -1094,6 +1128,20 @@ Zf(i_shake256_inject)(inner_shake256_context *sc, const uint8_t *in, size_t len)
 	while (len > 0) {
 		size_t clen, u;
 
+		/*
+		 * When the state buffer is empty, full blocks are
+		 * absorbed directly from the input, a lane at a time.
+		 */
+		if (dptr == 0 && len >= 136) {
+			do {
+				absorb_block(sc->st.A, in);
+				process_block(sc->st.A);
+				in += 136;
+				len -= 136;
+			} while (len >= 136);
+			continue;
+		}
+
 		clen = 136 - dptr;
 		if (clen > len) {
 			clen = len;
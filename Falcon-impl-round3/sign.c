@@ -1086,6 +1086,205 @@ do_sign_dyn(samplerZ samp, void *samp_ctx, int16_t *s2,
 	return 0;
 }
 
+/*
+ * Set d to the FFT representation of the small polynomial s, negated
+ * if neg is non-zero (for the basis elements b01 = -f and b11 = -F).
+ */
+static void
+smallints_to_fft(fpr *d, const int8_t *s, int neg, unsigned logn)
+{
+	smallints_to_fpr(d, s, logn);
+	Zf(FFT)(d, logn);
+	if (neg) {
+		Zf(poly_neg)(d, logn);
+	}
+}
+
+/*
+ * Compute the Gram matrix of B = [[g, -f], [G, -F]] (FFT representation)
+ * into g00, g01 and g11; t[] is scratch space for one polynomial. Basis
+ * elements are recomputed when needed, so that only four polynomials
+ * are used. Operations on values are the same as in do_sign_dyn().
+ */
+static void
+gram_fft_lowmem(fpr *restrict g00, fpr *restrict g01, fpr *restrict g11,
+	fpr *restrict t,
+	const int8_t *restrict f, const int8_t *restrict g,
+	const int8_t *restrict F, const int8_t *restrict G, unsigned logn)
+{
+	smallints_to_fft(g00, g, 0, logn);    // g00 <- b00
+	smallints_to_fft(t, f, 1, logn);      // t <- b01
+	Zf(poly_mulselfadj_fft)(t, logn);
+	Zf(poly_mulselfadj_fft)(g00, logn);
+	Zf(poly_add)(g00, t, logn);           // g00 <- g00
+
+	smallints_to_fft(g11, g, 0, logn);    // g11 <- b00
+	smallints_to_fft(t, G, 0, logn);      // t <- b10
+	Zf(poly_muladj_fft)(g11, t, logn);    // g11 <- b00*adj(b10)
+	smallints_to_fft(g01, f, 1, logn);    // g01 <- b01
+	smallints_to_fft(t, F, 1, logn);      // t <- b11
+	Zf(poly_muladj_fft)(g01, t, logn);    // g01 <- b01*adj(b11)
+	Zf(poly_add)(g01, g11, logn);         // g01 <- g01
+
+	smallints_to_fft(g11, G, 0, logn);    // g11 <- b10
+	Zf(poly_mulselfadj_fft)(g11, logn);
+	smallints_to_fft(t, F, 1, logn);      // t <- b11
+	Zf(poly_mulselfadj_fft)(t, logn);
+	Zf(poly_add)(g11, t, logn);           // g11 <- g11
+}
+
+/*
+ * Compute one coordinate of the target vector, in FFT representation:
+ * d <- FFT(hm)*(-FFT(b))*sc, with b = f and sc = -1/q for t1, or
+ * b = F and sc = 1/q for t0. t[] is scratch space.
+ */
+static void
+target_fft_lowmem(fpr *restrict d, fpr *restrict t, const uint16_t *hm,
+	const int8_t *b, fpr sc, unsigned logn)
+{
+	size_t n, u;
+
+	n = MKN(logn);
+	for (u = 0; u < n; u ++) {
+		d[u] = fpr_of(hm[u]);
+	}
+	Zf(FFT)(d, logn);
+	smallints_to_fft(t, b, 1, logn);
+	Zf(poly_mul_fft)(d, t, logn);
+	Zf(poly_mulconst)(d, sc, logn);
+}
+
+/*
+ * Same as do_sign_dyn(), but with tmp[] room for 5.5 polynomials
+ * instead of 9. The top level of ffSampling_fft_dyntree() is unrolled
+ * here: the Gram matrix, its LDL decomposition and the target vector
+ * are computed again before each of the two recursive calls instead
+ * of being kept, and basis elements are recomputed one at a time. The
+ * operations on values are the same as in do_sign_dyn(), so the same
+ * signature is obtained for the same random source.
+ */
+static int
+do_sign_dyn_lowmem(samplerZ samp, void *samp_ctx, int16_t *s2,
+	const int8_t *restrict f, const int8_t *restrict g,
+	const int8_t *restrict F, const int8_t *restrict G,
+	const uint16_t *hm, unsigned logn, fpr *restrict tmp)
+{
+	size_t n, hn, u;
+	fpr *w0, *w1, *w2, *w3, *w4;
+	fpr *t0, *t1, *tx, *ty, *bx;
+	fpr ni;
+	uint32_t sqn, ng;
+	int16_t *s1tmp, *s2tmp;
+
+	n = MKN(logn);
+	hn = n >> 1;
+	ni = fpr_inverse_of_q;
+	w0 = tmp;
+	w1 = w0 + n;
+	w2 = w1 + n;
+	w3 = w2 + n;
+	w4 = w3 + n;
+
+	/*
+	 * Right sub-tree. After the LDL decomposition, d11 is split
+	 * and expanded into the half-size Gram matrix (w0, w0+hn, w1),
+	 * and the split t1 is written in (w1+hn, w2). The recursive
+	 * call uses 2*n slots from w2+hn.
+	 */
+	gram_fft_lowmem(w0, w3, w1, w2, f, g, F, G, logn);
+	Zf(poly_LDL_fft)(w0, w3, w1, logn);
+	Zf(poly_split_fft)(w2, w2 + hn, w1, logn);
+	memcpy(w0, w2, n * sizeof *w2);
+	memcpy(w1, w2, hn * sizeof *w2);
+	target_fft_lowmem(w2, w3, hm, f, fpr_neg(ni), logn);
+	Zf(poly_split_fft)(w3, w3 + hn, w2, logn);
+	memmove(w1 + hn, w3, n * sizeof *w3);
+	ffSampling_fft_dyntree(samp, samp_ctx, w1 + hn, w2,
+		w0, w0 + hn, w1, logn, logn - 1, w2 + hn);
+
+	/*
+	 * The merged z1 (final t1) is kept in w0. Recompute d00 (w1),
+	 * l10 (w4) and t1 to get tb0 = t0 + (t1 - z1)*l10 in w2.
+	 */
+	Zf(poly_merge_fft)(w3, w1 + hn, w2, logn);
+	memcpy(w0, w3, n * sizeof *w3);
+	gram_fft_lowmem(w1, w4, w2, w3, f, g, F, G, logn);
+	Zf(poly_LDL_fft)(w1, w4, w2, logn);
+	target_fft_lowmem(w2, w3, hm, f, fpr_neg(ni), logn);
+	Zf(poly_sub)(w2, w0, logn);
+	Zf(poly_mul_fft)(w4, w2, logn);
+	target_fft_lowmem(w2, w3, hm, F, ni, logn);
+	Zf(poly_add)(w2, w4, logn);
+
+	/*
+	 * Left sub-tree: half-size Gram matrix in (w1, w1+hn, w2), split
+	 * tb0 in (w2+hn, w3), recursive call scratch from w3+hn. The
+	 * merged result (final t0) goes to w1.
+	 */
+	Zf(poly_split_fft)(w3, w3 + hn, w1, logn);
+	Zf(poly_split_fft)(w4, w4 + hn, w2, logn);
+	memcpy(w1, w3, n * sizeof *w3);
+	memcpy(w2, w1, hn * sizeof *w1);
+	memmove(w2 + hn, w4, n * sizeof *w4);
+	ffSampling_fft_dyntree(samp, samp_ctx, w2 + hn, w3,
+		w1, w1 + hn, w2, logn, logn - 1, w3 + hn);
+	Zf(poly_merge_fft)(w1, w2 + hn, w3, logn);
+	t0 = w1;
+	t1 = w0;
+
+	/*
+	 * Get the lattice point corresponding to that tiny vector,
+	 * with the basis elements recomputed one at a time in bx.
+	 */
+	tx = w2;
+	ty = w3;
+	bx = w4;
+	memcpy(tx, t0, n * sizeof *t0);
+	memcpy(ty, t1, n * sizeof *t1);
+	smallints_to_fft(bx, g, 0, logn);
+	Zf(poly_mul_fft)(tx, bx, logn);
+	smallints_to_fft(bx, G, 0, logn);
+	Zf(poly_mul_fft)(ty, bx, logn);
+	Zf(poly_add)(tx, ty, logn);
+	memcpy(ty, t0, n * sizeof *t0);
+	smallints_to_fft(bx, f, 1, logn);
+	Zf(poly_mul_fft)(ty, bx, logn);
+
+	memcpy(t0, tx, n * sizeof *tx);
+	smallints_to_fft(bx, F, 1, logn);
+	Zf(poly_mul_fft)(t1, bx, logn);
+	Zf(poly_add)(t1, ty, logn);
+	Zf(iFFT)(t0, logn);
+	Zf(iFFT)(t1, logn);
+
+	s1tmp = (int16_t *)tx;
+	sqn = 0;
+	ng = 0;
+	for (u = 0; u < n; u ++) {
+		int32_t z;
+
+		z = (int32_t)hm[u] - (int32_t)fpr_rint(t0[u]);
+		sqn += (uint32_t)(z * z);
+		ng |= sqn;
+		s1tmp[u] = (int16_t)z;
+	}
+	sqn |= -(ng >> 31);
+
+	/*
+	 * As in do_sign_dyn(), s2[] is written only on success.
+	 */
+	s2tmp = (int16_t *)bx;
+	for (u = 0; u < n; u ++) {
+		s2tmp[u] = (int16_t)-fpr_rint(t1[u]);
+	}
+	if (Zf(is_short_half)(sqn, s2tmp, logn)) {
+		memcpy(s2, s2tmp, n * sizeof *s2);
+		memcpy(tmp, s1tmp, n * sizeof *s1tmp);
+		return 1;
+	}
+	return 0;
+}
+
 /*
  * Sample an integer value along a half-gaussian distribution centered
  * on zero and standard deviation 1.8205, with a precision of 72 bits.
@@ -1526,3 +1725,30 @@ Zf(sign_dyn)(int16_t *sig, inner_shake256_context *rng,
 		}
 	}
 }
+
+/* see inner.h */
+void
+Zf(sign_dyn_lowmem)(int16_t *sig, inner_shake256_context *rng,
+	const int8_t *restrict f, const int8_t *restrict g,
+	const int8_t *restrict F, const int8_t *restrict G,
+	const uint16_t *hm, unsigned logn, uint8_t *tmp)
+{
+	fpr *ftmp;
+
+	ftmp = (fpr *)tmp;
+	for (;;) {
+		sampler_context spc;
+
+		/*
+		 * Same sampler setup as Zf(sign_dyn)(), so that both
+		 * functions consume the same random bytes.
+		 */
+		spc.sigma_min = fpr_sigma_min[logn];
+		Zf(prng_init)(&spc.p, rng);
+		if (do_sign_dyn_lowmem(Zf(sampler), &spc, sig,
+			f, g, F, G, hm, logn, ftmp))
+		{
+			break;
+		}
+	}
+}
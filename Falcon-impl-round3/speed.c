@@ -40,6 +40,11 @@
 
 #include "falcon.h"
 
+/*
+ * Optional hardware counters (-perf); they are not part of the library.
+ */
+#include "perfctr.h"
+
 static void *
 xmalloc(size_t len)
 {
@@ -202,6 +207,26 @@ bench_sign_dyn_ct(void *ctx, unsigned long num)
 	return 0;
 }
 
+/*
+ * Same as bench_sign_dyn(), with a buffer of the minimal size, which
+ * selects the low-memory mode.
+ */
+static int
+bench_sign_dyn_lowmem(void *ctx, unsigned long num)
+{
+	bench_context *bc;
+
+	bc = ctx;
+	while (num -- > 0) {
+		bc->sig_len = FALCON_SIG_COMPRESSED_MAXSIZE(bc->logn);
+		CC(falcon_sign_dyn(&bc->rng,
+			bc->sig, &bc->sig_len, FALCON_SIG_COMPRESSED,
+			bc->sk, FALCON_PRIVKEY_SIZE(bc->logn), "data", 4,
+			bc->tmp, FALCON_TMPSIZE_SIGNDYN_LOWMEM(bc->logn)));
+	}
+	return 0;
+}
+
 static int
 bench_expand_privkey(void *ctx, unsigned long num)
 {
@@ -249,6 +274,56 @@ bench_sign_tree_ct(void *ctx, unsigned long num)
 	return 0;
 }
 
+/*
+ * Latency of a fresh key up to its first signature: key pair generation,
+ * expansion of the private key, and one signature with the expanded key;
+ * either in separate steps, or with falcon_keygen_make_expanded().
+ */
+static int
+bench_keygen_sign(void *ctx, unsigned long num)
+{
+	bench_context *bc;
+
+	bc = ctx;
+	while (num -- > 0) {
+		CC(falcon_keygen_make(&bc->rng, bc->logn,
+			bc->sk, FALCON_PRIVKEY_SIZE(bc->logn),
+			bc->pk, FALCON_PUBKEY_SIZE(bc->logn),
+			bc->tmp, bc->tmp_len));
+		CC(falcon_expand_privkey(
+			bc->esk, FALCON_EXPANDEDKEY_SIZE(bc->logn),
+			bc->sk, FALCON_PRIVKEY_SIZE(bc->logn),
+			bc->tmp, bc->tmp_len));
+		bc->sig_len = FALCON_SIG_COMPRESSED_MAXSIZE(bc->logn);
+		CC(falcon_sign_tree(&bc->rng,
+			bc->sig, &bc->sig_len, FALCON_SIG_COMPRESSED,
+			bc->esk,
+			"data", 4, bc->tmp, bc->tmp_len));
+	}
+	return 0;
+}
+
+static int
+bench_keygen_expanded_sign(void *ctx, unsigned long num)
+{
+	bench_context *bc;
+
+	bc = ctx;
+	while (num -- > 0) {
+		CC(falcon_keygen_make_expanded(&bc->rng, bc->logn,
+			bc->sk, FALCON_PRIVKEY_SIZE(bc->logn),
+			bc->pk, FALCON_PUBKEY_SIZE(bc->logn),
+			bc->esk, FALCON_EXPANDEDKEY_SIZE(bc->logn),
+			bc->tmp, bc->tmp_len));
+		bc->sig_len = FALCON_SIG_COMPRESSED_MAXSIZE(bc->logn);
+		CC(falcon_sign_tree(&bc->rng,
+			bc->sig, &bc->sig_len, FALCON_SIG_COMPRESSED,
+			bc->esk,
+			"data", 4, bc->tmp, bc->tmp_len));
+	}
+	return 0;
+}
+
 static int
 bench_verify(void *ctx, unsigned long num)
 {
@@ -283,17 +358,42 @@ bench_verify_ct(void *ctx, unsigned long num)
 	return 0;
 }
 
+/*
+ * Benchmarked operations, in output order. Keygen (and keygen followed
+ * by a first signature) is reported in milliseconds in text mode; all
+ * values are in microseconds in JSON mode.
+ */
+static const struct {
+	const char *name;
+	bench_fun fun;
+	double text_scale;
+} speed_ops[] = {
+	{ "kg",  &bench_keygen,         1000000.0 },
+	{ "ek",  &bench_expand_privkey,    1000.0 },
+	{ "sd",  &bench_sign_dyn,          1000.0 },
+	{ "sdc", &bench_sign_dyn_ct,       1000.0 },
+	{ "sdl", &bench_sign_dyn_lowmem,   1000.0 },
+	{ "st",  &bench_sign_tree,         1000.0 },
+	{ "stc", &bench_sign_tree_ct,      1000.0 },
+	{ "vv",  &bench_verify,            1000.0 },
+	{ "vvc", &bench_verify_ct,         1000.0 },
+	{ "kgs", &bench_keygen_sign,    1000000.0 },
+	{ "kxs", &bench_keygen_expanded_sign, 1000000.0 }
+};
+
+#define NUM_SPEED_OPS   (sizeof speed_ops / sizeof speed_ops[0])
+
+/*
+ * Allocate the buffers of a benchmark context for degree 2^logn, with
+ * a tmp buffer large enough for all operations.
+ */
 static void
-test_speed_falcon(unsigned logn, double threshold)
+init_bench_context(bench_context *bc, unsigned logn)
 {
-	bench_context bc;
 	size_t len;
 
-	printf("%4u:", 1u << logn);
-	fflush(stdout);
-
-	bc.logn = logn;
-	if (shake256_init_prng_from_system(&bc.rng) != 0) {
+	bc->logn = logn;
+	if (shake256_init_prng_from_system(&bc->rng) != 0) {
 		fprintf(stderr, "random seeding failed\n");
 		exit(EXIT_FAILURE);
 	}
@@ -302,57 +402,364 @@ test_speed_falcon(unsigned logn, double threshold)
 	len = maxsz(len, FALCON_TMPSIZE_SIGNTREE(logn));
 	len = maxsz(len, FALCON_TMPSIZE_EXPANDPRIV(logn));
 	len = maxsz(len, FALCON_TMPSIZE_VERIFY(logn));
-	bc.tmp = xmalloc(len);
-	bc.tmp_len = len;
-	bc.pk = xmalloc(FALCON_PUBKEY_SIZE(logn));
-	bc.sk = xmalloc(FALCON_PRIVKEY_SIZE(logn));
-	bc.esk = xmalloc(FALCON_EXPANDEDKEY_SIZE(logn));
-	bc.sig = xmalloc(FALCON_SIG_COMPRESSED_MAXSIZE(logn));
-	bc.sig_len = 0;
-	bc.sigct = xmalloc(FALCON_SIG_CT_SIZE(logn));
-	bc.sigct_len = 0;
-
-	printf(" %8.2f",
-		do_bench(&bench_keygen, &bc, threshold) / 1000000.0);
-	fflush(stdout);
-	printf(" %8.2f",
-		do_bench(&bench_expand_privkey, &bc, threshold) / 1000.0);
-	fflush(stdout);
-	printf(" %8.2f",
-		do_bench(&bench_sign_dyn, &bc, threshold) / 1000.0);
-	fflush(stdout);
-	printf(" %8.2f",
-		do_bench(&bench_sign_dyn_ct, &bc, threshold) / 1000.0);
-	fflush(stdout);
-	printf(" %8.2f",
-		do_bench(&bench_sign_tree, &bc, threshold) / 1000.0);
-	fflush(stdout);
-	printf(" %8.2f",
-		do_bench(&bench_sign_tree_ct, &bc, threshold) / 1000.0);
-	fflush(stdout);
-	printf(" %8.2f",
-		do_bench(&bench_verify, &bc, threshold) / 1000.0);
+	len = maxsz(len, FALCON_TMPSIZE_KEYGEN_EXPANDED(logn));
+	bc->tmp = xmalloc(len);
+	bc->tmp_len = len;
+	bc->pk = xmalloc(FALCON_PUBKEY_SIZE(logn));
+	bc->sk = xmalloc(FALCON_PRIVKEY_SIZE(logn));
+	bc->esk = xmalloc(FALCON_EXPANDEDKEY_SIZE(logn));
+	bc->sig = xmalloc(FALCON_SIG_COMPRESSED_MAXSIZE(logn));
+	bc->sig_len = 0;
+	bc->sigct = xmalloc(FALCON_SIG_CT_SIZE(logn));
+	bc->sigct_len = 0;
+}
+
+static void
+free_bench_context(bench_context *bc)
+{
+	xfree(bc->tmp);
+	xfree(bc->pk);
+	xfree(bc->sk);
+	xfree(bc->esk);
+	xfree(bc->sig);
+	xfree(bc->sigct);
+}
+
+static void
+test_speed_falcon(unsigned logn, double threshold, int json, int last)
+{
+	bench_context bc;
+	size_t u;
+
+	if (json) {
+		printf("    { \"degree\": %u", 1u << logn);
+	} else {
+		printf("%4u:", 1u << logn);
+	}
 	fflush(stdout);
-	printf(" %8.2f",
-		do_bench(&bench_verify_ct, &bc, threshold) / 1000.0);
+
+	init_bench_context(&bc, logn);
+	for (u = 0; u < NUM_SPEED_OPS; u ++) {
+		double t;
+
+		t = do_bench(speed_ops[u].fun, &bc, threshold);
+		if (json) {
+			printf(", \"%s\": %.3f", speed_ops[u].name, t / 1000.0);
+		} else {
+			printf(" %8.2f", t / speed_ops[u].text_scale);
+		}
+		fflush(stdout);
+	}
+
+	if (json) {
+		printf(" }%s\n", last ? "" : ",");
+	} else {
+		printf("\n");
+	}
 	fflush(stdout);
 
-	printf("\n");
+	free_bench_context(&bc);
+}
+
+/*
+ * Run 'num' iterations of a benchmark function with the hardware
+ * counters enabled. Counts per iteration are written in cnt[], with
+ * -1.0 for counters that are not available.
+ */
+static void
+do_perf(bench_fun bf, void *ctx, unsigned long num,
+	perfctr *pc, double *cnt)
+{
+	int i, r;
+
+	perfctr_start(pc);
+	r = bf(ctx, num);
+	perfctr_stop(pc);
+	for (i = 0; i < PERFCTR_NUM; i ++) {
+		cnt[i] = (r == 0 && pc->ok[i])
+			? (double)pc->val[i] / (double)num : -1.0;
+	}
+	if (r != 0) {
+		fprintf(stderr, "ERR: %d\n", r);
+	}
+}
+
+static void
+print_count(double v, int json, const char *fmt, int width)
+{
+	if (json) {
+		if (v < 0.0) {
+			printf("null");
+		} else {
+			printf(fmt, v);
+		}
+	} else {
+		if (v < 0.0) {
+			printf(" %*s", width, "-");
+		} else {
+			printf(" ");
+			printf(fmt, width, v);
+		}
+	}
+}
+
+/*
+ * Hardware counters per operation: each operation is first timed as
+ * in test_speed_falcon(), then run again for about 'threshold' seconds
+ * with the counters enabled.
+ */
+static void
+test_speed_perf(unsigned logn, double threshold, int json, perfctr *pc,
+	int last)
+{
+	bench_context bc;
+	size_t u;
+
+	init_bench_context(&bc, logn);
+	for (u = 0; u < NUM_SPEED_OPS; u ++) {
+		double t, cnt[PERFCTR_NUM], ipc;
+		unsigned long num;
+
+		t = do_bench(speed_ops[u].fun, &bc, threshold);
+		num = t > 0.0 ? (unsigned long)(threshold * 1e9 / t) : 0;
+		if (num == 0) {
+			num = 1;
+		}
+		do_perf(speed_ops[u].fun, &bc, num, pc, cnt);
+		ipc = (cnt[PERFCTR_CYCLES] > 0.0
+			&& cnt[PERFCTR_INSTRUCTIONS] >= 0.0)
+			? cnt[PERFCTR_INSTRUCTIONS] / cnt[PERFCTR_CYCLES]
+			: -1.0;
+		if (json) {
+			printf("    { \"degree\": %u, \"op\": \"%s\","
+				" \"time\": %.3f, \"cycles\": ",
+				1u << logn, speed_ops[u].name, t / 1000.0);
+			print_count(cnt[PERFCTR_CYCLES], 1, "%.0f", 0);
+			printf(", \"instructions\": ");
+			print_count(cnt[PERFCTR_INSTRUCTIONS], 1, "%.0f", 0);
+			printf(", \"ipc\": ");
+			print_count(ipc, 1, "%.3f", 0);
+			printf(", \"branch_misses\": ");
+			print_count(cnt[PERFCTR_BRANCH_MISSES], 1, "%.1f", 0);
+			printf(", \"l1d_misses\": ");
+			print_count(cnt[PERFCTR_L1D_MISSES], 1, "%.1f", 0);
+			printf(", \"llc_misses\": ");
+			print_count(cnt[PERFCTR_LLC_MISSES], 1, "%.1f", 0);
+			printf(" }%s\n",
+				last && u == NUM_SPEED_OPS - 1 ? "" : ",");
+		} else {
+			printf("%6u  %-4s %10.2f", 1u << logn,
+				speed_ops[u].name, t / 1000.0);
+			print_count(cnt[PERFCTR_CYCLES], 0, "%*.0f", 11);
+			print_count(cnt[PERFCTR_INSTRUCTIONS], 0, "%*.0f", 11);
+			print_count(ipc, 0, "%*.2f", 5);
+			print_count(cnt[PERFCTR_BRANCH_MISSES], 0, "%*.1f", 9);
+			print_count(cnt[PERFCTR_L1D_MISSES], 0, "%*.1f", 9);
+			print_count(cnt[PERFCTR_LLC_MISSES], 0, "%*.1f", 9);
+			printf("\n");
+		}
+		fflush(stdout);
+	}
+	free_bench_context(&bc);
+}
+
+/*
+ * Key pair generation with a count of generated key pairs, so that
+ * per-depth times from falcon_keygen_profile() can be averaged.
+ */
+typedef struct {
+	bench_context bc;
+	unsigned long count;
+} kgdepth_context;
+
+static int
+bench_keygen_counted(void *ctx, unsigned long num)
+{
+	kgdepth_context *kc;
+
+	kc = ctx;
+	kc->count += num;
+	return bench_keygen(&kc->bc, num);
+}
+
+/*
+ * Time per key pair spent at each depth of the NTRU solver (depth d
+ * works at degree 2^(logn-d)), in microseconds. This needs a library
+ * compiled with FALCON_KG_PROFILE.
+ */
+static void
+test_speed_kgdepth(unsigned logn, double threshold, int json, int last)
+{
+	kgdepth_context kc;
+	uint64_t ns[FALCON_KG_PROFILE_DEPTHS];
+	double t, solve;
+	unsigned d;
+
+	kc.bc.logn = logn;
+	if (shake256_init_prng_from_system(&kc.bc.rng) != 0) {
+		fprintf(stderr, "random seeding failed\n");
+		exit(EXIT_FAILURE);
+	}
+	kc.bc.tmp_len = FALCON_TMPSIZE_KEYGEN(logn);
+	kc.bc.tmp = xmalloc(kc.bc.tmp_len);
+	kc.bc.pk = xmalloc(FALCON_PUBKEY_SIZE(logn));
+	kc.bc.sk = xmalloc(FALCON_PRIVKEY_SIZE(logn));
+	kc.count = 0;
+
+	falcon_keygen_profile(ns, FALCON_KG_PROFILE_DEPTHS, 1);
+	t = do_bench(&bench_keygen_counted, &kc, threshold) / 1000.0;
+	falcon_keygen_profile(ns, FALCON_KG_PROFILE_DEPTHS, 1);
+	solve = 0.0;
+	for (d = 0; d <= logn; d ++) {
+		solve += (double)ns[d] / 1000.0 / (double)kc.count;
+	}
+
+	if (json) {
+		printf("    { \"degree\": %u, \"kg\": %.3f,"
+			" \"solve\": %.3f, \"depths\": [",
+			1u << logn, t, solve);
+		for (d = 0; d <= logn; d ++) {
+			printf("%s%.3f", d == 0 ? "" : ", ",
+				(double)ns[d] / 1000.0 / (double)kc.count);
+		}
+		printf("] }%s\n", last ? "" : ",");
+	} else {
+		printf("degree %u: keygen %.1f us, NTRU solver %.1f us\n",
+			1u << logn, t, solve);
+		printf("  depth  degree         us   share\n");
+		for (d = 0; d <= logn; d ++) {
+			double td;
+
+			td = (double)ns[d] / 1000.0 / (double)kc.count;
+			printf("  %5u  %6u %10.1f  %5.1f%%\n",
+				d, 1u << (logn - d), td, 100.0 * td / t);
+		}
+		printf("\n");
+	}
 	fflush(stdout);
 
-	xfree(bc.tmp);
-	xfree(bc.pk);
-	xfree(bc.sk);
-	xfree(bc.esk);
-	xfree(bc.sig);
-	xfree(bc.sigct);
+	xfree(kc.bc.tmp);
+	xfree(kc.bc.pk);
+	xfree(kc.bc.sk);
+}
+
+/*
+ * SHAKE256 throughput: absorb 'len' bytes from 'data', then extract
+ * a 32-byte output.
+ */
+typedef struct {
+	const uint8_t *data;
+	size_t len;
+} shake_context;
+
+static int
+bench_shake256(void *ctx, unsigned long num)
+{
+	shake_context *sc;
+	shake256_context hc;
+	uint8_t out[32];
+
+	sc = ctx;
+	while (num -- > 0) {
+		shake256_init(&hc);
+		shake256_inject(&hc, sc->data, sc->len);
+		shake256_flip(&hc);
+		shake256_extract(&hc, out, sizeof out);
+	}
+	return 0;
+}
+
+/*
+ * Input sizes for the SHAKE256 benchmark: 64 bytes to 64 MB, by
+ * factors of 16. Each size is measured with a 64-bit aligned input,
+ * and with an input at an odd address.
+ */
+#define SHAKE_SIZES   6
+
+static void
+test_speed_shake(double threshold, int json)
+{
+	uint8_t *buf;
+	size_t maxlen, u;
+
+	maxlen = (size_t)64 << (4 * (SHAKE_SIZES - 1));
+	buf = xmalloc(maxlen + 8);
+	for (u = 0; u < maxlen + 8; u ++) {
+		buf[u] = (uint8_t)(u * 31 + 17);
+	}
+	for (u = 0; u < SHAKE_SIZES; u ++) {
+		shake_context sc;
+		double ta, tu;
+
+		sc.len = (size_t)64 << (4 * u);
+		sc.data = buf;
+		ta = do_bench(&bench_shake256, &sc, threshold);
+		sc.data = buf + 1;
+		tu = do_bench(&bench_shake256, &sc, threshold);
+
+		/*
+		 * Times are in nanoseconds; bytes per nanosecond is
+		 * thousands of megabytes per second.
+		 */
+		ta = ta > 0.0 ? (double)sc.len * 1000.0 / ta : 0.0;
+		tu = tu > 0.0 ? (double)sc.len * 1000.0 / tu : 0.0;
+		if (json) {
+			printf("    { \"size\": %lu, \"aligned\": %.2f,"
+				" \"unaligned\": %.2f }%s\n",
+				(unsigned long)sc.len, ta, tu,
+				u == SHAKE_SIZES - 1 ? "" : ",");
+		} else {
+			printf("%9lu %10.2f %10.2f\n",
+				(unsigned long)sc.len, ta, tu);
+		}
+		fflush(stdout);
+	}
+	xfree(buf);
+}
+
+/*
+ * Name of the platform the benchmark was compiled for, so that JSON
+ * outputs from native and WebAssembly builds can be told apart.
+ */
+static const char *
+platform_name(void)
+{
+#if defined __EMSCRIPTEN__
+	return "wasm";
+#elif defined __x86_64__ || defined _M_X64
+	return "native-x86_64";
+#elif defined __aarch64__
+	return "native-aarch64";
+#else
+	return "native";
+#endif
 }
 
 int
 main(int argc, char *argv[])
 {
 	double threshold;
-
+	int json, shake, kgdepth, perf;
+
+	json = 0;
+	shake = 0;
+	kgdepth = 0;
+	perf = 0;
+	while (argc >= 2) {
+		if (strcmp(argv[1], "-json") == 0) {
+			json = 1;
+		} else if (strcmp(argv[1], "-shake") == 0) {
+			shake = 1;
+		} else if (strcmp(argv[1], "-kgdepth") == 0) {
+			kgdepth = 1;
+		} else if (strcmp(argv[1], "-perf") == 0) {
+			perf = 1;
+		} else {
+			break;
+		}
+		argc --;
+		argv ++;
+	}
 	if (argc < 2) {
 		threshold = 2.0;
 	} else if (argc == 2) {
@@ -362,21 +769,145 @@ main(int argc, char *argv[])
 	}
 	if (threshold <= 0.0 || threshold > 60.0) {
 		fprintf(stderr,
-"usage: speed [ threshold ]\n"
+"usage: speed [ -json ] [ -shake | -kgdepth | -perf ] [ threshold ]\n"
 "'threshold' is the minimum time for a bench run, in seconds (must be\n"
-"positive and less than 60).\n");
+"positive and less than 60).\n"
+"'-json' prints results as JSON (all times in microseconds).\n"
+"'-shake' measures SHAKE256 throughput (MB/s) instead, for inputs of\n"
+"64 bytes to 64 MB.\n"
+"'-kgdepth' splits key pair generation time over the NTRU solver\n"
+"depths (needs a build with FALCON_KG_PROFILE).\n"
+"'-perf' reads hardware counters per operation (Linux\n"
+"perf_event_open(); times only when counters are not available).\n");
 		exit(EXIT_FAILURE);
 	}
+	if (kgdepth) {
+		uint64_t ns[FALCON_KG_PROFILE_DEPTHS];
+
+		if (!falcon_keygen_profile(ns, FALCON_KG_PROFILE_DEPTHS, 1)) {
+			fprintf(stderr, "keygen profiling is not compiled in"
+				" (build with -DFALCON_KG_PROFILE=1)\n");
+			exit(EXIT_FAILURE);
+		}
+		if (json) {
+			printf("{\n");
+			printf("  \"platform\": \"%s\",\n", platform_name());
+			printf("  \"threshold\": %.4f,\n", threshold);
+			printf("  \"unit\": \"us\",\n");
+			printf("  \"kgdepth\": [\n");
+			fflush(stdout);
+			test_speed_kgdepth(9, threshold, 1, 0);
+			test_speed_kgdepth(10, threshold, 1, 1);
+			printf("  ]\n");
+			printf("}\n");
+			return 0;
+		}
+		printf("time threshold = %.4f s\n", threshold);
+		printf("key pair generation time per NTRU solver depth\n");
+		printf("(depth 0 is the full degree)\n");
+		printf("\n");
+		fflush(stdout);
+		test_speed_kgdepth(9, threshold, 0, 0);
+		test_speed_kgdepth(10, threshold, 0, 1);
+		return 0;
+	}
+	if (perf) {
+		perfctr pc;
+		int n, err, i, first;
+
+		n = perfctr_open(&pc, &err);
+		if (n == 0) {
+			fprintf(stderr, "hardware counters are not available");
+			if (err != 0) {
+				fprintf(stderr, " (perf_event_open: %s)",
+					strerror(err));
+			}
+			fprintf(stderr, "; reporting times only\n");
+		}
+		if (json) {
+			printf("{\n");
+			printf("  \"platform\": \"%s\",\n", platform_name());
+			printf("  \"threshold\": %.4f,\n", threshold);
+			printf("  \"unit\": \"us\",\n");
+			printf("  \"counters\": [");
+			first = 1;
+			for (i = 0; i < PERFCTR_NUM; i ++) {
+				if (pc.fd[i] >= 0) {
+					printf("%s\"%s\"", first ? "" : ", ",
+						perfctr_names[i]);
+					first = 0;
+				}
+			}
+			printf("],\n");
+			printf("  \"perf\": [\n");
+			fflush(stdout);
+			test_speed_perf(9, threshold, 1, &pc, 0);
+			test_speed_perf(10, threshold, 1, &pc, 1);
+			printf("  ]\n");
+			printf("}\n");
+			perfctr_close(&pc);
+			return 0;
+		}
+		printf("time threshold = %.4f s\n", threshold);
+		printf("hardware counters per operation (user space);"
+			" '-' = not available\n");
+		printf("op names as in the default mode; time in microseconds\n");
+		printf("\n");
+		printf("degree  op         time      cycles"
+			"       instr   IPC   br-miss  L1D-miss  LLC-miss\n");
+		fflush(stdout);
+		test_speed_perf(9, threshold, 0, &pc, 0);
+		test_speed_perf(10, threshold, 0, &pc, 1);
+		perfctr_close(&pc);
+		return 0;
+	}
+	if (shake) {
+		if (json) {
+			printf("{\n");
+			printf("  \"platform\": \"%s\",\n", platform_name());
+			printf("  \"threshold\": %.4f,\n", threshold);
+			printf("  \"unit\": \"MB/s\",\n");
+			printf("  \"shake256\": [\n");
+			fflush(stdout);
+			test_speed_shake(threshold, 1);
+			printf("  ]\n");
+			printf("}\n");
+			return 0;
+		}
+		printf("time threshold = %.4f s\n", threshold);
+		printf("SHAKE256 absorb + 32-byte output, in MB/s\n");
+		printf("\n");
+		printf("     size    aligned  unaligned\n");
+		fflush(stdout);
+		test_speed_shake(threshold, 0);
+		return 0;
+	}
+	if (json) {
+		printf("{\n");
+		printf("  \"platform\": \"%s\",\n", platform_name());
+		printf("  \"threshold\": %.4f,\n", threshold);
+		printf("  \"unit\": \"us\",\n");
+		printf("  \"results\": [\n");
+		fflush(stdout);
+		test_speed_falcon(8, threshold, 1, 0);
+		test_speed_falcon(9, threshold, 1, 0);
+		test_speed_falcon(10, threshold, 1, 1);
+		printf("  ]\n");
+		printf("}\n");
+		return 0;
+	}
 	printf("time threshold = %.4f s\n", threshold);
 	printf("kg = keygen, ek = expand private key, sd = sign (without expanded key)\n");
 	printf("st = sign (with expanded key), vv = verify\n");
 	printf("sdc, stc, vvc: like sd, st and vv, but with constant-time hash-to-point\n");
-	printf("keygen in milliseconds, other values in microseconds\n");
+	printf("sdl = sd in low-memory mode (minimal tmp buffer)\n");
+	printf("kgs = keygen + expand + first signature, kxs = same with keygen_make_expanded\n");
+	printf("kg, kgs and kxs in milliseconds, other values in microseconds\n");
 	printf("\n");
-	printf("degree  kg(ms)   ek(us)   sd(us)  sdc(us)   st(us)  stc(us)   vv(us)  vvc(us)\n");
+	printf("degree  kg(ms)   ek(us)   sd(us)  sdc(us)  sdl(us)   st(us)  stc(us)   vv(us)  vvc(us)  kgs(ms)  kxs(ms)\n");
 	fflush(stdout);
-	test_speed_falcon(8, threshold);
-	test_speed_falcon(9, threshold);
-	test_speed_falcon(10, threshold);
+	test_speed_falcon(8, threshold, 0, 0);
+	test_speed_falcon(9, threshold, 0, 0);
+	test_speed_falcon(10, threshold, 0, 1);
 	return 0;
 }
@@ -184,6 +184,46 @@ test_SHAKE256_KAT(const char *hexsrc, const char *hexout,
 	check_eq(ref, out, olen, "SHAKE KAT 2");
 }
 
+/*
+ * Check that absorbing a long input in one call (full blocks XORed a
+ * lane at a time, possibly from unaligned addresses) gives the same
+ * output as absorbing it one byte at a time, for various split points.
+ */
+static void
+test_SHAKE256_bulk(void)
+{
+	uint8_t *buf, ref[64], out[64];
+	size_t blen, off, cut;
+	inner_shake256_context sc;
+
+	blen = 8 + 5 * 136 + 7;
+	buf = xmalloc(blen);
+	for (off = 0; off < blen; off ++) {
+		buf[off] = (uint8_t)(off * 7 + 3);
+	}
+	for (off = 0; off < 8; off ++) {
+		size_t ilen, u;
+
+		ilen = blen - 8;
+		inner_shake256_init(&sc);
+		for (u = 0; u < ilen; u ++) {
+			inner_shake256_inject(&sc, buf + off + u, 1);
+		}
+		inner_shake256_flip(&sc);
+		inner_shake256_extract(&sc, ref, sizeof ref);
+
+		for (cut = 0; cut <= ilen; cut += 67) {
+			inner_shake256_init(&sc);
+			inner_shake256_inject(&sc, buf + off, cut);
+			inner_shake256_inject(&sc, buf + off + cut, ilen - cut);
+			inner_shake256_flip(&sc);
+			inner_shake256_extract(&sc, out, sizeof out);
+			check_eq(ref, out, sizeof out, "SHAKE bulk absorb");
+		}
+	}
+	xfree(buf);
+}
+
 static void
 test_SHAKE256(void)
 {
@@ -198,6 +238,7 @@ test_SHAKE256(void)
 	test_SHAKE256_KAT("dc5a100fa16df1583c79722a0d72833d3bf22c109b8889dbd35213c6bfce205813edae3242695cfd9f59b9a1c203c1b72ef1a5423147cb990b5316a85266675894e2644c3f9578cebe451a09e58c53788fe77a9e850943f8a275f830354b0593a762bac55e984db3e0661eca3cb83f67a6fb348e6177f7dee2df40c4322602f094953905681be3954fe44c4c902c8f6bba565a788b38f13411ba76ce0f9f6756a2a2687424c5435a51e62df7a8934b6e141f74c6ccf539e3782d22b5955d3baf1ab2cf7b5c3f74ec2f9447344e937957fd7f0bdfec56d5d25f61cde18c0986e244ecf780d6307e313117256948d4230ebb9ea62bb302cfe80d7dfebabc4a51d7687967ed5b416a139e974c005fff507a96", "2bac5716803a9cda8f9e84365ab0a681327b5ba34fdedfb1c12e6e807f45284b", tmp, tlen);
 	test_SHAKE256_KAT("8d8001e2c096f1b88e7c9224a086efd4797fbf74a8033a2d422a2b6b8f6747e4", "2e975f6a8a14f0704d51b13667d8195c219f71e6345696c49fa4b9d08e9225d3d39393425152c97e71dd24601c11abcfa0f12f53c680bd3ae757b8134a9c10d429615869217fdd5885c4db174985703a6d6de94a667eac3023443a8337ae1bc601b76d7d38ec3c34463105f0d3949d78e562a039e4469548b609395de5a4fd43c46ca9fd6ee29ada5efc07d84d553249450dab4a49c483ded250c9338f85cd937ae66bb436f3b4026e859fda1ca571432f3bfc09e7c03ca4d183b741111ca0483d0edabc03feb23b17ee48e844ba2408d9dcfd0139d2e8c7310125aee801c61ab7900d1efc47c078281766f361c5e6111346235e1dc38325666c", tmp, tlen);
 	xfree(tmp);
+	test_SHAKE256_bulk();
 	printf("done.\n");
 	fflush(stdout);
 }
@@ -1969,6 +2010,32 @@ static const char *const KAT_SIG_1024[] = {
 	NULL
 };
 
+static void
+check_modq(const int16_t *s, const uint16_t *x, uint32_t sqn, size_t n,
+	const char *banner)
+{
+	size_t u;
+	uint32_t ref;
+
+	ref = 0;
+	for (u = 0; u < n; u ++) {
+		int32_t z;
+
+		z = s[u];
+		ref += (uint32_t)(z * z);
+		if (x[u] != (uint16_t)(z < 0 ? z + 12289 : z)) {
+			fprintf(stderr, "%s: wrong value at %zu: %d / %u\n",
+				banner, u, (int)z, (unsigned)x[u]);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (sqn != ref) {
+		fprintf(stderr, "%s: wrong norm: %lu / %lu\n", banner,
+			(unsigned long)sqn, (unsigned long)ref);
+		exit(EXIT_FAILURE);
+	}
+}
+
 static void
 test_codec_inner(unsigned logn, uint8_t *tmp, size_t tlen)
 {
@@ -1990,6 +2057,7 @@ test_codec_inner(unsigned logn, uint8_t *tmp, size_t tlen)
 		int8_t *b1, *b2;
 		uint8_t *ee;
 		unsigned bits;
+		uint32_t sqn;
 
 		m1 = (uint16_t *)tmp;
 		m2 = m1 + n;
@@ -2063,6 +2131,15 @@ test_codec_inner(unsigned logn, uint8_t *tmp, size_t tlen)
 			}
 			check_eq(s1, s2, n * sizeof *s2,
 				"trim_i16 encode/decode");
+			len2 = Zf(trim_i16_decode_modq)((uint16_t *)s2, &sqn,
+				logn, bits, ee, len1);
+			if (len2 != len1) {
+				fprintf(stderr,
+					"ERR trim_i16 decode_modq: %zu\n", len2);
+				exit(EXIT_FAILURE);
+			}
+			check_modq(s1, (uint16_t *)s2, sqn, n,
+				"trim_i16 decode_modq");
 
 			memset(s2, 0, n * sizeof *s2);
 			len1 = Zf(comp_encode)(ee, maxlen, s1, logn);
@@ -2079,6 +2156,15 @@ test_codec_inner(unsigned logn, uint8_t *tmp, size_t tlen)
 			}
 			check_eq(s1, s2, n * sizeof *s2,
 				"comp encode/decode");
+			len2 = Zf(comp_decode_modq)((uint16_t *)s2, &sqn,
+				logn, ee, len1);
+			if (len2 != len1) {
+				fprintf(stderr,
+					"ERR comp decode_modq: %zu\n", len2);
+				exit(EXIT_FAILURE);
+			}
+			check_modq(s1, (uint16_t *)s2, sqn, n,
+				"comp decode_modq");
 		}
 
 		b1 = (int8_t *)tmp;
@@ -2152,7 +2238,7 @@ test_vrfy_inner(unsigned logn, const int8_t *f, const int8_t *g,
 	const int8_t *F, const int8_t *G, const uint16_t *h,
 	const char *hexpkey, const char *const *kat, uint8_t *tmp, size_t tlen)
 {
-	size_t u, n, len1, len2;
+	size_t u, v, n, len1, len2;
 	int8_t *G2;
 	uint16_t *h2;
 
@@ -2281,6 +2367,40 @@ test_vrfy_inner(unsigned logn, const int8_t *f, const int8_t *g,
 			exit(EXIT_FAILURE);
 		}
 
+		/*
+		 * The fused path (signature already reduced modulo q,
+		 * with its norm) must reach the same decision, also on a
+		 * tampered hashed message.
+		 */
+		for (v = 0; v < 2; v ++) {
+			uint16_t *t2;
+			uint32_t sqn;
+			size_t w;
+
+			t2 = c0 + n;
+			sqn = 0;
+			for (w = 0; w < n; w ++) {
+				int32_t z;
+
+				z = s2[w];
+				sqn += (uint32_t)(z * z);
+				t2[w] = (uint16_t)(z < 0 ? z + 12289 : z);
+			}
+			if (v == 1) {
+				for (w = 0; w < n; w ++) {
+					c0[w] = (uint16_t)((c0[w] + 6144) % 12289);
+				}
+			}
+			if (Zf(verify_raw_modq)(c0, t2, sqn, h2, logn)
+				!= (v == 0)
+				|| Zf(verify_raw)(c0, s2, h2, logn,
+				(uint8_t *)(c0 + n)) != (v == 0))
+			{
+				fprintf(stderr, "KAT fused verify mismatch\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+
 		printf(".");
 		fflush(stdout);
 	}
@@ -2312,6 +2432,150 @@ test_vrfy(void)
 	fflush(stdout);
 }
 
+/*
+ * Check the Z_q[X]/(X^n+1) arithmetic functions against schoolbook
+ * multiplication and plain reductions, for all degrees.
+ */
+static void
+test_mq_poly_inner(unsigned logn, inner_shake256_context *rng, uint8_t *tmp)
+{
+	size_t n, u, v;
+	uint16_t *f, *g, *r, *h;
+	uint32_t *acc;
+	uint64_t sn;
+
+	n = (size_t)1 << logn;
+	f = (uint16_t *)tmp;
+	g = f + n;
+	r = g + n;
+	h = r + n;
+	acc = (uint32_t *)(h + n);
+	for (u = 0; u < n; u ++) {
+		uint8_t b[4];
+
+		inner_shake256_extract(rng, b, sizeof b);
+		f[u] = (uint16_t)(((unsigned)b[0] | ((unsigned)b[1] << 8)) % 12289);
+		g[u] = (uint16_t)(((unsigned)b[2] | ((unsigned)b[3] << 8)) % 12289);
+	}
+	if (logn == 1) {
+		/*
+		 * Extreme values.
+		 */
+		f[0] = 12288;
+		g[0] = 12288;
+	}
+
+	/*
+	 * Schoolbook product mod X^n+1: coefficient k accumulates
+	 * f[i]*g[j] for i+j = k, and q^2 - f[i]*g[j] for i+j = n+k.
+	 */
+	for (u = 0; u < n; u ++) {
+		acc[u] = 0;
+	}
+	for (u = 0; u < n; u ++) {
+		for (v = 0; v < n; v ++) {
+			uint32_t z;
+
+			z = ((uint32_t)f[u] * (uint32_t)g[v]) % 12289;
+			if (u + v < n) {
+				acc[u + v] = (acc[u + v] + z) % 12289;
+			} else {
+				acc[u + v - n] = (acc[u + v - n] + 12289 - z) % 12289;
+			}
+		}
+	}
+
+	memcpy(r, f, n * sizeof *f);
+	Zf(mq_poly_mul)(r, g, logn, (uint8_t *)(acc + n));
+	for (u = 0; u < n; u ++) {
+		if (r[u] != acc[u]) {
+			fprintf(stderr, "mq_poly_mul (logn=%u, u=%lu): %u / %u\n",
+				logn, (unsigned long)u,
+				(unsigned)r[u], (unsigned)acc[u]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/*
+	 * Same product through the NTT functions, and with a public
+	 * key in NTT + Montgomery format.
+	 */
+	memcpy(r, f, n * sizeof *f);
+	memcpy(h, g, n * sizeof *g);
+	Zf(mq_poly_ntt)(r, logn);
+	Zf(mq_poly_ntt)(h, logn);
+	Zf(mq_poly_mul_ntt)(r, h, logn);
+	Zf(mq_poly_intt)(r, logn);
+	for (u = 0; u < n; u ++) {
+		if (r[u] != acc[u]) {
+			fprintf(stderr, "mq_poly_mul_ntt (logn=%u)\n", logn);
+			exit(EXIT_FAILURE);
+		}
+	}
+	memcpy(r, f, n * sizeof *f);
+	memcpy(h, g, n * sizeof *g);
+	Zf(to_ntt_monty)(h, logn);
+	Zf(mq_poly_mul_public)(r, h, logn);
+	for (u = 0; u < n; u ++) {
+		if (r[u] != acc[u]) {
+			fprintf(stderr, "mq_poly_mul_public (logn=%u)\n", logn);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/*
+	 * NTT round trip, add, sub and norm.
+	 */
+	memcpy(r, f, n * sizeof *f);
+	Zf(mq_poly_ntt)(r, logn);
+	Zf(mq_poly_intt)(r, logn);
+	check_eq(r, f, n * sizeof *f, "mq_poly_ntt/intt");
+	memcpy(r, f, n * sizeof *f);
+	Zf(mq_poly_add)(r, g, logn);
+	for (u = 0; u < n; u ++) {
+		if (r[u] != ((uint32_t)f[u] + g[u]) % 12289) {
+			fprintf(stderr, "mq_poly_add (logn=%u)\n", logn);
+			exit(EXIT_FAILURE);
+		}
+	}
+	Zf(mq_poly_sub)(r, g, logn);
+	check_eq(r, f, n * sizeof *f, "mq_poly_sub");
+	sn = 0;
+	for (u = 0; u < n; u ++) {
+		int64_t z;
+
+		z = f[u] > 6144 ? (int64_t)f[u] - 12289 : (int64_t)f[u];
+		sn += (uint64_t)(z * z);
+	}
+	if (Zf(mq_poly_sqnorm)(f, logn) != sn) {
+		fprintf(stderr, "mq_poly_sqnorm (logn=%u)\n", logn);
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void
+test_mq_poly(void)
+{
+	inner_shake256_context rng;
+	uint8_t *tmp;
+	unsigned logn;
+
+	printf("Test mq_poly: ");
+	fflush(stdout);
+	tmp = xmalloc(14 << 10);
+	inner_shake256_init(&rng);
+	inner_shake256_inject(&rng, (const uint8_t *)"mq_poly", 7);
+	inner_shake256_flip(&rng);
+	for (logn = 1; logn <= 10; logn ++) {
+		test_mq_poly_inner(logn, &rng, tmp);
+		printf(".");
+		fflush(stdout);
+	}
+	xfree(tmp);
+	printf(" done.\n");
+	fflush(stdout);
+}
+
 static const uint64_t KAT_RNG_1[] = {
 	0xDB1F30843AAD694Cu, 0xFAD9C14E86D5B53Cu, 0x7F84F914F46C439Fu,
 	0xC46A6E399A376C6Du, 0x47A5CD6F8C6B1789u, 0x1E85D879707DA987u,
@@ -3810,115 +4074,1053 @@ test_keygen(void)
 }
 
 static void
-test_external_API_inner(unsigned logn, shake256_context *rng)
+test_keygen_batch_inner(unsigned logn)
 {
-	int i;
-	void *pubkey, *pubkey2, *privkey, *sig, *sigpad, *sigct, *expkey;
-	size_t pubkey_len, privkey_len, sig_len, sigpad_len, sigct_len;
-	size_t expkey_len;
-	uint8_t *tmpkg, *tmpmp, *tmpsd, *tmpst, *tmpvv, *tmpek;
-	size_t tmpkg_len, tmpmp_len, tmpsd_len, tmpst_len, tmpvv_len, tmpek_len;
+	static const unsigned batches[] = { 1, 2, 3, 5, 8, 16 };
+	size_t n, u, tlen;
+	int8_t *f, *g, *F, *G, *f2, *g2, *F2, *G2;
+	uint16_t *h, *h2;
+	uint8_t *tmp, *tt;
+	uint8_t out[32], out2[32];
+	uint8_t privkey[FALCON_PRIVKEY_SIZE(10)];
+	uint8_t privkey2[FALCON_PRIVKEY_SIZE(10)];
+	uint8_t pubkey[FALCON_PUBKEY_SIZE(10)];
+	uint8_t pubkey2[FALCON_PUBKEY_SIZE(10)];
+	inner_shake256_context rng, rng2;
+	shake256_context sc, sc2;
+	char buf[20];
+	int r;
 
 	printf("[%u]", logn);
 	fflush(stdout);
 
-	pubkey_len = FALCON_PUBKEY_SIZE(logn);
-	privkey_len = FALCON_PRIVKEY_SIZE(logn);
-	sig_len = FALCON_SIG_COMPRESSED_MAXSIZE(logn);
-	sigpad_len = FALCON_SIG_PADDED_SIZE(logn);
-	sigct_len = FALCON_SIG_CT_SIZE(logn);
-	expkey_len = FALCON_EXPANDEDKEY_SIZE(logn);
+	n = (size_t)1 << logn;
+	tlen = FALCON_TMPSIZE_KEYGEN_BATCH(logn, FALCON_KEYGEN_BATCH_MAX);
+	tmp = xmalloc(tlen + 12 * n + 8);
+	f = (int8_t *)tmp;
+	g = f + n;
+	F = g + n;
+	G = F + n;
+	f2 = G + n;
+	g2 = f2 + n;
+	F2 = g2 + n;
+	G2 = F2 + n;
+	h = (uint16_t *)(G2 + n);
+	h2 = h + n;
+	tt = (uint8_t *)(h2 + n);
+	tt += (8 - ((uintptr_t)tt & 7)) & 7;
 
-	pubkey = xmalloc(pubkey_len);
-	pubkey2 = xmalloc(pubkey_len);
-	privkey = xmalloc(privkey_len);
-	sig = xmalloc(sig_len);
-	sigpad = xmalloc(sig_len);
-	sigct = xmalloc(sigct_len);
-	expkey = xmalloc(expkey_len);
+	/* sprintf(buf, "keygen batch %u", logn); */
+	memcpy(buf, "keygen batch 00", 16);
+	buf[13] = '0' + logn / 10;
+	buf[14] = '0' + logn % 10;
 
-	tmpkg_len = FALCON_TMPSIZE_KEYGEN(logn);
-	tmpmp_len = FALCON_TMPSIZE_MAKEPUB(logn);
-	tmpsd_len = FALCON_TMPSIZE_SIGNDYN(logn);
-	tmpst_len = FALCON_TMPSIZE_SIGNTREE(logn);
-	tmpvv_len = FALCON_TMPSIZE_VERIFY(logn);
-	tmpek_len = FALCON_TMPSIZE_EXPANDPRIV(logn);
+	/*
+	 * Reference: plain key pair generation, followed by some RNG
+	 * output to check that the RNG is left in the same state.
+	 */
+	inner_shake256_init(&rng);
+	inner_shake256_inject(&rng, (uint8_t *)buf, strlen(buf));
+	inner_shake256_flip(&rng);
+	Zf(keygen)(&rng, f, g, F, G, h, logn, tt);
+	inner_shake256_extract(&rng, out, sizeof out);
+
+	for (u = 0; u < sizeof batches / sizeof batches[0]; u ++) {
+		inner_shake256_init(&rng2);
+		inner_shake256_inject(&rng2, (uint8_t *)buf, strlen(buf));
+		inner_shake256_flip(&rng2);
+		Zf(keygen_batch)(&rng2, f2, g2, F2, G2, h2,
+			logn, tt, batches[u]);
+		inner_shake256_extract(&rng2, out2, sizeof out2);
+		check_eq(f, f2, n, "keygen batch f");
+		check_eq(g, g2, n, "keygen batch g");
+		check_eq(F, F2, n, "keygen batch F");
+		check_eq(G, G2, n, "keygen batch G");
+		check_eq(h, h2, n * sizeof *h, "keygen batch h");
+		check_eq(out, out2, sizeof out, "keygen batch RNG state");
+	}
 
-	tmpkg = xmalloc(tmpkg_len);
-	tmpmp = xmalloc(tmpmp_len);
-	tmpsd = xmalloc(tmpsd_len);
-	tmpst = xmalloc(tmpst_len);
-	tmpvv = xmalloc(tmpvv_len);
-	tmpek = xmalloc(tmpek_len);
+	/*
+	 * Same check through the external API.
+	 */
+	shake256_init_prng_from_seed(&sc, buf, strlen(buf));
+	r = falcon_keygen_make(&sc, logn,
+		privkey, FALCON_PRIVKEY_SIZE(logn),
+		pubkey, FALCON_PUBKEY_SIZE(logn),
+		tmp, FALCON_TMPSIZE_KEYGEN(logn));
+	if (r != 0) {
+		fprintf(stderr, "keygen failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	shake256_init_prng_from_seed(&sc2, buf, strlen(buf));
+	r = falcon_keygen_make_batch(&sc2, logn,
+		privkey2, FALCON_PRIVKEY_SIZE(logn),
+		pubkey2, FALCON_PUBKEY_SIZE(logn),
+		tmp, FALCON_TMPSIZE_KEYGEN_BATCH(logn, 4), 4);
+	if (r != 0) {
+		fprintf(stderr, "keygen batch failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	check_eq(privkey, privkey2, FALCON_PRIVKEY_SIZE(logn),
+		"keygen batch private key");
+	check_eq(pubkey, pubkey2, FALCON_PUBKEY_SIZE(logn),
+		"keygen batch public key");
+	r = falcon_keygen_make_batch(&sc2, logn,
+		privkey2, FALCON_PRIVKEY_SIZE(logn),
+		pubkey2, FALCON_PUBKEY_SIZE(logn),
+		tmp, FALCON_TMPSIZE_KEYGEN_BATCH(logn, 4) - 1, 4);
+	if (r != FALCON_ERR_SIZE) {
+		fprintf(stderr, "keygen batch: short buffer accepted\n");
+		exit(EXIT_FAILURE);
+	}
 
-	for (i = 0; i < 12; i ++) {
-		int r;
+	xfree(tmp);
+	printf(".");
+	fflush(stdout);
+}
 
-		memset(privkey, 0, privkey_len);
-		memset(pubkey, 0, pubkey_len);
-		r = falcon_keygen_make(rng, logn, privkey, privkey_len,
-			pubkey, pubkey_len, tmpkg, tmpkg_len);
-		if (r != 0) {
-			fprintf(stderr, "keygen failed: %d\n", r);
-			exit(EXIT_FAILURE);
-		}
-		memset(pubkey2, 0xFF, pubkey_len);
-		r = falcon_make_public(pubkey2, pubkey_len,
-			privkey, privkey_len, tmpmp, tmpmp_len);
-		if (r != 0) {
-			fprintf(stderr, "makepub failed: %d\n", r);
-			exit(EXIT_FAILURE);
-		}
-		check_eq(pubkey, pubkey2, pubkey_len, "pub / repub");
+static void
+test_keygen_batch(void)
+{
+	unsigned logn;
 
-		r = falcon_get_logn(pubkey, pubkey_len);
-		if (r != (int)logn) {
-			fprintf(stderr, "get_logn failed: %d\n", r);
-			exit(EXIT_FAILURE);
-		}
+	printf("Test keygen batch: ");
+	fflush(stdout);
+	for (logn = 1; logn <= 10; logn ++) {
+		test_keygen_batch_inner(logn);
+	}
+	printf("done.\n");
+	fflush(stdout);
+}
 
-		sig_len = FALCON_SIG_COMPRESSED_MAXSIZE(logn);
-		memset(sig, 0, sig_len);
-		r = falcon_sign_dyn(rng, sig, &sig_len, FALCON_SIG_COMPRESSED,
-			privkey, privkey_len,
-			"data1", 5, tmpsd, tmpsd_len);
+static void
+test_import_keys_inner(unsigned logn, shake256_context *rng)
+{
+	size_t n, u, sk_len, pk_len, tmp_len;
+	uint8_t *sk, *pk, *tmp;
+	uint16_t *h_ntt, *h_ntt2, *h;
+	int results[6], results2[6];
+	unsigned nthreads;
+	int r;
+
+	printf("[%u]", logn);
+	fflush(stdout);
+
+	n = (size_t)1 << logn;
+	sk_len = FALCON_PRIVKEY_SIZE(logn);
+	pk_len = FALCON_PUBKEY_SIZE(logn);
+	tmp_len = FALCON_TMPSIZE_KEYGEN(logn);
+	if (tmp_len < 4 * FALCON_TMPSIZE_IMPORT(logn)) {
+		tmp_len = 4 * FALCON_TMPSIZE_IMPORT(logn);
+	}
+	sk = xmalloc(6 * sk_len);
+	pk = xmalloc(6 * pk_len);
+	tmp = xmalloc(tmp_len);
+	h_ntt = xmalloc(6 * n * sizeof *h_ntt);
+	h_ntt2 = xmalloc(6 * n * sizeof *h_ntt2);
+	h = xmalloc(n * sizeof *h);
+
+	for (u = 0; u < 6; u ++) {
+		r = falcon_keygen_make(rng, logn, sk + u * sk_len, sk_len,
+			pk + u * pk_len, pk_len, tmp, tmp_len);
 		if (r != 0) {
-			fprintf(stderr, "sign_dyn failed: %d\n", r);
+			fprintf(stderr, "keygen failed: %d\n", r);
 			exit(EXIT_FAILURE);
 		}
-		r = falcon_verify(sig, sig_len, FALCON_SIG_COMPRESSED,
-			pubkey, pubkey_len, "data1", 5, tmpvv, tmpvv_len);
-		if (r != 0) {
-			fprintf(stderr, "verify failed: %d\n", r);
+	}
+
+	/*
+	 * Pair 2 gets the public key of pair 3; pair 4 gets a bad
+	 * private key header.
+	 */
+	memcpy(pk + 2 * pk_len, pk + 3 * pk_len, pk_len);
+	sk[4 * sk_len] ^= 0x01;
+
+	for (nthreads = 1; nthreads <= 4; nthreads ++) {
+		r = falcon_import_keys(logn, sk, pk, 6, h_ntt, results,
+			tmp, nthreads * FALCON_TMPSIZE_IMPORT(logn), nthreads);
+		if (r != 4) {
+			fprintf(stderr, "import: %d valid pairs (expected 4)\n",
+				r);
 			exit(EXIT_FAILURE);
 		}
-		if (logn >= 5) {
-			/*
-			 * At very low degrees, it may happen that the
-			 * alternate data hashes to a point which is close
-			 * enough to the correct one that the signature
-			 * matches both. Thus, we skip that check for very
-			 * low degrees.
-			 */
-			r = falcon_verify(sig, sig_len, FALCON_SIG_COMPRESSED,
-				pubkey, pubkey_len, "data2", 5,
-				tmpvv, tmpvv_len);
-			if (r != FALCON_ERR_BADSIG) {
-				fprintf(stderr, "wrong verify err: %d\n", r);
+		for (u = 0; u < 6; u ++) {
+			int e;
+
+			e = u == 2 ? FALCON_ERR_MISMATCH
+				: u == 4 ? FALCON_ERR_FORMAT : 0;
+			if (results[u] != e) {
+				fprintf(stderr, "import: pair %u: %d"
+					" (expected %d)\n",
+					(unsigned)u, results[u], e);
+				exit(EXIT_FAILURE);
+			}
+			if (Zf(modq_decode)(h, logn, pk + u * pk_len + 1,
+				pk_len - 1) != pk_len - 1)
+			{
+				fprintf(stderr, "public key decode failed\n");
 				exit(EXIT_FAILURE);
 			}
+			Zf(to_ntt_monty)(h, logn);
+			check_eq(h, h_ntt + u * n, n * sizeof *h,
+				"import NTT public key");
 		}
-
-		sigpad_len = FALCON_SIG_PADDED_SIZE(logn);
-		memset(sigpad, 0, sigpad_len);
-		r = falcon_sign_dyn(rng, sigpad, &sigpad_len, FALCON_SIG_PADDED,
-			privkey, privkey_len,
-			"data1", 5, tmpsd, tmpsd_len);
-		if (r != 0) {
-			fprintf(stderr, "sign_dyn(padded) failed: %d\n", r);
-			exit(EXIT_FAILURE);
+		if (nthreads == 1) {
+			memcpy(h_ntt2, h_ntt, 6 * n * sizeof *h_ntt);
+			memcpy(results2, results, sizeof results);
+		} else {
+			check_eq(h_ntt, h_ntt2, 6 * n * sizeof *h_ntt,
+				"import threads NTT");
+			check_eq(results, results2, sizeof results,
+				"import threads results");
 		}
-		if (sigpad_len != FALCON_SIG_PADDED_SIZE(logn)) {
+	}
+
+	r = falcon_import_keys(logn, sk, pk, 6, NULL, results,
+		tmp, 2 * FALCON_TMPSIZE_IMPORT(logn) - 1, 2);
+	if (r != FALCON_ERR_SIZE) {
+		fprintf(stderr, "import: short buffer accepted\n");
+		exit(EXIT_FAILURE);
+	}
+
+	xfree(sk);
+	xfree(pk);
+	xfree(tmp);
+	xfree(h_ntt);
+	xfree(h_ntt2);
+	xfree(h);
+	printf(".");
+	fflush(stdout);
+}
+
+static void
+test_import_keys(void)
+{
+	unsigned logn;
+	shake256_context rng;
+
+	printf("Test import keys: ");
+	fflush(stdout);
+
+	shake256_init_prng_from_seed(&rng, "import", 6);
+	for (logn = 1; logn <= 10; logn ++) {
+		test_import_keys_inner(logn, &rng);
+	}
+
+	printf("done.\n");
+	fflush(stdout);
+}
+
+static void
+test_keygen_expanded(void)
+{
+	unsigned logn;
+
+	printf("Test keygen expanded: ");
+	fflush(stdout);
+
+	for (logn = 1; logn <= 10; logn ++) {
+		size_t sk_len, pk_len, ek_len, tmp_len;
+		uint8_t *sk, *pk, *sk2, *pk2, *ek, *ek2, *tmp;
+		shake256_context rng;
+		int r;
+
+		printf("[%u]", logn);
+		fflush(stdout);
+
+		sk_len = FALCON_PRIVKEY_SIZE(logn);
+		pk_len = FALCON_PUBKEY_SIZE(logn);
+		ek_len = FALCON_EXPANDEDKEY_SIZE(logn);
+		tmp_len = FALCON_TMPSIZE_KEYGEN_EXPANDED(logn);
+		if (tmp_len < FALCON_TMPSIZE_KEYGEN(logn)) {
+			fprintf(stderr, "TMPSIZE_KEYGEN_EXPANDED too small\n");
+			exit(EXIT_FAILURE);
+		}
+		if (tmp_len < FALCON_TMPSIZE_EXPANDPRIV(logn)) {
+			tmp_len = FALCON_TMPSIZE_EXPANDPRIV(logn);
+		}
+		sk = xmalloc(sk_len);
+		pk = xmalloc(pk_len);
+		sk2 = xmalloc(sk_len);
+		pk2 = xmalloc(pk_len);
+		ek = xmalloc(ek_len);
+		ek2 = xmalloc(ek_len);
+		tmp = xmalloc(tmp_len + 1);
+
+		/*
+		 * Alignment padding in expanded keys is not written.
+		 */
+		memset(ek, 0, ek_len);
+		memset(ek2, 0, ek_len);
+
+		/*
+		 * Reference: plain key generation, then expansion.
+		 */
+		shake256_init_prng_from_seed(&rng, "keygen expanded", 15);
+		r = falcon_keygen_make(&rng, logn, sk, sk_len, pk, pk_len,
+			tmp, tmp_len);
+		if (r != 0) {
+			fprintf(stderr, "keygen failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		r = falcon_expand_privkey(ek, ek_len, sk, sk_len,
+			tmp, tmp_len);
+		if (r != 0) {
+			fprintf(stderr, "expand_privkey failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+
+		/*
+		 * Same seed, in one call, with an odd tmp[] address and
+		 * the exact advertised size.
+		 */
+		shake256_init_prng_from_seed(&rng, "keygen expanded", 15);
+		r = falcon_keygen_make_expanded(&rng, logn,
+			sk2, sk_len, pk2, pk_len, ek2, ek_len,
+			tmp + 1, FALCON_TMPSIZE_KEYGEN_EXPANDED(logn));
+		if (r != 0) {
+			fprintf(stderr, "keygen_make_expanded failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		check_eq(sk, sk2, sk_len, "keygen expanded: private key");
+		check_eq(pk, pk2, pk_len, "keygen expanded: public key");
+		check_eq(ek, ek2, ek_len, "keygen expanded: expanded key");
+
+		r = falcon_keygen_make_expanded(&rng, logn,
+			sk2, sk_len, NULL, 0, ek2, ek_len - 1,
+			tmp, tmp_len);
+		if (r != FALCON_ERR_SIZE) {
+			fprintf(stderr, "keygen_make_expanded: short buffer"
+				" not detected: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+
+		xfree(sk);
+		xfree(pk);
+		xfree(sk2);
+		xfree(pk2);
+		xfree(ek);
+		xfree(ek2);
+		xfree(tmp);
+	}
+
+	printf("done.\n");
+	fflush(stdout);
+}
+
+static void
+test_keygen_profile(void)
+{
+	uint64_t ns[FALCON_KG_PROFILE_DEPTHS + 2];
+	uint8_t *sk, *pk, *tmp;
+	shake256_context rng;
+	size_t u;
+	int r;
+
+	printf("Test keygen profile: ");
+	fflush(stdout);
+
+	sk = xmalloc(FALCON_PRIVKEY_SIZE(9));
+	pk = xmalloc(FALCON_PUBKEY_SIZE(9));
+	tmp = xmalloc(FALCON_TMPSIZE_KEYGEN(9));
+
+	/*
+	 * Counters are reset, then accumulate over one key pair
+	 * generation; without FALCON_KG_PROFILE, all values are 0.
+	 */
+	falcon_keygen_profile(ns, FALCON_KG_PROFILE_DEPTHS, 1);
+	shake256_init_prng_from_seed(&rng, "keygen profile", 14);
+	r = falcon_keygen_make(&rng, 9, sk, FALCON_PRIVKEY_SIZE(9),
+		pk, FALCON_PUBKEY_SIZE(9), tmp, FALCON_TMPSIZE_KEYGEN(9));
+	if (r != 0) {
+		fprintf(stderr, "keygen failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	memset(ns, 0xFF, sizeof ns);
+	r = falcon_keygen_profile(ns, FALCON_KG_PROFILE_DEPTHS + 2, 1);
+	if (r != FALCON_KG_PROFILE) {
+		fprintf(stderr, "keygen_profile: unexpected result %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	for (u = 0; u < FALCON_KG_PROFILE_DEPTHS + 2; u ++) {
+		if (ns[u] != 0 && (!r || u >= FALCON_KG_PROFILE_DEPTHS)) {
+			fprintf(stderr, "keygen_profile: unexpected time"
+				" at depth %u\n", (unsigned)u);
+			exit(EXIT_FAILURE);
+		}
+	}
+	printf(".");
+	fflush(stdout);
+
+	falcon_keygen_profile(ns, FALCON_KG_PROFILE_DEPTHS, 0);
+	for (u = 0; u < FALCON_KG_PROFILE_DEPTHS; u ++) {
+		if (ns[u] != 0) {
+			fprintf(stderr, "keygen_profile: counters not reset\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	printf(".");
+	fflush(stdout);
+
+	xfree(sk);
+	xfree(pk);
+	xfree(tmp);
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_sign_lowmem_inner(unsigned logn)
+{
+	size_t n, sk_len, u;
+	int8_t *f, *g, *F, *G;
+	uint16_t *h, *hm;
+	int16_t *sig1, *sig2;
+	uint8_t *tmp, *tt, *lt;
+	uint8_t *sk, *sig, *sigl, *big, *small;
+	size_t sig_len, sigl_len;
+	inner_shake256_context rng, rng2;
+	shake256_context srng;
+	int i, r;
+
+	printf("[%u]", logn);
+	fflush(stdout);
+
+	n = (size_t)1 << logn;
+	tmp = xmalloc(90112);
+	lt = xmalloc(44u << logn);
+	f = (int8_t *)tmp;
+	g = f + n;
+	F = g + n;
+	G = F + n;
+	h = (uint16_t *)(G + n);
+	hm = h + n;
+	sig1 = (int16_t *)(hm + n);
+	sig2 = sig1 + n;
+	tt = (uint8_t *)(sig2 + n);
+
+	/*
+	 * Internal API: same signature and s1 with the same random
+	 * source; the low-memory variant gets a buffer of exactly
+	 * the documented size.
+	 */
+	inner_shake256_init(&rng);
+	inner_shake256_inject(&rng, (const uint8_t *)"sign lowmem", 11);
+	inner_shake256_flip(&rng);
+	Zf(keygen)(&rng, f, g, F, G, h, logn, tt);
+	for (i = 0; i < 10; i ++) {
+		for (u = 0; u < n; u ++) {
+			uint8_t x[2];
+
+			inner_shake256_extract(&rng, x, 2);
+			hm[u] = ((unsigned)x[0] + ((unsigned)x[1] << 8)) % 12289;
+		}
+		rng2 = rng;
+		Zf(sign_dyn)(sig1, &rng, f, g, F, G, hm, logn, tt);
+		Zf(sign_dyn_lowmem)(sig2, &rng2, f, g, F, G, hm, logn, lt);
+		check_eq(sig1, sig2, n * sizeof *sig1, "sign lowmem: s2");
+		check_eq(tt, lt, n * sizeof(int16_t), "sign lowmem: s1");
+		check_eq(&rng, &rng2, sizeof rng, "sign lowmem: RNG state");
+		printf(".");
+		fflush(stdout);
+	}
+	xfree(lt);
+	xfree(tmp);
+
+	/*
+	 * External API: the low-memory mode is selected by the buffer
+	 * size, with the same output.
+	 */
+	sk_len = FALCON_PRIVKEY_SIZE(logn);
+	sk = xmalloc(sk_len);
+	sig_len = FALCON_SIG_CT_SIZE(logn);
+	sig = xmalloc(sig_len);
+	sigl = xmalloc(sig_len);
+	big = xmalloc(FALCON_TMPSIZE_SIGNDYN(logn));
+	small = xmalloc(FALCON_TMPSIZE_SIGNDYN_LOWMEM(logn));
+	shake256_init_prng_from_seed(&srng, "sign lowmem", 11);
+	r = falcon_keygen_make(&srng, logn, sk, sk_len, NULL, 0,
+		big, FALCON_TMPSIZE_KEYGEN(logn));
+	if (r != 0) {
+		fprintf(stderr, "keygen failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	shake256_init_prng_from_seed(&srng, "sign", 4);
+	r = falcon_sign_dyn(&srng, sig, &sig_len, FALCON_SIG_CT,
+		sk, sk_len, "data", 4, big, FALCON_TMPSIZE_SIGNDYN(logn));
+	if (r != 0) {
+		fprintf(stderr, "sign_dyn failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	shake256_init_prng_from_seed(&srng, "sign", 4);
+	sigl_len = FALCON_SIG_CT_SIZE(logn);
+	r = falcon_sign_dyn(&srng, sigl, &sigl_len, FALCON_SIG_CT,
+		sk, sk_len, "data", 4,
+		small, FALCON_TMPSIZE_SIGNDYN_LOWMEM(logn));
+	if (r != 0) {
+		fprintf(stderr, "sign_dyn(lowmem) failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	if (sig_len != sigl_len) {
+		fprintf(stderr, "sign_dyn(lowmem): wrong length\n");
+		exit(EXIT_FAILURE);
+	}
+	check_eq(sig, sigl, sig_len, "sign_dyn(lowmem)");
+	r = falcon_sign_dyn(&srng, sigl, &sigl_len, FALCON_SIG_CT,
+		sk, sk_len, "data", 4,
+		small, FALCON_TMPSIZE_SIGNDYN_LOWMEM(logn) - 1);
+	if (r != FALCON_ERR_SIZE) {
+		fprintf(stderr, "sign_dyn: short buffer not detected: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	xfree(sk);
+	xfree(sig);
+	xfree(sigl);
+	xfree(big);
+	xfree(small);
+}
+
+static void
+test_sign_lowmem(void)
+{
+	unsigned logn;
+
+	printf("Test sign lowmem: ");
+	fflush(stdout);
+	for (logn = 1; logn <= 10; logn ++) {
+		test_sign_lowmem_inner(logn);
+	}
+	printf("done.\n");
+	fflush(stdout);
+}
+
+static void
+blob_sign(shake256_context *rng, const void *ek, uint8_t *sig,
+	size_t sig_max, size_t *sig_len, uint8_t *tmp, size_t tmp_len)
+{
+	int r;
+
+	shake256_init_prng_from_seed(rng, "blob sign", 9);
+	*sig_len = sig_max;
+	r = falcon_sign_tree(rng, sig, sig_len, FALCON_SIG_COMPRESSED,
+		ek, "data", 4, tmp, tmp_len);
+	if (r != 0) {
+		fprintf(stderr, "sign_tree failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void
+test_expanded_key_blob_inner(unsigned logn, shake256_context *rng)
+{
+	size_t sk_len, pk_len, ek_len, blob_len, sig_max, tmp_len;
+	size_t sig_len, sig2_len;
+	uint8_t *sk, *pk, *ekbuf, *ek, *blob, *blob2, *sig, *sig2, *tmp;
+	const void *ek2;
+	int r;
+
+	printf("[%u]", logn);
+	fflush(stdout);
+
+	sk_len = FALCON_PRIVKEY_SIZE(logn);
+	pk_len = FALCON_PUBKEY_SIZE(logn);
+	ek_len = FALCON_EXPANDEDKEY_SIZE(logn);
+	blob_len = FALCON_EXPANDEDKEY_BLOB_SIZE(logn);
+	sig_max = FALCON_SIG_COMPRESSED_MAXSIZE(logn);
+	tmp_len = FALCON_TMPSIZE_KEYGEN(logn);
+	if (tmp_len < FALCON_TMPSIZE_EXPANDPRIV(logn)) {
+		tmp_len = FALCON_TMPSIZE_EXPANDPRIV(logn);
+	}
+	if (tmp_len < FALCON_TMPSIZE_SIGNTREE(logn)) {
+		tmp_len = FALCON_TMPSIZE_SIGNTREE(logn);
+	}
+	sk = xmalloc(sk_len);
+	pk = xmalloc(pk_len);
+	ekbuf = xmalloc(ek_len + 8);
+	blob = xmalloc(blob_len + 8);
+	blob2 = xmalloc(ek_len + 31);
+	sig = xmalloc(sig_max);
+	sig2 = xmalloc(sig_max);
+	tmp = xmalloc(tmp_len);
+
+	r = falcon_keygen_make(rng, logn, sk, sk_len, pk, pk_len,
+		tmp, tmp_len);
+	if (r != 0) {
+		fprintf(stderr, "keygen failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+
+	/*
+	 * Reference signature, with an expanded key at an odd address.
+	 */
+	ek = ekbuf + 3;
+	r = falcon_expand_privkey(ek, ek_len, sk, sk_len, tmp, tmp_len);
+	if (r != 0) {
+		fprintf(stderr, "expand_privkey failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	blob_sign(rng, ek, sig, sig_max, &sig_len, tmp, tmp_len);
+
+	/*
+	 * Save, then use the blob in place and through a copy.
+	 */
+	r = falcon_expanded_key_save(blob, blob_len - 1, ek);
+	if (r != FALCON_ERR_SIZE) {
+		fprintf(stderr, "blob save (short): %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	r = falcon_expanded_key_save(blob, blob_len, ek);
+	if (r != 0) {
+		fprintf(stderr, "blob save failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	r = falcon_expanded_key_open(&ek2, blob, blob_len);
+	if (r != 0) {
+		fprintf(stderr, "blob open failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	blob_sign(rng, ek2, sig2, sig_max, &sig2_len, tmp, tmp_len);
+	if (sig2_len != sig_len) {
+		fprintf(stderr, "blob open: wrong signature length\n");
+		exit(EXIT_FAILURE);
+	}
+	check_eq(sig, sig2, sig_len, "blob open sign");
+
+	memset(ekbuf, 0, ek_len + 8);
+	ek = ekbuf + 5;
+	r = falcon_expanded_key_load(ek, ek_len, blob, blob_len);
+	if (r != 0) {
+		fprintf(stderr, "blob load failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	blob_sign(rng, ek, sig2, sig_max, &sig2_len, tmp, tmp_len);
+	check_eq(sig, sig2, sig_len, "blob load sign");
+
+	/*
+	 * Expansion in place, at offset 31 in the blob buffer, gives the
+	 * same blob.
+	 */
+	r = falcon_expand_privkey(blob2 + 31, ek_len, sk, sk_len,
+		tmp, tmp_len);
+	if (r != 0) {
+		fprintf(stderr, "expand_privkey failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	r = falcon_expanded_key_save(blob2, blob_len, blob2 + 31);
+	if (r != 0) {
+		fprintf(stderr, "blob save (in place) failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	check_eq(blob, blob2, blob_len, "blob save in place");
+
+	/*
+	 * Rejections: misaligned blob, wrong length, corrupted values
+	 * or header.
+	 */
+	memmove(blob + 1, blob, blob_len);
+	if (falcon_expanded_key_open(&ek2, blob + 1, blob_len)
+		!= FALCON_ERR_BADARG)
+	{
+		fprintf(stderr, "blob open: misalignment not detected\n");
+		exit(EXIT_FAILURE);
+	}
+	if (falcon_expanded_key_load(ek, ek_len, blob + 1, blob_len) != 0) {
+		fprintf(stderr, "blob load (unaligned) failed\n");
+		exit(EXIT_FAILURE);
+	}
+	memmove(blob, blob + 1, blob_len);
+	if (falcon_expanded_key_open(&ek2, blob, blob_len - 8)
+		!= FALCON_ERR_FORMAT)
+	{
+		fprintf(stderr, "blob open: bad length not detected\n");
+		exit(EXIT_FAILURE);
+	}
+	blob[blob_len - 3] ^= 0x10;
+	if (falcon_expanded_key_open(&ek2, blob, blob_len)
+		!= FALCON_ERR_FORMAT)
+	{
+		fprintf(stderr, "blob open: corruption not detected\n");
+		exit(EXIT_FAILURE);
+	}
+	blob[blob_len - 3] ^= 0x10;
+	blob[4] ++;
+	if (falcon_expanded_key_load(ek, ek_len, blob, blob_len)
+		!= FALCON_ERR_FORMAT)
+	{
+		fprintf(stderr, "blob load: bad version not detected\n");
+		exit(EXIT_FAILURE);
+	}
+
+	xfree(sk);
+	xfree(pk);
+	xfree(ekbuf);
+	xfree(blob);
+	xfree(blob2);
+	xfree(sig);
+	xfree(sig2);
+	xfree(tmp);
+}
+
+static void
+test_expanded_key_blob(void)
+{
+	unsigned logn;
+	shake256_context rng;
+
+	printf("Test expanded key blob: ");
+	fflush(stdout);
+
+	shake256_init_prng_from_seed(&rng, "blob", 4);
+	for (logn = 1; logn <= 10; logn ++) {
+		test_expanded_key_blob_inner(logn, &rng);
+	}
+
+	printf("done.\n");
+	fflush(stdout);
+}
+
+#define PIPE_JOBS   6
+
+static void
+test_sign_pipeline_inner(unsigned logn, shake256_context *rng)
+{
+	static const struct {
+		unsigned nworkers, ring_size;
+		int sig_type;
+	} cfg[] = {
+		{ 1, 2, FALCON_SIG_COMPRESSED },
+		{ 3, 4, FALCON_SIG_PADDED },
+		{ 4, 2, FALCON_SIG_CT }
+	};
+	size_t u, v, sk_len, pk_len, ek_len, sig_max, tmp_len, data_len;
+	uint8_t *sk, *pk, *ek, *data, *sigs, *sig2, *tmp;
+	uint16_t *hm;
+	falcon_sign_job jobs[PIPE_JOBS];
+	int r, tree;
+
+	printf("[%u]", logn);
+	fflush(stdout);
+
+	sk_len = FALCON_PRIVKEY_SIZE(logn);
+	pk_len = FALCON_PUBKEY_SIZE(logn);
+	ek_len = FALCON_EXPANDEDKEY_SIZE(logn);
+	sig_max = FALCON_SIG_COMPRESSED_MAXSIZE(logn);
+	if (sig_max < FALCON_SIG_CT_SIZE(logn)) {
+		sig_max = FALCON_SIG_CT_SIZE(logn);
+	}
+	tmp_len = FALCON_TMPSIZE_SIGNPIPE_DYN(logn, 4, 4);
+	if (tmp_len < FALCON_TMPSIZE_KEYGEN(logn)) {
+		tmp_len = FALCON_TMPSIZE_KEYGEN(logn);
+	}
+	if (tmp_len < FALCON_TMPSIZE_EXPANDPRIV(logn)) {
+		tmp_len = FALCON_TMPSIZE_EXPANDPRIV(logn);
+	}
+	data_len = 70000;
+	sk = xmalloc(sk_len);
+	pk = xmalloc(pk_len);
+	ek = xmalloc(ek_len);
+	data = xmalloc(data_len);
+	sigs = xmalloc(PIPE_JOBS * sig_max);
+	sig2 = xmalloc(sig_max);
+	tmp = xmalloc(tmp_len);
+	hm = xmalloc((size_t)2 << logn);
+	for (u = 0; u < data_len; u ++) {
+		data[u] = (uint8_t)(u * 31 + logn);
+	}
+
+	r = falcon_keygen_make(rng, logn, sk, sk_len, pk, pk_len,
+		tmp, tmp_len);
+	if (r != 0) {
+		fprintf(stderr, "keygen failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	r = falcon_expand_privkey(ek, ek_len, sk, sk_len, tmp, tmp_len);
+	if (r != 0) {
+		fprintf(stderr, "expand_privkey failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+
+	for (tree = 0; tree <= 1; tree ++) {
+		for (v = 0; v < sizeof cfg / sizeof cfg[0]; v ++) {
+			shake256_context mrng, ref;
+
+			/*
+			 * Messages of various sizes, including large ones
+			 * and an empty one.
+			 */
+			for (u = 0; u < PIPE_JOBS; u ++) {
+				jobs[u].data = data;
+				jobs[u].data_len = (u * 13001) % data_len;
+				jobs[u].sig = sigs + u * sig_max;
+				jobs[u].sig_len = sig_max;
+			}
+			shake256_init_prng_from_seed(&mrng, "pipe", 4);
+			shake256_flip(&mrng);
+			ref = mrng;
+			if (tree) {
+				r = falcon_sign_tree_pipeline(&mrng,
+					cfg[v].sig_type, ek, jobs, PIPE_JOBS,
+					tmp, FALCON_TMPSIZE_SIGNPIPE_TREE(logn,
+					cfg[v].nworkers, cfg[v].ring_size),
+					cfg[v].nworkers, cfg[v].ring_size);
+			} else {
+				r = falcon_sign_dyn_pipeline(&mrng,
+					cfg[v].sig_type, sk, sk_len,
+					jobs, PIPE_JOBS,
+					tmp, FALCON_TMPSIZE_SIGNPIPE_DYN(logn,
+					cfg[v].nworkers, cfg[v].ring_size),
+					cfg[v].nworkers, cfg[v].ring_size);
+			}
+			if (r != 0) {
+				fprintf(stderr, "sign pipeline failed: %d\n", r);
+				exit(EXIT_FAILURE);
+			}
+
+			/*
+			 * Recompute each signature from its own nonce and
+			 * seed, drawn in job order, and verify it.
+			 */
+			for (u = 0; u < PIPE_JOBS; u ++) {
+				shake256_context hd, jrng;
+				uint8_t nonce[40], seed[48];
+				size_t sig2_len;
+
+				if (jobs[u].status != 0) {
+					fprintf(stderr, "pipeline job %u: %d\n",
+						(unsigned)u, jobs[u].status);
+					exit(EXIT_FAILURE);
+				}
+				shake256_extract(&ref, nonce, 40);
+				shake256_extract(&ref, seed, 48);
+				shake256_init(&hd);
+				shake256_inject(&hd, nonce, 40);
+				shake256_inject(&hd, jobs[u].data,
+					jobs[u].data_len);
+				falcon_hash_to_point(&hd, logn,
+					cfg[v].sig_type, hm, tmp, tmp_len);
+				shake256_init_prng_from_seed(&jrng, seed, 48);
+				shake256_flip(&jrng);
+				sig2_len = sig_max;
+				r = falcon_sign_dyn_hm(&jrng, sig2, &sig2_len,
+					cfg[v].sig_type, sk, sk_len, hm, nonce,
+					tmp, tmp_len);
+				if (r != 0) {
+					fprintf(stderr, "sign_dyn_hm failed:"
+						" %d\n", r);
+					exit(EXIT_FAILURE);
+				}
+				if (sig2_len != jobs[u].sig_len) {
+					fprintf(stderr, "pipeline: wrong"
+						" signature length\n");
+					exit(EXIT_FAILURE);
+				}
+				check_eq(sig2, jobs[u].sig, sig2_len,
+					"pipeline signature");
+				r = falcon_verify(jobs[u].sig, jobs[u].sig_len,
+					cfg[v].sig_type, pk, pk_len,
+					jobs[u].data, jobs[u].data_len,
+					tmp, tmp_len);
+				if (r != 0) {
+					fprintf(stderr, "pipeline: verify"
+						" failed: %d\n", r);
+					exit(EXIT_FAILURE);
+				}
+			}
+
+			/*
+			 * The RNG must be left just after the last job.
+			 */
+			{
+				uint8_t x1[16], x2[16];
+
+				shake256_extract(&mrng, x1, sizeof x1);
+				shake256_extract(&ref, x2, sizeof x2);
+				check_eq(x1, x2, sizeof x1, "pipeline RNG");
+			}
+		}
+	}
+
+	/*
+	 * The _hm variant matches the _finish variant.
+	 */
+	{
+		shake256_context hd, hd2, r1, r2;
+		uint8_t nonce[40];
+		size_t sig_len, sig2_len;
+
+		shake256_init_prng_from_seed(&r1, "hm", 2);
+		shake256_flip(&r1);
+		falcon_sign_start(&r1, nonce, &hd);
+		shake256_inject(&hd, data, 1000);
+		hd2 = hd;
+		r2 = r1;
+		sig_len = sig_max;
+		r = falcon_sign_tree_finish(&r1, sigs, &sig_len,
+			FALCON_SIG_COMPRESSED, ek, &hd, nonce, tmp, tmp_len);
+		if (r != 0) {
+			fprintf(stderr, "sign_tree_finish failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		falcon_hash_to_point(&hd2, logn, FALCON_SIG_COMPRESSED,
+			hm, tmp, tmp_len);
+		sig2_len = sig_max;
+		r = falcon_sign_tree_hm(&r2, sig2, &sig2_len,
+			FALCON_SIG_COMPRESSED, ek, hm, nonce, tmp, tmp_len);
+		if (r != 0 || sig2_len != sig_len) {
+			fprintf(stderr, "sign_tree_hm failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		check_eq(sigs, sig2, sig_len, "sign_tree_hm");
+	}
+
+	r = falcon_sign_dyn_pipeline(rng, FALCON_SIG_COMPRESSED, sk, sk_len,
+		jobs, PIPE_JOBS, tmp, tmp_len, 4, 3);
+	if (r != FALCON_ERR_BADARG) {
+		fprintf(stderr, "pipeline: bad ring size accepted\n");
+		exit(EXIT_FAILURE);
+	}
+
+	xfree(sk);
+	xfree(pk);
+	xfree(ek);
+	xfree(data);
+	xfree(sigs);
+	xfree(sig2);
+	xfree(tmp);
+	xfree(hm);
+	printf(".");
+	fflush(stdout);
+}
+
+static void
+test_sign_pipeline(void)
+{
+	unsigned logn;
+	shake256_context rng;
+
+	printf("Test sign pipeline: ");
+	fflush(stdout);
+
+	shake256_init_prng_from_seed(&rng, "pipeline", 8);
+	for (logn = 1; logn <= 10; logn ++) {
+		test_sign_pipeline_inner(logn, &rng);
+	}
+
+	printf("done.\n");
+	fflush(stdout);
+}
+
+static void
+test_external_API_inner(unsigned logn, shake256_context *rng)
+{
+	int i;
+	void *pubkey, *pubkey2, *privkey, *sig, *sigpad, *sigct, *expkey;
+	size_t pubkey_len, privkey_len, sig_len, sigpad_len, sigct_len;
+	size_t expkey_len;
+	uint8_t *tmpkg, *tmpmp, *tmpsd, *tmpst, *tmpvv, *tmpek;
+	size_t tmpkg_len, tmpmp_len, tmpsd_len, tmpst_len, tmpvv_len, tmpek_len;
+
+	printf("[%u]", logn);
+	fflush(stdout);
+
+	pubkey_len = FALCON_PUBKEY_SIZE(logn);
+	privkey_len = FALCON_PRIVKEY_SIZE(logn);
+	sig_len = FALCON_SIG_COMPRESSED_MAXSIZE(logn);
+	sigpad_len = FALCON_SIG_PADDED_SIZE(logn);
+	sigct_len = FALCON_SIG_CT_SIZE(logn);
+	expkey_len = FALCON_EXPANDEDKEY_SIZE(logn);
+
+	pubkey = xmalloc(pubkey_len);
+	pubkey2 = xmalloc(pubkey_len);
+	privkey = xmalloc(privkey_len);
+	sig = xmalloc(sig_len);
+	sigpad = xmalloc(sig_len);
+	sigct = xmalloc(sigct_len);
+	expkey = xmalloc(expkey_len);
+
+	tmpkg_len = FALCON_TMPSIZE_KEYGEN(logn);
+	tmpmp_len = FALCON_TMPSIZE_MAKEPUB(logn);
+	tmpsd_len = FALCON_TMPSIZE_SIGNDYN(logn);
+	tmpst_len = FALCON_TMPSIZE_SIGNTREE(logn);
+	tmpvv_len = FALCON_TMPSIZE_VERIFY(logn);
+	tmpek_len = FALCON_TMPSIZE_EXPANDPRIV(logn);
+
+	tmpkg = xmalloc(tmpkg_len);
+	tmpmp = xmalloc(tmpmp_len);
+	tmpsd = xmalloc(tmpsd_len);
+	tmpst = xmalloc(tmpst_len);
+	tmpvv = xmalloc(tmpvv_len);
+	tmpek = xmalloc(tmpek_len);
+
+	for (i = 0; i < 12; i ++) {
+		int r;
+
+		memset(privkey, 0, privkey_len);
+		memset(pubkey, 0, pubkey_len);
+		r = falcon_keygen_make(rng, logn, privkey, privkey_len,
+			pubkey, pubkey_len, tmpkg, tmpkg_len);
+		if (r != 0) {
+			fprintf(stderr, "keygen failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		memset(pubkey2, 0xFF, pubkey_len);
+		r = falcon_make_public(pubkey2, pubkey_len,
+			privkey, privkey_len, tmpmp, tmpmp_len);
+		if (r != 0) {
+			fprintf(stderr, "makepub failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		check_eq(pubkey, pubkey2, pubkey_len, "pub / repub");
+
+		r = falcon_get_logn(pubkey, pubkey_len);
+		if (r != (int)logn) {
+			fprintf(stderr, "get_logn failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+
+		sig_len = FALCON_SIG_COMPRESSED_MAXSIZE(logn);
+		memset(sig, 0, sig_len);
+		r = falcon_sign_dyn(rng, sig, &sig_len, FALCON_SIG_COMPRESSED,
+			privkey, privkey_len,
+			"data1", 5, tmpsd, tmpsd_len);
+		if (r != 0) {
+			fprintf(stderr, "sign_dyn failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		r = falcon_verify(sig, sig_len, FALCON_SIG_COMPRESSED,
+			pubkey, pubkey_len, "data1", 5, tmpvv, tmpvv_len);
+		if (r != 0) {
+			fprintf(stderr, "verify failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		if (logn >= 5) {
+			/*
+			 * At very low degrees, it may happen that the
+			 * alternate data hashes to a point which is close
+			 * enough to the correct one that the signature
+			 * matches both. Thus, we skip that check for very
+			 * low degrees.
+			 */
+			r = falcon_verify(sig, sig_len, FALCON_SIG_COMPRESSED,
+				pubkey, pubkey_len, "data2", 5,
+				tmpvv, tmpvv_len);
+			if (r != FALCON_ERR_BADSIG) {
+				fprintf(stderr, "wrong verify err: %d\n", r);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		sigpad_len = FALCON_SIG_PADDED_SIZE(logn);
+		memset(sigpad, 0, sigpad_len);
+		r = falcon_sign_dyn(rng, sigpad, &sigpad_len, FALCON_SIG_PADDED,
+			privkey, privkey_len,
+			"data1", 5, tmpsd, tmpsd_len);
+		if (r != 0) {
+			fprintf(stderr, "sign_dyn(padded) failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		if (sigpad_len != FALCON_SIG_PADDED_SIZE(logn)) {
 			fprintf(stderr, "sign_dyn(padded): wrong length %lu\n",
 				(unsigned long)sigpad_len);
 			exit(EXIT_FAILURE);
@@ -4013,80 +5215,425 @@ test_external_API_inner(unsigned logn, shake256_context *rng)
 			fprintf(stderr, "sign_tree(padded) failed: %d\n", r);
 			exit(EXIT_FAILURE);
 		}
-		r = falcon_verify(sigpad, sigpad_len, FALCON_SIG_PADDED,
-			pubkey, pubkey_len, "data1", 5, tmpvv, tmpvv_len);
-		if (r != 0) {
-			fprintf(stderr, "verify2(padded) failed: %d\n", r);
+		r = falcon_verify(sigpad, sigpad_len, FALCON_SIG_PADDED,
+			pubkey, pubkey_len, "data1", 5, tmpvv, tmpvv_len);
+		if (r != 0) {
+			fprintf(stderr, "verify2(padded) failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		if (logn >= 5) {
+			r = falcon_verify(sigpad, sigpad_len, FALCON_SIG_PADDED,
+				pubkey, pubkey_len, "data2", 5,
+				tmpvv, tmpvv_len);
+			if (r != FALCON_ERR_BADSIG) {
+				fprintf(stderr,
+					"wrong verify2(padded) err: %d\n", r);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		sigct_len = FALCON_SIG_CT_SIZE(logn);
+		memset(sigct, 0, sigct_len);
+		r = falcon_sign_tree(rng, sigct, &sigct_len, FALCON_SIG_CT,
+			expkey,
+			"data1", 5, tmpst, tmpst_len);
+		if (r != 0) {
+			fprintf(stderr, "sign_tree(ct) failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		r = falcon_verify(sigct, sigct_len, FALCON_SIG_CT,
+			pubkey, pubkey_len, "data1", 5, tmpvv, tmpvv_len);
+		if (r != 0) {
+			fprintf(stderr, "verify2(ct) failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		if (logn >= 5) {
+			r = falcon_verify(sigct, sigct_len, FALCON_SIG_CT,
+				pubkey, pubkey_len, "data2", 5,
+				tmpvv, tmpvv_len);
+			if (r != FALCON_ERR_BADSIG) {
+				fprintf(stderr,
+					"wrong verify2(ct) err: %d\n", r);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		printf(".");
+		fflush(stdout);
+	}
+
+	xfree(pubkey);
+	xfree(pubkey2);
+	xfree(privkey);
+	xfree(sig);
+	xfree(sigpad);
+	xfree(sigct);
+	xfree(expkey);
+	xfree(tmpkg);
+	xfree(tmpmp);
+	xfree(tmpsd);
+	xfree(tmpst);
+	xfree(tmpvv);
+	xfree(tmpek);
+}
+
+static void
+test_external_API(void)
+{
+	unsigned logn;
+	shake256_context rng;
+
+	printf("Test external API: ");
+	fflush(stdout);
+
+	shake256_init_prng_from_seed(&rng, "external", 8);
+	for (logn = 1; logn <= 10; logn ++) {
+		test_external_API_inner(logn, &rng);
+	}
+
+	printf("done.\n");
+	fflush(stdout);
+}
+
+static void
+test_verify_prepared_inner(unsigned logn, shake256_context *rng)
+{
+	uint8_t *pubkey, *privkey, *sig, *vkey, *tmp;
+	size_t pubkey_len, privkey_len, sig_len, vkey_len, tmp_len;
+	int i, sig_type;
+
+	pubkey_len = FALCON_PUBKEY_SIZE(logn);
+	privkey_len = FALCON_PRIVKEY_SIZE(logn);
+	vkey_len = FALCON_VERIFYKEY_SIZE(logn);
+	tmp_len = FALCON_TMPSIZE_KEYGEN(logn);
+	if (tmp_len < FALCON_TMPSIZE_SIGNDYN(logn)) {
+		tmp_len = FALCON_TMPSIZE_SIGNDYN(logn);
+	}
+	pubkey = xmalloc(pubkey_len);
+	privkey = xmalloc(privkey_len);
+	sig = xmalloc(FALCON_SIG_COMPRESSED_MAXSIZE(logn)
+		+ FALCON_SIG_CT_SIZE(logn));
+	/* one extra byte to also try an odd vkey[] address */
+	vkey = xmalloc(vkey_len + 1);
+	tmp = xmalloc(tmp_len);
+
+	if (falcon_keygen_make(rng, logn, privkey, privkey_len,
+		pubkey, pubkey_len, tmp, tmp_len) != 0)
+	{
+		fprintf(stderr, "keygen failed\n");
+		exit(EXIT_FAILURE);
+	}
+	if (falcon_verify_key_prepare(vkey, vkey_len - 1,
+		pubkey, pubkey_len) != FALCON_ERR_SIZE)
+	{
+		fprintf(stderr, "short vkey not rejected\n");
+		exit(EXIT_FAILURE);
+	}
+	pubkey[0] ^= 0x10;
+	if (falcon_verify_key_prepare(vkey, vkey_len,
+		pubkey, pubkey_len) != FALCON_ERR_FORMAT)
+	{
+		fprintf(stderr, "bad public key not rejected\n");
+		exit(EXIT_FAILURE);
+	}
+	pubkey[0] ^= 0x10;
+
+	for (i = 0; i < 6; i ++) {
+		uint8_t *vk;
+		int r, r2;
+
+		sig_type = 1 + (i % 3);
+		vk = vkey + (i >> 2);
+		sig_len = sig_type == FALCON_SIG_CT
+			? FALCON_SIG_CT_SIZE(logn)
+			: sig_type == FALCON_SIG_PADDED
+			? FALCON_SIG_PADDED_SIZE(logn)
+			: FALCON_SIG_COMPRESSED_MAXSIZE(logn);
+		r = falcon_sign_dyn(rng, sig, &sig_len, sig_type,
+			privkey, privkey_len, "data1", 5, tmp, tmp_len);
+		if (r != 0) {
+			fprintf(stderr, "sign_dyn failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		r = falcon_verify_key_prepare(vk, vkey_len,
+			pubkey, pubkey_len);
+		if (r != 0) {
+			fprintf(stderr, "verify_key_prepare failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+
+		/*
+		 * Prepared and plain verification must agree, on the
+		 * signed data, on other data (at low degrees, both may
+		 * accept it), and with a forced signature type.
+		 */
+		r = falcon_verify_prepared(sig, sig_len, sig_type, vk,
+			"data1", 5, tmp, FALCON_TMPSIZE_VERIFY(logn));
+		if (r != 0) {
+			fprintf(stderr, "verify_prepared failed: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		r = falcon_verify_prepared(sig, sig_len, 0, vk,
+			"data2", 5, tmp, FALCON_TMPSIZE_VERIFY(logn));
+		r2 = falcon_verify(sig, sig_len, 0, pubkey, pubkey_len,
+			"data2", 5, tmp, FALCON_TMPSIZE_VERIFY(logn));
+		if (r != r2 || (logn >= 5 && r != FALCON_ERR_BADSIG)) {
+			fprintf(stderr, "wrong verify err: %d / %d\n", r, r2);
+			exit(EXIT_FAILURE);
+		}
+		r = falcon_verify_prepared(sig, sig_len,
+			sig_type == FALCON_SIG_CT
+				? FALCON_SIG_COMPRESSED : FALCON_SIG_CT,
+			vk, "data1", 5, tmp, FALCON_TMPSIZE_VERIFY(logn));
+		if (r != FALCON_ERR_FORMAT) {
+			fprintf(stderr, "wrong sig type accepted: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+		r = falcon_verify_prepared(sig, sig_len, sig_type, vk,
+			"data1", 5, tmp, FALCON_TMPSIZE_VERIFY(logn) - 1);
+		if (r != FALCON_ERR_SIZE) {
+			fprintf(stderr, "short tmp accepted: %d\n", r);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	xfree(pubkey);
+	xfree(privkey);
+	xfree(sig);
+	xfree(vkey);
+	xfree(tmp);
+	printf(".");
+	fflush(stdout);
+}
+
+static void
+test_verify_prepared(void)
+{
+	unsigned logn;
+	shake256_context rng;
+
+	printf("Test prepared verify: ");
+	fflush(stdout);
+
+	shake256_init_prng_from_seed(&rng, "prepared", 8);
+	for (logn = 1; logn <= 10; logn ++) {
+		test_verify_prepared_inner(logn, &rng);
+	}
+
+	printf("done.\n");
+	fflush(stdout);
+}
+
+/*
+ * Run keygen, sign and verify batches with a context of nthreads
+ * threads; outputs must not depend on nthreads.
+ */
+static void
+test_batch_ctx_inner(unsigned logn, unsigned nthreads,
+	uint8_t *sk, uint8_t *pk, uint8_t *sigs, size_t count)
+{
+	falcon_batch_ctx *ctx;
+	void *mem;
+	uint8_t *expkey, *tmp, *vkey, seed[48];
+	size_t sk_len, pk_len, sig_max, tmp_len, u;
+	shake256_context rng, rng2;
+	falcon_sign_job *jobs;
+	falcon_verify_item *items;
+	int *results, r;
+
+	sk_len = FALCON_PRIVKEY_SIZE(logn);
+	pk_len = FALCON_PUBKEY_SIZE(logn);
+	sig_max = FALCON_SIG_CT_SIZE(logn);
+	tmp_len = sk_len + pk_len + FALCON_TMPSIZE_KEYGEN(logn);
+	if (tmp_len < FALCON_TMPSIZE_SIGNTREE(logn)) {
+		tmp_len = FALCON_TMPSIZE_SIGNTREE(logn);
+	}
+	if (tmp_len < FALCON_TMPSIZE_EXPANDPRIV(logn)) {
+		tmp_len = FALCON_TMPSIZE_EXPANDPRIV(logn);
+	}
+	mem = xmalloc(falcon_batch_ctx_size(logn, nthreads));
+	expkey = xmalloc(FALCON_EXPANDEDKEY_SIZE(logn));
+	tmp = xmalloc(tmp_len);
+	vkey = xmalloc(FALCON_VERIFYKEY_SIZE(logn));
+	jobs = xmalloc(count * sizeof *jobs);
+	items = xmalloc(count * sizeof *items);
+	results = xmalloc(count * sizeof *results);
+
+	if (falcon_batch_ctx_init(&ctx, mem,
+		falcon_batch_ctx_size(logn, nthreads) - 1,
+		logn, nthreads) != FALCON_ERR_SIZE)
+	{
+		fprintf(stderr, "short context memory not rejected\n");
+		exit(EXIT_FAILURE);
+	}
+	r = falcon_batch_ctx_init(&ctx, mem,
+		falcon_batch_ctx_size(logn, nthreads), logn, nthreads);
+	if (r != 0) {
+		fprintf(stderr, "batch_ctx_init failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+
+	/*
+	 * Key pair i is that of falcon_keygen_make() with the RNG
+	 * SHAKE256(batch seed || i).
+	 */
+	shake256_init_prng_from_seed(&rng, "batch", 5);
+	shake256_flip(&rng);
+	rng2 = rng;
+	shake256_extract(&rng2, seed, sizeof seed);
+	r = falcon_batch_keygen(ctx, &rng, sk, pk, results, count);
+	if (r != 0) {
+		fprintf(stderr, "batch_keygen failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+	for (u = 0; u < count; u ++) {
+		uint8_t buf[56];
+		unsigned k;
+
+		check_eq(results + u, (int[]){ 0 }, sizeof(int),
+			"batch_keygen result");
+		if (u != 0 && u != count - 1) {
+			continue;
+		}
+		memcpy(buf, seed, 48);
+		for (k = 0; k < 8; k ++) {
+			buf[48 + k] = (uint8_t)((uint64_t)u >> (8 * k));
+		}
+		shake256_init_prng_from_seed(&rng2, buf, sizeof buf);
+		shake256_flip(&rng2);
+		falcon_keygen_make(&rng2, logn, tmp, sk_len,
+			tmp + sk_len, pk_len, tmp + sk_len + pk_len,
+			FALCON_TMPSIZE_KEYGEN(logn));
+		check_eq(tmp, sk + u * sk_len, sk_len, "batch_keygen sk");
+		check_eq(tmp + sk_len, pk + u * pk_len, pk_len,
+			"batch_keygen pk");
+	}
+
+	/*
+	 * Sign one message per job with the first key; jobs with
+	 * u % 5 == 3 get a buffer that is too small.
+	 */
+	falcon_expand_privkey(expkey, FALCON_EXPANDEDKEY_SIZE(logn),
+		sk, sk_len, tmp, tmp_len);
+	for (u = 0; u < count; u ++) {
+		jobs[u].data = tmp + u;
+		jobs[u].data_len = 1 + u;
+		jobs[u].sig = sigs + u * sig_max;
+		jobs[u].sig_len = (u % 5) == 3 ? 10 : sig_max;
+	}
+	memset(tmp, 0x5A, 2 * count);
+	r = falcon_batch_sign_tree(ctx, &rng, FALCON_SIG_CT,
+		expkey, jobs, count);
+	if (r != 0) {
+		fprintf(stderr, "batch_sign_tree failed: %d\n", r);
+		exit(EXIT_FAILURE);
+	}
+
+	/*
+	 * Verify, with the encoded key or a prepared one; item 1 has
+	 * other data.
+	 */
+	falcon_verify_key_prepare(vkey, FALCON_VERIFYKEY_SIZE(logn),
+		pk, pk_len);
+	for (u = 0; u < count; u ++) {
+		int want;
+
+		want = (u % 5) == 3 ? FALCON_ERR_SIZE : 0;
+		if (jobs[u].status != want) {
+			fprintf(stderr, "batch_sign_tree status %d: %d\n",
+				(int)u, jobs[u].status);
 			exit(EXIT_FAILURE);
 		}
-		if (logn >= 5) {
-			r = falcon_verify(sigpad, sigpad_len, FALCON_SIG_PADDED,
-				pubkey, pubkey_len, "data2", 5,
-				tmpvv, tmpvv_len);
-			if (r != FALCON_ERR_BADSIG) {
-				fprintf(stderr,
-					"wrong verify2(padded) err: %d\n", r);
+		items[u].sig = jobs[u].sig;
+		items[u].sig_len = want == 0 ? jobs[u].sig_len : 0;
+		items[u].data = jobs[u].data;
+		items[u].data_len = u == 1 ? 0 : jobs[u].data_len;
+		items[u].pubkey = (u & 1) ? vkey : pk;
+		items[u].pubkey_len = (u & 1) ? 0 : pk_len;
+	}
+	r = falcon_batch_verify(ctx, FALCON_SIG_CT, items, results, count);
+	for (u = 0; u < count; u ++) {
+		int want;
+
+		if ((u % 5) == 3) {
+			want = FALCON_ERR_FORMAT;
+		} else if (u == 1) {
+			want = results[u];
+			if (logn >= 5 && want != FALCON_ERR_BADSIG) {
+				fprintf(stderr, "batch_verify accepted"
+					" other data\n");
 				exit(EXIT_FAILURE);
 			}
+		} else {
+			want = 0;
 		}
-
-		sigct_len = FALCON_SIG_CT_SIZE(logn);
-		memset(sigct, 0, sigct_len);
-		r = falcon_sign_tree(rng, sigct, &sigct_len, FALCON_SIG_CT,
-			expkey,
-			"data1", 5, tmpst, tmpst_len);
-		if (r != 0) {
-			fprintf(stderr, "sign_tree(ct) failed: %d\n", r);
-			exit(EXIT_FAILURE);
-		}
-		r = falcon_verify(sigct, sigct_len, FALCON_SIG_CT,
-			pubkey, pubkey_len, "data1", 5, tmpvv, tmpvv_len);
-		if (r != 0) {
-			fprintf(stderr, "verify2(ct) failed: %d\n", r);
+		if (results[u] != want) {
+			fprintf(stderr, "batch_verify result %d: %d\n",
+				(int)u, results[u]);
 			exit(EXIT_FAILURE);
 		}
-		if (logn >= 5) {
-			r = falcon_verify(sigct, sigct_len, FALCON_SIG_CT,
-				pubkey, pubkey_len, "data2", 5,
-				tmpvv, tmpvv_len);
-			if (r != FALCON_ERR_BADSIG) {
-				fprintf(stderr,
-					"wrong verify2(ct) err: %d\n", r);
-				exit(EXIT_FAILURE);
-			}
+		if (want == 0) {
+			r --;
 		}
-
-		printf(".");
-		fflush(stdout);
+	}
+	if (r != 0) {
+		fprintf(stderr, "batch_verify count mismatch\n");
+		exit(EXIT_FAILURE);
 	}
 
-	xfree(pubkey);
-	xfree(pubkey2);
-	xfree(privkey);
-	xfree(sig);
-	xfree(sigpad);
-	xfree(sigct);
+	falcon_batch_ctx_release(ctx);
+	xfree(mem);
 	xfree(expkey);
-	xfree(tmpkg);
-	xfree(tmpmp);
-	xfree(tmpsd);
-	xfree(tmpst);
-	xfree(tmpvv);
-	xfree(tmpek);
+	xfree(tmp);
+	xfree(vkey);
+	xfree(jobs);
+	xfree(items);
+	xfree(results);
 }
 
 static void
-test_external_API(void)
+test_batch_ctx(void)
 {
 	unsigned logn;
-	shake256_context rng;
+	size_t count;
 
-	printf("Test external API: ");
+	printf("Test batch context: ");
 	fflush(stdout);
 
-	shake256_init_prng_from_seed(&rng, "external", 8);
+	if (falcon_batch_ctx_size(9, 0) != 0
+		|| falcon_batch_ctx_size(11, 1) != 0
+		|| falcon_batch_ctx_size(9, 65) != 0)
+	{
+		fprintf(stderr, "invalid batch_ctx parameters accepted\n");
+		exit(EXIT_FAILURE);
+	}
 	for (logn = 1; logn <= 10; logn ++) {
-		test_external_API_inner(logn, &rng);
+		uint8_t *sk[2], *pk[2], *sigs[2];
+		size_t sk_len, pk_len, sig_len;
+		unsigned k;
+
+		count = logn <= 8 ? 23 : 6;
+		sk_len = count * FALCON_PRIVKEY_SIZE(logn);
+		pk_len = count * FALCON_PUBKEY_SIZE(logn);
+		sig_len = count * FALCON_SIG_CT_SIZE(logn);
+		for (k = 0; k < 2; k ++) {
+			sk[k] = xmalloc(sk_len);
+			pk[k] = xmalloc(pk_len);
+			sigs[k] = xmalloc(sig_len);
+			memset(sigs[k], 0, sig_len);
+			test_batch_ctx_inner(logn, k == 0 ? 1 : 4,
+				sk[k], pk[k], sigs[k], count);
+		}
+		check_eq(sk[0], sk[1], sk_len, "batch keys / threads");
+		check_eq(pk[0], pk[1], pk_len, "batch keys / threads");
+		check_eq(sigs[0], sigs[1], sig_len, "batch sigs / threads");
+		for (k = 0; k < 2; k ++) {
+			xfree(sk[k]);
+			xfree(pk[k]);
+			xfree(sigs[k]);
+		}
+		printf(".");
+		fflush(stdout);
 	}
 
 	printf("done.\n");
@@ -5003,26 +6550,462 @@ test_speed(void)
 }
 #endif
 
+/*
+ * Kernel digests for cross-backend differential testing. Each kernel
+ * is fed pseudorandom inputs derived from a seed string and the kernel
+ * name; all outputs are absorbed into SHAKE256 and a 32-byte digest is
+ * printed. Two builds of this file (e.g. FPEMU and AVX2) that print
+ * the same digests for the same seed computed bit-identical outputs.
+ */
+
+static void
+digest_init(inner_shake256_context *sc, prng *p,
+	const char *seed, const char *name)
+{
+	inner_shake256_context rng;
+
+	inner_shake256_init(&rng);
+	inner_shake256_inject(&rng, (const uint8_t *)seed, strlen(seed) + 1);
+	inner_shake256_inject(&rng, (const uint8_t *)name, strlen(name) + 1);
+	inner_shake256_flip(&rng);
+	if (p != NULL) {
+		Zf(prng_init)(p, &rng);
+	}
+	inner_shake256_init(sc);
+}
+
+static void
+digest_fpr(inner_shake256_context *sc, const fpr *f, size_t n)
+{
+	size_t u;
+
+	/*
+	 * fpr is a uint64_t with FPEMU and a wrapped double otherwise;
+	 * both are 8 bytes holding the IEEE-754 encoding. We absorb it
+	 * in little-endian order.
+	 */
+	for (u = 0; u < n; u ++) {
+		uint64_t w;
+		uint8_t buf[8];
+		int i;
+
+		memcpy(&w, &f[u], sizeof w);
+		for (i = 0; i < 8; i ++) {
+			buf[i] = (uint8_t)(w >> (8 * i));
+		}
+		inner_shake256_inject(sc, buf, sizeof buf);
+	}
+}
+
+static void
+digest_u16(inner_shake256_context *sc, const uint16_t *x, size_t n)
+{
+	size_t u;
+
+	for (u = 0; u < n; u ++) {
+		uint8_t buf[2];
+
+		buf[0] = (uint8_t)x[u];
+		buf[1] = (uint8_t)(x[u] >> 8);
+		inner_shake256_inject(sc, buf, sizeof buf);
+	}
+}
+
+static void
+digest_print(inner_shake256_context *sc, const char *name)
+{
+	uint8_t out[32];
+	size_t u;
+
+	inner_shake256_flip(sc);
+	inner_shake256_extract(sc, out, sizeof out);
+	printf("%-8s ", name);
+	for (u = 0; u < sizeof out; u ++) {
+		printf("%02x", out[u]);
+	}
+	printf("\n");
+	fflush(stdout);
+}
+
+static void
+mk_rand_small(prng *p, int16_t *x, unsigned logn, int bound)
+{
+	size_t u, n;
+
+	n = (size_t)1 << logn;
+	for (u = 0; u < n; u ++) {
+		unsigned v;
+
+		v = prng_get_u8(p);
+		v = (v << 8) + prng_get_u8(p);
+		x[u] = (int16_t)((int)(v % (unsigned)(2 * bound + 1)) - bound);
+	}
+}
+
+static void
+digest_fft(const char *seed, uint8_t *tmp)
+{
+	inner_shake256_context sc;
+	prng p;
+	unsigned logn;
+
+	digest_init(&sc, &p, seed, "fft");
+	for (logn = 1; logn <= 10; logn ++) {
+		size_t n;
+		fpr *f, *g, *h, *d;
+		fpr third;
+		int i;
+
+		n = (size_t)1 << logn;
+		f = (fpr *)tmp;
+		g = f + n;
+		h = g + n;
+		d = h + n;
+		third = fpr_div(fpr_one, fpr_of(3));
+		for (i = 0; i < 16; i ++) {
+			mk_rand_poly(&p, f, logn);
+			mk_rand_poly(&p, g, logn);
+			Zf(poly_mulconst)(f, third, logn);
+			Zf(FFT)(f, logn);
+			Zf(FFT)(g, logn);
+			digest_fpr(&sc, f, n);
+			memcpy(h, f, n * sizeof *f);
+			Zf(poly_mul_fft)(h, g, logn);
+			digest_fpr(&sc, h, n);
+			Zf(poly_invnorm2_fft)(d, f, g, logn);
+			digest_fpr(&sc, d, n >> 1);
+			Zf(poly_div_fft)(h, f, logn);
+			digest_fpr(&sc, h, n);
+			Zf(iFFT)(h, logn);
+			digest_fpr(&sc, h, n);
+			memcpy(h, f, n * sizeof *f);
+			Zf(poly_mulselfadj_fft)(h, logn);
+			memcpy(d, g, n * sizeof *g);
+			Zf(poly_LDL_fft)(h, d, f, logn);
+			digest_fpr(&sc, d, n);
+			digest_fpr(&sc, f, n);
+		}
+	}
+	digest_print(&sc, "fft");
+}
+
+static void
+digest_ntt(const char *seed, uint8_t *tmp)
+{
+	inner_shake256_context sc;
+	prng p;
+	unsigned logn;
+
+	digest_init(&sc, &p, seed, "ntt");
+	for (logn = 1; logn <= 10; logn ++) {
+		size_t n, u;
+		uint16_t *h, *c0;
+		int16_t *s2, *s1;
+		int8_t *f, *g;
+		int i;
+
+		n = (size_t)1 << logn;
+		h = (uint16_t *)tmp;
+		c0 = h + n;
+		s2 = (int16_t *)(c0 + n);
+		f = (int8_t *)(s2 + n);
+		g = f + n;
+		s1 = (int16_t *)(g + n);
+		for (i = 0; i < 16; i ++) {
+			for (u = 0; u < n; u ++) {
+				h[u] = (uint16_t)(prng_get_u64(&p) % 12289);
+				c0[u] = (uint16_t)(prng_get_u64(&p) % 12289);
+			}
+			mk_rand_small(&p, s2, logn, 200);
+			Zf(to_ntt_monty)(h, logn);
+			digest_u16(&sc, h, n);
+			Zf(compute_s1)(s1, c0, s2, h, logn, (uint8_t *)(s1 + n));
+			digest_u16(&sc, (uint16_t *)s1, n);
+			for (u = 0; u < n; u ++) {
+				f[u] = (int8_t)((int)(prng_get_u8(&p) % 9) - 4);
+				g[u] = (int8_t)((int)(prng_get_u8(&p) % 9) - 4);
+			}
+			if (Zf(compute_public)(h, f, g, logn, (uint8_t *)s1)) {
+				digest_u16(&sc, h, n);
+			} else {
+				inner_shake256_inject(&sc, (const uint8_t *)"-", 1);
+			}
+		}
+	}
+	digest_print(&sc, "ntt");
+}
+
+static void
+digest_codec(const char *seed, uint8_t *tmp)
+{
+	inner_shake256_context sc;
+	prng p;
+	unsigned logn;
+
+	digest_init(&sc, &p, seed, "codec");
+	for (logn = 1; logn <= 10; logn ++) {
+		size_t n, u, len;
+		uint16_t *h;
+		int16_t *s;
+		int8_t *f;
+		uint8_t *buf;
+		size_t buf_len;
+		int i;
+
+		n = (size_t)1 << logn;
+		h = (uint16_t *)tmp;
+		s = (int16_t *)(h + n);
+		f = (int8_t *)(s + n);
+		buf = (uint8_t *)(f + n);
+		buf_len = 4 * n;
+		for (i = 0; i < 16; i ++) {
+			for (u = 0; u < n; u ++) {
+				h[u] = (uint16_t)(prng_get_u64(&p) % 12289);
+				f[u] = (int8_t)((int)(prng_get_u8(&p) % 63) - 31);
+			}
+			mk_rand_small(&p, s, logn, 300);
+
+			len = Zf(modq_encode)(buf, buf_len, h, logn);
+			inner_shake256_inject(&sc, buf, len);
+			len = Zf(modq_decode)(h, logn, buf, len);
+			digest_u16(&sc, h, n);
+
+			len = Zf(trim_i8_encode)(buf, buf_len, f, logn, 6);
+			inner_shake256_inject(&sc, buf, len);
+			len = Zf(trim_i8_decode)(f, logn, 6, buf, len);
+			inner_shake256_inject(&sc, (const uint8_t *)f, n);
+
+			len = Zf(comp_encode)(buf, buf_len, s, logn);
+			inner_shake256_inject(&sc, buf, len);
+			len = Zf(comp_decode)(s, logn, buf, len);
+			digest_u16(&sc, (uint16_t *)s, n);
+		}
+	}
+	digest_print(&sc, "codec");
+}
+
+static void
+digest_sampler(const char *seed)
+{
+	inner_shake256_context sc, rng;
+	sampler_context spc;
+	int i;
+
+	digest_init(&sc, NULL, seed, "sampler");
+	inner_shake256_init(&rng);
+	inner_shake256_inject(&rng, (const uint8_t *)seed, strlen(seed) + 1);
+	inner_shake256_inject(&rng, (const uint8_t *)"sampler", 8);
+	inner_shake256_flip(&rng);
+	Zf(prng_init)(&spc.p, &rng);
+	spc.sigma_min = fpr_sigma_min[10];
+	for (i = 0; i < 16384; i ++) {
+		int z;
+		uint8_t zb[2];
+
+		z = Zf(gaussian0_sampler)(&spc.p);
+		zb[0] = (uint8_t)z;
+		zb[1] = (uint8_t)(z >> 8);
+		inner_shake256_inject(&sc, zb, sizeof zb);
+	}
+	for (i = 0; i < 16384; i ++) {
+		fpr mu, isigma;
+		int z;
+		uint8_t zb[2];
+
+		mu = fpr_scaled((int64_t)(prng_get_u64(&spc.p) >> 40)
+			- ((int64_t)1 << 23), -16);
+		/*
+		 * sigma must stay within [sigma_min, sigma_max] (1.8205);
+		 * we use sigma_min + [0, 0.5).
+		 */
+		isigma = fpr_div(fpr_one, fpr_add(fpr_sigma_min[10],
+			fpr_scaled((int64_t)(prng_get_u64(&spc.p) >> 45), -20)));
+		z = Zf(sampler)(&spc, mu, isigma);
+		zb[0] = (uint8_t)z;
+		zb[1] = (uint8_t)(z >> 8);
+		inner_shake256_inject(&sc, zb, sizeof zb);
+	}
+	digest_print(&sc, "sampler");
+}
+
+static void
+digest_keygen_sign(const char *seed, uint8_t *tmp)
+{
+	inner_shake256_context sck, scs, rng;
+	unsigned logn;
+
+	digest_init(&sck, NULL, seed, "keygen");
+	digest_init(&scs, NULL, seed, "sign");
+	inner_shake256_init(&rng);
+	inner_shake256_inject(&rng, (const uint8_t *)seed, strlen(seed) + 1);
+	inner_shake256_inject(&rng, (const uint8_t *)"keygen", 7);
+	inner_shake256_flip(&rng);
+	for (logn = 1; logn <= 10; logn ++) {
+		size_t n;
+		int8_t *f, *g, *F, *G;
+		uint16_t *h, *hm;
+		int16_t *sig;
+		fpr *ek;
+		uint8_t *tt;
+		int i;
+
+		n = (size_t)1 << logn;
+		ek = (fpr *)tmp;
+		f = (int8_t *)tmp + ((8 * logn + 40) << logn);
+		g = f + n;
+		F = g + n;
+		G = F + n;
+		h = (uint16_t *)(G + n);
+		hm = h + n;
+		sig = (int16_t *)(hm + n);
+		tt = (uint8_t *)(sig + n);
+		tt += (8 - ((uintptr_t)tt & 7)) & 7;
+		for (i = 0; i < 4; i ++) {
+			uint8_t msg[50];
+			inner_shake256_context hc;
+
+			Zf(keygen)(&rng, f, g, F, G, h, logn, tt);
+			inner_shake256_inject(&sck, (const uint8_t *)f, 4 * n);
+			digest_u16(&sck, h, n);
+
+			inner_shake256_extract(&rng, msg, sizeof msg);
+			inner_shake256_init(&hc);
+			inner_shake256_inject(&hc, msg, sizeof msg);
+			inner_shake256_flip(&hc);
+			Zf(hash_to_point_vartime)(&hc, hm, logn);
+			Zf(sign_dyn)(sig, &rng, f, g, F, G, hm, logn, tt);
+			digest_u16(&scs, (uint16_t *)sig, n);
+			Zf(expand_privkey)(ek, f, g, F, G, logn, tt);
+			Zf(sign_tree)(sig, &rng, ek, hm, logn, tt);
+			digest_u16(&scs, (uint16_t *)sig, n);
+		}
+	}
+	digest_print(&sck, "keygen");
+	digest_print(&scs, "sign");
+}
+
+static void
+print_kernel_digests(const char *seed)
+{
+	uint8_t *tmp;
+
+	tmp = xmalloc(262144);
+	digest_fft(seed, tmp);
+	digest_ntt(seed, tmp);
+	digest_codec(seed, tmp);
+	digest_sampler(seed);
+	digest_keygen_sign(seed, tmp);
+	xfree(tmp);
+}
+
+static void
+test_nist_KAT_512(void)
+{
+	test_nist_KAT(9, "a57400cbaee7109358859a56c735a3cf048a9da2");
+}
+
+static void
+test_nist_KAT_1024(void)
+{
+	test_nist_KAT(10, "affdeb3aa83bf9a2039fa9c17d65fd3e3b9828e2");
+}
+
+/*
+ * All tests, in the order in which they run by default. Names can be
+ * given on the command line to run only a subset.
+ */
+static const struct {
+	const char *name;
+	void (*run)(void);
+} all_tests[] = {
+	{ "SHAKE256",          &test_SHAKE256 },
+	{ "codec",             &test_codec },
+	{ "vrfy",              &test_vrfy },
+	{ "mq_poly",           &test_mq_poly },
+	{ "RNG",               &test_RNG },
+	{ "FP_block",          &test_FP_block },
+	{ "poly",              &test_poly },
+	{ "gaussian0_sampler", &test_gaussian0_sampler },
+	{ "sampler",           &test_sampler },
+	{ "sign",              &test_sign },
+	{ "keygen",            &test_keygen },
+	{ "keygen_batch",      &test_keygen_batch },
+	{ "keygen_expanded",   &test_keygen_expanded },
+	{ "keygen_profile",    &test_keygen_profile },
+	{ "sign_lowmem",       &test_sign_lowmem },
+	{ "external_API",      &test_external_API },
+	{ "verify_prepared",   &test_verify_prepared },
+	{ "batch_ctx",         &test_batch_ctx },
+	{ "import_keys",       &test_import_keys },
+	{ "expanded_key_blob", &test_expanded_key_blob },
+	{ "sign_pipeline",     &test_sign_pipeline },
+	{ "nist_KAT_512",      &test_nist_KAT_512 },
+	{ "nist_KAT_1024",     &test_nist_KAT_1024 }
+};
+
+#define NUM_TESTS   (sizeof all_tests / sizeof all_tests[0])
+
+static void
+usage(void)
+{
+	size_t u;
+
+	fprintf(stderr,
+"usage: test_falcon [ name... ]\n"
+"       test_falcon -digest [ seed ]\n"
+"With no argument, all tests are run. Test names:\n");
+	for (u = 0; u < NUM_TESTS; u ++) {
+		fprintf(stderr, "   %s\n", all_tests[u].name);
+	}
+	fprintf(stderr,
+"'-digest' prints SHAKE256 digests of FFT, NTT, codec, sampler, keygen\n"
+"and sign outputs on inputs derived from 'seed', for cross-backend\n"
+"comparison.\n");
+	exit(EXIT_FAILURE);
+}
+
 int
-main(void)
+main(int argc, char *argv[])
 {
 	unsigned old;
+	size_t u;
+	int i;
+
+	if (argc >= 2 && strcmp(argv[1], "-digest") == 0) {
+		if (argc > 3) {
+			usage();
+		}
+		old = set_fpu_cw(2);
+		print_kernel_digests(argc == 3 ? argv[2] : "falcon");
+		set_fpu_cw(old);
+		return 0;
+	}
+	for (i = 1; i < argc; i ++) {
+		for (u = 0; u < NUM_TESTS; u ++) {
+			if (strcmp(argv[i], all_tests[u].name) == 0) {
+				break;
+			}
+		}
+		if (u == NUM_TESTS) {
+			usage();
+		}
+	}
 
 	old = set_fpu_cw(2);
 
-	test_SHAKE256();
-	test_codec();
-	test_vrfy();
-	test_RNG();
-	test_FP_block();
-	test_poly();
-	test_gaussian0_sampler();
-	test_sampler();
-	test_sign();
-	test_keygen();
-	test_external_API();
-	test_nist_KAT(9, "a57400cbaee7109358859a56c735a3cf048a9da2");
-	test_nist_KAT(10, "affdeb3aa83bf9a2039fa9c17d65fd3e3b9828e2");
+	if (argc < 2) {
+		for (u = 0; u < NUM_TESTS; u ++) {
+			all_tests[u].run();
+		}
+	} else {
+		for (i = 1; i < argc; i ++) {
+			for (u = 0; u < NUM_TESTS; u ++) {
+				if (strcmp(argv[i], all_tests[u].name) == 0) {
+					all_tests[u].run();
+				}
+			}
+		}
+	}
 	/* test_speed(); */
 
 	set_fpu_cw(old);
@@ -0,0 +1,386 @@
+/*
+ * Tests for the C++ API (falcon.hpp, falcon_async.hpp). Build with:
+ * make test_falcon_hpp
+ *
+ * ==========================(LICENSE BEGIN)============================
+ *
+ * Copyright (c) 2025  Falcon QONE WASM Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ===========================(LICENSE END)=============================
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "falcon.hpp"
+#include "falcon_async.hpp"
+
+#define CHECK(x)   do { \
+		if (!(x)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", \
+				__FILE__, __LINE__, #x); \
+			std::exit(EXIT_FAILURE); \
+		} \
+	} while (0)
+
+static_assert(falcon::Falcon512::pubkey_size == 897);
+static_assert(falcon::Falcon512::privkey_size == 1281);
+static_assert(falcon::Falcon1024::sig_compressed_max_size == 1462);
+static_assert(!std::is_copy_constructible_v<falcon::Falcon512::SigningKey>);
+static_assert(!std::is_copy_constructible_v<falcon::Falcon512::VerifyingKey>);
+static_assert(std::is_nothrow_move_constructible_v<
+	falcon::Falcon512::SigningKey>);
+
+static std::span<const std::uint8_t>
+bytes(const char *s)
+{
+	return { reinterpret_cast<const std::uint8_t *>(s), std::strlen(s) };
+}
+
+template<unsigned LOGN>
+static void
+test_degree()
+{
+	using F = falcon::Falcon<LOGN>;
+	static const std::uint8_t seed[] = { 'h', 'p', 'p', LOGN };
+	falcon::Rng rng(seed);
+	typename F::PrivateKey priv;
+	typename F::Signature sig;
+
+	std::printf("[%u]", LOGN);
+	std::fflush(stdout);
+
+	auto [sk, vk, pub] = F::generate(rng, &priv);
+	CHECK(F::public_key(priv) == pub);
+
+	/* The same key pair, through the C API. */
+	{
+		falcon::Rng rng2(seed);
+		typename F::PrivateKey priv2;
+		typename F::PublicKey pub2;
+		std::vector<std::uint8_t> tmp(FALCON_TMPSIZE_KEYGEN(LOGN));
+
+		CHECK(falcon_keygen_make(rng2.get(), LOGN,
+			priv2.data(), priv2.size(), pub2.data(), pub2.size(),
+			tmp.data(), tmp.size()) == 0);
+		CHECK(priv2 == priv && pub2 == pub);
+	}
+
+	for (auto type : { falcon::SigType::compressed,
+		falcon::SigType::padded, falcon::SigType::ct })
+	{
+		auto s = sk.sign(rng, bytes("data1"), sig, type);
+		std::vector<std::uint8_t> tmp(FALCON_TMPSIZE_VERIFY(LOGN));
+
+		CHECK(s.data() == sig.data());
+		CHECK(type != falcon::SigType::padded
+			|| s.size() == F::sig_padded_size);
+		CHECK(type != falcon::SigType::ct
+			|| s.size() == F::sig_ct_size);
+		CHECK(vk.verify(s, bytes("data1")));
+		CHECK(vk.verify(s, bytes("data1"), type));
+		CHECK(falcon_verify(s.data(), s.size(), 0,
+			pub.data(), pub.size(), "data1", 5,
+			tmp.data(), tmp.size()) == 0);
+		if (LOGN >= 5) {
+			CHECK(!vk.verify(s, bytes("data2")));
+		}
+		CHECK(!vk.verify(s.first(s.size() - 1), bytes("data1"),
+			falcon::SigType::ct));
+	}
+
+	/* Keys rebuilt from their encodings sign and verify alike. */
+	auto sk2 = F::SigningKey::from_private_key(priv);
+	auto vk2 = F::VerifyingKey::from_public_key(pub);
+	auto s = sk2.sign(rng, bytes("data3"), sig);
+	CHECK(vk2.verify(s, bytes("data3")) && vk.verify(s, bytes("data3")));
+
+	/* Moves keep the key; too short outputs are errors. */
+	typename F::SigningKey sk3 = std::move(sk2);
+	sk3 = std::move(sk);
+	CHECK(vk.verify(sk3.sign(rng, bytes("data4"), sig), bytes("data4")));
+	try {
+		sk3.sign(rng, bytes("data4"),
+			std::span<std::uint8_t>(sig).first(10));
+		CHECK(false);
+	} catch (const falcon::error &e) {
+		CHECK(e.code() == FALCON_ERR_SIZE);
+	}
+	pub[0] ^= 0x10;
+	try {
+		F::VerifyingKey::from_public_key(pub);
+		CHECK(false);
+	} catch (const falcon::error &e) {
+		CHECK(e.code() == FALCON_ERR_FORMAT);
+	}
+	std::printf(".");
+	std::fflush(stdout);
+}
+
+/*
+ * Shared keys, with each thread's own Rng and scratch buffer.
+ */
+static void
+test_threads()
+{
+	using F = falcon::Falcon512;
+	static const std::uint8_t seed[] = { 't' };
+	falcon::Rng rng(seed);
+	auto kp = F::generate(rng);
+	std::vector<std::thread> threads;
+	std::vector<int> ok(4, 0);
+
+	for (unsigned t = 0; t < ok.size(); t ++) {
+		threads.emplace_back([&, t] {
+			const std::uint8_t tseed[] = { 't', std::uint8_t(t) };
+			falcon::Rng trng(tseed);
+			F::Signature sig;
+			int good = 1;
+
+			for (int i = 0; i < 20; i ++) {
+				auto s = kp.signing_key.sign(trng,
+					bytes("threads"), sig);
+				good &= kp.verifying_key.verify(s,
+					bytes("threads"));
+			}
+			ok[t] = good;
+		});
+	}
+	for (auto &th : threads) {
+		th.join();
+	}
+	for (int good : ok) {
+		CHECK(good);
+	}
+	std::printf("[threads]");
+	std::fflush(stdout);
+}
+
+/*
+ * Fire-and-forget coroutine; *done is set when it returns.
+ */
+struct Task {
+	struct promise_type {
+		Task get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+/*
+ * Single-threaded event loop; its executor queues tasks from any thread.
+ */
+class Loop {
+public:
+	struct Executor {
+		Loop *loop;
+
+		template<typename F>
+		void execute(F &&f) const
+		{
+			{
+				std::lock_guard<std::mutex> lk(loop->mu_);
+				loop->tasks_.emplace_back(std::forward<F>(f));
+			}
+			loop->cv_.notify_one();
+		}
+	};
+
+	Executor executor() { return { this }; }
+
+	/* Run tasks on the calling thread until *done reaches n. */
+	void run(const int *done, int n)
+	{
+		std::unique_lock<std::mutex> lk(mu_);
+
+		while (*done < n) {
+			cv_.wait(lk, [this] { return !tasks_.empty(); });
+			auto f = std::move(tasks_.front());
+			tasks_.pop_front();
+			lk.unlock();
+			f();
+			lk.lock();
+		}
+	}
+
+private:
+	std::mutex mu_;
+	std::condition_variable cv_;
+	std::deque<std::function<void()>> tasks_;
+};
+
+static Task
+async_verify(falcon::ComputePool512 &pool, Loop::Executor ex,
+	const falcon::Falcon512::VerifyingKey &vk,
+	std::span<const std::uint8_t> sig, std::span<const std::uint8_t> msg,
+	bool expected, int *done)
+{
+	auto id = std::this_thread::get_id();
+	bool ok = co_await pool.verify(ex, vk, sig, msg);
+
+	CHECK(ok == expected);
+	CHECK(std::this_thread::get_id() == id);
+	++ *done;
+}
+
+static Task
+async_sign(falcon::ComputePool512 &pool, Loop::Executor ex,
+	const falcon::Falcon512::SigningKey &sk,
+	const falcon::Falcon512::VerifyingKey &vk,
+	std::span<std::uint8_t> out, falcon::SigType type, int *done)
+{
+	auto s = co_await pool.sign(ex, sk, bytes("async"), out, type);
+
+	CHECK(s.data() == out.data());
+	CHECK(type != falcon::SigType::ct
+		|| s.size() == falcon::Falcon512::sig_ct_size);
+	CHECK(vk.verify(s, bytes("async")));
+	CHECK(co_await pool.verify(ex, vk, s, bytes("async"), type));
+	try {
+		co_await pool.sign(ex, sk, bytes("async"), out.first(10));
+		CHECK(false);
+	} catch (const falcon::error &e) {
+		CHECK(e.code() == FALCON_ERR_SIZE);
+	}
+	++ *done;
+}
+
+static Task
+async_inline(falcon::ComputePool512 &pool,
+	const falcon::Falcon512::VerifyingKey &vk,
+	std::span<const std::uint8_t> sig, std::atomic<int> *done)
+{
+	auto id = std::this_thread::get_id();
+
+	CHECK(co_await pool.verify(vk, sig, bytes("inline")));
+	CHECK(std::this_thread::get_id() != id);
+	++ *done;
+}
+
+/*
+ * Coroutines on an event loop await verifications and signatures
+ * computed by a ComputePool; concurrent requests share batches.
+ */
+static void
+test_async()
+{
+	using F = falcon::Falcon512;
+	static const std::uint8_t seed[] = { 'a' };
+	falcon::Rng rng(seed);
+	F::KeyPair kp[2] = { F::generate(rng), F::generate(rng) };
+	std::vector<F::Signature> sigs(32);
+	std::vector<std::span<std::uint8_t>> s(sigs.size());
+	Loop loop;
+	int done;
+
+	for (std::size_t i = 0; i < sigs.size(); i ++) {
+		s[i] = kp[i & 1].signing_key.sign(rng, bytes("async"),
+			sigs[i]);
+	}
+
+	/* One batch of 32: all requests are made before it is due. */
+	{
+		falcon::ComputePool512 pool({ .threads = 4, .max_batch = 32,
+			.max_delay = std::chrono::seconds(10) });
+
+		done = 0;
+		for (std::size_t i = 0; i < sigs.size(); i ++) {
+			bool good = (i % 3) != 0;
+
+			async_verify(pool, loop.executor(),
+				kp[(i & 1) ^ !good].verifying_key,
+				s[i], bytes(i == 4 ? "other" : "async"),
+				good && i != 4, &done);
+		}
+		loop.run(&done, int(sigs.size()));
+		CHECK(pool.stats().batches == 1);
+		CHECK(pool.stats().requests == sigs.size());
+		CHECK(pool.threads() >= 1);
+	}
+
+	/* Signing with two keys and all signature types. */
+	{
+		falcon::ComputePool512 pool({ .threads = 3 }, seed);
+
+		done = 0;
+		for (std::size_t i = 0; i < 12; i ++) {
+			static const falcon::SigType types[] = {
+				falcon::SigType::compressed,
+				falcon::SigType::padded,
+				falcon::SigType::ct
+			};
+
+			async_sign(pool, loop.executor(),
+				kp[i & 1].signing_key, kp[i & 1].verifying_key,
+				sigs[i], types[i % 3], &done);
+		}
+		loop.run(&done, 12);
+		CHECK(pool.stats().requests == 36);
+	}
+
+	/* Without an executor, coroutines resume on the pool thread. */
+	{
+		falcon::ComputePool512 pool({ .threads = 1 });
+		auto si = kp[0].signing_key.sign(rng, bytes("inline"),
+			sigs[0]);
+		std::atomic<int> n = 0;
+
+		for (int i = 0; i < 4; i ++) {
+			async_inline(pool, kp[0].verifying_key, si, &n);
+		}
+		while (n < 4) {
+			std::this_thread::yield();
+		}
+	}
+	std::printf("[async]");
+	std::fflush(stdout);
+}
+
+int
+main()
+{
+	std::printf("Test C++ API: ");
+	std::fflush(stdout);
+	test_degree<1>();
+	test_degree<2>();
+	test_degree<5>();
+	test_degree<8>();
+	test_degree<9>();
+	test_degree<10>();
+	test_threads();
+	test_async();
+	std::printf(" done.\n");
+	return 0;
+}
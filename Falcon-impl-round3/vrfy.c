@@ -532,10 +532,12 @@ mq_NTT(uint16_t *a, unsigned logn)
 }
 
 /*
- * Compute the inverse NTT on a ring element, binary case.
+ * Compute the inverse NTT on a ring element, binary case, except for
+ * the final division by n; the value to multiply with (1/n, in
+ * Montgomery representation) is returned.
  */
-static void
-mq_iNTT(uint16_t *a, unsigned logn)
+static uint32_t
+mq_iNTT_partial(uint16_t *a, unsigned logn)
 {
 	size_t n, t, m;
 	uint32_t ni;
@@ -582,6 +584,20 @@ mq_iNTT(uint16_t *a, unsigned logn)
 	for (m = n; m > 1; m >>= 1) {
 		ni = mq_rshift1(ni);
 	}
+	return ni;
+}
+
+/*
+ * Compute the inverse NTT on a ring element, binary case.
+ */
+static void
+mq_iNTT(uint16_t *a, unsigned logn)
+{
+	size_t n, m;
+	uint32_t ni;
+
+	n = (size_t)1 << logn;
+	ni = mq_iNTT_partial(a, logn);
 	for (m = 0; m < n; m ++) {
 		a[m] = (uint16_t)mq_montymul(a[m], ni);
 	}
@@ -616,20 +632,6 @@ mq_poly_montymul_ntt(uint16_t *f, const uint16_t *g, unsigned logn)
 	}
 }
 
-/*
- * Subtract polynomial g from polynomial f.
- */
-static void
-mq_poly_sub(uint16_t *f, const uint16_t *g, unsigned logn)
-{
-	size_t u, n;
-
-	n = (size_t)1 << logn;
-	for (u = 0; u < n; u ++) {
-		f[u] = (uint16_t)mq_sub(f[u], g[u]);
-	}
-}
-
 /* ===================================================================== */
 
 /* see inner.h */
@@ -647,45 +649,112 @@ Zf(verify_raw)(const uint16_t *c0, const int16_t *s2,
 {
 	size_t u, n;
 	uint16_t *tt;
+	uint32_t sn, ng;
 
 	n = (size_t)1 << logn;
 	tt = (uint16_t *)tmp;
 
 	/*
-	 * Reduce s2 elements modulo q ([0..q-1] range).
+	 * Reduce s2 elements modulo q ([0..q-1] range), and compute
+	 * the squared norm of s2 in the same pass.
 	 */
+	sn = 0;
+	ng = 0;
 	for (u = 0; u < n; u ++) {
 		uint32_t w;
+		int32_t z;
 
-		w = (uint32_t)s2[u];
+		z = s2[u];
+		sn += (uint32_t)(z * z);
+		ng |= sn;
+		w = (uint32_t)z;
 		w += Q & -(w >> 31);
 		tt[u] = (uint16_t)w;
 	}
+	sn |= -(ng >> 31);
+
+	return Zf(verify_raw_modq)(c0, tt, sn, h, logn);
+}
+
+/* see inner.h */
+int
+Zf(verify_raw_modq)(const uint16_t *c0, uint16_t *s2, uint32_t sqn2,
+	const uint16_t *h, unsigned logn)
+{
+	size_t u, n;
+	uint32_t ni, sn, ng;
+
+	n = (size_t)1 << logn;
 
 	/*
-	 * Compute -s1 = s2*h - c0 mod phi mod q (in tt[]).
+	 * Compute -s1 = s2*h - c0 mod phi mod q (in s2[]).
 	 */
-	mq_NTT(tt, logn);
-	mq_poly_montymul_ntt(tt, h, logn);
-	mq_iNTT(tt, logn);
-	mq_poly_sub(tt, c0, logn);
+	mq_NTT(s2, logn);
+	mq_poly_montymul_ntt(s2, h, logn);
+	ni = mq_iNTT_partial(s2, logn);
 
 	/*
-	 * Normalize -s1 elements into the [-q/2..q/2] range.
+	 * Last pass of the inverse NTT (division by n), subtraction of
+	 * c0, normalization of -s1 into the [-q/2..q/2] range, and
+	 * squared norm, all at once.
 	 */
+	sn = 0;
+	ng = 0;
 	for (u = 0; u < n; u ++) {
 		int32_t w;
 
-		w = (int32_t)tt[u];
+		w = (int32_t)mq_sub(mq_montymul(s2[u], ni), c0[u]);
 		w -= (int32_t)(Q & -(((Q >> 1) - (uint32_t)w) >> 31));
-		((int16_t *)tt)[u] = (int16_t)w;
+		sn += (uint32_t)(w * w);
+		ng |= sn;
 	}
+	sn |= -(ng >> 31);
 
 	/*
 	 * Signature is valid if and only if the aggregate (-s1,s2) vector
 	 * is short enough.
 	 */
-	return Zf(is_short)((int16_t *)tt, s2, logn);
+	return Zf(is_short_sqn)(sn, sqn2, logn);
+}
+
+/* see inner.h */
+void
+Zf(compute_s1)(int16_t *s1, const uint16_t *c0, const int16_t *s2,
+	const uint16_t *h, unsigned logn, uint8_t *tmp)
+{
+	size_t u, n;
+	uint16_t *tt;
+
+	n = (size_t)1 << logn;
+	tt = (uint16_t *)tmp;
+
+	/*
+	 * Reduce s2 elements modulo q ([0..q-1] range).
+	 */
+	for (u = 0; u < n; u ++) {
+		uint32_t w;
+
+		w = (uint32_t)s2[u];
+		w += Q & -(w >> 31);
+		tt[u] = (uint16_t)w;
+	}
+
+	/*
+	 * Compute s1 = c0 - s2*h mod phi mod q.
+	 */
+	mq_NTT(tt, logn);
+	mq_poly_montymul_ntt(tt, h, logn);
+	mq_iNTT(tt, logn);
+	for (u = 0; u < n; u ++) {
+		int32_t w;
+
+		/*
+		 * Normalize into the [-q/2..q/2] range.
+		 */
+		w = (int32_t)mq_sub(c0[u], tt[u]);
+		w -= (int32_t)(Q & -(((Q >> 1) - (uint32_t)w) >> 31));
+		s1[u] = (int16_t)w;
+	}
 }
 
 /* see inner.h */
@@ -869,3 +938,100 @@ Zf(count_nttzero)(const int16_t *sig, unsigned logn, uint8_t *tmp)
 	}
 	return (int)r;
 }
+
+/* see inner.h */
+void
+Zf(mq_poly_ntt)(uint16_t *f, unsigned logn)
+{
+	mq_NTT(f, logn);
+}
+
+/* see inner.h */
+void
+Zf(mq_poly_intt)(uint16_t *f, unsigned logn)
+{
+	mq_iNTT(f, logn);
+}
+
+/* see inner.h */
+void
+Zf(mq_poly_add)(uint16_t *f, const uint16_t *g, unsigned logn)
+{
+	size_t u, n;
+
+	n = (size_t)1 << logn;
+	for (u = 0; u < n; u ++) {
+		f[u] = (uint16_t)mq_add(f[u], g[u]);
+	}
+}
+
+/* see inner.h */
+void
+Zf(mq_poly_sub)(uint16_t *f, const uint16_t *g, unsigned logn)
+{
+	size_t u, n;
+
+	n = (size_t)1 << logn;
+	for (u = 0; u < n; u ++) {
+		f[u] = (uint16_t)mq_sub(f[u], g[u]);
+	}
+}
+
+/* see inner.h */
+void
+Zf(mq_poly_mul_ntt)(uint16_t *f, const uint16_t *g, unsigned logn)
+{
+	size_t u, n;
+
+	/*
+	 * Montgomery multiplication by R^2 first, so that the second
+	 * one yields the plain product.
+	 */
+	n = (size_t)1 << logn;
+	for (u = 0; u < n; u ++) {
+		f[u] = (uint16_t)mq_montymul(mq_montymul(f[u], R2), g[u]);
+	}
+}
+
+/* see inner.h */
+void
+Zf(mq_poly_mul)(uint16_t *f, const uint16_t *g,
+	unsigned logn, uint8_t *tmp)
+{
+	size_t n;
+	uint16_t *tt;
+
+	n = (size_t)1 << logn;
+	tt = (uint16_t *)tmp;
+	memcpy(tt, g, n * sizeof *g);
+	Zf(to_ntt_monty)(tt, logn);
+	Zf(mq_poly_mul_public)(f, tt, logn);
+}
+
+/* see inner.h */
+void
+Zf(mq_poly_mul_public)(uint16_t *f, const uint16_t *h, unsigned logn)
+{
+	mq_NTT(f, logn);
+	mq_poly_montymul_ntt(f, h, logn);
+	mq_iNTT(f, logn);
+}
+
+/* see inner.h */
+uint64_t
+Zf(mq_poly_sqnorm)(const uint16_t *f, unsigned logn)
+{
+	size_t u, n;
+	uint64_t s;
+
+	n = (size_t)1 << logn;
+	s = 0;
+	for (u = 0; u < n; u ++) {
+		int32_t w;
+
+		w = (int32_t)f[u];
+		w -= (int32_t)Q & -(int32_t)((uint32_t)((Q >> 1) - w) >> 31);
+		s += (uint64_t)((uint32_t)(w * w));
+	}
+	return s;
+}
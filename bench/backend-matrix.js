@@ -0,0 +1,278 @@
+#!/usr/bin/env node
+/**
+ * Cross-backend differential test and benchmark matrix.
+ *
+ * Builds the upstream test_falcon and speed programs once per backend
+ * (config.h macro combination), then for each backend:
+ *   1. runs the KATs from test_falcon.c (keygen, sign, external_API and
+ *      the NIST KAT hashes for Falcon-512/1024);
+ *   2. runs `test_falcon -digest <seed>` for several seeds and compares
+ *      the FFT, NTT, codec, sampler, keygen and sign digests with the
+ *      reference backend (FPEMU, i.e. bit-exact IEEE-754 emulation);
+ *   3. runs `speed -json` and collects a per-backend speed table.
+ *
+ * The wasm-relaxed backend uses f64x2.relaxed_madd (FALCON_WASM_RELAXED);
+ * comparing its speed row with wasm-simd128 measures the FMA gain.
+ *
+ * Usage: node bench/backend-matrix.js [options]
+ *   --backends a,b,...   subset of backends (default: all)
+ *   --seeds N            number of random digest seeds (default: 3)
+ *   --threshold T        speed threshold in seconds (default: 0.5)
+ *   --no-speed           skip benchmarks
+ *
+ * Environment: CC (default: cc) and CFLAGS (default: -O3) for native
+ * backends. WASM backends are built with `build.sh tools` and are skipped
+ * when emcc is not in PATH. Full results go to bench/results/matrix.json.
+ *
+ * Exits with a non-zero status if any KAT fails or any digest differs
+ * from the reference, except FFT digests on FMA backends: fused
+ * multiply-add rounds differently by design, and only the keygen/sign
+ * outputs (which must still match) are required to be identical.
+ */
+
+import { spawnSync } from 'child_process';
+import { mkdirSync, writeFileSync, existsSync } from 'fs';
+import { randomBytes } from 'crypto';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+const ROOT = join(dirname(fileURLToPath(import.meta.url)), '..');
+const SRC = join(ROOT, 'Falcon-impl-round3');
+const OUT = join(ROOT, '_matrix');
+const RESULTS = join(ROOT, 'bench', 'results');
+
+const CORE = ['codec', 'common', 'falcon', 'fft', 'fpr', 'keygen',
+  'rng', 'shake', 'sign', 'vrfy'];
+const KATS = ['keygen', 'sign', 'external_API', 'nist_KAT_512', 'nist_KAT_1024'];
+
+const BACKENDS = [
+  { name: 'fpemu', kind: 'native', cflags: ['-DFALCON_FPEMU=1'] },
+  { name: 'scalar', kind: 'native',
+    cflags: ['-DFALCON_FPNATIVE=1', '-DFALCON_AVX2=0', '-DFALCON_FMA=0'] },
+  { name: 'avx2', kind: 'native', arch: 'x64',
+    cflags: ['-DFALCON_FPNATIVE=1', '-DFALCON_AVX2=1', '-DFALCON_FMA=0'] },
+  { name: 'avx2-fma', kind: 'native', arch: 'x64', fma: true,
+    cflags: ['-DFALCON_FPNATIVE=1', '-DFALCON_AVX2=1', '-DFALCON_FMA=1'] },
+  { name: 'wasm', kind: 'wasm', cflags: [] },
+  { name: 'wasm-simd128', kind: 'wasm',
+    cflags: ['-msimd128', '-DFALCON_WASM_SIMD=1'] },
+  { name: 'wasm-relaxed', kind: 'wasm', fma: true, relaxed: true,
+    cflags: ['-msimd128', '-DFALCON_WASM_SIMD=1',
+      '-mrelaxed-simd', '-DFALCON_WASM_RELAXED=1'] },
+];
+
+const REFERENCE = 'fpemu';
+const FP_KERNELS = ['fft'];
+// Speed columns reported in milliseconds in the table
+const MS_OPS = new Set(['kg', 'kgs', 'kxs']);
+
+function parseArgs(argv) {
+  const opts = { backends: null, seeds: 3, threshold: 0.5, speed: true };
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case '--backends': opts.backends = argv[++i].split(','); break;
+      case '--seeds': opts.seeds = parseInt(argv[++i], 10); break;
+      case '--threshold': opts.threshold = parseFloat(argv[++i]); break;
+      case '--no-speed': opts.speed = false; break;
+      default:
+        console.error(`unknown option: ${argv[i]}`);
+        process.exit(2);
+    }
+  }
+  return opts;
+}
+
+function run(cmd, args, options = {}) {
+  const r = spawnSync(cmd, args, { encoding: 'utf8', maxBuffer: 64 << 20, ...options });
+  return { ok: r.status === 0, status: r.status, signal: r.signal,
+    stdout: r.stdout || '', stderr: (r.stderr || '') + (r.error ? r.error.message : '') };
+}
+
+function hasCommand(cmd) {
+  return run('sh', ['-c', `command -v ${cmd}`]).ok;
+}
+
+function buildNative(b, dir) {
+  const cc = process.env.CC || 'cc';
+  const cflags = (process.env.CFLAGS || '-O3').split(/\s+/).filter(Boolean);
+  const objs = [];
+  for (const name of [...CORE, 'test_falcon', 'speed']) {
+    const obj = join(dir, `${name}.o`);
+    const r = run(cc, [...cflags, ...b.cflags, '-c', '-o', obj, join(SRC, `${name}.c`)]);
+    if (!r.ok) return r;
+    objs.push(obj);
+  }
+  const core = objs.slice(0, CORE.length);
+  for (const [i, tool] of ['test_falcon', 'speed'].entries()) {
+    const r = run(cc, ['-o', join(dir, tool), objs[CORE.length + i], ...core, '-lm']);
+    if (!r.ok) return r;
+  }
+  return { ok: true };
+}
+
+function buildWasm(b, dir) {
+  return run('bash', [join(ROOT, 'build.sh'), 'tools'], {
+    cwd: ROOT,
+    env: { ...process.env, TOOLS_DIR: dir, EXTRA_CFLAGS: b.cflags.join(' ') },
+  });
+}
+
+// Node.js flags needed for relaxed-SIMD, or null if unsupported.
+function relaxedSimdFlags() {
+  const probe = 'process.exit(WebAssembly.validate(new Uint8Array(['
+    + '0,97,115,109,1,0,0,0,1,5,1,96,0,1,123,3,2,1,0,10,19,1,17,0,65,0,253,15,'
+    + '65,0,253,15,65,0,253,15,253,135,2,11])) ? 0 : 1)';
+  for (const flags of [[], ['--experimental-wasm-relaxed-simd']]) {
+    if (run('node', [...flags, '-e', probe]).ok) return flags;
+  }
+  return null;
+}
+
+function tool(b, dir, name, args) {
+  return b.kind === 'wasm'
+    ? run('node', [...(b.nodeFlags || []), join(dir, `${name}.js`), ...args])
+    : run(join(dir, name), args);
+}
+
+function parseDigests(text) {
+  const d = {};
+  for (const line of text.trim().split('\n')) {
+    const [k, v] = line.trim().split(/\s+/);
+    if (k && v) d[k] = v;
+  }
+  return d;
+}
+
+function main() {
+  const opts = parseArgs(process.argv.slice(2));
+  const seeds = ['falcon'];
+  for (let i = 0; i < opts.seeds; i++) seeds.push(randomBytes(8).toString('hex'));
+
+  let selected = BACKENDS;
+  if (opts.backends) {
+    selected = BACKENDS.filter((b) => opts.backends.includes(b.name));
+    const missing = opts.backends.filter((n) => !BACKENDS.some((b) => b.name === n));
+    if (missing.length) {
+      console.error(`unknown backend(s): ${missing.join(', ')}`);
+      process.exit(2);
+    }
+  }
+  // The reference is always needed for the differential comparison.
+  if (!selected.some((b) => b.name === REFERENCE)) {
+    selected = [BACKENDS.find((b) => b.name === REFERENCE), ...selected];
+  }
+
+  const haveEmcc = hasCommand('emcc');
+  const results = [];
+  let failed = false;
+
+  for (const b of selected) {
+    const res = { backend: b.name, status: 'ok', kats: {}, digests: {}, speed: null };
+    results.push(res);
+    if (b.arch && b.arch !== process.arch) { res.status = `skipped (needs ${b.arch})`; continue; }
+    if (b.kind === 'wasm' && !haveEmcc) { res.status = 'skipped (no emcc)'; continue; }
+    if (b.relaxed) {
+      b.nodeFlags = relaxedSimdFlags();
+      if (!b.nodeFlags) { res.status = 'skipped (no relaxed-SIMD in node)'; continue; }
+    }
+
+    const dir = join(OUT, b.name);
+    mkdirSync(dir, { recursive: true });
+    process.stdout.write(`[${b.name}] build... `);
+    const built = b.kind === 'wasm' ? buildWasm(b, dir) : buildNative(b, dir);
+    if (!built.ok) {
+      res.status = 'build failed';
+      res.error = built.stderr.trim();
+      failed = true;
+      console.log('FAILED');
+      continue;
+    }
+
+    process.stdout.write('KAT... ');
+    const kat = tool(b, dir, 'test_falcon', KATS);
+    if (kat.signal === 'SIGILL') {
+      res.status = 'skipped (unsupported CPU)';
+      console.log('SIGILL');
+      continue;
+    }
+    for (const name of KATS) res.kats[name] = kat.ok;
+    if (!kat.ok) {
+      res.status = 'KAT failed';
+      res.error = kat.stderr.trim();
+      failed = true;
+    }
+
+    process.stdout.write('digest... ');
+    for (const seed of seeds) {
+      const r = tool(b, dir, 'test_falcon', ['-digest', seed]);
+      res.digests[seed] = r.ok ? parseDigests(r.stdout) : null;
+      if (!r.ok) { res.status = 'digest failed'; failed = true; }
+    }
+
+    if (opts.speed && res.status === 'ok') {
+      process.stdout.write('speed... ');
+      const r = tool(b, dir, 'speed', ['-json', String(opts.threshold)]);
+      if (r.ok) res.speed = JSON.parse(r.stdout);
+    }
+    console.log(res.status === 'ok' ? 'done' : res.status);
+  }
+
+  // Differential comparison against the reference backend.
+  const ref = results.find((r) => r.backend === REFERENCE);
+  for (const res of results) {
+    res.diff = {};
+    if (!res.digests || res === ref || !Object.keys(res.digests).length) continue;
+    for (const seed of seeds) {
+      const a = ref.digests[seed], d = res.digests[seed];
+      if (!a || !d) continue;
+      for (const k of Object.keys(a)) {
+        if (a[k] === d[k]) continue;
+        const backend = BACKENDS.find((b) => b.name === res.backend);
+        const tolerated = backend.fma && FP_KERNELS.includes(k);
+        res.diff[k] = tolerated ? 'fma' : 'MISMATCH';
+        if (!tolerated) { res.status = 'digest mismatch'; failed = true; }
+      }
+    }
+  }
+
+  // Report.
+  const kernels = ref && ref.digests[seeds[0]] ? Object.keys(ref.digests[seeds[0]]) : [];
+  console.log('');
+  console.log(`Differential test vs ${REFERENCE} (${seeds.length} seeds)`);
+  console.log('backend'.padEnd(14) + 'KAT'.padEnd(6) + kernels.map((k) => k.padEnd(9)).join(''));
+  for (const res of results) {
+    if (!Object.keys(res.kats).length) {
+      console.log(res.backend.padEnd(14) + res.status);
+      continue;
+    }
+    const kat = Object.values(res.kats).every(Boolean) ? 'ok' : 'FAIL';
+    const cells = kernels.map((k) =>
+      (res === ref ? 'ref' : res.diff[k] || 'same').padEnd(9));
+    console.log(res.backend.padEnd(14) + kat.padEnd(6) + cells.join(''));
+  }
+
+  const timed = results.filter((r) => r.speed);
+  if (timed.length) {
+    const ops = Object.keys(timed[0].speed.results[0]).filter((k) => k !== 'degree');
+    for (const degree of timed[0].speed.results.map((r) => r.degree)) {
+      console.log('');
+      console.log(`Speed, degree ${degree} (us; kg, kgs and kxs in ms)`);
+      console.log('backend'.padEnd(14) + ops.map((op) => op.padStart(9)).join(''));
+      for (const res of timed) {
+        const row = res.speed.results.find((r) => r.degree === degree);
+        const cells = ops.map((op) =>
+          (MS_OPS.has(op) ? row[op] / 1000 : row[op]).toFixed(MS_OPS.has(op) ? 2 : 1).padStart(9));
+        console.log(res.backend.padEnd(14) + cells.join(''));
+      }
+    }
+  }
+
+  if (!existsSync(RESULTS)) mkdirSync(RESULTS, { recursive: true });
+  writeFileSync(join(RESULTS, 'matrix.json'),
+    JSON.stringify({ seeds, reference: REFERENCE, results }, null, 2) + '\n');
+  console.log('');
+  console.log('Wrote bench/results/matrix.json');
+  process.exit(failed ? 1 : 0);
+}
+
+main();
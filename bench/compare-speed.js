@@ -0,0 +1,43 @@
+#!/usr/bin/env node
+/**
+ * Compare two `speed -json` outputs (e.g. native vs WASM).
+ *
+ * Usage: node bench/compare-speed.js <baseline.json> <candidate.json>
+ *
+ * Prints one row per degree with candidate/baseline time ratios for each
+ * operation (> 1.00 means the candidate is slower).
+ */
+
+import { readFileSync } from 'fs';
+
+function load(path) {
+  const data = JSON.parse(readFileSync(path, 'utf8'));
+  if (!Array.isArray(data.results)) {
+    throw new Error(`${path}: not a speed -json output`);
+  }
+  return data;
+}
+
+const [basePath, candPath] = process.argv.slice(2);
+if (!basePath || !candPath) {
+  console.error('usage: node bench/compare-speed.js <baseline.json> <candidate.json>');
+  process.exit(1);
+}
+
+const base = load(basePath);
+const cand = load(candPath);
+const ops = Object.keys(base.results[0]).filter((k) => k !== 'degree');
+
+console.log(`baseline:  ${base.platform} (${basePath})`);
+console.log(`candidate: ${cand.platform} (${candPath})`);
+console.log('ratios are candidate time / baseline time');
+console.log('');
+console.log('degree' + ops.map((op) => op.padStart(8)).join(''));
+
+for (const row of cand.results) {
+  const ref = base.results.find((r) => r.degree === row.degree);
+  if (!ref) continue;
+  const cells = ops.map((op) =>
+    (op in row && ref[op] > 0 ? (row[op] / ref[op]).toFixed(2) : '-').padStart(8));
+  console.log(`${String(row.degree).padStart(4)}:${cells.join('')}`);
+}
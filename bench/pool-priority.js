@@ -0,0 +1,53 @@
+#!/usr/bin/env node
+/**
+ * Latency of interactive signatures while a worker pool is busy with bulk
+ * verification, with the default priority classes and with a single FIFO
+ * class (every call in one queue, same bulk batch size).
+ *
+ * Usage: node bench/pool-priority.js [workers] [bulk-verifications]
+ *
+ * Requires the `./build.sh` output in dist/.
+ */
+
+import { Falcon512 } from '../src/falcon.js';
+import { FalconPool } from '../src/falcon-pool.js';
+
+const workers = parseInt(process.argv[2] || '4', 10);
+const bulkCount = parseInt(process.argv[3] || '4000', 10);
+const interactiveCount = 50;
+
+const falcon = await Falcon512.load();
+const { publicKey, privateKey } = falcon.createKeypairFromSeed(new Uint8Array(48).fill(1));
+const message = new TextEncoder().encode('bulk message');
+const signature = falcon.signMessage(message, privateKey, new Uint8Array(48).fill(2));
+const jobs = Array.from({ length: bulkCount }, () => ({ message, signature, publicKey }));
+
+const sleep = (ms) => new Promise((r) => setTimeout(r, ms));
+
+async function run(label, classes, interactiveClass, bulkClass) {
+  const pool = await FalconPool.create({ size: workers, classes });
+  const t0 = performance.now();
+  const bulk = pool.verifyMany(jobs, { priority: bulkClass }).then(() => performance.now() - t0);
+
+  // Interactive calls arrive while the bulk queue drains
+  const latencies = [];
+  for (let i = 0; i < interactiveCount; i++) {
+    const t = performance.now();
+    await pool.sign(message, privateKey, { priority: interactiveClass });
+    latencies.push(performance.now() - t);
+    await sleep(5);
+  }
+  const bulkMs = await bulk;
+  await pool.close();
+
+  latencies.sort((a, b) => a - b);
+  const p = (q) => latencies[Math.min(latencies.length - 1, Math.floor(q * latencies.length))];
+  console.log(`${label.padEnd(12)}${p(0.5).toFixed(1).padStart(10)}${p(0.95).toFixed(1).padStart(10)}`
+    + `${(bulkCount / bulkMs * 1000).toFixed(0).padStart(14)}`);
+}
+
+console.log(`workers: ${workers}, bulk verifications: ${bulkCount}, interactive signatures: ${interactiveCount}`);
+console.log('');
+console.log('scheduler    p50(ms)   p95(ms)  bulk(verif/s)');
+await run('priority', undefined, 'interactive', 'bulk');
+await run('fifo', { all: { priority: 0, maxBatch: 32 } }, 'all', 'all');
@@ -0,0 +1,47 @@
+#!/usr/bin/env node
+/**
+ * Verification rate through shared-memory rings (FalconIngest) and through
+ * postMessage batches (FalconPool.verifyMany), with the same number of
+ * workers.
+ *
+ * Usage: node bench/ring-ingest.js [workers] [verifications]
+ *
+ * Requires the `./build.sh` output in dist/.
+ */
+
+import { Falcon512 } from '../src/falcon.js';
+import { FalconPool } from '../src/falcon-pool.js';
+import { FalconIngest } from '../src/falcon-ring.js';
+
+const workers = parseInt(process.argv[2] || '4', 10);
+const count = parseInt(process.argv[3] || '20000', 10);
+
+const falcon = await Falcon512.load();
+const { publicKey, privateKey } = falcon.createKeypairFromSeed(new Uint8Array(48).fill(1));
+const message = new TextEncoder().encode('ingest message');
+const signature = falcon.signMessage(message, privateKey, new Uint8Array(48).fill(2));
+const jobs = Array.from({ length: count }, () => ({ message, signature, publicKey }));
+
+async function report(label, fn) {
+  const t0 = performance.now();
+  const results = await fn();
+  const ms = performance.now() - t0;
+  if (!results.every((ok) => ok)) {
+    throw new Error(`${label}: verification failed`);
+  }
+  console.log(`${label.padEnd(12)}${ms.toFixed(0).padStart(10)}${(count / ms * 1000).toFixed(0).padStart(12)}`);
+}
+
+console.log(`workers: ${workers}, verifications: ${count}`);
+console.log('');
+console.log('path          time(ms)     verif/s');
+
+const pool = await FalconPool.create({ size: workers, classes: { all: { priority: 0, maxBatch: 32 } } });
+await report('pool', () => pool.verifyMany(jobs, { priority: 'all' }));
+await pool.close();
+
+const ingest = await FalconIngest.create({ workers });
+await report('ring', () => Promise.all(jobs.map((j) => ingest.verify(j.message, j.signature, j.publicKey))));
+console.log('');
+console.log('ring stats:', ingest.stats());
+await ingest.close();
@@ -0,0 +1,67 @@
+#!/usr/bin/env node
+/**
+ * Benchmark the baseline, SIMD128 and relaxed-SIMD module builds through
+ * the JavaScript API, and check that they produce identical signatures.
+ *
+ * Usage: node bench/simd-variants.js [iterations]
+ *
+ * Requires `./build.sh lib simd` outputs in dist/. Relaxed-SIMD needs a
+ * recent engine; on Node.js 20 run with --experimental-wasm-relaxed-simd.
+ */
+
+import { Falcon512, detectWasmFeatures } from '../src/falcon.js';
+
+const iterations = parseInt(process.argv[2] || '200', 10);
+const seed = new Uint8Array(48).map((_, i) => i);
+const rngSeed = new Uint8Array(48).map((_, i) => 255 - i);
+const messages = Array.from({ length: iterations },
+  (_, i) => new TextEncoder().encode(`message ${i}`));
+
+function time(fn) {
+  const t0 = process.hrtime.bigint();
+  fn();
+  return Number(process.hrtime.bigint() - t0) / 1000 / iterations;
+}
+
+console.log('features:', detectWasmFeatures());
+console.log(`iterations: ${iterations}`);
+console.log('');
+console.log('variant     sign(us)  verify(us)  signatures');
+
+let reference = null;
+let failed = false;
+for (const variant of ['baseline', 'simd', 'relaxed']) {
+  let falcon;
+  try {
+    falcon = await Falcon512.load({ variant });
+  } catch (e) {
+    console.log(`${variant.padEnd(10)}  not available (${e.code || e.message})`);
+    continue;
+  }
+  const { publicKey, privateKey } = falcon.createKeypairFromSeed(seed);
+
+  // Warm up, then time; signing uses a fixed RNG seed so that outputs
+  // can be compared across builds.
+  falcon.signMessage(messages[0], privateKey, rngSeed);
+  const sigs = [];
+  const signUs = time(() => {
+    for (const m of messages) sigs.push(falcon.signMessage(m, privateKey, rngSeed));
+  });
+  const verifyUs = time(() => {
+    for (let i = 0; i < iterations; i++) {
+      if (!falcon.verifySignature(messages[i], sigs[i], publicKey)) failed = true;
+    }
+  });
+
+  let same = 'reference';
+  if (reference === null) {
+    reference = sigs;
+  } else {
+    const diff = sigs.filter((s, i) => Buffer.compare(s, reference[i]) !== 0).length;
+    same = diff === 0 ? 'identical' : `${diff} differ`;
+    if (diff !== 0) failed = true;
+  }
+  console.log(`${variant.padEnd(10)}${signUs.toFixed(1).padStart(10)}${verifyUs.toFixed(1).padStart(12)}  ${same}`);
+}
+
+process.exit(failed ? 1 : 0);
@@ -1,6 +1,9 @@
 @echo off
 REM Build script for Falcon-512 WebAssembly module (Windows)
 REM Requires Emscripten SDK (emcc) to be installed and in PATH
+REM Usage: build.bat [tools]  - "tools" builds upstream speed/test_falcon and bench_kernels for Node.js
+
+if /I "%~1"=="tools" goto tools
 
 echo Building Falcon-512 WebAssembly module...
 
@@ -8,7 +11,7 @@ REM Create dist directory if it doesn't exist
 if not exist "dist" mkdir dist
 
 REM Compiler flags and source files
-set CFLAGS=-O3 -flto -I./Falcon-impl-round3 -DFALCON_FPEMU=0 -DFALCON_FPNATIVE=1
+set CFLAGS=-O3 -flto -I./Falcon-impl-round3 -DFALCON_FPEMU=0 -DFALCON_FPNATIVE=1 -DFALCON_RAND_GETENTROPY=1
 
 set EMFLAGS=-s WASM=1 -s ALLOW_MEMORY_GROWTH=1 -s "EXPORTED_RUNTIME_METHODS=['cwrap','ccall','getValue','setValue']" -s MODULARIZE=1 -s EXPORT_ES6=1 -s "EXPORT_NAME=createFalconModule" -s TOTAL_MEMORY=16777216 -s STACK_SIZE=1048576 --no-entry
 
@@ -29,3 +32,36 @@ if %ERRORLEVEL% EQU 0 (
     echo Build failed!
     exit /b 1
 )
+exit /b 0
+
+:tools
+echo Building upstream tools for Node.js...
+if not exist "dist\tools" mkdir dist\tools
+echo { "type": "commonjs" } > dist\tools\package.json
+
+set CFLAGS=-O3 -flto -I./Falcon-impl-round3 -DFALCON_FPEMU=0 -DFALCON_FPNATIVE=1 -DFALCON_RAND_GETENTROPY=1
+set TOOL_EMFLAGS=-s WASM=1 -s ALLOW_MEMORY_GROWTH=1 -s ENVIRONMENT=node -s EXIT_RUNTIME=1 -s TOTAL_MEMORY=16777216 -s STACK_SIZE=1048576
+set FALCON_SOURCES=Falcon-impl-round3/codec.c Falcon-impl-round3/common.c Falcon-impl-round3/falcon.c Falcon-impl-round3/fft.c Falcon-impl-round3/fpr.c Falcon-impl-round3/keygen.c Falcon-impl-round3/rng.c Falcon-impl-round3/shake.c Falcon-impl-round3/sign.c Falcon-impl-round3/vrfy.c
+
+for %%T in (speed test_falcon) do (
+    echo Compiling %%T with emcc...
+    call emcc %CFLAGS% %TOOL_EMFLAGS% %FALCON_SOURCES% Falcon-impl-round3/%%T.c -o dist/tools/%%T.js
+    if errorlevel 1 (
+        echo Build failed!
+        exit /b 1
+    )
+)
+
+REM bench_kernels.c includes shake.c and vrfy.c (for their static kernels)
+set KERNEL_SOURCES=Falcon-impl-round3/codec.c Falcon-impl-round3/common.c Falcon-impl-round3/falcon.c Falcon-impl-round3/fft.c Falcon-impl-round3/fpr.c Falcon-impl-round3/keygen.c Falcon-impl-round3/rng.c Falcon-impl-round3/sign.c
+echo Compiling bench_kernels with emcc...
+call emcc %CFLAGS% %TOOL_EMFLAGS% %KERNEL_SOURCES% Falcon-impl-round3/bench_kernels.c -o dist/tools/bench_kernels.js
+if errorlevel 1 (
+    echo Build failed!
+    exit /b 1
+)
+echo Build complete!
+echo Output files:
+echo   - dist/tools/speed.js, dist/tools/speed.wasm
+echo   - dist/tools/test_falcon.js, dist/tools/test_falcon.wasm
+echo   - dist/tools/bench_kernels.js, dist/tools/bench_kernels.wasm
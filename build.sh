@@ -2,10 +2,29 @@
 
 # Build script for Falcon-512 WebAssembly module
 # Requires Emscripten SDK (emcc) to be installed and in PATH
+#
+# Usage: ./build.sh [lib|simd|lowmem|standalone|tools|all]
+#   lib    - dist/falcon.js + dist/falcon.wasm (default)
+#   simd   - dist/falcon-simd.* (SIMD128) and dist/falcon-relaxed.* (SIMD128 +
+#            relaxed-SIMD FMA); Falcon512.load() picks one at runtime
+#   lowmem - dist/falcon-lowmem.*: small initial memory and stack, low-memory
+#            signing mode; Falcon512.load({ variant: 'lowmem' })
+#   standalone - dist/falcon-standalone.wasm only: no imports, no Emscripten
+#            glue; loaded by src/falcon-standalone.js (edge runtimes)
+#   tools  - upstream speed and test_falcon programs, and bench_kernels, for
+#            Node.js, in dist/tools/
+#   all    - all of the above
+#
+# Environment: EXTRA_CFLAGS is appended to CFLAGS; TOOLS_DIR overrides
+# dist/tools/ for the tools target.
 
 set -e
 
-echo "Building Falcon-512 WebAssembly module..."
+TARGET="${1:-lib}"
+case "$TARGET" in
+    lib|simd|lowmem|standalone|tools|all) ;;
+    *) echo "Unknown target: $TARGET (expected lib, simd, lowmem, standalone, tools or all)" >&2; exit 1 ;;
+esac
 
 # Create dist directory if it doesn't exist
 mkdir -p dist
@@ -34,7 +53,16 @@ CFLAGS=(
     "-I./Falcon-impl-round3"       # Include path for Falcon headers
     "-DFALCON_FPEMU=0"             # Use native floating point (faster in WASM)
     "-DFALCON_FPNATIVE=1"
+    "-DFALCON_RAND_GETENTROPY=1"   # Emscripten maps getentropy() to crypto.getRandomValues
 )
+# Extra flags from the environment (e.g. EXTRA_CFLAGS=-msimd128)
+if [ -n "$EXTRA_CFLAGS" ]; then
+    read -r -a EXTRA <<< "$EXTRA_CFLAGS"
+    CFLAGS+=("${EXTRA[@]}")
+fi
+
+# Output directory for the tools target
+TOOLS_DIR="${TOOLS_DIR:-dist/tools}"
 
 # Emscripten-specific flags
 EMFLAGS=(
@@ -44,19 +72,167 @@ EMFLAGS=(
     -s MODULARIZE=1                                # Export as ES6 module
     -s EXPORT_ES6=1                                # ES6 module format
     -s "EXPORT_NAME=createFalconModule"            # Module factory name
+    --no-entry                                     # No main() function
+)
+
+# Memory profile of the library builds
+MEMFLAGS=(
     -s TOTAL_MEMORY=16777216                       # Initial memory: 16MB
     -s STACK_SIZE=1048576                          # Stack size: 1MB
-    --no-entry                                     # No main() function
 )
 
-# Build command
-echo "Compiling with emcc..."
-emcc "${CFLAGS[@]}" "${EMFLAGS[@]}" \
-    "${FALCON_SOURCES[@]}" \
-    "$WRAPPER_SOURCE" \
-    -o dist/falcon.js
+# Memory profile of the lowmem build: the largest stack frame is about
+# 28kB (key generation with expanded key, or signing in low-memory mode);
+# the heap grows from there on demand
+LOWMEM_MEMFLAGS=(
+    -s TOTAL_MEMORY=524288                         # Initial memory: 512kB
+    -s STACK_SIZE=65536                            # Stack size: 64kB
+    -s MALLOC=emmalloc                             # Smaller allocator
+)
+LOWMEM_CFLAGS=("-DFALCON_WASM_LOWMEM=1")
+
+# Standalone module: only the wrapper exports, the bump allocator of
+# falcon_wasm.c instead of malloc, and no system RNG (getentropy() and
+# /dev/urandom would be WASI imports). Signing needs a seed or the entropy
+# pool, which the JS loader seeds from crypto.getRandomValues()
+STANDALONE_CFLAGS=(
+    "-DFALCON_WASM_STANDALONE=1"
+    "-DFALCON_RAND_URANDOM=0"
+    "-DFALCON_RAND_WIN32=0"
+    "-DFALCON_RAND_GETENTROPY=0"
+)
+STANDALONE_EMFLAGS=(
+    -s STANDALONE_WASM=1
+    -s MALLOC=none
+    -s FILESYSTEM=0
+    -s ALLOW_MEMORY_GROWTH=1                       # Grown by wasm_malloc()
+    -s TOTAL_MEMORY=1048576                        # Initial memory: 1MB
+    -s STACK_SIZE=262144                           # Stack size: 256kB
+    -s ERROR_ON_UNDEFINED_SYMBOLS=1
+    --no-entry
+)
+
+# Flags for the upstream command-line tools: same CFLAGS as the library,
+# but with a main() and a Node.js runtime instead of an ES6 module factory
+TOOL_EMFLAGS=(
+    -s WASM=1
+    -s ALLOW_MEMORY_GROWTH=1
+    -s ENVIRONMENT=node                            # Run with `node dist/tools/<tool>.js`
+    -s EXIT_RUNTIME=1                              # Flush stdout and return main()'s exit code
+    -s TOTAL_MEMORY=16777216
+    -s STACK_SIZE=1048576
+)
+
+# SIMD variants of the library (see FALCON_WASM_SIMD in config.h)
+SIMD_CFLAGS=("-msimd128" "-DFALCON_WASM_SIMD=1")
+RELAXED_CFLAGS=("${SIMD_CFLAGS[@]}" "-mrelaxed-simd" "-DFALCON_WASM_RELAXED=1")
+
+# build_lib <name> [extra cflags...]: build dist/<name>.js + dist/<name>.wasm
+build_lib() {
+    local name="$1"
+    shift
+    echo "Building Falcon-512 WebAssembly module ($name)..."
+    echo "Compiling with emcc..."
+    emcc "${CFLAGS[@]}" "$@" "${EMFLAGS[@]}" "${MEMFLAGS[@]}" \
+        "${FALCON_SOURCES[@]}" \
+        "$WRAPPER_SOURCE" \
+        -o "dist/$name.js"
+
+    echo "Build complete!"
+    echo "Output files:"
+    echo "  - dist/$name.js"
+    echo "  - dist/$name.wasm"
+}
+
+# build_lowmem: build dist/falcon-lowmem.* with the low-memory profile
+build_lowmem() {
+    local MEMFLAGS=("${LOWMEM_MEMFLAGS[@]}")
+    build_lib falcon-lowmem "${LOWMEM_CFLAGS[@]}"
+}
+
+# build_standalone: build dist/falcon-standalone.wasm and check that it has
+# no imports
+build_standalone() {
+    local flag cflags=()
+    for flag in "${CFLAGS[@]}"; do
+        case "$flag" in
+            -DFALCON_RAND_GETENTROPY=*) ;;
+            *) cflags+=("$flag") ;;
+        esac
+    done
+    echo "Building standalone Falcon-512 WebAssembly module..."
+    echo "Compiling with emcc..."
+    emcc "${cflags[@]}" "${STANDALONE_CFLAGS[@]}" "${STANDALONE_EMFLAGS[@]}" \
+        "${FALCON_SOURCES[@]}" \
+        "$WRAPPER_SOURCE" \
+        -o dist/falcon-standalone.wasm
+
+    if command -v node >/dev/null 2>&1; then
+        node -e '
+            const fs = require("fs");
+            const mod = new WebAssembly.Module(fs.readFileSync(process.argv[1]));
+            const imports = WebAssembly.Module.imports(mod);
+            if (imports.length !== 0) {
+                console.error("Unexpected imports:", imports.map((i) => i.module + "." + i.name).join(", "));
+                process.exit(1);
+            }' dist/falcon-standalone.wasm
+    fi
+
+    echo "Build complete!"
+    echo "Output files:"
+    echo "  - dist/falcon-standalone.wasm (load with src/falcon-standalone.js)"
+}
+
+build_tools() {
+    echo "Building upstream tools for Node.js..."
+    mkdir -p "$TOOLS_DIR"
+    # package.json at the root sets "type": "module"; the Emscripten
+    # launchers are CommonJS
+    echo '{ "type": "commonjs" }' > "$TOOLS_DIR/package.json"
+
+    for tool in speed test_falcon; do
+        echo "Compiling $tool with emcc..."
+        emcc "${CFLAGS[@]}" "${TOOL_EMFLAGS[@]}" \
+            "${FALCON_SOURCES[@]}" \
+            "Falcon-impl-round3/$tool.c" \
+            -o "$TOOLS_DIR/$tool.js"
+    done
+
+    # bench_kernels.c includes shake.c and vrfy.c (for their static
+    # kernels): compile it with the other sources only
+    local src kernel_sources=()
+    for src in "${FALCON_SOURCES[@]}"; do
+        case "$src" in
+            */shake.c|*/vrfy.c) ;;
+            *) kernel_sources+=("$src") ;;
+        esac
+    done
+    echo "Compiling bench_kernels with emcc..."
+    emcc "${CFLAGS[@]}" "${TOOL_EMFLAGS[@]}" \
+        "${kernel_sources[@]}" \
+        "Falcon-impl-round3/bench_kernels.c" \
+        -o "$TOOLS_DIR/bench_kernels.js"
+
+    echo "Build complete!"
+    echo "Output files:"
+    echo "  - $TOOLS_DIR/speed.js, $TOOLS_DIR/speed.wasm"
+    echo "  - $TOOLS_DIR/test_falcon.js, $TOOLS_DIR/test_falcon.wasm"
+    echo "  - $TOOLS_DIR/bench_kernels.js, $TOOLS_DIR/bench_kernels.wasm"
+}
 
-echo "Build complete!"
-echo "Output files:"
-echo "  - dist/falcon.js"
-echo "  - dist/falcon.wasm"
+if [ "$TARGET" = "lib" ] || [ "$TARGET" = "all" ]; then
+    build_lib falcon
+fi
+if [ "$TARGET" = "simd" ] || [ "$TARGET" = "all" ]; then
+    build_lib falcon-simd "${SIMD_CFLAGS[@]}"
+    build_lib falcon-relaxed "${RELAXED_CFLAGS[@]}"
+fi
+if [ "$TARGET" = "lowmem" ] || [ "$TARGET" = "all" ]; then
+    build_lowmem
+fi
+if [ "$TARGET" = "standalone" ] || [ "$TARGET" = "all" ]; then
+    build_standalone
+fi
+if [ "$TARGET" = "tools" ] || [ "$TARGET" = "all" ]; then
+    build_tools
+fi
@@ -0,0 +1,85 @@
+/**
+ * Worker entry point for FalconPool (see falcon-pool.js)
+ *
+ * Runs in a Node.js worker thread or a browser module worker. Each worker
+ * loads its own Falcon512 instance and runs batches of calls sent by the
+ * pool, one message per batch, or serves a verification ring of
+ * FalconIngest (see falcon-ring.js).
+ */
+
+import { Falcon512 } from './falcon.js';
+import { RequestRing, CompletionRing, serveVerifyRing } from './falcon-ring.js';
+
+// Calls a batch item may name, with their arguments in order
+const OPS = {
+  sign: (falcon, [message, privateKey, rngSeed]) => falcon.signMessage(message, privateKey, rngSeed),
+  verify: (falcon, [message, signature, publicKey]) => falcon.verifySignature(message, signature, publicKey),
+  signPoly: (falcon, [hm, privateKey]) => falcon.signPoly(hm, privateKey),
+  verifyPoly: (falcon, [hm, sv, publicKey]) => falcon.verifyPoly(hm, sv, publicKey),
+  hashToPoint: (falcon, [message]) => falcon.hashToPoint(message),
+};
+
+let port;
+if (typeof WorkerGlobalScope !== 'undefined') {
+  port = {
+    post: (msg, transfer) => self.postMessage(msg, transfer),
+    listen: (fn) => self.addEventListener('message', (e) => fn(e.data)),
+  };
+} else {
+  const { parentPort } = await import('node:worker_threads');
+  port = {
+    post: (msg, transfer) => parentPort.postMessage(msg, transfer),
+    listen: (fn) => parentPort.on('message', fn),
+  };
+}
+
+let falcon = null;
+
+port.listen(async (msg) => {
+  if (msg.type === 'init') {
+    try {
+      falcon = await Falcon512.load({ variant: msg.variant });
+      port.post({ type: 'ready', variant: falcon.variant });
+    } catch (e) {
+      port.post({ type: 'failed', error: String(e && e.message || e) });
+    }
+    return;
+  }
+
+  // Dedicated ring worker (see FalconIngest): serve until the ring is closed,
+  // or report the failure that stopped it
+  if (msg.type === 'ring') {
+    const err = serveVerifyRing(falcon, new RequestRing(msg.req), new CompletionRing(msg.comp));
+    if (err) {
+      port.post({ type: 'failed', error: String(err.message || err) });
+    }
+    return;
+  }
+
+  // type 'run': one result (or error message) per item, in order
+  const fn = OPS[msg.op];
+  const results = [];
+  const errors = [];
+  const transfer = new Set();
+  for (const args of msg.items) {
+    try {
+      if (!fn) {
+        throw new Error(`Unknown pool operation: ${msg.op}`);
+      }
+      const r = fn(falcon, args);
+      if (ArrayBuffer.isView(r)) {
+        transfer.add(r.buffer);
+      }
+      results.push(r);
+      errors.push(null);
+    } catch (e) {
+      results.push(null);
+      errors.push(String(e && e.message || e));
+    }
+  }
+  port.post({ type: 'done', id: msg.id, results, errors }, [...transfer]);
+});
+
+// Messages sent before the listener is attached could be lost in browsers:
+// the pool waits for this one before sending 'init'
+port.post({ type: 'loaded' });
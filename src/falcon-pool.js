@@ -0,0 +1,494 @@
+/**
+ * Worker pool for Falcon-512 signing and verification, with priority classes
+ *
+ * Calls are queued per class and sent to workers in batches. A worker that
+ * finishes a batch always takes its next one from the highest-priority
+ * class with queued work, so latency-sensitive calls wait for at most one
+ * batch of bulk work per worker; bulk calls still travel in batches large
+ * enough to amortize the message round-trip.
+ */
+
+// Default classes: 'interactive' is served first, one call per batch;
+// 'bulk' goes in batches of up to 32 calls and leaves one worker free
+const DEFAULT_CLASSES = {
+  interactive: { priority: 0, maxBatch: 1 },
+  bulk: { priority: 1, maxBatch: 32, reserve: 1 },
+};
+
+// Queue-time samples kept per class for percentiles
+const QUEUE_TIME_SAMPLES = 1024;
+
+const now = () => (typeof performance !== 'undefined' ? performance.now() : Date.now());
+
+/**
+ * Start a worker running falcon-pool-worker.js (or the module at `url`): a
+ * module Web Worker when the global Worker constructor exists, a Node.js
+ * worker thread otherwise.
+ * @private
+ */
+export async function defaultCreateWorker(url = new URL('./falcon-pool-worker.js', import.meta.url)) {
+  if (typeof globalThis.Worker === 'function') {
+    const w = new globalThis.Worker(url, { type: 'module' });
+    return {
+      post: (msg) => w.postMessage(msg),
+      onMessage: (fn) => w.addEventListener('message', (e) => fn(e.data)),
+      onError: (fn) => w.addEventListener('error', (e) => fn(e.error || new Error(e.message))),
+      terminate: () => w.terminate(),
+    };
+  }
+  const { Worker } = await import('node:worker_threads');
+  const w = new Worker(url);
+  let terminating = false;
+  return {
+    post: (msg) => w.postMessage(msg),
+    onMessage: (fn) => w.on('message', fn),
+    // An exit that terminate() did not ask for (process.exit() in the
+    // worker, out-of-memory kill) is reported as an error too
+    onError: (fn) => {
+      w.on('error', fn);
+      w.on('exit', (code) => {
+        if (!terminating) {
+          fn(new Error(`Worker exited with code ${code}`));
+        }
+      });
+    },
+    terminate: () => {
+      terminating = true;
+      return w.terminate();
+    },
+  };
+}
+
+/**
+ * Queue, limits and metrics of one priority class
+ * @private
+ */
+class PoolClass {
+  constructor(name, { priority = 0, maxBatch = 1, maxConcurrency, reserve = 0 }, size) {
+    this.name = name;
+    this.priority = priority;
+    this.maxBatch = Math.max(1, maxBatch);
+    this.maxConcurrency = Math.max(1, maxConcurrency !== undefined ? maxConcurrency : size - reserve);
+    this.queue = [];
+    this.head = 0;
+    this.running = 0;
+    this.dispatched = 0;
+    this.completed = 0;
+    this.failed = 0;
+    this.batches = 0;
+    this.waitSum = 0;
+    this.waitMax = 0;
+    this.samples = [];
+    this.sampleNext = 0;
+  }
+
+  get queued() {
+    return this.queue.length - this.head;
+  }
+
+  /**
+   * Take the next batch: consecutive calls of the same operation as the
+   * oldest one, at most maxBatch of them.
+   */
+  take() {
+    const op = this.queue[this.head].op;
+    let end = this.head + 1;
+    const limit = Math.min(this.queue.length, this.head + this.maxBatch);
+    while (end < limit && this.queue[end].op === op) {
+      end++;
+    }
+    const batch = this.queue.slice(this.head, end);
+    this.head = end;
+    if (this.head > 1024 && this.head * 2 > this.queue.length) {
+      this.queue = this.queue.slice(this.head);
+      this.head = 0;
+    }
+    return batch;
+  }
+
+  recordWait(ms) {
+    this.waitSum += ms;
+    if (ms > this.waitMax) {
+      this.waitMax = ms;
+    }
+    if (this.samples.length < QUEUE_TIME_SAMPLES) {
+      this.samples.push(ms);
+    } else {
+      this.samples[this.sampleNext] = ms;
+      this.sampleNext = (this.sampleNext + 1) % QUEUE_TIME_SAMPLES;
+    }
+  }
+
+  metrics() {
+    const sorted = this.samples.slice().sort((a, b) => a - b);
+    const pct = (p) => (sorted.length ? sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))] : 0);
+    return {
+      priority: this.priority,
+      maxBatch: this.maxBatch,
+      maxConcurrency: this.maxConcurrency,
+      queued: this.queued,
+      running: this.running,
+      completed: this.completed,
+      failed: this.failed,
+      batches: this.batches,
+      queueTime: {
+        mean: this.dispatched ? this.waitSum / this.dispatched : 0,
+        max: this.waitMax,
+        p50: pct(0.5),
+        p95: pct(0.95),
+        p99: pct(0.99),
+      },
+    };
+  }
+}
+
+/**
+ * Pool of workers, each with its own Falcon512 instance.
+ *
+ * Every call names a priority class. When a worker becomes free, it takes
+ * a batch from the class with the lowest `priority` value that has queued
+ * calls and runs fewer than `maxConcurrency` batches. A batch holds up to
+ * `maxBatch` consecutive calls of the same operation, so a class with a
+ * large maxBatch amortizes the per-message cost while a higher-priority
+ * class preempts it at every batch boundary.
+ */
+export class FalconPool {
+  /**
+   * @param {Object} [options]
+   * @private
+   */
+  constructor({ size, classes, createWorker }) {
+    this.size = size;
+    this.createWorker = createWorker;
+    this.classes = new Map();
+    for (const [name, cfg] of Object.entries(classes)) {
+      this.classes.set(name, new PoolClass(name, cfg, size));
+    }
+    this.order = [...this.classes.values()].sort((a, b) => a.priority - b.priority);
+    this.workers = [];
+    this.idle = [];
+    this.nextId = 1;
+    this.closed = false;
+    this.variant = null;
+  }
+
+  /**
+   * Start a pool and wait for all of its workers to be ready.
+   *
+   * @param {Object} [options]
+   * @param {number} [options.size=4] - Number of workers
+   * @param {string} [options.variant='auto'] - Module build loaded by each worker (see Falcon512.load)
+   * @param {Object<string, {priority: number, maxBatch?: number, maxConcurrency?: number, reserve?: number}>}
+   *   [options.classes] - Priority classes by name; a lower priority value is served first.
+   *   maxConcurrency caps the workers busy with the class at once (default: size - reserve).
+   *   Defaults to 'interactive' (priority 0, maxBatch 1) and 'bulk' (priority 1, maxBatch 32,
+   *   one worker kept free of bulk work).
+   * @param {Function} [options.createWorker] - Async factory of worker adapters
+   *   { post, onMessage, onError, terminate }; onError must also report workers that
+   *   stop unexpectedly. Defaults to falcon-pool-worker.js in a
+   *   Web Worker or Node.js worker thread
+   * @returns {Promise<FalconPool>}
+   */
+  static async create({ size = 4, variant = 'auto', classes = DEFAULT_CLASSES, createWorker = defaultCreateWorker } = {}) {
+    if (!Number.isInteger(size) || size < 1) {
+      throw new Error(`Invalid pool size: ${size}`);
+    }
+    const pool = new FalconPool({ size, classes, createWorker });
+    try {
+      await Promise.all(Array.from({ length: size }, () => pool.spawn(variant)));
+    } catch (e) {
+      await pool.close();
+      throw e;
+    }
+    return pool;
+  }
+
+  /**
+   * Start one worker and resolve once its module is loaded
+   * @private
+   */
+  async spawn(variant) {
+    const adapter = await this.createWorker();
+    const worker = { adapter, batch: null };
+    this.workers.push(worker);
+    let ready = false;
+    await new Promise((resolve, reject) => {
+      adapter.onError((err) => {
+        if (!ready) {
+          reject(err);
+        }
+        this.lose(worker, err);
+      });
+      adapter.onMessage((msg) => {
+        switch (msg.type) {
+          case 'loaded':
+            adapter.post({ type: 'init', variant });
+            break;
+          case 'ready':
+            ready = true;
+            this.variant = msg.variant;
+            this.release(worker);
+            resolve();
+            break;
+          case 'failed':
+            reject(new Error(`Worker failed to load: ${msg.error}`));
+            break;
+          case 'done':
+            this.finish(worker, msg);
+            break;
+        }
+      });
+    });
+  }
+
+  /**
+   * Queue calls in one class; resolves to their results, in order
+   * @private
+   */
+  submit(className, op, itemsArgs) {
+    const cls = this.classes.get(className);
+    if (!cls) {
+      return Promise.reject(new Error(`Unknown priority class: ${className}`));
+    }
+    if (this.closed) {
+      return Promise.reject(new Error('Pool is closed'));
+    }
+    const t = now();
+    const promises = itemsArgs.map((args) => new Promise((resolve, reject) => {
+      cls.queue.push({ op, args, resolve, reject, queuedAt: t });
+    }));
+    this.dispatch();
+    return Promise.all(promises);
+  }
+
+  /**
+   * Hand batches to idle workers, highest-priority class first
+   * @private
+   */
+  dispatch() {
+    while (this.idle.length > 0) {
+      const cls = this.order.find((c) => c.queued > 0 && c.running < c.maxConcurrency);
+      if (!cls) {
+        return;
+      }
+      const worker = this.idle.pop();
+      const items = cls.take();
+      const t = now();
+      for (const item of items) {
+        cls.recordWait(t - item.queuedAt);
+      }
+      cls.running++;
+      cls.dispatched += items.length;
+      cls.batches++;
+      const id = this.nextId++;
+      worker.batch = { id, cls, items };
+      worker.adapter.post({ type: 'run', id, op: items[0].op, items: items.map((i) => i.args) });
+    }
+  }
+
+  /**
+   * @private
+   */
+  release(worker) {
+    worker.batch = null;
+    this.idle.push(worker);
+    this.dispatch();
+  }
+
+  /**
+   * @private
+   */
+  finish(worker, msg) {
+    const batch = worker.batch;
+    if (!batch || batch.id !== msg.id) {
+      return;
+    }
+    batch.cls.running--;
+    batch.items.forEach((item, i) => {
+      if (msg.errors[i] === null) {
+        batch.cls.completed++;
+        item.resolve(msg.results[i]);
+      } else {
+        batch.cls.failed++;
+        item.reject(new Error(msg.errors[i]));
+      }
+    });
+    if (this.closed) {
+      worker.batch = null;
+      return;
+    }
+    this.release(worker);
+  }
+
+  /**
+   * Drop a crashed worker: its batch fails, and queued calls fail too if
+   * no worker is left.
+   * @private
+   */
+  lose(worker, err) {
+    const i = this.workers.indexOf(worker);
+    if (i < 0) {
+      return;
+    }
+    this.workers.splice(i, 1);
+    this.idle = this.idle.filter((w) => w !== worker);
+    if (worker.batch) {
+      const { cls, items } = worker.batch;
+      cls.running--;
+      cls.failed += items.length;
+      for (const item of items) {
+        item.reject(err);
+      }
+      worker.batch = null;
+    }
+    if (this.workers.length === 0) {
+      this.rejectQueued(new Error(`All pool workers failed: ${err && err.message}`));
+    } else {
+      this.dispatch();
+    }
+  }
+
+  /**
+   * @private
+   */
+  rejectQueued(err) {
+    for (const cls of this.classes.values()) {
+      for (let i = cls.head; i < cls.queue.length; i++) {
+        cls.failed++;
+        cls.queue[i].reject(err);
+      }
+      cls.queue = [];
+      cls.head = 0;
+    }
+  }
+
+  /**
+   * Sign a message (see Falcon512#signMessage).
+   *
+   * @param {Uint8Array} message - Message to sign
+   * @param {Uint8Array} privateKey - Private key (1281 bytes)
+   * @param {Object} [options]
+   * @param {string} [options.priority='interactive'] - Priority class
+   * @param {Uint8Array} [options.rngSeed] - Seed for signature randomness; when omitted,
+   *   the worker's entropy pool is used
+   * @returns {Promise<Uint8Array>} Signature bytes (compressed format)
+   */
+  async sign(message, privateKey, { priority = 'interactive', rngSeed } = {}) {
+    const [sig] = await this.submit(priority, 'sign', [[message, privateKey, rngSeed]]);
+    return sig;
+  }
+
+  /**
+   * Verify a signature (see Falcon512#verifySignature).
+   *
+   * @param {Uint8Array} message - Signed message
+   * @param {Uint8Array} signature - Signature bytes
+   * @param {Uint8Array} publicKey - Public key (897 bytes)
+   * @param {Object} [options]
+   * @param {string} [options.priority='interactive'] - Priority class
+   * @returns {Promise<boolean>}
+   */
+  async verify(message, signature, publicKey, { priority = 'interactive' } = {}) {
+    const [ok] = await this.submit(priority, 'verify', [[message, signature, publicKey]]);
+    return ok;
+  }
+
+  /**
+   * Sign several messages with one key; they are queued in order and
+   * batched according to the class maxBatch.
+   *
+   * @param {Uint8Array[]} messages - Messages to sign
+   * @param {Uint8Array} privateKey - Private key (1281 bytes)
+   * @param {Object} [options]
+   * @param {string} [options.priority='bulk'] - Priority class
+   * @param {Uint8Array[]} [options.rngSeeds] - One seed per message (entropy pool if omitted)
+   * @returns {Promise<Uint8Array[]>} Signatures, in input order
+   */
+  signMany(messages, privateKey, { priority = 'bulk', rngSeeds } = {}) {
+    return this.submit(priority, 'sign',
+      messages.map((m, i) => [m, privateKey, rngSeeds ? rngSeeds[i] : undefined]));
+  }
+
+  /**
+   * Verify several signatures.
+   *
+   * @param {{message: Uint8Array, signature: Uint8Array, publicKey: Uint8Array}[]} jobs
+   * @param {Object} [options]
+   * @param {string} [options.priority='bulk'] - Priority class
+   * @returns {Promise<boolean[]>} Per-job validity, in input order
+   */
+  verifyMany(jobs, { priority = 'bulk' } = {}) {
+    return this.submit(priority, 'verify',
+      jobs.map((j) => [j.message, j.signature, j.publicKey]));
+  }
+
+  /**
+   * Sign a hash-to-point polynomial (see Falcon512#signPoly).
+   *
+   * @param {Int16Array|Uint16Array} hm - 512 hash-to-point coefficients
+   * @param {Uint8Array} privateKey - Private key (1281 bytes)
+   * @param {Object} [options]
+   * @param {string} [options.priority='interactive'] - Priority class
+   * @returns {Promise<Int16Array>} Signature polynomial s2
+   */
+  async signPoly(hm, privateKey, { priority = 'interactive' } = {}) {
+    const [sv] = await this.submit(priority, 'signPoly', [[hm, privateKey]]);
+    return sv;
+  }
+
+  /**
+   * Verify a signature polynomial (see Falcon512#verifyPoly).
+   *
+   * @param {Int16Array|Uint16Array} hm - 512 hash-to-point coefficients
+   * @param {Int16Array} sv - 512 signature polynomial coefficients
+   * @param {Uint8Array} publicKey - Public key (897 bytes)
+   * @param {Object} [options]
+   * @param {string} [options.priority='interactive'] - Priority class
+   * @returns {Promise<boolean>}
+   */
+  async verifyPoly(hm, sv, publicKey, { priority = 'interactive' } = {}) {
+    const [ok] = await this.submit(priority, 'verifyPoly', [[hm, sv, publicKey]]);
+    return ok;
+  }
+
+  /**
+   * Per-class counters and queue times (in milliseconds, from submission to
+   * dispatch to a worker; percentiles over the last 1024 calls).
+   *
+   * @returns {Object<string, Object>} Metrics by class name
+   */
+  metrics() {
+    const out = {};
+    for (const [name, cls] of this.classes) {
+      out[name] = cls.metrics();
+    }
+    return out;
+  }
+
+  /**
+   * Stop all workers. Queued calls are rejected; calls already sent to a
+   * worker are rejected when it stops.
+   */
+  async close() {
+    if (this.closed) {
+      return;
+    }
+    this.closed = true;
+    this.rejectQueued(new Error('Pool is closed'));
+    const workers = this.workers;
+    this.workers = [];
+    this.idle = [];
+    for (const w of workers) {
+      if (w.batch) {
+        for (const item of w.batch.items) {
+          item.reject(new Error('Pool is closed'));
+        }
+        w.batch.cls.running--;
+        w.batch = null;
+      }
+    }
+    await Promise.all(workers.map((w) => w.adapter.terminate()));
+  }
+}
+
+export default FalconPool;
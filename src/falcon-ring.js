@@ -0,0 +1,564 @@
+/**
+ * SharedArrayBuffer rings for high-rate verification in workers
+ *
+ * The main thread writes verification requests into a request ring shared
+ * with a worker; the worker copies each run of pending records into its
+ * WASM memory in one block, verifies them there (falcon512_verify_records)
+ * and writes (id, result) pairs into a completion ring. Wakeups go through
+ * Atomics.wait / Atomics.notify, so no message is structured-cloned per
+ * request.
+ */
+
+import { defaultCreateWorker } from './falcon-pool.js';
+
+const FALCON512_PUBKEY_SIZE = 897;
+
+// Both rings start with a control block of Int32 words
+const CONTROL_BYTES = 64;
+const HEAD = 0;     // producer offset
+const TAIL = 1;     // consumer offset
+const SEQ = 2;      // bumped by the producer when it publishes; consumers wait on it
+const CLOSED = 3;   // set to 1 to stop the worker loop
+
+// Request record header: record length, id, message length, signature length
+const RECORD_HEADER = 16;
+
+/**
+ * Size of the request record for one verification, in bytes.
+ *
+ * @param {number} messageLength
+ * @param {number} signatureLength
+ * @returns {number}
+ */
+export function verifyRecordLength(messageLength, signatureLength) {
+  return (RECORD_HEADER + FALCON512_PUBKEY_SIZE + signatureLength + messageLength + 3) & ~3;
+}
+
+/**
+ * Ring of variable-size records in a SharedArrayBuffer, with one producer
+ * and one consumer. A record never wraps around: when it does not fit before
+ * the end, a zero length word marks the end of data and the record is
+ * written at offset 0. One 4-byte gap is kept so that head === tail always
+ * means empty.
+ */
+export class RequestRing {
+  /**
+   * @param {SharedArrayBuffer|number} bufferOrBytes - Existing ring buffer, or
+   *   data capacity in bytes (a multiple of 4) for a new one
+   */
+  constructor(bufferOrBytes) {
+    this.buffer = typeof bufferOrBytes === 'number'
+      ? new SharedArrayBuffer(CONTROL_BYTES + (bufferOrBytes & ~3))
+      : bufferOrBytes;
+    this.ctl = new Int32Array(this.buffer, 0, CONTROL_BYTES / 4);
+    this.bytes = new Uint8Array(this.buffer, CONTROL_BYTES);
+    this.view = new DataView(this.buffer, CONTROL_BYTES);
+    this.capacity = this.bytes.length;
+  }
+
+  /**
+   * Reserve len bytes (a multiple of 4) for the next record.
+   *
+   * @returns {number} Offset of the record in `bytes`, or -1 if the ring is full
+   * @private
+   */
+  reserve(len) {
+    const head = Atomics.load(this.ctl, HEAD);
+    const tail = Atomics.load(this.ctl, TAIL);
+    if (head >= tail) {
+      const end = head + len;
+      if (end < this.capacity || (end === this.capacity && tail > 0)) {
+        return head;
+      }
+      if (len < tail) {
+        this.view.setUint32(head, 0, true);
+        return 0;
+      }
+      return -1;
+    }
+    return head + len < tail ? head : -1;
+  }
+
+  /**
+   * Append one verification request, without waking the consumer (see
+   * {@link RequestRing#publish}).
+   *
+   * @returns {boolean} false if the ring has no room for it
+   */
+  tryPushVerify(id, message, signature, publicKey) {
+    const len = verifyRecordLength(message.length, signature.length);
+    const off = this.reserve(len);
+    if (off < 0) {
+      return false;
+    }
+    const v = this.view;
+    v.setUint32(off, len, true);
+    v.setUint32(off + 4, id, true);
+    v.setUint32(off + 8, message.length, true);
+    v.setUint32(off + 12, signature.length, true);
+    let p = off + RECORD_HEADER;
+    this.bytes.set(publicKey, p);
+    p += FALCON512_PUBKEY_SIZE;
+    this.bytes.set(signature, p);
+    p += signature.length;
+    this.bytes.set(message, p);
+    p += message.length;
+    this.bytes.fill(0, p, off + len);
+    Atomics.store(this.ctl, HEAD, (off + len) % this.capacity);
+    return true;
+  }
+
+  /**
+   * Wake the consumer after one or more pushes.
+   */
+  publish() {
+    Atomics.add(this.ctl, SEQ, 1);
+    Atomics.notify(this.ctl, SEQ);
+  }
+
+  /**
+   * Next run of contiguous records, up to maxBytes (at least one record).
+   *
+   * @returns {{offset: number, length: number, count: number, next: number}|null}
+   *   null when the ring is empty; pass `next` to {@link RequestRing#release}
+   */
+  peek(maxBytes) {
+    let tail = Atomics.load(this.ctl, TAIL);
+    const head = Atomics.load(this.ctl, HEAD);
+    if (tail === head) {
+      return null;
+    }
+    if (tail > head && (tail === this.capacity || this.view.getUint32(tail, true) === 0)) {
+      tail = 0;
+      if (tail === head) {
+        Atomics.store(this.ctl, TAIL, 0);
+        return null;
+      }
+    }
+    const limit = tail < head ? head : this.capacity;
+    let end = tail;
+    let count = 0;
+    while (end < limit) {
+      const len = this.view.getUint32(end, true);
+      if (len === 0 || (count > 0 && end + len - tail > maxBytes)) {
+        break;
+      }
+      end += len;
+      count++;
+    }
+    return { offset: tail, length: end - tail, count, next: end % this.capacity };
+  }
+
+  /**
+   * Give back the space of a run returned by {@link RequestRing#peek}.
+   */
+  release(next) {
+    Atomics.store(this.ctl, TAIL, next);
+    Atomics.notify(this.ctl, TAIL);
+  }
+}
+
+/**
+ * Ring of (id, result) Int32 pairs in a SharedArrayBuffer, written by the
+ * worker and drained by the main thread.
+ */
+export class CompletionRing {
+  /**
+   * @param {SharedArrayBuffer|number} bufferOrSlots - Existing ring buffer, or
+   *   number of slots for a new one
+   */
+  constructor(bufferOrSlots) {
+    this.buffer = typeof bufferOrSlots === 'number'
+      ? new SharedArrayBuffer(CONTROL_BYTES + bufferOrSlots * 8)
+      : bufferOrSlots;
+    this.ctl = new Int32Array(this.buffer, 0, CONTROL_BYTES / 4);
+    this.slots = new Int32Array(this.buffer, CONTROL_BYTES);
+    this.capacity = this.slots.length / 2;
+  }
+
+  /**
+   * Append pairs from an Int32Array (id, result, id, result, ...), blocking
+   * while the ring is full. Worker side only (Atomics.wait).
+   */
+  pushAll(pairs) {
+    let head = Atomics.load(this.ctl, HEAD);
+    for (let i = 0; i < pairs.length; i += 2) {
+      const next = (head + 1) % this.capacity;
+      let tail;
+      while (next === (tail = Atomics.load(this.ctl, TAIL))) {
+        Atomics.store(this.ctl, HEAD, head);
+        this.publish();
+        Atomics.wait(this.ctl, TAIL, tail);
+      }
+      this.slots[head * 2] = pairs[i];
+      this.slots[head * 2 + 1] = pairs[i + 1];
+      head = next;
+    }
+    Atomics.store(this.ctl, HEAD, head);
+    this.publish();
+  }
+
+  /**
+   * @private
+   */
+  publish() {
+    Atomics.add(this.ctl, SEQ, 1);
+    Atomics.notify(this.ctl, SEQ);
+  }
+
+  /**
+   * Call fn(id, result) for every pending pair, then free their slots.
+   *
+   * @returns {number} Number of pairs drained
+   */
+  drain(fn) {
+    const head = Atomics.load(this.ctl, HEAD);
+    let tail = Atomics.load(this.ctl, TAIL);
+    let n = 0;
+    while (tail !== head) {
+      fn(this.slots[tail * 2], this.slots[tail * 2 + 1]);
+      tail = (tail + 1) % this.capacity;
+      n++;
+    }
+    if (n > 0) {
+      Atomics.store(this.ctl, TAIL, tail);
+      Atomics.notify(this.ctl, TAIL);
+    }
+    return n;
+  }
+}
+
+/**
+ * Worker side: verify requests from `req` until the ring is closed, posting
+ * results to `comp`. Blocks the calling worker.
+ *
+ * A failure of the verifier (such as a WASM allocation failure) stops the
+ * loop; the error is returned, for the worker to report to the main thread.
+ *
+ * @param {Falcon512} falcon - Initialized instance of the worker
+ * @param {RequestRing} req
+ * @param {CompletionRing} comp
+ * @param {number} [maxBytes=262144] - Largest run copied into WASM memory at once
+ * @returns {Error|null} Error that stopped the loop, or null once the ring is closed
+ */
+export function serveVerifyRing(falcon, req, comp, maxBytes = 1 << 18) {
+  for (;;) {
+    const seq = Atomics.load(req.ctl, SEQ);
+    const run = req.peek(maxBytes);
+    if (run === null) {
+      if (Atomics.load(req.ctl, CLOSED)) {
+        return null;
+      }
+      Atomics.wait(req.ctl, SEQ, seq);
+      continue;
+    }
+    let pairs;
+    try {
+      pairs = falcon.verifyRecords(
+        new Uint8Array(req.buffer, CONTROL_BYTES + run.offset, run.length), run.count);
+    } catch (e) {
+      return e instanceof Error ? e : new Error(String(e));
+    }
+    req.release(run.next);
+    comp.pushAll(pairs);
+  }
+}
+
+/**
+ * Verification front end over dedicated workers, one request ring and one
+ * completion ring per worker.
+ *
+ * Requests that do not fit in any ring wait in a backlog and are written as
+ * completions free space. Completions are collected with Atomics.waitAsync
+ * where available, by polling otherwise.
+ *
+ * A worker that crashes or fails takes its lane out of rotation: requests
+ * written to that lane are rejected, and the other lanes take new ones.
+ */
+export class FalconIngest {
+  /**
+   * @private
+   */
+  constructor() {
+    this.lanes = [];
+    this.pending = new Map();
+    this.backlog = [];
+    this.nextId = 1;
+    this.nextLane = 0;
+    this.publishQueued = false;
+    this.closed = false;
+    this.failure = null;
+    this.submitted = 0;
+    this.completed = 0;
+    this.backlogged = 0;
+  }
+
+  /**
+   * Start the workers and their rings.
+   *
+   * @param {Object} [options]
+   * @param {number} [options.workers=2] - Number of workers
+   * @param {number} [options.ringBytes=1048576] - Request ring capacity per worker
+   * @param {number} [options.completionSlots=16384] - Completion ring slots per worker
+   * @param {string} [options.variant='auto'] - Module build (see Falcon512.load)
+   * @param {Function} [options.createWorker] - Worker adapter factory (see FalconPool.create)
+   * @returns {Promise<FalconIngest>}
+   */
+  static async create({ workers = 2, ringBytes = 1 << 20, completionSlots = 16384,
+    variant = 'auto', createWorker = defaultCreateWorker } = {}) {
+    if (typeof SharedArrayBuffer === 'undefined') {
+      throw new Error('SharedArrayBuffer is not available (cross-origin isolation is required in browsers)');
+    }
+    const ingest = new FalconIngest();
+    try {
+      for (let i = 0; i < workers; i++) {
+        await ingest.startLane(createWorker, variant, ringBytes, completionSlots);
+      }
+    } catch (e) {
+      await ingest.close();
+      throw e;
+    }
+    return ingest;
+  }
+
+  /**
+   * Start a worker and add its lane once it serves the rings
+   * @private
+   */
+  async startLane(createWorker, variant, ringBytes, completionSlots) {
+    const adapter = await createWorker();
+    const lane = {
+      adapter,
+      req: new RequestRing(ringBytes),
+      comp: new CompletionRing(completionSlots),
+      outstanding: 0,
+      dirty: false,
+      watching: false,
+    };
+    let ready = false;
+    await new Promise((resolve, reject) => {
+      // Errors before 'ready' fail the startup; later ones lose the lane
+      adapter.onError((err) => {
+        if (ready) {
+          this.lose(lane, err);
+        } else {
+          reject(err);
+        }
+      });
+      adapter.onMessage((msg) => {
+        if (msg.type === 'loaded') {
+          adapter.post({ type: 'init', variant });
+        } else if (msg.type === 'ready') {
+          ready = true;
+          adapter.post({ type: 'ring', req: lane.req.buffer, comp: lane.comp.buffer });
+          this.lanes.push(lane);
+          resolve();
+        } else if (msg.type === 'failed') {
+          if (ready) {
+            this.lose(lane, new Error(`Worker failed: ${msg.error}`));
+          } else {
+            reject(new Error(`Worker failed to load: ${msg.error}`));
+          }
+        }
+      });
+    });
+  }
+
+  /**
+   * Take a crashed or failed lane out of rotation: its pending requests are
+   * rejected, and the backlog goes to the other lanes (or is rejected if
+   * none is left).
+   * @private
+   */
+  lose(lane, err) {
+    const i = this.lanes.indexOf(lane);
+    if (i < 0) {
+      return;
+    }
+    this.lanes.splice(i, 1);
+    this.nextLane = this.lanes.length > 0 ? this.nextLane % this.lanes.length : 0;
+    for (const [id, p] of this.pending) {
+      if (p.lane === lane) {
+        this.pending.delete(id);
+        p.reject(err);
+      }
+    }
+    lane.outstanding = 0;
+    // Stop the worker loop if it still runs, and wake the lane's watcher
+    Atomics.store(lane.req.ctl, CLOSED, 1);
+    lane.req.publish();
+    Atomics.add(lane.comp.ctl, SEQ, 1);
+    Atomics.notify(lane.comp.ctl, SEQ);
+    Promise.resolve(lane.adapter.terminate()).catch(() => {});
+    if (this.lanes.length === 0) {
+      this.failure = err;
+      const all = new Error(`All ingest workers failed: ${err && err.message}`);
+      for (const job of this.backlog) {
+        job.reject(all);
+      }
+      this.backlog = [];
+    } else {
+      while (this.backlog.length > 0 && this.write(this.backlog[0])) {
+        this.backlog.shift();
+      }
+    }
+  }
+
+  /**
+   * Verify a signature on one of the workers.
+   *
+   * @param {Uint8Array} message - Signed message
+   * @param {Uint8Array} signature - Signature bytes
+   * @param {Uint8Array} publicKey - Public key (897 bytes)
+   * @returns {Promise<boolean>}
+   */
+  verify(message, signature, publicKey) {
+    if (this.closed) {
+      return Promise.reject(new Error('Ingest is closed'));
+    }
+    if (this.lanes.length === 0) {
+      return Promise.reject(new Error(`All ingest workers failed: ${this.failure && this.failure.message}`));
+    }
+    if (publicKey.length !== FALCON512_PUBKEY_SIZE) {
+      return Promise.reject(new Error(`Invalid public key size: expected ${FALCON512_PUBKEY_SIZE}, got ${publicKey.length}`));
+    }
+    // Up to half the ring, a record always fits once the ring is empty
+    const len = verifyRecordLength(message.length, signature.length);
+    if (len > (this.lanes[0].req.capacity >> 1) - 4) {
+      return Promise.reject(new Error(`Request of ${len} bytes does not fit in the ring`));
+    }
+    const id = this.nextId;
+    this.nextId = (this.nextId + 1) | 0 || 1;
+    this.submitted++;
+    return new Promise((resolve, reject) => {
+      const job = { id, message, signature, publicKey, resolve, reject };
+      if (this.backlog.length > 0 || !this.write(job)) {
+        this.backlog.push(job);
+        this.backlogged++;
+      }
+    });
+  }
+
+  /**
+   * Write a request into the next lane with room for it
+   * @private
+   */
+  write(job) {
+    for (let i = 0; i < this.lanes.length; i++) {
+      const lane = this.lanes[(this.nextLane + i) % this.lanes.length];
+      if (lane.req.tryPushVerify(job.id, job.message, job.signature, job.publicKey)) {
+        this.nextLane = (this.nextLane + i + 1) % this.lanes.length;
+        this.pending.set(job.id, { resolve: job.resolve, reject: job.reject, lane });
+        lane.outstanding++;
+        lane.dirty = true;
+        this.schedulePublish();
+        this.watch(lane);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Wake workers once per microtask, however many requests were written
+   * @private
+   */
+  schedulePublish() {
+    if (this.publishQueued) {
+      return;
+    }
+    this.publishQueued = true;
+    queueMicrotask(() => {
+      this.publishQueued = false;
+      for (const lane of this.lanes) {
+        if (lane.dirty) {
+          lane.dirty = false;
+          lane.req.publish();
+        }
+      }
+    });
+  }
+
+  /**
+   * Collect completions of a lane while it has outstanding requests
+   * @private
+   */
+  watch(lane) {
+    if (lane.watching || this.closed) {
+      return;
+    }
+    lane.watching = true;
+    const step = () => {
+      const seq = Atomics.load(lane.comp.ctl, SEQ);
+      lane.comp.drain((id, result) => {
+        const p = this.pending.get(id);
+        if (p) {
+          this.pending.delete(id);
+          p.lane.outstanding--;
+          this.completed++;
+          p.resolve(result === 0);
+        }
+      });
+      while (this.backlog.length > 0 && this.write(this.backlog[0])) {
+        this.backlog.shift();
+      }
+      if (lane.outstanding === 0 || this.closed) {
+        lane.watching = false;
+        return;
+      }
+      const w = typeof Atomics.waitAsync === 'function'
+        ? Atomics.waitAsync(lane.comp.ctl, SEQ, seq) : null;
+      if (w && w.async) {
+        w.value.then(step);
+      } else if (w) {
+        queueMicrotask(step);
+      } else {
+        setTimeout(step, 1);
+      }
+    };
+    step();
+  }
+
+  /**
+   * @returns {{submitted: number, completed: number, pending: number, backlog: number, backlogged: number}}
+   *   Counters since creation; `backlogged` counts requests that had to wait for ring space
+   */
+  stats() {
+    return {
+      submitted: this.submitted,
+      completed: this.completed,
+      pending: this.pending.size,
+      backlog: this.backlog.length,
+      backlogged: this.backlogged,
+    };
+  }
+
+  /**
+   * Stop the workers; requests not completed yet are rejected.
+   */
+  async close() {
+    if (this.closed) {
+      return;
+    }
+    this.closed = true;
+    const err = new Error('Ingest is closed');
+    for (const job of this.backlog) {
+      job.reject(err);
+    }
+    this.backlog = [];
+    for (const p of this.pending.values()) {
+      p.reject(err);
+    }
+    this.pending.clear();
+    for (const lane of this.lanes) {
+      Atomics.store(lane.req.ctl, CLOSED, 1);
+      lane.req.publish();
+      Atomics.add(lane.comp.ctl, SEQ, 1);
+      Atomics.notify(lane.comp.ctl, SEQ);
+    }
+    await Promise.all(this.lanes.map((lane) => lane.adapter.terminate()));
+    this.lanes = [];
+  }
+}
+
+export default FalconIngest;
@@ -0,0 +1,125 @@
+/**
+ * Loader for the standalone Falcon-512 module (`./build.sh standalone`)
+ *
+ * dist/falcon-standalone.wasm has no imports and no Emscripten runtime: it
+ * exports its memory, the falcon512_* functions and a bump allocator
+ * (wasm_malloc / wasm_free). This loader instantiates it and returns an
+ * object shaped like the Emscripten module, for Falcon512#init():
+ *
+ *   import createFalconModule from './falcon-standalone.js';
+ *   import wasm from '../dist/falcon-standalone.wasm'; // WebAssembly.Module
+ *
+ *   const falcon = new Falcon512();
+ *   await falcon.init(createFalconModule({ wasm }));
+ *
+ * The module cannot read the system RNG: when the entropy pool is seeded or
+ * reseeded without a seed, the loader passes 48 bytes from
+ * crypto.getRandomValues() instead. Such a pool is not reseeded from the
+ * system automatically; a reseed interval only ratchets it forward.
+ */
+
+const DEFAULT_WASM = new URL('../dist/falcon-standalone.wasm', import.meta.url);
+const SYSTEM_SEED_SIZE = 48;
+
+/**
+ * Compile and instantiate the module from any supported source
+ *
+ * @param {WebAssembly.Module|BufferSource|Response|Promise<Response>|URL|string} source
+ * @returns {Promise<WebAssembly.Instance>}
+ */
+async function instantiate(source) {
+  if (source instanceof WebAssembly.Module) {
+    return WebAssembly.instantiate(source, {});
+  }
+  if (source instanceof ArrayBuffer || ArrayBuffer.isView(source)) {
+    return (await WebAssembly.instantiate(source, {})).instance;
+  }
+  if (typeof source === 'string' || source instanceof URL) {
+    const url = new URL(source, import.meta.url);
+    if (url.protocol === 'file:') {
+      const { readFile } = await import('node:fs/promises');
+      return instantiate(await readFile(url));
+    }
+    source = fetch(url);
+  }
+  const response = await source;
+  if (typeof WebAssembly.instantiateStreaming === 'function') {
+    try {
+      return (await WebAssembly.instantiateStreaming(response.clone(), {})).instance;
+    } catch (e) {
+      // Wrong MIME type: fall back to compiling the bytes
+    }
+  }
+  return instantiate(await response.arrayBuffer());
+}
+
+/**
+ * Load the standalone module
+ *
+ * @param {Object} [options]
+ * @param {WebAssembly.Module|BufferSource|Response|Promise<Response>|URL|string} [options.wasm]
+ *   Compiled module (e.g. a Cloudflare Workers wasm import), its bytes, a
+ *   fetch() response, or its URL; defaults to dist/falcon-standalone.wasm
+ * @returns {Promise<Object>} Module object for Falcon512#init()
+ */
+export default async function createFalconModule({ wasm = DEFAULT_WASM } = {}) {
+  const instance = await instantiate(wasm);
+  const exports = instance.exports;
+  const memory = exports.memory;
+
+  // Reactor modules run their static constructors here
+  if (typeof exports._initialize === 'function') {
+    exports._initialize();
+  }
+
+  const module = {};
+  for (const [name, value] of Object.entries(exports)) {
+    if (typeof value === 'function') {
+      module[`_${name}`] = value;
+    }
+  }
+
+  // Views are rebuilt after memory growth, which detaches the old buffer
+  let buffer = null;
+  let views = null;
+  const heap = () => {
+    if (buffer !== memory.buffer) {
+      buffer = memory.buffer;
+      views = {
+        HEAP8: new Int8Array(buffer),
+        HEAPU8: new Uint8Array(buffer),
+        HEAP16: new Int16Array(buffer),
+        HEAPU16: new Uint16Array(buffer),
+        HEAP32: new Int32Array(buffer),
+        HEAPU32: new Uint32Array(buffer),
+        HEAPF64: new Float64Array(buffer),
+      };
+    }
+    return views;
+  };
+  for (const name of ['HEAP8', 'HEAPU8', 'HEAP16', 'HEAPU16', 'HEAP32', 'HEAPU32', 'HEAPF64']) {
+    Object.defineProperty(module, name, { get: () => heap()[name], enumerable: true });
+  }
+
+  // Seedless entropy pool calls get their seed from crypto.getRandomValues()
+  const withSystemSeed = (fn) => (seedPtr, seedLength, ...rest) => {
+    if (seedLength !== 0) {
+      return fn(seedPtr, seedLength, ...rest);
+    }
+    const ptr = exports.wasm_malloc(SYSTEM_SEED_SIZE);
+    if (ptr === 0) {
+      return fn(seedPtr, seedLength, ...rest);
+    }
+    try {
+      crypto.getRandomValues(module.HEAPU8.subarray(ptr, ptr + SYSTEM_SEED_SIZE));
+      return fn(ptr, SYSTEM_SEED_SIZE, ...rest);
+    } finally {
+      module.HEAPU8.fill(0, ptr, ptr + SYSTEM_SEED_SIZE);
+      exports.wasm_free(ptr);
+    }
+  };
+  module._falcon512_entropy_pool_init = withSystemSeed(exports.falcon512_entropy_pool_init);
+  module._falcon512_entropy_pool_reseed = withSystemSeed(exports.falcon512_entropy_pool_reseed);
+
+  return module;
+}
@@ -9,6 +9,51 @@ const FALCON512_N = 512;
 const FALCON512_PRIVKEY_SIZE = 1281;
 const FALCON512_PUBKEY_SIZE = 897;
 const FALCON512_SIG_MAX_SIZE = 752;
+const FALCON512_EXPANDED_KEY_BLOB_SIZE = 57376;
+
+// Key pairs checked per WASM call by importKeyPairs (bounds WASM heap usage)
+const IMPORT_CHUNK_SIZE = 1024;
+
+// Feature probes: tiny modules that only validate if the engine supports
+// SIMD128 (i8x16.popcnt) or relaxed-SIMD (f64x2.relaxed_madd).
+const WASM_SIMD128_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0,
+  10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11,
+]);
+const WASM_RELAXED_SIMD_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0,
+  10, 19, 1, 17, 0, 65, 0, 253, 15, 65, 0, 253, 15, 65, 0, 253, 15,
+  253, 135, 2, 11,
+]);
+
+// Module builds, fastest first (see `./build.sh simd`). The low-memory build
+// (`./build.sh lowmem`) is slower and only loaded when asked for by name.
+const WASM_VARIANTS = [
+  { name: 'relaxed', requires: 'relaxedSimd', load: () => import('../dist/falcon-relaxed.js') },
+  { name: 'simd', requires: 'simd128', load: () => import('../dist/falcon-simd.js') },
+  { name: 'baseline', requires: null, load: () => import('../dist/falcon.js') },
+  { name: 'lowmem', requires: null, auto: false, load: () => import('../dist/falcon-lowmem.js') },
+  { name: 'standalone', requires: null, auto: false, load: () => import('./falcon-standalone.js') },
+];
+
+/**
+ * Detect WebAssembly features used by the SIMD module builds
+ *
+ * @returns {{simd128: boolean, relaxedSimd: boolean}} Supported features
+ */
+export function detectWasmFeatures() {
+  const validate = (bytes) => {
+    try {
+      return typeof WebAssembly === 'object' && WebAssembly.validate(bytes);
+    } catch (e) {
+      return false;
+    }
+  };
+  return {
+    simd128: validate(WASM_SIMD128_PROBE),
+    relaxedSimd: validate(WASM_RELAXED_SIMD_PROBE),
+  };
+}
 
 /**
  * Falcon-512 WebAssembly API
@@ -17,6 +62,50 @@ export class Falcon512 {
   constructor() {
     this.module = null;
     this.initialized = false;
+    this.entropyPoolReady = false;
+    this.variant = null;
+  }
+
+  /**
+   * Create and initialize an instance with the fastest module build the
+   * engine supports: relaxed-SIMD FMA, then SIMD128, then the baseline
+   * build. Builds missing from dist/ are skipped.
+   *
+   * @param {Object} [options]
+   * @param {string} [options.variant='auto'] - 'auto', or force 'relaxed', 'simd', 'baseline',
+   *   'lowmem' (small initial memory and signing buffers) or 'standalone' (no Emscripten
+   *   glue, see falcon-standalone.js); the last two are never picked by 'auto'
+   * @returns {Promise<Falcon512>} Initialized instance; `variant` names the loaded build
+   */
+  static async load({ variant = 'auto' } = {}) {
+    let candidates;
+    if (variant === 'auto') {
+      const features = detectWasmFeatures();
+      candidates = WASM_VARIANTS.filter((v) =>
+        v.auto !== false && (!v.requires || features[v.requires]));
+    } else {
+      candidates = WASM_VARIANTS.filter((v) => v.name === variant);
+      if (candidates.length === 0) {
+        throw new Error(`Unknown WASM variant: ${variant}`);
+      }
+    }
+
+    let lastError = null;
+    for (const v of candidates) {
+      // A build whose glue imports but whose module fails to fetch or
+      // instantiate falls through to the next one as well
+      const falcon = new Falcon512();
+      try {
+        const mod = await v.load();
+        await falcon.init(mod.default || mod);
+      } catch (e) {
+        lastError = e;
+        continue;
+      }
+      falcon.variant = v.name;
+      return falcon;
+    }
+    throw lastError;
   }
 
   /**
@@ -102,12 +191,246 @@ export class Falcon512 {
     }
   }
 
+  /**
+   * Generate a Falcon-512 keypair from a seed, together with its expanded
+   * key blob, in one call.
+   *
+   * Same keypair as {@link createKeypairFromSeed}, and same blob as
+   * {@link expandPrivateKey} on its private key, but faster than the two
+   * calls: the key generation already has what the expansion needs. Meant
+   * for short-lived keys that sign right away, through {@link openSigner}.
+   *
+   * @param {Uint8Array} seed - Seed bytes (recommended: 48 bytes for security)
+   * @returns {{publicKey: Uint8Array, privateKey: Uint8Array, expandedKey: Uint8Array}} Keys, and the expanded key blob (57376 bytes)
+   */
+  createKeypairExpandedFromSeed(seed) {
+    const module = this.ensureInitialized();
+
+    // The key is expanded in place, just past the blob header
+    const bufferSize = module._falcon512_get_expanded_key_buffer_size();
+    const seedPtr = module._wasm_malloc(seed.length);
+    const privkeyPtr = module._wasm_malloc(FALCON512_PRIVKEY_SIZE);
+    const pubkeyPtr = module._wasm_malloc(FALCON512_PUBKEY_SIZE);
+    const blobPtr = module._wasm_malloc(bufferSize);
+
+    try {
+      module.HEAPU8.set(seed, seedPtr);
+
+      const result = module._falcon512_keygen_expanded_from_seed(
+        seedPtr, seed.length,
+        privkeyPtr, pubkeyPtr,
+        blobPtr
+      );
+
+      if (result !== 0) {
+        throw new Error(`Keypair generation failed with error code: ${result}`);
+      }
+
+      // Copy results back to JavaScript
+      const privateKey = new Uint8Array(FALCON512_PRIVKEY_SIZE);
+      const publicKey = new Uint8Array(FALCON512_PUBKEY_SIZE);
+      const expandedKey = new Uint8Array(FALCON512_EXPANDED_KEY_BLOB_SIZE);
+
+      privateKey.set(module.HEAPU8.subarray(privkeyPtr, privkeyPtr + FALCON512_PRIVKEY_SIZE));
+      publicKey.set(module.HEAPU8.subarray(pubkeyPtr, pubkeyPtr + FALCON512_PUBKEY_SIZE));
+      expandedKey.set(module.HEAPU8.subarray(blobPtr, blobPtr + FALCON512_EXPANDED_KEY_BLOB_SIZE));
+
+      return { privateKey, publicKey, expandedKey };
+
+    } finally {
+      // Clear sensitive data
+      module.HEAPU8.fill(0, seedPtr, seedPtr + seed.length);
+      module.HEAPU8.fill(0, privkeyPtr, privkeyPtr + FALCON512_PRIVKEY_SIZE);
+      module.HEAPU8.fill(0, blobPtr, blobPtr + bufferSize);
+      module._wasm_free(seedPtr);
+      module._wasm_free(privkeyPtr);
+      module._wasm_free(pubkeyPtr);
+      module._wasm_free(blobPtr);
+    }
+  }
+
+  /**
+   * Check that each private key matches its public key, for many key pairs.
+   *
+   * Each private key is decoded, its public key recomputed and compared with
+   * the supplied one, inside WASM, a chunk of key pairs per call. Keys can be
+   * given as arrays or as flat buffers of N×1281 / N×897 bytes. With
+   * `ntt: true`, the NTT form of every decodable public key (as used by
+   * verification) is returned as well.
+   *
+   * Codes are 0 for a match, -3 (FALCON_ERR_FORMAT) if either key cannot be
+   * decoded, and -7 (FALCON_ERR_MISMATCH) if the keys do not belong together.
+   *
+   * @param {Uint8Array[]|Uint8Array} privateKeys - Falcon-512 private keys (1281 bytes each)
+   * @param {Uint8Array[]|Uint8Array} publicKeys - Falcon-512 public keys (897 bytes each), one per private key
+   * @param {Object} [options]
+   * @param {boolean} [options.ntt=false] - Also return the NTT-form public keys
+   * @returns {{valid: boolean[], codes: Int32Array, publicKeysNtt: Uint16Array|null}} Per-pair results; publicKeysNtt holds N×512 values
+   */
+  importKeyPairs(privateKeys, publicKeys, { ntt = false } = {}) {
+    const module = this.ensureInitialized();
+
+    const flatten = (keys, size, what) => {
+      if (keys instanceof Uint8Array) {
+        if (keys.length % size !== 0) {
+          throw new Error(`Invalid ${what} buffer size: ${keys.length} is not a multiple of ${size}`);
+        }
+        return keys;
+      }
+      const flat = new Uint8Array(keys.length * size);
+      keys.forEach((key, i) => {
+        if (key.length !== size) {
+          throw new Error(`Invalid ${what} size: expected ${size}, got ${key.length}`);
+        }
+        flat.set(key, i * size);
+      });
+      return flat;
+    };
+    const sks = flatten(privateKeys, FALCON512_PRIVKEY_SIZE, 'private key');
+    const pks = flatten(publicKeys, FALCON512_PUBKEY_SIZE, 'public key');
+    const count = sks.length / FALCON512_PRIVKEY_SIZE;
+    if (pks.length / FALCON512_PUBKEY_SIZE !== count) {
+      throw new Error(`Invalid public key count: expected ${count}, got ${pks.length / FALCON512_PUBKEY_SIZE}`);
+    }
+
+    const codes = new Int32Array(count);
+    const publicKeysNtt = ntt ? new Uint16Array(count * FALCON512_N) : null;
+
+    const chunk = Math.max(Math.min(count, IMPORT_CHUNK_SIZE), 1);
+    const skPtr = module._wasm_malloc(chunk * FALCON512_PRIVKEY_SIZE);
+    const pkPtr = module._wasm_malloc(chunk * FALCON512_PUBKEY_SIZE);
+    const nttPtr = ntt ? module._wasm_malloc(chunk * FALCON512_N * 2) : 0;
+    const resultsPtr = module._wasm_malloc(chunk * 4);
+
+    try {
+      for (let start = 0; start < count; start += chunk) {
+        const n = Math.min(chunk, count - start);
+        module.HEAPU8.set(sks.subarray(start * FALCON512_PRIVKEY_SIZE,
+          (start + n) * FALCON512_PRIVKEY_SIZE), skPtr);
+        module.HEAPU8.set(pks.subarray(start * FALCON512_PUBKEY_SIZE,
+          (start + n) * FALCON512_PUBKEY_SIZE), pkPtr);
+
+        const result = module._falcon512_import_keys_batch(
+          skPtr, pkPtr, n,
+          nttPtr,
+          resultsPtr
+        );
+
+        if (result < 0) {
+          throw new Error(`importKeyPairs failed with error code: ${result}`);
+        }
+
+        codes.set(new Int32Array(module.HEAP32.buffer, resultsPtr, n), start);
+        if (ntt) {
+          publicKeysNtt.set(new Uint16Array(module.HEAPU16.buffer, nttPtr, n * FALCON512_N),
+            start * FALCON512_N);
+        }
+      }
+
+      const valid = Array.from(codes, (code) => code === 0);
+      return { valid, codes, publicKeysNtt };
+
+    } finally {
+      // Private keys must not linger in WASM memory
+      module.HEAPU8.fill(0, skPtr, skPtr + chunk * FALCON512_PRIVKEY_SIZE);
+      module._wasm_free(skPtr);
+      module._wasm_free(pkPtr);
+      if (ntt) {
+        module._wasm_free(nttPtr);
+      }
+      module._wasm_free(resultsPtr);
+    }
+  }
+
+  /**
+   * Seed the internal entropy pool used by {@link signMessage} when no
+   * rngSeed is given.
+   *
+   * Without a seed, the pool is seeded once from the system RNG
+   * (crypto.getRandomValues) and reseeded from it every `reseedInterval`
+   * signatures. With a seed, pooled signing is fully deterministic (useful
+   * for tests); reseeding then only ratchets the pool state forward.
+   * Each signature forks its own PRNG state from the pool inside WASM.
+   *
+   * @param {Object} [options]
+   * @param {Uint8Array} [options.seed] - Seed for a deterministic pool (recommended: 48 bytes)
+   * @param {number} [options.reseedInterval=0] - Signatures between reseeds (0 = never)
+   */
+  initEntropyPool({ seed, reseedInterval = 0 } = {}) {
+    const module = this.ensureInitialized();
+
+    const seedLength = seed ? seed.length : 0;
+    const seedPtr = module._wasm_malloc(Math.max(seedLength, 1));
+
+    try {
+      if (seed) {
+        module.HEAPU8.set(seed, seedPtr);
+      }
+
+      const result = module._falcon512_entropy_pool_init(
+        seedPtr, seedLength,
+        reseedInterval
+      );
+
+      if (result !== 0) {
+        throw new Error(`Entropy pool initialization failed with error code: ${result}`);
+      }
+
+      this.entropyPoolReady = true;
+
+    } finally {
+      module.HEAPU8.fill(0, seedPtr, seedPtr + seedLength);
+      module._wasm_free(seedPtr);
+    }
+  }
+
+  /**
+   * Mix fresh entropy into the internal entropy pool
+   *
+   * @param {Uint8Array} [seed] - Extra seed bytes; the system RNG is used if omitted
+   */
+  reseedEntropyPool(seed) {
+    const module = this.ensureInitialized();
+
+    const seedLength = seed ? seed.length : 0;
+    const seedPtr = module._wasm_malloc(Math.max(seedLength, 1));
+
+    try {
+      if (seed) {
+        module.HEAPU8.set(seed, seedPtr);
+      }
+
+      const result = module._falcon512_entropy_pool_reseed(seedPtr, seedLength);
+
+      if (result !== 0) {
+        throw new Error(`Entropy pool reseed failed with error code: ${result}`);
+      }
+
+    } finally {
+      module.HEAPU8.fill(0, seedPtr, seedPtr + seedLength);
+      module._wasm_free(seedPtr);
+    }
+  }
+
+  /**
+   * Wipe the internal entropy pool
+   */
+  clearEntropyPool() {
+    const module = this.ensureInitialized();
+    module._falcon512_entropy_pool_clear();
+    this.entropyPoolReady = false;
+  }
+
   /**
    * Sign a message with a Falcon-512 private key
+   *
+   * When rngSeed is omitted, signature randomness comes from the internal
+   * entropy pool (see {@link initEntropyPool}), which is seeded from the
+   * system RNG on first use.
    * 
    * @param {Uint8Array} message - Message to sign
    * @param {Uint8Array} privateKey - Private key (1281 bytes)
-   * @param {Uint8Array} rngSeed - Seed for signature randomness (recommended: 48 bytes)
+   * @param {Uint8Array} [rngSeed] - Seed for signature randomness (recommended: 48 bytes); null or omitted uses the entropy pool
    * @returns {Uint8Array} Signature bytes (compressed format, ~652 bytes average)
    */
   signMessage(message, privateKey, rngSeed) {
@@ -116,6 +439,10 @@ export class Falcon512 {
     if (privateKey.length !== FALCON512_PRIVKEY_SIZE) {
       throw new Error(`Invalid private key size: expected ${FALCON512_PRIVKEY_SIZE}, got ${privateKey.length}`);
     }
+
+    if (rngSeed == null) {
+      return this.signMessagePooled(message, privateKey);
+    }
     
     // Allocate memory
     const messagePtr = module._wasm_malloc(message.length);
@@ -165,6 +492,138 @@ export class Falcon512 {
     }
   }
 
+  /**
+   * Sign with randomness forked from the internal entropy pool
+   * @private
+   */
+  signMessagePooled(message, privateKey) {
+    const module = this.ensureInitialized();
+
+    if (!this.entropyPoolReady) {
+      this.initEntropyPool();
+    }
+
+    // Allocate memory
+    const messagePtr = module._wasm_malloc(message.length);
+    const privkeyPtr = module._wasm_malloc(privateKey.length);
+    const sigPtr = module._wasm_malloc(FALCON512_SIG_MAX_SIZE);
+    const sigLenPtr = module._wasm_malloc(8); // size_t
+
+    try {
+      // Copy inputs to WASM memory
+      module.HEAPU8.set(message, messagePtr);
+      module.HEAPU8.set(privateKey, privkeyPtr);
+
+      // Set initial signature length
+      const sigLenView = new DataView(module.HEAPU8.buffer, sigLenPtr, 8);
+      sigLenView.setUint32(0, FALCON512_SIG_MAX_SIZE, true);
+
+      // Sign message
+      const result = module._falcon512_sign_pooled(
+        messagePtr, message.length,
+        privkeyPtr,
+        sigPtr, sigLenPtr
+      );
+
+      if (result !== 0) {
+        throw new Error(`Signature generation failed with error code: ${result}`);
+      }
+
+      // Get actual signature length
+      const actualSigLen = sigLenView.getUint32(0, true);
+
+      // Copy signature back
+      const signature = new Uint8Array(actualSigLen);
+      signature.set(module.HEAPU8.subarray(sigPtr, sigPtr + actualSigLen));
+
+      return signature;
+
+    } finally {
+      // Clean up
+      module._wasm_free(messagePtr);
+      module._wasm_free(privkeyPtr);
+      module._wasm_free(sigPtr);
+      module._wasm_free(sigLenPtr);
+    }
+  }
+
+  /**
+   * Expand a private key for fast repeated signing, and serialize it.
+   *
+   * The returned blob (57376 bytes) is versioned and checksummed; it can be
+   * written to storage and passed to {@link openSigner} after a restart,
+   * which skips the key expansion entirely. It holds secret key material
+   * and must be protected like the private key.
+   *
+   * @param {Uint8Array} privateKey - Private key (1281 bytes)
+   * @returns {Uint8Array} Expanded key blob
+   */
+  expandPrivateKey(privateKey) {
+    const module = this.ensureInitialized();
+
+    if (privateKey.length !== FALCON512_PRIVKEY_SIZE) {
+      throw new Error(`Invalid private key size: expected ${FALCON512_PRIVKEY_SIZE}, got ${privateKey.length}`);
+    }
+
+    // The key is expanded in place, just past the blob header
+    const bufferSize = module._falcon512_get_expanded_key_buffer_size();
+    const privkeyPtr = module._wasm_malloc(privateKey.length);
+    const blobPtr = module._wasm_malloc(bufferSize);
+
+    try {
+      module.HEAPU8.set(privateKey, privkeyPtr);
+
+      const result = module._falcon512_expand_privkey_blob(privkeyPtr, blobPtr);
+
+      if (result !== 0) {
+        throw new Error(`Private key expansion failed with error code: ${result}`);
+      }
+
+      const blob = new Uint8Array(FALCON512_EXPANDED_KEY_BLOB_SIZE);
+      blob.set(module.HEAPU8.subarray(blobPtr, blobPtr + FALCON512_EXPANDED_KEY_BLOB_SIZE));
+      return blob;
+
+    } finally {
+      // Clear sensitive data
+      module.HEAPU8.fill(0, privkeyPtr, privkeyPtr + privateKey.length);
+      module.HEAPU8.fill(0, blobPtr, blobPtr + bufferSize);
+      module._wasm_free(privkeyPtr);
+      module._wasm_free(blobPtr);
+    }
+  }
+
+  /**
+   * Open a signing handle on an expanded key blob from
+   * {@link expandPrivateKey}.
+   *
+   * The blob is copied into WASM memory once and checked (header, length
+   * and checksum); signatures are then computed from it in place. Call
+   * `close()` on the handle to wipe and release that memory.
+   *
+   * @param {Uint8Array} blob - Expanded key blob (57376 bytes)
+   * @returns {Falcon512Signer} Signing handle
+   */
+  openSigner(blob) {
+    const module = this.ensureInitialized();
+
+    if (blob.length !== FALCON512_EXPANDED_KEY_BLOB_SIZE) {
+      throw new Error(`Invalid expanded key blob size: expected ${FALCON512_EXPANDED_KEY_BLOB_SIZE}, got ${blob.length}`);
+    }
+
+    // wasm_malloc() memory is 8-byte aligned, as the blob must be
+    const blobPtr = module._wasm_malloc(blob.length);
+    module.HEAPU8.set(blob, blobPtr);
+
+    const result = module._falcon512_signer_open(blobPtr, blob.length);
+    if (result !== 0) {
+      module.HEAPU8.fill(0, blobPtr, blobPtr + blob.length);
+      module._wasm_free(blobPtr);
+      throw new Error(`Expanded key blob rejected with error code: ${result}`);
+    }
+
+    return new Falcon512Signer(this, blobPtr);
+  }
+
   /**
    * Verify a Falcon-512 signature
    * 
@@ -209,6 +668,45 @@ export class Falcon512 {
     }
   }
 
+  /**
+   * Verify a run of packed verification records (see src/falcon-ring.js).
+   *
+   * The records are copied into WASM memory in one block; `records` may be a
+   * view on a SharedArrayBuffer.
+   *
+   * @param {Uint8Array} records - Concatenated records
+   * @param {number} count - Number of records
+   * @returns {Int32Array} count (id, result) pairs; result 0 means valid
+   */
+  verifyRecords(records, count) {
+    const module = this.ensureInitialized();
+
+    const recordsPtr = module._wasm_malloc(Math.max(records.length, 1));
+    const outPtr = module._wasm_malloc(Math.max(count, 1) * 8);
+
+    try {
+      module.HEAPU8.set(records, recordsPtr);
+
+      const result = module._falcon512_verify_records(
+        recordsPtr, records.length,
+        count,
+        outPtr
+      );
+
+      if (result !== count) {
+        throw new Error(`verifyRecords failed with error code: ${result}`);
+      }
+
+      const pairs = new Int32Array(count * 2);
+      pairs.set(new Int32Array(module.HEAP32.buffer, outPtr, count * 2));
+      return pairs;
+
+    } finally {
+      module._wasm_free(recordsPtr);
+      module._wasm_free(outPtr);
+    }
+  }
+
   /**
    * Sign a pre-computed hash-to-point polynomial with a Falcon-512 private key.
    *
@@ -319,26 +817,146 @@ export class Falcon512 {
   }
 
   /**
-   * Hash a message to a point in the Falcon-512 polynomial ring
-   * 
-   * @param {Uint8Array} message - Message to hash
-   * @returns {Int16Array} Array of 512 signed 16-bit coefficients
+   * Sign a batch of pre-computed hash-to-point polynomials with one private key.
+   *
+   * Batch equivalent of {@link signPoly}: the private key is decoded once and
+   * all polynomials are signed in a single WASM call. Block i of the result is
+   * identical to signPoly(hms.subarray(i * 512, (i + 1) * 512), privateKey).
+   *
+   * @param {Int16Array|Uint16Array} hms - N×512 hash-to-point coefficients, contiguous
+   * @param {Uint8Array} privateKey - Falcon-512 private key (1281 bytes)
+   * @returns {Int16Array} N×512 signature polynomial coefficients (s2), contiguous
    */
-  hashToPoint(message) {
+  signPolyBatch(hms, privateKey) {
     const module = this.ensureInitialized();
-    
-    // Allocate memory
-    const messagePtr = module._wasm_malloc(message.length);
-    const pointPtr = module._wasm_malloc(FALCON512_N * 2); // 512 int16_t
-    
-    try {
-      // Copy message to WASM memory
-      module.HEAPU8.set(message, messagePtr);
-      
-      // Compute hash-to-point
-      const result = module._falcon512_hash_to_point(
-        messagePtr, message.length,
-        pointPtr
+
+    if (hms.length % FALCON512_N !== 0) {
+      throw new Error(`Invalid hm batch size: ${hms.length} is not a multiple of ${FALCON512_N}`);
+    }
+    if (privateKey.length !== FALCON512_PRIVKEY_SIZE) {
+      throw new Error(`Invalid private key size: expected ${FALCON512_PRIVKEY_SIZE}, got ${privateKey.length}`);
+    }
+
+    const count = hms.length / FALCON512_N;
+    if (count === 0) {
+      return new Int16Array(0);
+    }
+    const polyBytes = hms.length * 2;
+    const hmBytes = new Uint8Array(hms.buffer, hms.byteOffset, polyBytes);
+
+    const hmPtr = module._wasm_malloc(polyBytes);
+    const privkeyPtr = module._wasm_malloc(privateKey.length);
+    const svPtr = module._wasm_malloc(polyBytes);
+
+    try {
+      module.HEAPU8.set(hmBytes, hmPtr);
+      module.HEAPU8.set(privateKey, privkeyPtr);
+
+      const result = module._falcon512_sign_poly_batch(
+        hmPtr, count,
+        privkeyPtr,
+        svPtr
+      );
+
+      if (result !== 0) {
+        throw new Error(`signPolyBatch failed with error code: ${result}`);
+      }
+
+      const svs = new Int16Array(hms.length);
+      svs.set(new Int16Array(module.HEAP16.buffer, svPtr, hms.length));
+      return svs;
+
+    } finally {
+      module._wasm_free(hmPtr);
+      module._wasm_free(privkeyPtr);
+      module._wasm_free(svPtr);
+    }
+  }
+
+  /**
+   * Verify a batch of signature polynomials under one public key.
+   *
+   * Batch equivalent of {@link verifyPoly}: the public key is decoded once and
+   * all (hm, sv) pairs are checked in a single WASM call.
+   *
+   * @param {Int16Array|Uint16Array} hms - N×512 hash-to-point coefficients, contiguous
+   * @param {Int16Array} svs - N×512 signature polynomial coefficients, contiguous
+   * @param {Uint8Array} publicKey - Falcon-512 public key (897 bytes)
+   * @returns {boolean[]} Per-pair validity, in input order
+   */
+  verifyPolyBatch(hms, svs, publicKey) {
+    const module = this.ensureInitialized();
+
+    if (hms.length % FALCON512_N !== 0) {
+      throw new Error(`Invalid hm batch size: ${hms.length} is not a multiple of ${FALCON512_N}`);
+    }
+    if (svs.length !== hms.length) {
+      throw new Error(`Invalid sv batch size: expected ${hms.length}, got ${svs.length}`);
+    }
+    if (publicKey.length !== FALCON512_PUBKEY_SIZE) {
+      throw new Error(`Invalid public key size: expected ${FALCON512_PUBKEY_SIZE}, got ${publicKey.length}`);
+    }
+
+    const count = hms.length / FALCON512_N;
+    if (count === 0) {
+      return [];
+    }
+    const polyBytes = hms.length * 2;
+    const hmBytes = new Uint8Array(hms.buffer, hms.byteOffset, polyBytes);
+    const svBytes = new Uint8Array(svs.buffer, svs.byteOffset, polyBytes);
+
+    const hmPtr = module._wasm_malloc(polyBytes);
+    const svPtr = module._wasm_malloc(polyBytes);
+    const pubkeyPtr = module._wasm_malloc(publicKey.length);
+    const resultsPtr = module._wasm_malloc(count * 4);
+
+    try {
+      module.HEAPU8.set(hmBytes, hmPtr);
+      module.HEAPU8.set(svBytes, svPtr);
+      module.HEAPU8.set(publicKey, pubkeyPtr);
+
+      const result = module._falcon512_verify_poly_batch(
+        hmPtr, svPtr, count,
+        pubkeyPtr,
+        resultsPtr
+      );
+
+      if (result < 0) {
+        throw new Error(`verifyPolyBatch failed with error code: ${result}`);
+      }
+
+      const codes = new Int32Array(module.HEAP32.buffer, resultsPtr, count);
+      return Array.from(codes, (code) => code === 0);
+
+    } finally {
+      module._wasm_free(hmPtr);
+      module._wasm_free(svPtr);
+      module._wasm_free(pubkeyPtr);
+      module._wasm_free(resultsPtr);
+    }
+  }
+
+  /**
+   * Hash a message to a point in the Falcon-512 polynomial ring
+   * 
+   * @param {Uint8Array} message - Message to hash
+   * @returns {Int16Array} Array of 512 signed 16-bit coefficients
+   */
+  hashToPoint(message) {
+    const module = this.ensureInitialized();
+    
+    // Allocate memory
+    const messagePtr = module._wasm_malloc(message.length);
+    const pointPtr = module._wasm_malloc(FALCON512_N * 2); // 512 int16_t
+    
+    try {
+      // Copy message to WASM memory
+      module.HEAPU8.set(message, messagePtr);
+      
+      // Compute hash-to-point
+      const result = module._falcon512_hash_to_point(
+        messagePtr, message.length,
+        pointPtr
       );
       
       if (result !== 0) {
@@ -359,6 +977,59 @@ export class Falcon512 {
     }
   }
 
+  /**
+   * Hash a batch of messages to points in the Falcon-512 polynomial ring
+   *
+   * Batch equivalent of {@link hashToPoint}: all messages are copied into WASM
+   * memory at once and hashed in a single call.
+   *
+   * @param {Uint8Array[]} messages - Messages to hash
+   * @returns {Int16Array} N×512 signed 16-bit coefficients, contiguous
+   */
+  hashToPointBatch(messages) {
+    const module = this.ensureInitialized();
+
+    const count = messages.length;
+    let totalLength = 0;
+    for (const message of messages) {
+      totalLength += message.length;
+    }
+
+    // Allocate memory (at least one byte so that empty batches are valid)
+    const messagesPtr = module._wasm_malloc(Math.max(totalLength, 1));
+    const lengthsPtr = module._wasm_malloc(Math.max(count * 4, 4));
+    const pointsPtr = module._wasm_malloc(Math.max(count * FALCON512_N * 2, 2));
+
+    try {
+      // Copy messages back to back, and their lengths
+      const lengths = new Uint32Array(module.HEAPU32.buffer, lengthsPtr, count);
+      let offset = messagesPtr;
+      messages.forEach((message, i) => {
+        module.HEAPU8.set(message, offset);
+        lengths[i] = message.length;
+        offset += message.length;
+      });
+
+      const result = module._falcon512_hash_to_point_batch(
+        messagesPtr, lengthsPtr, count,
+        pointsPtr
+      );
+
+      if (result !== 0) {
+        throw new Error(`Hash-to-point batch failed with error code: ${result}`);
+      }
+
+      const points = new Int16Array(count * FALCON512_N);
+      points.set(new Int16Array(module.HEAP16.buffer, pointsPtr, count * FALCON512_N));
+      return points;
+
+    } finally {
+      module._wasm_free(messagesPtr);
+      module._wasm_free(lengthsPtr);
+      module._wasm_free(pointsPtr);
+    }
+  }
+
   /**
    * Extract coefficients from a Falcon-512 public key
    * 
@@ -405,11 +1076,29 @@ export class Falcon512 {
 
   /**
    * Extract coefficients from a Falcon-512 signature
+   *
+   * s1 is the polynomial encoded in the signature. When the signed message
+   * and the public key are supplied, s0 is recovered exactly as
+   * hm - s1·h mod q (normalized to [-q/2, q/2]); without them, s0 is only an
+   * approximation. Passing only one of them is an error.
    * 
    * @param {Uint8Array} signature - Encoded signature
+   * @param {Uint8Array} [message] - Signed message (requires publicKey)
+   * @param {Uint8Array} [publicKey] - Public key (897 bytes, requires message)
    * @returns {{s0: Int16Array, s1: Int16Array}} Object with s0 and s1 coefficient arrays (512 elements each)
    */
-  getSignatureCoefficients(signature) {
+  getSignatureCoefficients(signature, message, publicKey) {
+    if (message !== undefined || publicKey !== undefined) {
+      if (message === undefined || publicKey === undefined) {
+        throw new Error('Exact signature coefficients need both the message and the public key');
+      }
+      const { s0, s1, valid } = this.getSignatureCoefficientsBatch([signature], [message], publicKey);
+      if (!valid[0]) {
+        throw new Error('Failed to recover signature coefficients: signature does not match message and public key');
+      }
+      return { s0, s1 };
+    }
+
     const module = this.ensureInitialized();
     
     // Allocate memory
@@ -451,6 +1140,136 @@ export class Falcon512 {
     }
   }
 
+  /**
+   * Extract the exact coefficients from a batch of Falcon-512 signatures
+   *
+   * Batch equivalent of getSignatureCoefficients(signature, message, publicKey).
+   * The public key's NTT form is prepared once and reused while consecutive
+   * items share the same key. Items whose signature cannot be decoded or does
+   * not verify are reported in `valid`; the coefficients of decodable but
+   * invalid signatures are still returned, and those of items that cannot be
+   * decoded are zero.
+   *
+   * @param {Uint8Array[]} signatures - Encoded signatures
+   * @param {Uint8Array[]} messages - Signed messages, one per signature
+   * @param {Uint8Array|Uint8Array[]} publicKeys - One public key for all items, or one per item
+   * @returns {{s0: Int16Array, s1: Int16Array, valid: boolean[]}} N×512 coefficients for each half, contiguous
+   */
+  getSignatureCoefficientsBatch(signatures, messages, publicKeys) {
+    const module = this.ensureInitialized();
+
+    const count = signatures.length;
+    if (messages.length !== count) {
+      throw new Error(`Invalid message count: expected ${count}, got ${messages.length}`);
+    }
+    const sharedKey = publicKeys instanceof Uint8Array;
+    const keys = sharedKey ? [publicKeys] : publicKeys;
+    if (!sharedKey && keys.length !== count) {
+      throw new Error(`Invalid public key count: expected ${count}, got ${keys.length}`);
+    }
+    for (const key of keys) {
+      if (key.length !== FALCON512_PUBKEY_SIZE) {
+        throw new Error(`Invalid public key size: expected ${FALCON512_PUBKEY_SIZE}, got ${key.length}`);
+      }
+    }
+
+    let sigTotal = 0;
+    let msgTotal = 0;
+    for (let i = 0; i < count; i++) {
+      sigTotal += signatures[i].length;
+      msgTotal += messages[i].length;
+    }
+
+    // Allocate memory (at least one byte per buffer so that empty batches are valid)
+    const sigsPtr = module._wasm_malloc(Math.max(sigTotal, 1));
+    const sigLensPtr = module._wasm_malloc(Math.max(count * 4, 4));
+    const msgsPtr = module._wasm_malloc(Math.max(msgTotal, 1));
+    const msgLensPtr = module._wasm_malloc(Math.max(count * 4, 4));
+    const pubkeysPtr = module._wasm_malloc(keys.length * FALCON512_PUBKEY_SIZE);
+    const s0Ptr = module._wasm_malloc(Math.max(count * FALCON512_N * 2, 2));
+    const s1Ptr = module._wasm_malloc(Math.max(count * FALCON512_N * 2, 2));
+    const resultsPtr = module._wasm_malloc(Math.max(count * 4, 4));
+
+    try {
+      // Copy signatures, messages and keys back to back
+      const sigLens = new Uint32Array(module.HEAPU32.buffer, sigLensPtr, count);
+      const msgLens = new Uint32Array(module.HEAPU32.buffer, msgLensPtr, count);
+      let sigOffset = sigsPtr;
+      let msgOffset = msgsPtr;
+      for (let i = 0; i < count; i++) {
+        module.HEAPU8.set(signatures[i], sigOffset);
+        module.HEAPU8.set(messages[i], msgOffset);
+        sigLens[i] = signatures[i].length;
+        msgLens[i] = messages[i].length;
+        sigOffset += signatures[i].length;
+        msgOffset += messages[i].length;
+      }
+      keys.forEach((key, i) => {
+        module.HEAPU8.set(key, pubkeysPtr + i * FALCON512_PUBKEY_SIZE);
+      });
+
+      const result = module._falcon512_recover_signature_coefficients_batch(
+        sigsPtr, sigLensPtr,
+        msgsPtr, msgLensPtr,
+        count,
+        pubkeysPtr, sharedKey ? 0 : FALCON512_PUBKEY_SIZE,
+        s0Ptr, s1Ptr,
+        resultsPtr
+      );
+
+      if (result < 0) {
+        throw new Error(`Failed to recover signature coefficients: error code ${result}`);
+      }
+
+      // Copy results back
+      const s0 = new Int16Array(count * FALCON512_N);
+      const s1 = new Int16Array(count * FALCON512_N);
+      s0.set(new Int16Array(module.HEAP16.buffer, s0Ptr, count * FALCON512_N));
+      s1.set(new Int16Array(module.HEAP16.buffer, s1Ptr, count * FALCON512_N));
+      const codes = new Int32Array(module.HEAP32.buffer, resultsPtr, count);
+      const valid = Array.from(codes, (code) => code === 0);
+
+      return { s0, s1, valid };
+
+    } finally {
+      // Clean up
+      module._wasm_free(sigsPtr);
+      module._wasm_free(sigLensPtr);
+      module._wasm_free(msgsPtr);
+      module._wasm_free(msgLensPtr);
+      module._wasm_free(pubkeysPtr);
+      module._wasm_free(s0Ptr);
+      module._wasm_free(s1Ptr);
+      module._wasm_free(resultsPtr);
+    }
+  }
+
+  /**
+   * Allocate a batch of polynomials of Z_q[x]/(x^512+1) in WASM memory.
+   *
+   * @param {number|Int16Array|Uint16Array|number[]} countOrCoeffs - Number
+   *   of polynomials (all zero), or N×512 coefficients to start from
+   *   (signed values are reduced modulo q)
+   * @returns {Falcon512PolyBatch} Batch handle; call `close()` to free it
+   */
+  polyBatch(countOrCoeffs) {
+    const module = this.ensureInitialized();
+
+    const fromCoeffs = typeof countOrCoeffs !== 'number';
+    const count = fromCoeffs ? countOrCoeffs.length / FALCON512_N : countOrCoeffs;
+    if (!Number.isInteger(count) || count < 1) {
+      throw new Error(`Invalid polynomial batch: expected a multiple of ${FALCON512_N} coefficients`);
+    }
+
+    const ptr = module._wasm_malloc(count * FALCON512_N * 2);
+    module.HEAPU16.fill(0, ptr >> 1, (ptr >> 1) + count * FALCON512_N);
+    const batch = new Falcon512PolyBatch(this, count, ptr);
+    if (fromCoeffs) {
+      batch.set(countOrCoeffs);
+    }
+    return batch;
+  }
+
   /**
    * Get Falcon-512 constants
    */
@@ -460,10 +1279,341 @@ export class Falcon512 {
       PRIVKEY_SIZE: FALCON512_PRIVKEY_SIZE,
       PUBKEY_SIZE: FALCON512_PUBKEY_SIZE,
       SIG_MAX_SIZE: FALCON512_SIG_MAX_SIZE,
+      EXPANDED_KEY_BLOB_SIZE: FALCON512_EXPANDED_KEY_BLOB_SIZE,
       Q: 12289, // Modulus
     };
   }
 }
 
+/**
+ * Signing handle on an expanded private key held in WASM memory
+ * (see {@link Falcon512#openSigner}).
+ */
+export class Falcon512Signer {
+  /**
+   * @param {Falcon512} falcon - Instance that owns the WASM memory
+   * @param {number} blobPtr - Pointer to the opened blob
+   * @private
+   */
+  constructor(falcon, blobPtr) {
+    this.falcon = falcon;
+    this.blobPtr = blobPtr;
+  }
+
+  /**
+   * Sign a message with the expanded key.
+   *
+   * When rngSeed is omitted, signature randomness comes from the entropy
+   * pool of the owning instance, as in {@link Falcon512#signMessage}.
+   *
+   * @param {Uint8Array} message - Message to sign
+   * @param {Uint8Array} [rngSeed] - Seed for signature randomness (recommended: 48 bytes); null or omitted uses the entropy pool
+   * @returns {Uint8Array} Signature bytes (compressed format)
+   */
+  sign(message, rngSeed) {
+    if (this.blobPtr === null) {
+      throw new Error('Signer is closed');
+    }
+    const module = this.falcon.ensureInitialized();
+
+    if (rngSeed == null && !this.falcon.entropyPoolReady) {
+      this.falcon.initEntropyPool();
+    }
+    const seedLength = rngSeed ? rngSeed.length : 0;
+
+    // Allocate memory
+    const messagePtr = module._wasm_malloc(Math.max(message.length, 1));
+    const rngSeedPtr = module._wasm_malloc(Math.max(seedLength, 1));
+    const sigPtr = module._wasm_malloc(FALCON512_SIG_MAX_SIZE);
+    const sigLenPtr = module._wasm_malloc(8); // size_t
+
+    try {
+      // Copy inputs to WASM memory
+      module.HEAPU8.set(message, messagePtr);
+      if (rngSeed) {
+        module.HEAPU8.set(rngSeed, rngSeedPtr);
+      }
+
+      // Set initial signature length
+      const sigLenView = new DataView(module.HEAPU8.buffer, sigLenPtr, 8);
+      sigLenView.setUint32(0, FALCON512_SIG_MAX_SIZE, true);
+
+      // Sign message
+      const result = module._falcon512_signer_sign(
+        this.blobPtr,
+        messagePtr, message.length,
+        rngSeedPtr, seedLength,
+        sigPtr, sigLenPtr
+      );
+
+      if (result !== 0) {
+        throw new Error(`Signature generation failed with error code: ${result}`);
+      }
+
+      // Get actual signature length
+      const actualSigLen = sigLenView.getUint32(0, true);
+
+      // Copy signature back
+      const signature = new Uint8Array(actualSigLen);
+      signature.set(module.HEAPU8.subarray(sigPtr, sigPtr + actualSigLen));
+
+      return signature;
+
+    } finally {
+      // Clean up
+      module.HEAPU8.fill(0, rngSeedPtr, rngSeedPtr + seedLength);
+      module._wasm_free(messagePtr);
+      module._wasm_free(rngSeedPtr);
+      module._wasm_free(sigPtr);
+      module._wasm_free(sigLenPtr);
+    }
+  }
+
+  /**
+   * Wipe the expanded key from WASM memory and release it. The handle
+   * cannot be used afterwards.
+   */
+  close() {
+    if (this.blobPtr === null) {
+      return;
+    }
+    const module = this.falcon.ensureInitialized();
+    module.HEAPU8.fill(0, this.blobPtr, this.blobPtr + FALCON512_EXPANDED_KEY_BLOB_SIZE);
+    module._wasm_free(this.blobPtr);
+    this.blobPtr = null;
+  }
+}
+
+/**
+ * Batch of polynomials of Z_q[x]/(x^512+1) held in WASM memory
+ * (see {@link Falcon512#polyBatch}).
+ *
+ * Coefficients are kept in the 0..q-1 range. Operations run in place on the
+ * whole batch, in one WASM call, and return the batch so that they can be
+ * chained; coefficients are only copied by set(), toArray() and centered().
+ * Keeping track of which batches are in NTT representation is up to the
+ * caller.
+ *
+ * Operands of add(), sub(), mul() and mulNtt() are batches of the same
+ * length, or of length 1 (the same polynomial for every item).
+ */
+export class Falcon512PolyBatch {
+  /**
+   * @param {Falcon512} falcon - Instance that owns the WASM memory
+   * @param {number} count - Number of polynomials
+   * @param {number} ptr - Pointer to count×512 uint16_t coefficients
+   * @private
+   */
+  constructor(falcon, count, ptr) {
+    this.falcon = falcon;
+    this.length = count;
+    this.ptr = ptr;
+  }
+
+  /**
+   * Overwrite polynomials, starting at polynomial `index`.
+   *
+   * @param {Int16Array|Uint16Array|number[]} coeffs - k×512 coefficients;
+   *   signed values are reduced modulo q
+   * @param {number} [index=0] - First polynomial to overwrite
+   * @returns {Falcon512PolyBatch} this
+   */
+  set(coeffs, index = 0) {
+    const view = this.view();
+    if (coeffs.length % FALCON512_N !== 0 || index < 0
+      || index * FALCON512_N + coeffs.length > view.length) {
+      throw new Error(`Invalid coefficients: expected a multiple of ${FALCON512_N}, within the ${this.length} polynomials of the batch`);
+    }
+    const q = Falcon512.constants.Q;
+    const base = index * FALCON512_N;
+    for (let i = 0; i < coeffs.length; i++) {
+      const v = coeffs[i] % q;
+      view[base + i] = v < 0 ? v + q : v;
+    }
+    return this;
+  }
+
+  /**
+   * Live view of the coefficients in WASM memory. It is detached when the
+   * WASM memory grows: do not keep it across other calls.
+   *
+   * @returns {Uint16Array} length×512 coefficients
+   */
+  view() {
+    if (this.ptr === null) {
+      throw new Error('Polynomial batch is closed');
+    }
+    const module = this.falcon.ensureInitialized();
+    return new Uint16Array(module.HEAPU16.buffer, this.ptr, this.length * FALCON512_N);
+  }
+
+  /**
+   * @returns {Uint16Array} Copy of the coefficients (0..q-1)
+   */
+  toArray() {
+    return this.view().slice();
+  }
+
+  /**
+   * @returns {Int16Array} Copy of the coefficients, in the -6144..6144 range
+   */
+  centered() {
+    const view = this.view();
+    const q = Falcon512.constants.Q;
+    const out = new Int16Array(view.length);
+    for (let i = 0; i < view.length; i++) {
+      out[i] = view[i] > (q >> 1) ? view[i] - q : view[i];
+    }
+    return out;
+  }
+
+  /**
+   * Convert every polynomial to NTT representation.
+   *
+   * @returns {Falcon512PolyBatch} this
+   */
+  ntt() {
+    return this.run('ntt', this.ptr, this.length);
+  }
+
+  /**
+   * Convert every polynomial back from NTT representation.
+   *
+   * @returns {Falcon512PolyBatch} this
+   */
+  intt() {
+    return this.run('intt', this.ptr, this.length);
+  }
+
+  /**
+   * @param {Falcon512PolyBatch} other
+   * @returns {Falcon512PolyBatch} this, with this[i] + other[i]
+   */
+  add(other) {
+    return this.runBinary('add', other);
+  }
+
+  /**
+   * @param {Falcon512PolyBatch} other
+   * @returns {Falcon512PolyBatch} this, with this[i] - other[i]
+   */
+  sub(other) {
+    return this.runBinary('sub', other);
+  }
+
+  /**
+   * Product modulo x^512+1 (three NTTs per item; for many products by the
+   * same polynomial, use mulNtt() on NTT representations or mulPublicKey()).
+   *
+   * @param {Falcon512PolyBatch} other
+   * @returns {Falcon512PolyBatch} this, with this[i] * other[i]
+   */
+  mul(other) {
+    return this.runBinary('mul', other);
+  }
+
+  /**
+   * Coefficient-wise product of NTT representations.
+   *
+   * @param {Falcon512PolyBatch} other - Batch in NTT representation
+   * @returns {Falcon512PolyBatch} this (in NTT representation), with this[i] * other[i]
+   */
+  mulNtt(other) {
+    return this.runBinary('mul_ntt', other);
+  }
+
+  /**
+   * Multiply every polynomial by the public key polynomial h, modulo
+   * x^512+1. The key is decoded and converted once for the batch.
+   *
+   * @param {Uint8Array} publicKey - Public key (897 bytes)
+   * @returns {Falcon512PolyBatch} this, with this[i] * h
+   */
+  mulPublicKey(publicKey) {
+    const module = this.falcon.ensureInitialized();
+
+    if (publicKey.length !== FALCON512_PUBKEY_SIZE) {
+      throw new Error(`Invalid public key size: expected ${FALCON512_PUBKEY_SIZE}, got ${publicKey.length}`);
+    }
+
+    const pubkeyPtr = module._wasm_malloc(FALCON512_PUBKEY_SIZE);
+    const hPtr = module._wasm_malloc(FALCON512_N * 2);
+
+    try {
+      module.HEAPU8.set(publicKey, pubkeyPtr);
+      const result = module._falcon512_poly_prepare_public(pubkeyPtr, hPtr);
+      if (result !== 0) {
+        throw new Error(`Invalid public key: error code ${result}`);
+      }
+      return this.run('mul_public', this.ptr, this.length, hPtr);
+    } finally {
+      module._wasm_free(pubkeyPtr);
+      module._wasm_free(hPtr);
+    }
+  }
+
+  /**
+   * Squared Euclidean norms, with coefficients taken in -6144..6144.
+   *
+   * @returns {Float64Array} One norm per polynomial
+   */
+  sqnorm() {
+    const module = this.falcon.ensureInitialized();
+
+    const outPtr = module._wasm_malloc(this.length * 8);
+
+    try {
+      this.run('sqnorm', this.ptr, this.length, outPtr);
+      const norms = new Float64Array(this.length);
+      norms.set(new Float64Array(module.HEAPF64.buffer, outPtr, this.length));
+      return norms;
+    } finally {
+      module._wasm_free(outPtr);
+    }
+  }
+
+  /**
+   * Free the batch. The handle cannot be used afterwards.
+   */
+  close() {
+    if (this.ptr === null) {
+      return;
+    }
+    this.falcon.ensureInitialized()._wasm_free(this.ptr);
+    this.ptr = null;
+  }
+
+  /**
+   * @private
+   */
+  runBinary(op, other) {
+    if (!(other instanceof Falcon512PolyBatch) || other.falcon !== this.falcon) {
+      throw new Error('Operand must be a polynomial batch of the same Falcon512 instance');
+    }
+    if (other.length !== 1 && other.length !== this.length) {
+      throw new Error(`Operand has ${other.length} polynomials, expected 1 or ${this.length}`);
+    }
+    if (other.ptr === null) {
+      throw new Error('Polynomial batch is closed');
+    }
+    return this.run(op, this.ptr, this.length, other.ptr, other.length);
+  }
+
+  /**
+   * @private
+   */
+  run(op, ...args) {
+    if (this.ptr === null) {
+      throw new Error('Polynomial batch is closed');
+    }
+    const module = this.falcon.ensureInitialized();
+    const result = module[`_falcon512_poly_${op}`](...args);
+    if (result !== 0) {
+      throw new Error(`Polynomial ${op} failed with error code: ${result}`);
+    }
+    return this;
+  }
+}
+
 // Export for convenience
 export default Falcon512;
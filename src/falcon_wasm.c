@@ -2,7 +2,7 @@
  * WebAssembly wrapper for Falcon-512 post-quantum signatures
  * 
  * This file provides WASM-friendly exports for the Falcon-512 implementation
- * without modifying the original Falcon-impl-round3 code.
+ * on top of the Falcon-impl-round3 code.
  */
 
 #include <stddef.h>
@@ -28,11 +28,104 @@
 #define FALCON512_TMPSIZE_KEYGEN 15879
 #define FALCON512_TMPSIZE_SIGNDYN 39943
 #define FALCON512_TMPSIZE_VERIFY 4097
+#define FALCON512_TMPSIZE_EXPANDPRIV 26631
+#define FALCON512_TMPSIZE_KEYGEN_EXPANDED 27656
+#define FALCON512_TMPSIZE_SIGNTREE 25607
+#define FALCON512_TMPSIZE_SIGNDYN_LOWMEM 25607
+#define FALCON512_EXPANDEDKEY_SIZE 57352
+#define FALCON512_EXPANDEDKEY_BLOB_SIZE 57376
+
+// Low-memory build (`./build.sh lowmem`): signing without an expanded key
+// uses the low-memory mode of sign_dyn, with a smaller stack buffer
+#ifndef FALCON_WASM_LOWMEM
+#define FALCON_WASM_LOWMEM 0
+#endif
+#if FALCON_WASM_LOWMEM
+#define FALCON512_TMPSIZE_SIGN FALCON512_TMPSIZE_SIGNDYN_LOWMEM
+#else
+#define FALCON512_TMPSIZE_SIGN FALCON512_TMPSIZE_SIGNDYN
+#endif
+
+// Standalone build (`./build.sh standalone`): no Emscripten runtime and no
+// imports. wasm_malloc() is then a bump allocator over the linear memory, and
+// the system RNG is not available (see src/falcon-standalone.js)
+#ifndef FALCON_WASM_STANDALONE
+#define FALCON_WASM_STANDALONE 0
+#endif
 
 // ============================================================================
 // MEMORY MANAGEMENT
 // ============================================================================
 
+#if FALCON_WASM_STANDALONE
+
+/*
+ * Bump allocator: each block starts with a header that links it to the block
+ * allocated before it. Freeing a block only marks it; the top of the heap
+ * then moves back down over all the freed blocks at the top. The JS wrappers
+ * free their buffers before returning, so only long-lived allocations
+ * (signing handles, polynomial batches) keep the heap up, together with the
+ * blocks above them until they are freed as well.
+ */
+typedef struct heap_block_ {
+    struct heap_block_* prev;
+    size_t freed;
+    size_t pad[2];  // 16 bytes on wasm32: blocks stay 16-byte aligned
+} heap_block;
+
+extern unsigned char __heap_base;
+static heap_block* heap_last = NULL;
+static uintptr_t heap_top = 0;
+
+/**
+ * Allocate memory that can be accessed by JavaScript
+ */
+WASM_EXPORT
+void* wasm_malloc(size_t size) {
+    uintptr_t end;
+    uint64_t limit;
+    heap_block* b;
+
+    if (heap_top == 0) {
+        heap_top = ((uintptr_t)&__heap_base + 15) & ~(uintptr_t)15;
+    }
+    if (size > ((size_t)1 << 30)) {
+        return NULL;
+    }
+    end = heap_top + sizeof(heap_block) + ((size + 15) & ~(size_t)15);
+    limit = (uint64_t)__builtin_wasm_memory_size(0) << 16;
+    if (end > limit
+        && __builtin_wasm_memory_grow(0, (size_t)((end - limit + 65535) >> 16))
+            == (size_t)-1)
+    {
+        return NULL;
+    }
+
+    b = (heap_block*)heap_top;
+    b->prev = heap_last;
+    b->freed = 0;
+    heap_last = b;
+    heap_top = end;
+    return b + 1;
+}
+
+/**
+ * Free memory allocated by wasm_malloc
+ */
+WASM_EXPORT
+void wasm_free(void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    ((heap_block*)ptr - 1)->freed = 1;
+    while (heap_last != NULL && heap_last->freed) {
+        heap_top = (uintptr_t)heap_last;
+        heap_last = heap_last->prev;
+    }
+}
+
+#else
+
 /**
  * Allocate memory that can be accessed by JavaScript
  */
@@ -49,6 +142,8 @@ void wasm_free(void* ptr) {
     free(ptr);
 }
 
+#endif
+
 // ============================================================================
 // KEYPAIR GENERATION
 // ============================================================================
@@ -92,6 +187,48 @@ int falcon512_keygen_from_seed(
     return ret;
 }
 
+// ============================================================================
+// KEY IMPORT
+// ============================================================================
+
+/**
+ * Check N Falcon-512 key pairs in one call.
+ *
+ * Private keys (1281 bytes each) and public keys (897 bytes each) are stored
+ * back to back. For each pair the private key is decoded, its public key is
+ * recomputed and compared with the supplied one. results_out[i] receives 0 on
+ * a match, FALCON_ERR_FORMAT if either key cannot be decoded, or
+ * FALCON_ERR_MISMATCH if the keys do not belong together.
+ *
+ * If h_ntt_out is not NULL, it receives N blocks of 512 uint16_t values:
+ * public key i in the NTT form used by verification.
+ *
+ * @param privkeys Pointer to count * 1281 bytes of private keys
+ * @param pubkeys Pointer to count * 897 bytes of public keys
+ * @param count Number of key pairs
+ * @param h_ntt_out Pointer to buffer for count * 512 uint16_t values, or NULL
+ * @param results_out Pointer to buffer for count int32_t result codes
+ * @return number of matching pairs, or negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_import_keys_batch(
+    const uint8_t* privkeys,
+    const uint8_t* pubkeys,
+    size_t count,
+    uint16_t* h_ntt_out,
+    int32_t* results_out
+) {
+    uint16_t tmp_aligned[(FALCON_TMPSIZE_IMPORT(FALCON512_LOGN) + 1) / 2];
+    int ret;
+
+    ret = falcon_import_keys(FALCON512_LOGN, privkeys, pubkeys, count,
+        h_ntt_out, results_out, tmp_aligned, sizeof tmp_aligned, 1);
+
+    memset(tmp_aligned, 0, sizeof tmp_aligned);
+
+    return ret;
+}
+
 // ============================================================================
 // SIGNING
 // ============================================================================
@@ -119,7 +256,7 @@ int falcon512_sign(
     size_t* sig_len_inout
 ) {
     shake256_context rng;
-    uint8_t tmp[FALCON512_TMPSIZE_SIGNDYN];
+    uint8_t tmp[FALCON512_TMPSIZE_SIGN];
     int ret;
 
     // Initialize PRNG from seed
@@ -141,6 +278,382 @@ int falcon512_sign(
     return ret;
 }
 
+// ============================================================================
+// ENTROPY POOL
+// (one internal SHAKE256 PRNG, forked per signature, so callers do not have
+// to supply a fresh seed for every signature)
+// ============================================================================
+
+// Bytes squeezed from the pool to seed each per-signature sub-state
+#define ENTROPY_POOL_FORK_SIZE 48
+
+static shake256_context entropy_pool;
+static int entropy_pool_ready = 0;
+static int entropy_pool_from_system = 0;
+static uint32_t entropy_pool_uses = 0;
+static uint32_t entropy_pool_reseed_interval = 0;
+
+/**
+ * Replace the pool state with SHAKE256(pool output || extra).
+ * The old state cannot be recovered from the new one.
+ */
+static void
+entropy_pool_ratchet(const uint8_t* extra, size_t extra_len)
+{
+    uint8_t carry[64];
+
+    shake256_extract(&entropy_pool, carry, sizeof carry);
+    shake256_init(&entropy_pool);
+    shake256_inject(&entropy_pool, carry, sizeof carry);
+    shake256_inject(&entropy_pool, extra, extra_len);
+    shake256_flip(&entropy_pool);
+    memset(carry, 0, sizeof carry);
+}
+
+/**
+ * Seed the internal entropy pool.
+ *
+ * With seed_len == 0, the pool is seeded from the system RNG
+ * (crypto.getRandomValues under Emscripten) and is reseeded from it every
+ * reseed_interval signatures. With a caller-supplied seed, the pool is fully
+ * deterministic: reseeding then only ratchets the state forward.
+ *
+ * @param seed Pointer to seed bytes (ignored if seed_len is 0)
+ * @param seed_len Length of seed, or 0 to use the system RNG
+ * @param reseed_interval Signatures between reseeds (0 = never reseed)
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_entropy_pool_init(
+    const uint8_t* seed,
+    size_t seed_len,
+    uint32_t reseed_interval
+) {
+    int ret;
+
+    if (seed_len == 0) {
+        ret = shake256_init_prng_from_system(&entropy_pool);
+        if (ret != 0) {
+            entropy_pool_ready = 0;
+            return ret;
+        }
+    } else {
+        shake256_init_prng_from_seed(&entropy_pool, seed, seed_len);
+    }
+    shake256_flip(&entropy_pool);
+
+    entropy_pool_ready = 1;
+    entropy_pool_from_system = (seed_len == 0);
+    entropy_pool_uses = 0;
+    entropy_pool_reseed_interval = reseed_interval;
+    return 0;
+}
+
+/**
+ * Mix extra entropy into the pool. With seed_len == 0, fresh bytes are read
+ * from the system RNG.
+ *
+ * @param seed Pointer to extra seed bytes (ignored if seed_len is 0)
+ * @param seed_len Length of seed, or 0 to use the system RNG
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_entropy_pool_reseed(
+    const uint8_t* seed,
+    size_t seed_len
+) {
+    uint8_t sys_seed[48];
+
+    if (!entropy_pool_ready) {
+        return FALCON_ERR_RANDOM;
+    }
+    if (seed_len == 0) {
+        if (!Zf(get_seed)(sys_seed, sizeof sys_seed)) {
+            return FALCON_ERR_RANDOM;
+        }
+        entropy_pool_ratchet(sys_seed, sizeof sys_seed);
+        memset(sys_seed, 0, sizeof sys_seed);
+    } else {
+        entropy_pool_ratchet(seed, seed_len);
+    }
+    entropy_pool_uses = 0;
+    return 0;
+}
+
+/**
+ * Wipe the entropy pool; pooled signing fails until it is seeded again.
+ */
+WASM_EXPORT
+void falcon512_entropy_pool_clear(void) {
+    memset(&entropy_pool, 0, sizeof entropy_pool);
+    entropy_pool_ready = 0;
+    entropy_pool_uses = 0;
+}
+
+/**
+ * Fork a per-signature PRNG from the pool, reseeding the pool first when the
+ * reseed interval has been reached.
+ */
+static int
+entropy_pool_fork(shake256_context* rng)
+{
+    uint8_t sub_seed[ENTROPY_POOL_FORK_SIZE];
+    int ret;
+
+    if (!entropy_pool_ready) {
+        return FALCON_ERR_RANDOM;
+    }
+    if (entropy_pool_reseed_interval != 0
+        && entropy_pool_uses >= entropy_pool_reseed_interval)
+    {
+        if (entropy_pool_from_system) {
+            ret = falcon512_entropy_pool_reseed(NULL, 0);
+            if (ret != 0) {
+                return ret;
+            }
+        } else {
+            entropy_pool_ratchet(NULL, 0);
+            entropy_pool_uses = 0;
+        }
+    }
+
+    shake256_extract(&entropy_pool, sub_seed, sizeof sub_seed);
+    shake256_init_prng_from_seed(rng, sub_seed, sizeof sub_seed);
+    shake256_flip(rng);
+    entropy_pool_uses++;
+    memset(sub_seed, 0, sizeof sub_seed);
+    return 0;
+}
+
+/**
+ * Sign a message with a Falcon-512 private key, drawing signature randomness
+ * from the internal entropy pool (see falcon512_entropy_pool_init) instead of
+ * a caller-supplied seed.
+ *
+ * @param message Pointer to message bytes
+ * @param message_len Length of message
+ * @param privkey Pointer to private key (1281 bytes)
+ * @param sig_out Pointer to buffer for signature (max 752 bytes)
+ * @param sig_len_inout Pointer to size_t: input = buffer size, output = actual sig size
+ * @return 0 on success, FALCON_ERR_RANDOM if the pool is not seeded,
+ *         other negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_sign_pooled(
+    const uint8_t* message,
+    size_t message_len,
+    const uint8_t* privkey,
+    uint8_t* sig_out,
+    size_t* sig_len_inout
+) {
+    shake256_context rng;
+    uint8_t tmp[FALCON512_TMPSIZE_SIGN];
+    int ret;
+
+    ret = entropy_pool_fork(&rng);
+    if (ret != 0) {
+        return ret;
+    }
+
+    // Sign message (compressed format)
+    ret = falcon_sign_dyn(
+        &rng,
+        sig_out, sig_len_inout, FALCON_SIG_COMPRESSED,
+        privkey, FALCON512_PRIVKEY_SIZE,
+        message, message_len,
+        tmp, sizeof(tmp)
+    );
+
+    // Clear sensitive data
+    memset(tmp, 0, sizeof(tmp));
+    memset(&rng, 0, sizeof(rng));
+
+    return ret;
+}
+
+// ============================================================================
+// SIGNING HANDLES
+// (expanded private keys, serialized as blobs that can be stored and loaded
+// back without expanding the key again)
+// ============================================================================
+
+// Offset of the expanded key within a blob (see falcon_expanded_key_save)
+#define EXPANDED_KEY_BLOB_OFFSET 31
+
+/**
+ * Expand a Falcon-512 private key and serialize it as a blob.
+ *
+ * The key is expanded in place in blob_out, which must be 8-byte aligned
+ * (wasm_malloc() memory is) and have room for
+ * falcon512_get_expanded_key_buffer_size() bytes; the blob itself is
+ * falcon512_get_expanded_key_blob_size() bytes.
+ *
+ * @param privkey Pointer to private key (1281 bytes)
+ * @param blob_out Pointer to 8-byte aligned buffer for the blob
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_expand_privkey_blob(
+    const uint8_t* privkey,
+    uint8_t* blob_out
+) {
+    uint8_t tmp[FALCON512_TMPSIZE_EXPANDPRIV];
+    int ret;
+
+    if (((uintptr_t)blob_out & 7u) != 0) {
+        return FALCON_ERR_BADARG;
+    }
+    ret = falcon_expand_privkey(
+        blob_out + EXPANDED_KEY_BLOB_OFFSET, FALCON512_EXPANDEDKEY_SIZE,
+        privkey, FALCON512_PRIVKEY_SIZE,
+        tmp, sizeof(tmp)
+    );
+    memset(tmp, 0, sizeof(tmp));
+    if (ret != 0) {
+        return ret;
+    }
+    return falcon_expanded_key_save(blob_out,
+        FALCON512_EXPANDEDKEY_BLOB_SIZE, blob_out + EXPANDED_KEY_BLOB_OFFSET);
+}
+
+/**
+ * Generate a Falcon-512 keypair from a seed, and its expanded key blob in
+ * the same call (see falcon_keygen_make_expanded). The keypair is the one
+ * falcon512_keygen_from_seed() returns for the same seed, and the blob the
+ * one falcon512_expand_privkey_blob() returns for its private key.
+ *
+ * @param seed Pointer to seed bytes
+ * @param seed_len Length of seed (recommended: 48 bytes)
+ * @param privkey_out Pointer to buffer for private key (1281 bytes)
+ * @param pubkey_out Pointer to buffer for public key (897 bytes)
+ * @param blob_out Pointer to 8-byte aligned buffer for the blob, with room
+ *        for falcon512_get_expanded_key_buffer_size() bytes
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_keygen_expanded_from_seed(
+    const uint8_t* seed,
+    size_t seed_len,
+    uint8_t* privkey_out,
+    uint8_t* pubkey_out,
+    uint8_t* blob_out
+) {
+    shake256_context rng;
+    uint8_t tmp[FALCON512_TMPSIZE_KEYGEN_EXPANDED];
+    int ret;
+
+    if (((uintptr_t)blob_out & 7u) != 0) {
+        return FALCON_ERR_BADARG;
+    }
+
+    // Initialize PRNG from seed
+    shake256_init_prng_from_seed(&rng, seed, seed_len);
+
+    // Generate keypair, expanding the key in place past the blob header
+    ret = falcon_keygen_make_expanded(
+        &rng,
+        FALCON512_LOGN,
+        privkey_out, FALCON512_PRIVKEY_SIZE,
+        pubkey_out, FALCON512_PUBKEY_SIZE,
+        blob_out + EXPANDED_KEY_BLOB_OFFSET, FALCON512_EXPANDEDKEY_SIZE,
+        tmp, sizeof(tmp)
+    );
+
+    // Clear sensitive data
+    memset(tmp, 0, sizeof(tmp));
+    memset(&rng, 0, sizeof(rng));
+
+    if (ret != 0) {
+        return ret;
+    }
+    return falcon_expanded_key_save(blob_out,
+        FALCON512_EXPANDEDKEY_BLOB_SIZE, blob_out + EXPANDED_KEY_BLOB_OFFSET);
+}
+
+/**
+ * Check an expanded key blob before signing with it. The blob itself is
+ * then the signing handle: falcon512_signer_sign() uses it in place, with
+ * no copy and no recomputation, so it must stay unmodified until the
+ * caller frees it.
+ *
+ * @param blob Pointer to 8-byte aligned blob
+ * @param blob_len Length of blob
+ * @return 0 on success, FALCON_ERR_FORMAT if the blob is corrupted or not a
+ *         Falcon-512 expanded key, other negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_signer_open(
+    const uint8_t* blob,
+    size_t blob_len
+) {
+    const void* expanded_key;
+    int ret;
+
+    ret = falcon_expanded_key_open(&expanded_key, blob, blob_len);
+    if (ret != 0) {
+        return ret;
+    }
+    if (*(const uint8_t*)expanded_key != FALCON512_LOGN) {
+        return FALCON_ERR_FORMAT;
+    }
+    return 0;
+}
+
+/**
+ * Sign a message with a signing handle (a blob accepted by
+ * falcon512_signer_open()).
+ *
+ * With rng_seed_len == 0, signature randomness is forked from the internal
+ * entropy pool, as in falcon512_sign_pooled().
+ *
+ * @param blob Pointer to the opened blob
+ * @param message Pointer to message bytes
+ * @param message_len Length of message
+ * @param rng_seed Pointer to RNG seed (ignored if rng_seed_len is 0)
+ * @param rng_seed_len Length of RNG seed, or 0 to use the entropy pool
+ * @param sig_out Pointer to buffer for signature (max 752 bytes)
+ * @param sig_len_inout Pointer to size_t: input = buffer size, output = actual sig size
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_signer_sign(
+    const uint8_t* blob,
+    const uint8_t* message,
+    size_t message_len,
+    const uint8_t* rng_seed,
+    size_t rng_seed_len,
+    uint8_t* sig_out,
+    size_t* sig_len_inout
+) {
+    shake256_context rng;
+    uint8_t tmp[FALCON512_TMPSIZE_SIGNTREE];
+    int ret;
+
+    if (rng_seed_len == 0) {
+        ret = entropy_pool_fork(&rng);
+        if (ret != 0) {
+            return ret;
+        }
+    } else {
+        shake256_init_prng_from_seed(&rng, rng_seed, rng_seed_len);
+    }
+
+    // Sign message (compressed format)
+    ret = falcon_sign_tree(
+        &rng,
+        sig_out, sig_len_inout, FALCON_SIG_COMPRESSED,
+        blob + EXPANDED_KEY_BLOB_OFFSET,
+        message, message_len,
+        tmp, sizeof(tmp)
+    );
+
+    // Clear sensitive data
+    memset(tmp, 0, sizeof(tmp));
+    memset(&rng, 0, sizeof(rng));
+
+    return ret;
+}
+
 // ============================================================================
 // VERIFICATION
 // ============================================================================
@@ -179,47 +692,94 @@ int falcon512_verify(
     return ret;
 }
 
-// ============================================================================
-// POLY-LEVEL SIGN / VERIFY
-// (operate directly on a caller-supplied hash-to-point polynomial)
-// ============================================================================
+/**
+ * Read a little-endian 32-bit word (packed records may come from any
+ * host through a shared buffer, so the byte order is fixed).
+ */
+static uint32_t
+get_u32le(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8)
+        | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
 
 /**
- * Sign a pre-computed hash-to-point polynomial with a Falcon-512 private key.
- *
- * The caller is expected to have already run hash_to_point (e.g. via
- * falcon512_hash_to_point) and supplies the 512 coefficients of hm directly.
- * This function returns the raw signature polynomial s2 (also called sv), i.e.
- * the same polynomial that falcon_verify internally recovers from a compressed
- * Falcon signature. It does NOT produce a nonce or an encoded signature blob.
+ * Verify a run of packed verification records, as written into the request
+ * ring of src/falcon-ring.js and copied here in one block.
  *
- * Gaussian-sampling randomness is derived deterministically from the bytes of
- * hm itself, so for a fixed (hm, privkey) pair this function is deterministic
- * and needs no external RNG seed.
+ * Each record starts with four little-endian uint32 words: record length
+ * (header included, a multiple of 4), caller id, message length and signature
+ * length. They are followed by the public key (897 bytes), the signature and
+ * the message, then zero padding up to the record length.
  *
- * Coefficients of hm must be in [0, q-1] with q = 12289.
+ * out receives two int32 values per record: its id, and the result of
+ * falcon512_verify for it.
  *
- * @param hm Pointer to 512 uint16_t coefficients of the hashed point
- * @param privkey Pointer to encoded Falcon-512 private key (1281 bytes)
- * @param sv_out Pointer to buffer for 512 int16_t coefficients of s2 (1024 bytes)
- * @return 0 on success, negative error code on failure
+ * @param records Pointer to the first record
+ * @param len Total length of the records, in bytes
+ * @param max Maximum number of records to process (size of out / 2)
+ * @param out Pointer to buffer for 2 * max int32 values
+ * @return number of records processed, or FALCON_ERR_FORMAT if a record
+ *         header is inconsistent (records before it are processed)
  */
 WASM_EXPORT
-int falcon512_sign_poly(
-    const uint16_t* hm,
-    const uint8_t* privkey,
-    int16_t* sv_out
+int falcon512_verify_records(
+    const uint8_t* records,
+    size_t len,
+    size_t max,
+    int32_t* out
 ) {
-    shake256_context rng;
-    uint64_t tmp_aligned[(FALCON512_TMPSIZE_SIGNDYN + 7) / 8];
-    uint8_t *tmp = (uint8_t *)tmp_aligned;
-    int8_t f[FALCON512_N];
-    int8_t g[FALCON512_N];
-    int8_t F[FALCON512_N];
-    int8_t G[FALCON512_N];
-    uint16_t hm_local[FALCON512_N];
+    size_t count;
+
+    count = 0;
+    while (len >= 16 && count < max) {
+        uint32_t id, rec_len, msg_len, sig_len;
+        const uint8_t* pubkey;
+        const uint8_t* sig;
+
+        rec_len = get_u32le(records);
+        id = get_u32le(records + 4);
+        msg_len = get_u32le(records + 8);
+        sig_len = get_u32le(records + 12);
+        if (rec_len > len || (rec_len & 3) != 0
+            || sig_len > rec_len || msg_len > rec_len
+            || (size_t)16 + FALCON512_PUBKEY_SIZE + sig_len + msg_len > rec_len)
+        {
+            return FALCON_ERR_FORMAT;
+        }
+        pubkey = records + 16;
+        sig = pubkey + FALCON512_PUBKEY_SIZE;
+        out[0] = (int32_t)id;
+        out[1] = falcon512_verify(sig + sig_len, msg_len, sig, sig_len, pubkey);
+        out += 2;
+        count++;
+        records += rec_len;
+        len -= rec_len;
+    }
+    return (int)count;
+}
+
+// ============================================================================
+// POLY-LEVEL SIGN / VERIFY
+// (operate directly on a caller-supplied hash-to-point polynomial)
+// ============================================================================
+
+/**
+ * Decode an encoded Falcon-512 private key into (f, g, F) and recompute G.
+ *
+ * @param f Output buffer for f (512 int8_t)
+ * @param g Output buffer for g (512 int8_t)
+ * @param F Output buffer for F (512 int8_t)
+ * @param G Output buffer for G (512 int8_t)
+ * @param privkey Pointer to encoded private key (1281 bytes)
+ * @param tmp Temporary buffer (at least 2048 bytes, 16-bit aligned)
+ * @return 0 on success, FALCON_ERR_FORMAT if the key cannot be decoded
+ */
+static int
+decode_privkey512(int8_t* f, int8_t* g, int8_t* F, int8_t* G,
+    const uint8_t* privkey, uint8_t* tmp)
+{
     size_t u, v;
-    unsigned oldcw;
 
     if (privkey[0] != (0x50 + FALCON512_LOGN)) {
         return FALCON_ERR_FORMAT;
@@ -243,6 +803,49 @@ int falcon512_sign_poly(
     if (!Zf(complete_private)(G, f, g, F, FALCON512_LOGN, tmp)) {
         return FALCON_ERR_FORMAT;
     }
+    return 0;
+}
+
+/**
+ * Decode an encoded Falcon-512 public key into NTT + Montgomery form,
+ * ready for Zf(verify_raw).
+ *
+ * @param h Output buffer for 512 uint16_t coefficients
+ * @param pubkey Pointer to encoded public key (897 bytes)
+ * @return 0 on success, FALCON_ERR_FORMAT if the key cannot be decoded
+ */
+static int
+decode_pubkey512_ntt(uint16_t* h, const uint8_t* pubkey)
+{
+    size_t decoded_len;
+
+    if (pubkey[0] != (0x00 + FALCON512_LOGN)) {
+        return FALCON_ERR_FORMAT;
+    }
+
+    decoded_len = Zf(modq_decode)(h, FALCON512_LOGN,
+        pubkey + 1, FALCON512_PUBKEY_SIZE - 1);
+    if (decoded_len != FALCON512_PUBKEY_SIZE - 1) {
+        return FALCON_ERR_FORMAT;
+    }
+
+    Zf(to_ntt_monty)(h, FALCON512_LOGN);
+    return 0;
+}
+
+/**
+ * Sign one hash-to-point polynomial with an already decoded private key.
+ * Sampling randomness is derived from the bytes of hm (see
+ * falcon512_sign_poly).
+ */
+static void
+sign_poly512_decoded(const uint16_t* hm,
+    const int8_t* f, const int8_t* g, const int8_t* F, const int8_t* G,
+    int16_t* sv_out, uint8_t* tmp)
+{
+    shake256_context rng;
+    uint16_t hm_local[FALCON512_N];
+    unsigned oldcw;
 
     memcpy(hm_local, hm, sizeof hm_local);
 
@@ -251,19 +854,142 @@ int falcon512_sign_poly(
         (const uint8_t *)hm_local, sizeof hm_local);
 
     oldcw = set_fpu_cw(2);
+#if FALCON_WASM_LOWMEM
+    Zf(sign_dyn_lowmem)(sv_out, (inner_shake256_context *)&rng,
+        f, g, F, G, hm_local, FALCON512_LOGN, tmp);
+#else
     Zf(sign_dyn)(sv_out, (inner_shake256_context *)&rng,
         f, g, F, G, hm_local, FALCON512_LOGN, tmp);
+#endif
     set_fpu_cw(oldcw);
 
-    memset(tmp_aligned, 0, sizeof tmp_aligned);
-    memset(f, 0, sizeof f);
-    memset(g, 0, sizeof g);
-    memset(F, 0, sizeof F);
-    memset(G, 0, sizeof G);
-    memset(hm_local, 0, sizeof hm_local);
-    memset(&rng, 0, sizeof rng);
+    memset(hm_local, 0, sizeof hm_local);
+    memset(&rng, 0, sizeof rng);
+}
+
+/**
+ * Sign N pre-computed hash-to-point polynomials with one private key.
+ *
+ * hm holds N contiguous blocks of 512 uint16_t coefficients; sv_out receives
+ * N contiguous blocks of 512 int16_t coefficients, block i being exactly what
+ * falcon512_sign_poly would return for block i of hm. The private key is
+ * decoded (and G recomputed) only once for the whole batch.
+ *
+ * @param hm Pointer to count * 512 uint16_t coefficients
+ * @param count Number of polynomials to sign
+ * @param privkey Pointer to encoded Falcon-512 private key (1281 bytes)
+ * @param sv_out Pointer to buffer for count * 512 int16_t coefficients
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_sign_poly_batch(
+    const uint16_t* hm,
+    size_t count,
+    const uint8_t* privkey,
+    int16_t* sv_out
+) {
+    uint64_t tmp_aligned[(FALCON512_TMPSIZE_SIGN + 7) / 8];
+    uint8_t *tmp = (uint8_t *)tmp_aligned;
+    int8_t f[FALCON512_N];
+    int8_t g[FALCON512_N];
+    int8_t F[FALCON512_N];
+    int8_t G[FALCON512_N];
+    size_t i;
+    int ret;
+
+    ret = decode_privkey512(f, g, F, G, privkey, tmp);
+    if (ret == 0) {
+        for (i = 0; i < count; i++) {
+            sign_poly512_decoded(hm + i * FALCON512_N,
+                f, g, F, G, sv_out + i * FALCON512_N, tmp);
+        }
+    }
+
+    memset(tmp_aligned, 0, sizeof tmp_aligned);
+    memset(f, 0, sizeof f);
+    memset(g, 0, sizeof g);
+    memset(F, 0, sizeof F);
+    memset(G, 0, sizeof G);
+
+    return ret;
+}
+
+/**
+ * Sign a pre-computed hash-to-point polynomial with a Falcon-512 private key.
+ *
+ * The caller is expected to have already run hash_to_point (e.g. via
+ * falcon512_hash_to_point) and supplies the 512 coefficients of hm directly.
+ * This function returns the raw signature polynomial s2 (also called sv), i.e.
+ * the same polynomial that falcon_verify internally recovers from a compressed
+ * Falcon signature. It does NOT produce a nonce or an encoded signature blob.
+ *
+ * Gaussian-sampling randomness is derived deterministically from the bytes of
+ * hm itself, so for a fixed (hm, privkey) pair this function is deterministic
+ * and needs no external RNG seed.
+ *
+ * Coefficients of hm must be in [0, q-1] with q = 12289.
+ *
+ * @param hm Pointer to 512 uint16_t coefficients of the hashed point
+ * @param privkey Pointer to encoded Falcon-512 private key (1281 bytes)
+ * @param sv_out Pointer to buffer for 512 int16_t coefficients of s2 (1024 bytes)
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_sign_poly(
+    const uint16_t* hm,
+    const uint8_t* privkey,
+    int16_t* sv_out
+) {
+    return falcon512_sign_poly_batch(hm, 1, privkey, sv_out);
+}
+
+/**
+ * Verify N signature polynomials against N hash-to-point polynomials, all
+ * under the same public key.
+ *
+ * hm and sv hold N contiguous blocks of 512 coefficients each. The public key
+ * is decoded and converted to NTT form only once. results_out[i] receives 0
+ * if pair i is valid, FALCON_ERR_BADSIG otherwise.
+ *
+ * @param hm Pointer to count * 512 uint16_t coefficients
+ * @param sv Pointer to count * 512 int16_t coefficients
+ * @param count Number of pairs to verify
+ * @param pubkey Pointer to encoded Falcon-512 public key (897 bytes)
+ * @param results_out Pointer to buffer for count int32_t result codes
+ * @return number of valid pairs, or negative error code if the public key
+ *         cannot be decoded
+ */
+WASM_EXPORT
+int falcon512_verify_poly_batch(
+    const uint16_t* hm,
+    const int16_t* sv,
+    size_t count,
+    const uint8_t* pubkey,
+    int32_t* results_out
+) {
+    uint16_t h[FALCON512_N];
+    uint16_t tmp_aligned[(FALCON512_TMPSIZE_VERIFY + 1) / 2];
+    uint8_t *tmp = (uint8_t *)tmp_aligned;
+    size_t i;
+    int ret, valid;
+
+    ret = decode_pubkey512_ntt(h, pubkey);
+    if (ret != 0) {
+        return ret;
+    }
 
-    return 0;
+    valid = 0;
+    for (i = 0; i < count; i++) {
+        if (Zf(verify_raw)(hm + i * FALCON512_N, sv + i * FALCON512_N,
+            h, FALCON512_LOGN, tmp))
+        {
+            results_out[i] = 0;
+            valid++;
+        } else {
+            results_out[i] = FALCON_ERR_BADSIG;
+        }
+    }
+    return valid;
 }
 
 /**
@@ -285,27 +1011,14 @@ int falcon512_verify_poly(
     const int16_t* sv,
     const uint8_t* pubkey
 ) {
-    uint16_t h[FALCON512_N];
-    uint16_t tmp_aligned[(FALCON512_TMPSIZE_VERIFY + 1) / 2];
-    uint8_t *tmp = (uint8_t *)tmp_aligned;
-    size_t decoded_len;
-
-    if (pubkey[0] != (0x00 + FALCON512_LOGN)) {
-        return FALCON_ERR_FORMAT;
-    }
-
-    decoded_len = Zf(modq_decode)(h, FALCON512_LOGN,
-        pubkey + 1, FALCON512_PUBKEY_SIZE - 1);
-    if (decoded_len != FALCON512_PUBKEY_SIZE - 1) {
-        return FALCON_ERR_FORMAT;
-    }
-
-    Zf(to_ntt_monty)(h, FALCON512_LOGN);
+    int32_t result;
+    int ret;
 
-    if (!Zf(verify_raw)(hm, sv, h, FALCON512_LOGN, tmp)) {
-        return FALCON_ERR_BADSIG;
+    ret = falcon512_verify_poly_batch(hm, sv, 1, pubkey, &result);
+    if (ret < 0) {
+        return ret;
     }
-    return 0;
+    return result;
 }
 
 // ============================================================================
@@ -346,6 +1059,47 @@ int falcon512_hash_to_point(
     return 0;
 }
 
+/**
+ * Hash N messages to points in the Falcon-512 polynomial ring.
+ *
+ * The messages are stored back to back in one buffer; lengths[i] gives the
+ * length of message i. points_out receives N contiguous blocks of 512
+ * int16_t coefficients, block i being what falcon512_hash_to_point would
+ * return for message i.
+ *
+ * @param messages Pointer to the concatenated message bytes
+ * @param lengths Pointer to count uint32_t message lengths
+ * @param count Number of messages
+ * @param points_out Pointer to buffer for count * 512 int16_t values
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_hash_to_point_batch(
+    const uint8_t* messages,
+    const uint32_t* lengths,
+    size_t count,
+    int16_t* points_out
+) {
+    inner_shake256_context sc;
+    uint16_t hm[FALCON512_N];
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        inner_shake256_init(&sc);
+        inner_shake256_inject(&sc, messages, lengths[i]);
+        inner_shake256_flip(&sc);
+        Zf(hash_to_point_vartime)(&sc, hm, FALCON512_LOGN);
+
+        for (int j = 0; j < FALCON512_N; j++) {
+            points_out[j] = (int16_t)hm[j];
+        }
+        messages += lengths[i];
+        points_out += FALCON512_N;
+    }
+
+    return 0;
+}
+
 // ============================================================================
 // PUBLIC KEY COEFFICIENTS
 // ============================================================================
@@ -392,6 +1146,9 @@ int falcon512_get_pubkey_coefficients(
 /**
  * Extract the signature coefficients from a Falcon-512 signature.
  * The signature consists of s1 (explicitly encoded) and s0 (computed from s1).
+ *
+ * Without the message and public key, s0 can only be approximated; use
+ * falcon512_recover_signature_coefficients for the exact values.
  * 
  * @param signature Pointer to encoded signature
  * @param signature_len Length of signature
@@ -452,6 +1209,446 @@ int falcon512_get_signature_coefficients(
     return 0;
 }
 
+/**
+ * Decode the s1 polynomial of an encoded Falcon-512 signature (compressed,
+ * padded or constant-time format).
+ *
+ * @param signature Pointer to encoded signature
+ * @param signature_len Length of signature
+ * @param s1 Output buffer for 512 int16_t coefficients
+ * @return 0 on success, FALCON_ERR_FORMAT on a malformed signature
+ */
+static int
+decode_signature512(const uint8_t* signature, size_t signature_len,
+    int16_t* s1)
+{
+    size_t u, v;
+
+    if (signature_len < 41 || (signature[0] & 0x0F) != FALCON512_LOGN) {
+        return FALCON_ERR_FORMAT;
+    }
+
+    u = 41;
+    switch (signature[0] & 0xF0) {
+    case 0x30:
+        v = Zf(comp_decode)(s1, FALCON512_LOGN,
+            signature + u, signature_len - u);
+        if (v == 0) {
+            return FALCON_ERR_FORMAT;
+        }
+        // Trailing zero bytes are the padding of the "padded" format
+        while (u + v < signature_len) {
+            if (signature[u + v] != 0) {
+                return FALCON_ERR_FORMAT;
+            }
+            v++;
+        }
+        return 0;
+    case 0x50:
+        if (signature_len != FALCON_SIG_CT_SIZE(FALCON512_LOGN)) {
+            return FALCON_ERR_FORMAT;
+        }
+        v = Zf(trim_i16_decode)(s1, FALCON512_LOGN,
+            Zf(max_sig_bits)[FALCON512_LOGN],
+            signature + u, signature_len - u);
+        return v == 0 ? FALCON_ERR_FORMAT : 0;
+    default:
+        return FALCON_ERR_FORMAT;
+    }
+}
+
+/**
+ * Recover the exact coefficients of one signature, given its message and a
+ * public key already converted by decode_pubkey512_ntt.
+ *
+ * s0 = hm - s1 * h mod q, with hm = HashToPoint(nonce || message), which is
+ * exactly the first half of the short vector checked by verification.
+ */
+static int
+recover_signature512(const uint8_t* signature, size_t signature_len,
+    const uint8_t* message, size_t message_len, const uint16_t* h,
+    int16_t* s0_out, int16_t* s1_out, uint8_t* tmp)
+{
+    inner_shake256_context sc;
+    uint16_t hm[FALCON512_N];
+    int ret;
+
+    ret = decode_signature512(signature, signature_len, s1_out);
+    if (ret != 0) {
+        return ret;
+    }
+
+    inner_shake256_init(&sc);
+    inner_shake256_inject(&sc, signature + 1, 40);
+    inner_shake256_inject(&sc, message, message_len);
+    inner_shake256_flip(&sc);
+    Zf(hash_to_point_vartime)(&sc, hm, FALCON512_LOGN);
+
+    Zf(compute_s1)(s0_out, hm, s1_out, h, FALCON512_LOGN, tmp);
+
+    if (!Zf(is_short)(s0_out, s1_out, FALCON512_LOGN)) {
+        return FALCON_ERR_BADSIG;
+    }
+    return 0;
+}
+
+/**
+ * Extract the exact signature coefficients from N Falcon-512 signatures.
+ *
+ * Signatures and messages are stored back to back; sig_lens[i] and
+ * msg_lens[i] give their lengths. Public keys are read with a stride of
+ * pubkey_stride bytes; a stride of 0 uses the same key for every item. The
+ * NTT form of the public key is prepared once and reused for as long as
+ * consecutive items share the same key.
+ *
+ * s0_out and s1_out each receive N contiguous blocks of 512 int16_t
+ * coefficients. results_out[i] receives the per-item result code, as
+ * returned by falcon512_recover_signature_coefficients. The blocks of an
+ * item whose signature or public key cannot be decoded are set to zero;
+ * those of a decoded signature that does not verify hold its coefficients.
+ *
+ * @param signatures Pointer to the concatenated signatures
+ * @param sig_lens Pointer to count uint32_t signature lengths
+ * @param messages Pointer to the concatenated messages
+ * @param msg_lens Pointer to count uint32_t message lengths
+ * @param count Number of signatures
+ * @param pubkeys Pointer to the public key(s) (897 bytes each)
+ * @param pubkey_stride Distance in bytes between public keys, or 0
+ * @param s0_out Pointer to buffer for count * 512 int16_t values
+ * @param s1_out Pointer to buffer for count * 512 int16_t values
+ * @param results_out Pointer to buffer for count int32_t result codes
+ * @return number of items that form valid signatures
+ */
+WASM_EXPORT
+int falcon512_recover_signature_coefficients_batch(
+    const uint8_t* signatures,
+    const uint32_t* sig_lens,
+    const uint8_t* messages,
+    const uint32_t* msg_lens,
+    size_t count,
+    const uint8_t* pubkeys,
+    size_t pubkey_stride,
+    int16_t* s0_out,
+    int16_t* s1_out,
+    int32_t* results_out
+) {
+    uint16_t h[FALCON512_N];
+    uint16_t tmp_aligned[(FALCON512_TMPSIZE_VERIFY + 1) / 2];
+    uint8_t *tmp = (uint8_t *)tmp_aligned;
+    const uint8_t* prepared = NULL;
+    int prepared_ret = 0;
+    size_t i;
+    int valid;
+
+    valid = 0;
+    for (i = 0; i < count; i++) {
+        const uint8_t* pubkey = pubkeys + i * pubkey_stride;
+        int ret;
+
+        // Prepare the NTT form of the key only when it changes
+        if (prepared == NULL || (pubkey != prepared
+            && memcmp(pubkey, prepared, FALCON512_PUBKEY_SIZE) != 0))
+        {
+            prepared_ret = decode_pubkey512_ntt(h, pubkey);
+        }
+        prepared = pubkey;
+
+        ret = prepared_ret;
+        if (ret == 0) {
+            ret = recover_signature512(signatures, sig_lens[i],
+                messages, msg_lens[i], h,
+                s0_out + i * FALCON512_N, s1_out + i * FALCON512_N, tmp);
+        }
+        if (ret == 0) {
+            valid++;
+        } else if (ret != FALCON_ERR_BADSIG) {
+            // Not decoded: the blocks may be partly written, and would
+            // otherwise return stale heap contents
+            memset(s0_out + i * FALCON512_N, 0, FALCON512_N * sizeof *s0_out);
+            memset(s1_out + i * FALCON512_N, 0, FALCON512_N * sizeof *s1_out);
+        }
+        results_out[i] = ret;
+        signatures += sig_lens[i];
+        messages += msg_lens[i];
+    }
+    return valid;
+}
+
+/**
+ * Extract the exact signature coefficients from a Falcon-512 signature.
+ *
+ * Unlike falcon512_get_signature_coefficients, this hashes nonce || message
+ * (as signing does) and recovers s0 = hm - s1 * h mod q with the public key,
+ * using NTT multiplication. s0 is normalized to [-q/2, q/2].
+ *
+ * @param signature Pointer to encoded signature
+ * @param signature_len Length of signature
+ * @param message Pointer to the signed message
+ * @param message_len Length of message
+ * @param pubkey Pointer to encoded public key (897 bytes)
+ * @param s0_out Pointer to buffer for s0 coefficients: 512 int16_t (1024 bytes)
+ * @param s1_out Pointer to buffer for s1 coefficients: 512 int16_t (1024 bytes)
+ * @return 0 on success, FALCON_ERR_BADSIG if the coefficients were recovered
+ *         but do not form a valid signature, other negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_recover_signature_coefficients(
+    const uint8_t* signature,
+    size_t signature_len,
+    const uint8_t* message,
+    size_t message_len,
+    const uint8_t* pubkey,
+    int16_t* s0_out,
+    int16_t* s1_out
+) {
+    uint32_t msg_len32 = (uint32_t)message_len;
+    uint32_t sig_len32 = (uint32_t)signature_len;
+    int32_t result;
+    int ret;
+
+    ret = falcon512_recover_signature_coefficients_batch(
+        signature, &sig_len32, message, &msg_len32, 1,
+        pubkey, 0, s0_out, s1_out, &result);
+    if (ret < 0) {
+        return ret;
+    }
+    return result;
+}
+
+// ============================================================================
+// POLYNOMIAL ARITHMETIC IN Z_q[x]/(x^512+1)
+// ============================================================================
+
+// Batches are count polynomials of 512 uint16_t coefficients, back to back,
+// all in the 0..q-1 range. Functions with a second operand take b_count,
+// either 1 (the same b for every polynomial of the batch) or count.
+
+/**
+ * Check that n coefficients are in the 0..q-1 range
+ */
+static int poly_check_modq(const uint16_t* f, size_t n) {
+    uint32_t bad = 0;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        bad |= (uint32_t)(12288 - (int32_t)f[i]);
+    }
+    return (bad >> 31) ? FALCON_ERR_FORMAT : 0;
+}
+
+/**
+ * Check a batch and its second operand
+ */
+static int poly_check_operands(
+    const uint16_t* polys, size_t count,
+    const uint16_t* b, size_t b_count
+) {
+    if (b_count != 1 && b_count != count) {
+        return FALCON_ERR_BADARG;
+    }
+    if (poly_check_modq(polys, count * FALCON512_N) != 0
+        || poly_check_modq(b, b_count * FALCON512_N) != 0) {
+        return FALCON_ERR_FORMAT;
+    }
+    return 0;
+}
+
+/**
+ * Apply the NTT to each polynomial of a batch, in place.
+ *
+ * @param polys Pointer to count * 512 coefficients
+ * @param count Number of polynomials
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_poly_ntt(uint16_t* polys, size_t count) {
+    size_t i;
+
+    if (poly_check_modq(polys, count * FALCON512_N) != 0) {
+        return FALCON_ERR_FORMAT;
+    }
+    for (i = 0; i < count; i++) {
+        Zf(mq_poly_ntt)(polys + i * FALCON512_N, FALCON512_LOGN);
+    }
+    return 0;
+}
+
+/**
+ * Apply the inverse NTT to each polynomial of a batch, in place.
+ *
+ * @param polys Pointer to count * 512 coefficients (NTT representation)
+ * @param count Number of polynomials
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_poly_intt(uint16_t* polys, size_t count) {
+    size_t i;
+
+    if (poly_check_modq(polys, count * FALCON512_N) != 0) {
+        return FALCON_ERR_FORMAT;
+    }
+    for (i = 0; i < count; i++) {
+        Zf(mq_poly_intt)(polys + i * FALCON512_N, FALCON512_LOGN);
+    }
+    return 0;
+}
+
+// Binary operations of poly_binop()
+#define POLY_ADD      0
+#define POLY_SUB      1
+#define POLY_MUL_NTT  2
+#define POLY_MUL      3
+
+/**
+ * Binary operation on a batch, in place: polys[i] = polys[i] op b[i]
+ */
+static int poly_binop(
+    uint16_t* polys, size_t count,
+    const uint16_t* b, size_t b_count,
+    int op
+) {
+    union {
+        uint8_t b[FALCON512_N * 2];
+        uint16_t dummy_u16;
+    } tmp;
+    size_t i;
+    int ret;
+
+    ret = poly_check_operands(polys, count, b, b_count);
+    if (ret != 0) {
+        return ret;
+    }
+    for (i = 0; i < count; i++) {
+        uint16_t* f = polys + i * FALCON512_N;
+        const uint16_t* g = b + (b_count == 1 ? 0 : i * FALCON512_N);
+
+        switch (op) {
+        case POLY_ADD:
+            Zf(mq_poly_add)(f, g, FALCON512_LOGN);
+            break;
+        case POLY_SUB:
+            Zf(mq_poly_sub)(f, g, FALCON512_LOGN);
+            break;
+        case POLY_MUL_NTT:
+            Zf(mq_poly_mul_ntt)(f, g, FALCON512_LOGN);
+            break;
+        default:
+            Zf(mq_poly_mul)(f, g, FALCON512_LOGN, tmp.b);
+            break;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Add b to each polynomial of a batch, in place.
+ *
+ * @param polys Pointer to count * 512 coefficients, overwritten
+ * @param count Number of polynomials
+ * @param b Pointer to b_count * 512 coefficients
+ * @param b_count 1 or count
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_poly_add(uint16_t* polys, size_t count, const uint16_t* b, size_t b_count) {
+    return poly_binop(polys, count, b, b_count, POLY_ADD);
+}
+
+/**
+ * Subtract b from each polynomial of a batch, in place (same parameters as
+ * falcon512_poly_add()).
+ */
+WASM_EXPORT
+int falcon512_poly_sub(uint16_t* polys, size_t count, const uint16_t* b, size_t b_count) {
+    return poly_binop(polys, count, b, b_count, POLY_SUB);
+}
+
+/**
+ * Coefficient-wise product with b, both in NTT representation, in place
+ * (same parameters as falcon512_poly_add()).
+ */
+WASM_EXPORT
+int falcon512_poly_mul_ntt(uint16_t* polys, size_t count, const uint16_t* b, size_t b_count) {
+    return poly_binop(polys, count, b, b_count, POLY_MUL_NTT);
+}
+
+/**
+ * Product with b modulo x^512+1, in place (same parameters as
+ * falcon512_poly_add()). Each product goes through three NTTs; for many
+ * products by the same polynomial, falcon512_poly_mul_public() or
+ * falcon512_poly_mul_ntt() saves one or two of them.
+ */
+WASM_EXPORT
+int falcon512_poly_mul(uint16_t* polys, size_t count, const uint16_t* b, size_t b_count) {
+    return poly_binop(polys, count, b, b_count, POLY_MUL);
+}
+
+/**
+ * Decode a public key into the NTT + Montgomery format used by
+ * falcon512_poly_mul_public().
+ *
+ * @param pubkey Pointer to encoded public key (897 bytes)
+ * @param h_out Pointer to buffer for 512 uint16_t values
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_poly_prepare_public(const uint8_t* pubkey, uint16_t* h_out) {
+    if (pubkey[0] != (0x00 + FALCON512_LOGN)) {
+        return FALCON_ERR_FORMAT;
+    }
+    if (Zf(modq_decode)(h_out, FALCON512_LOGN,
+            pubkey + 1, FALCON512_PUBKEY_SIZE - 1) != FALCON512_PUBKEY_SIZE - 1) {
+        return FALCON_ERR_FORMAT;
+    }
+    Zf(to_ntt_monty)(h_out, FALCON512_LOGN);
+    return 0;
+}
+
+/**
+ * Multiply each polynomial of a batch by a public key, in place.
+ *
+ * @param polys Pointer to count * 512 coefficients, overwritten
+ * @param count Number of polynomials
+ * @param h Public key from falcon512_poly_prepare_public()
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_poly_mul_public(uint16_t* polys, size_t count, const uint16_t* h) {
+    size_t i;
+    int ret;
+
+    ret = poly_check_operands(polys, count, h, 1);
+    if (ret != 0) {
+        return ret;
+    }
+    for (i = 0; i < count; i++) {
+        Zf(mq_poly_mul_public)(polys + i * FALCON512_N, h, FALCON512_LOGN);
+    }
+    return 0;
+}
+
+/**
+ * Squared norm of each polynomial of a batch, with coefficients taken in
+ * the -6144..+6144 range.
+ *
+ * @param polys Pointer to count * 512 coefficients
+ * @param count Number of polynomials
+ * @param out Pointer to count doubles (exact: norms are below 2^35)
+ * @return 0 on success, negative error code on failure
+ */
+WASM_EXPORT
+int falcon512_poly_sqnorm(const uint16_t* polys, size_t count, double* out) {
+    size_t i;
+
+    if (poly_check_modq(polys, count * FALCON512_N) != 0) {
+        return FALCON_ERR_FORMAT;
+    }
+    for (i = 0; i < count; i++) {
+        out[i] = (double)Zf(mq_poly_sqnorm)(polys + i * FALCON512_N, FALCON512_LOGN);
+    }
+    return 0;
+}
+
 // ============================================================================
 // UTILITY FUNCTIONS
 // ============================================================================
@@ -474,6 +1671,20 @@ int falcon512_get_sig_max_size(void) {
     return FALCON512_SIG_COMPRESSED_MAXSIZE;
 }
 
+WASM_EXPORT
+int falcon512_get_expanded_key_blob_size(void) {
+    return FALCON512_EXPANDEDKEY_BLOB_SIZE;
+}
+
+/**
+ * Get the buffer size needed by falcon512_expand_privkey_blob(), which
+ * expands the key in place before serializing it
+ */
+WASM_EXPORT
+int falcon512_get_expanded_key_buffer_size(void) {
+    return EXPANDED_KEY_BLOB_OFFSET + FALCON512_EXPANDEDKEY_SIZE;
+}
+
 WASM_EXPORT
 int falcon512_get_n(void) {
     return FALCON512_N;
@@ -5,7 +5,9 @@
  * Run: docker-compose up falcon-wasm-builder (or npm run build:wasm)
  */
 
-import { Falcon512 } from '../src/falcon.js';
+import { Falcon512, detectWasmFeatures } from '../src/falcon.js';
+import { FalconPool, defaultCreateWorker } from '../src/falcon-pool.js';
+import { FalconIngest } from '../src/falcon-ring.js';
 
 // Dynamic import to handle if WASM isn't built yet
 let createFalconModule;
@@ -172,6 +174,78 @@ describe('Falcon512', () => {
     });
   });
 
+  describe('Entropy Pool Signing', () => {
+    let keypair;
+    const message = new TextEncoder().encode('pooled signing');
+
+    beforeAll(() => {
+      const seed = new Uint8Array(48);
+      for (let i = 0; i < 48; i++) seed[i] = i;
+      keypair = falcon.createKeypairFromSeed(seed);
+    });
+
+    afterAll(() => {
+      falcon.clearEntropyPool();
+    });
+
+    it('should sign without a caller-supplied seed', () => {
+      const sig1 = falcon.signMessage(message, keypair.privateKey);
+      const sig2 = falcon.signMessage(message, keypair.privateKey);
+
+      expect(falcon.verifySignature(message, sig1, keypair.publicKey)).toBe(true);
+      expect(falcon.verifySignature(message, sig2, keypair.publicKey)).toBe(true);
+      // Fresh nonce for every signature
+      expect(sig1.subarray(1, 41)).not.toEqual(sig2.subarray(1, 41));
+    });
+
+    it('should use the entropy pool for a null seed', () => {
+      const seed = new Uint8Array(48).fill(5);
+
+      falcon.initEntropyPool({ seed });
+      const sig1 = falcon.signMessage(message, keypair.privateKey, null);
+      falcon.initEntropyPool({ seed });
+      const sig2 = falcon.signMessage(message, keypair.privateKey);
+
+      expect(sig1).toEqual(sig2);
+      expect(falcon.verifySignature(message, sig1, keypair.publicKey)).toBe(true);
+    });
+
+    it('should be deterministic when seeded explicitly', () => {
+      const seed = new Uint8Array(48).fill(7);
+
+      falcon.initEntropyPool({ seed, reseedInterval: 2 });
+      const run1 = [0, 1, 2].map(() => falcon.signMessage(message, keypair.privateKey));
+      falcon.initEntropyPool({ seed, reseedInterval: 2 });
+      const run2 = [0, 1, 2].map(() => falcon.signMessage(message, keypair.privateKey));
+
+      expect(run1).toEqual(run2);
+      for (const sig of run1) {
+        expect(falcon.verifySignature(message, sig, keypair.publicKey)).toBe(true);
+      }
+    });
+
+    it('should keep seeded signing independent of the pool', () => {
+      const rngSeed = new Uint8Array(48).fill(9);
+      const sig1 = falcon.signMessage(message, keypair.privateKey, rngSeed);
+      falcon.reseedEntropyPool(new Uint8Array([1, 2, 3]));
+      const sig2 = falcon.signMessage(message, keypair.privateKey, rngSeed);
+
+      expect(sig1).toEqual(sig2);
+    });
+
+    it('should change output after a reseed', () => {
+      const seed = new Uint8Array(48).fill(3);
+
+      falcon.initEntropyPool({ seed });
+      const sig1 = falcon.signMessage(message, keypair.privateKey);
+      falcon.initEntropyPool({ seed });
+      falcon.reseedEntropyPool(new Uint8Array([42]));
+      const sig2 = falcon.signMessage(message, keypair.privateKey);
+
+      expect(sig1).not.toEqual(sig2);
+    });
+  });
+
   describe('Hash-to-Point', () => {
     it('should hash a message to 512 coefficients', () => {
       const message = new Uint8Array([1, 2, 3, 4, 5]);
@@ -301,6 +375,102 @@ describe('Falcon512', () => {
     });
   });
 
+  describe('Exact Signature Coefficients', () => {
+    const Q = 12289;
+    let keypair;
+    let messages;
+    let signatures;
+
+    // s0 + s1·h mod (x^512 + 1, q), computed naively
+    const reconstructHm = (s0, s1, h) => {
+      const out = new Array(512);
+      for (let k = 0; k < 512; k++) {
+        let acc = s0[k];
+        for (let i = 0; i < 512; i++) {
+          const j = k - i;
+          acc += j >= 0 ? s1[i] * h[j] : -s1[i] * h[j + 512];
+          acc %= Q;
+        }
+        out[k] = ((acc % Q) + Q) % Q;
+      }
+      return out;
+    };
+
+    beforeAll(() => {
+      const seed = new Uint8Array(48);
+      for (let i = 0; i < 48; i++) seed[i] = i;
+      keypair = falcon.createKeypairFromSeed(seed);
+
+      messages = [
+        new TextEncoder().encode('archived message 0'),
+        new TextEncoder().encode('archived message 1'),
+        new Uint8Array(0),
+      ];
+      signatures = messages.map((message, i) => {
+        const rngSeed = new Uint8Array(48).fill(i + 1);
+        return falcon.signMessage(message, keypair.privateKey, rngSeed);
+      });
+    });
+
+    it('should satisfy s0 + s1·h = HashToPoint(nonce || message) mod q', () => {
+      const { s0, s1 } = falcon.getSignatureCoefficients(signatures[0], messages[0], keypair.publicKey);
+      const h = falcon.getPublicKeyCoefficients(keypair.publicKey);
+
+      // Rebuild the hashed point of nonce || message through hashToPoint
+      const nonceAndMessage = new Uint8Array(40 + messages[0].length);
+      nonceAndMessage.set(signatures[0].subarray(1, 41));
+      nonceAndMessage.set(messages[0], 40);
+      const hm = Array.from(falcon.hashToPoint(nonceAndMessage));
+
+      expect(reconstructHm(s0, s1, h)).toEqual(hm);
+      for (let i = 0; i < 512; i++) {
+        expect(Math.abs(s0[i])).toBeLessThanOrEqual(Q >> 1);
+      }
+    });
+
+    it('should keep s1 identical to the legacy extraction', () => {
+      const exact = falcon.getSignatureCoefficients(signatures[1], messages[1], keypair.publicKey);
+      const legacy = falcon.getSignatureCoefficients(signatures[1]);
+
+      expect(exact.s1).toEqual(legacy.s1);
+    });
+
+    it('should match single extraction in batch mode', () => {
+      const batch = falcon.getSignatureCoefficientsBatch(signatures, messages, keypair.publicKey);
+
+      expect(batch.valid).toEqual([true, true, true]);
+      expect(batch.s0.length).toBe(3 * 512);
+      signatures.forEach((signature, i) => {
+        const single = falcon.getSignatureCoefficients(signature, messages[i], keypair.publicKey);
+        expect(batch.s0.subarray(i * 512, (i + 1) * 512)).toEqual(single.s0);
+        expect(batch.s1.subarray(i * 512, (i + 1) * 512)).toEqual(single.s1);
+      });
+
+      const perItemKeys = signatures.map(() => keypair.publicKey);
+      const batch2 = falcon.getSignatureCoefficientsBatch(signatures, messages, perItemKeys);
+      expect(batch2.s0).toEqual(batch.s0);
+    });
+
+    it('should require both the message and the public key', () => {
+      expect(() => {
+        falcon.getSignatureCoefficients(signatures[0], messages[0]);
+      }).toThrow('need both the message and the public key');
+      expect(() => {
+        falcon.getSignatureCoefficients(signatures[0], undefined, keypair.publicKey);
+      }).toThrow('need both the message and the public key');
+    });
+
+    it('should flag signatures that do not match their message', () => {
+      const swapped = [messages[1], messages[0], messages[2]];
+      const batch = falcon.getSignatureCoefficientsBatch(signatures, swapped, keypair.publicKey);
+
+      expect(batch.valid).toEqual([false, false, true]);
+      expect(() => {
+        falcon.getSignatureCoefficients(signatures[0], messages[1], keypair.publicKey);
+      }).toThrow();
+    });
+  });
+
   describe('Poly-level Sign and Verify', () => {
     let keypair;
 
@@ -434,6 +604,454 @@ describe('Falcon512', () => {
     });
   });
 
+  describe('Batch hash-to-point → signPoly / verifyPoly', () => {
+    let keypair;
+    let messages;
+
+    beforeAll(() => {
+      const seed = new Uint8Array(48);
+      for (let i = 0; i < 48; i++) seed[i] = i;
+      keypair = falcon.createKeypairFromSeed(seed);
+
+      messages = [
+        new TextEncoder().encode('batch item 0'),
+        new Uint8Array(0),
+        new Uint8Array([1, 2, 3, 4, 5]),
+        new TextEncoder().encode('batch item 3, a little longer than the rest'),
+      ];
+    });
+
+    it('should match hashToPoint for every message', () => {
+      const hms = falcon.hashToPointBatch(messages);
+
+      expect(hms).toBeInstanceOf(Int16Array);
+      expect(hms.length).toBe(messages.length * 512);
+      messages.forEach((message, i) => {
+        expect(hms.subarray(i * 512, (i + 1) * 512)).toEqual(falcon.hashToPoint(message));
+      });
+    });
+
+    it('should match signPoly for every polynomial', () => {
+      const hms = falcon.hashToPointBatch(messages);
+      const svs = falcon.signPolyBatch(hms, keypair.privateKey);
+
+      expect(svs).toBeInstanceOf(Int16Array);
+      expect(svs.length).toBe(hms.length);
+      for (let i = 0; i < messages.length; i++) {
+        const hm = hms.slice(i * 512, (i + 1) * 512);
+        expect(svs.subarray(i * 512, (i + 1) * 512)).toEqual(falcon.signPoly(hm, keypair.privateKey));
+      }
+    });
+
+    it('should verify a batch and flag only the bad entries', () => {
+      const hms = falcon.hashToPointBatch(messages);
+      const svs = falcon.signPolyBatch(hms, keypair.privateKey);
+
+      expect(falcon.verifyPolyBatch(hms, svs, keypair.publicKey)).toEqual([true, true, true, true]);
+
+      // Swap the signatures of items 1 and 2
+      const swapped = new Int16Array(svs);
+      swapped.set(svs.subarray(2 * 512, 3 * 512), 1 * 512);
+      swapped.set(svs.subarray(1 * 512, 2 * 512), 2 * 512);
+      expect(falcon.verifyPolyBatch(hms, swapped, keypair.publicKey)).toEqual([true, false, false, true]);
+    });
+
+    it('should handle empty batches', () => {
+      expect(falcon.hashToPointBatch([]).length).toBe(0);
+      expect(falcon.signPolyBatch(new Int16Array(0), keypair.privateKey).length).toBe(0);
+      expect(falcon.verifyPolyBatch(new Int16Array(0), new Int16Array(0), keypair.publicKey)).toEqual([]);
+    });
+
+    it('should reject batches that are not a multiple of 512 coefficients', () => {
+      expect(() => falcon.signPolyBatch(new Int16Array(513), keypair.privateKey)).toThrow();
+      expect(() => falcon.verifyPolyBatch(new Int16Array(1024), new Int16Array(512), keypair.publicKey)).toThrow();
+    });
+  });
+
+  describe('Key Import', () => {
+    let keypairs;
+
+    beforeAll(() => {
+      keypairs = [0, 1, 2, 3].map((k) => {
+        const seed = new Uint8Array(48).fill(k + 1);
+        return falcon.createKeypairFromSeed(seed);
+      });
+    });
+
+    it('should accept matching key pairs', () => {
+      const { valid, codes, publicKeysNtt } = falcon.importKeyPairs(
+        keypairs.map((kp) => kp.privateKey),
+        keypairs.map((kp) => kp.publicKey)
+      );
+
+      expect(valid).toEqual([true, true, true, true]);
+      expect(Array.from(codes)).toEqual([0, 0, 0, 0]);
+      expect(publicKeysNtt).toBeNull();
+    });
+
+    it('should flag mismatched and malformed pairs', () => {
+      const privateKeys = keypairs.map((kp) => kp.privateKey);
+      const publicKeys = keypairs.map((kp) => kp.publicKey);
+      publicKeys[1] = keypairs[2].publicKey;
+      privateKeys[3] = new Uint8Array(privateKeys[3]);
+      privateKeys[3][0] ^= 0x01;
+
+      const { valid, codes } = falcon.importKeyPairs(privateKeys, publicKeys);
+
+      expect(valid).toEqual([true, false, true, false]);
+      expect(Array.from(codes)).toEqual([0, -7, 0, -3]);
+    });
+
+    it('should accept flat key buffers', () => {
+      const privateKeys = new Uint8Array(keypairs.length * 1281);
+      const publicKeys = new Uint8Array(keypairs.length * 897);
+      keypairs.forEach((kp, i) => {
+        privateKeys.set(kp.privateKey, i * 1281);
+        publicKeys.set(kp.publicKey, i * 897);
+      });
+
+      expect(falcon.importKeyPairs(privateKeys, publicKeys).valid).toEqual([true, true, true, true]);
+    });
+
+    it('should return the NTT form of every decodable public key', () => {
+      const publicKeys = keypairs.map((kp) => kp.publicKey);
+      publicKeys[1] = keypairs[2].publicKey;
+
+      const { publicKeysNtt } = falcon.importKeyPairs(keypairs.map((kp) => kp.privateKey), publicKeys, { ntt: true });
+
+      expect(publicKeysNtt).toBeInstanceOf(Uint16Array);
+      expect(publicKeysNtt.length).toBe(4 * 512);
+      expect(publicKeysNtt.subarray(512, 1024)).toEqual(publicKeysNtt.subarray(1024, 1536));
+      expect(publicKeysNtt.subarray(0, 512)).not.toEqual(publicKeysNtt.subarray(1024, 1536));
+      expect(publicKeysNtt.every((v) => v < 12289)).toBe(true);
+    });
+
+    it('should handle empty batches', () => {
+      const { valid, codes } = falcon.importKeyPairs([], []);
+      expect(valid).toEqual([]);
+      expect(codes.length).toBe(0);
+    });
+
+    it('should reject inconsistent inputs', () => {
+      const privateKeys = keypairs.map((kp) => kp.privateKey);
+      const publicKeys = keypairs.map((kp) => kp.publicKey);
+      expect(() => falcon.importKeyPairs(privateKeys, publicKeys.slice(1))).toThrow();
+      expect(() => falcon.importKeyPairs([new Uint8Array(1280)], [publicKeys[0]])).toThrow();
+      expect(() => falcon.importKeyPairs(new Uint8Array(1282), new Uint8Array(897))).toThrow();
+    });
+  });
+
+  describe('Signing Handles', () => {
+    let keypair;
+    let blob;
+
+    beforeAll(() => {
+      keypair = falcon.createKeypairFromSeed(new Uint8Array(48).fill(9));
+      blob = falcon.expandPrivateKey(keypair.privateKey);
+    });
+
+    it('should serialize the expanded key as a versioned blob', () => {
+      expect(blob.length).toBe(Falcon512.constants.EXPANDED_KEY_BLOB_SIZE);
+      expect(Array.from(blob.subarray(0, 6))).toEqual([0x46, 0x58, 0x4b, 0x1a, 1, 9]);
+      expect(falcon.expandPrivateKey(keypair.privateKey)).toEqual(blob);
+    });
+
+    it('should sign like the private key does', () => {
+      const message = new TextEncoder().encode('signing handle');
+      const rngSeed = new Uint8Array(48).fill(3);
+      const signer = falcon.openSigner(blob);
+      try {
+        const signature = signer.sign(message, rngSeed);
+        expect(falcon.verifySignature(message, signature, keypair.publicKey)).toBe(true);
+        expect(signer.sign(message, rngSeed)).toEqual(signature);
+
+        const pooled = signer.sign(message);
+        expect(falcon.verifySignature(message, pooled, keypair.publicKey)).toBe(true);
+      } finally {
+        signer.close();
+      }
+    });
+
+    it('should generate the same keys and blob in one call', () => {
+      const seed = new Uint8Array(48).fill(9);
+      const { publicKey, privateKey, expandedKey } = falcon.createKeypairExpandedFromSeed(seed);
+
+      expect(privateKey).toEqual(keypair.privateKey);
+      expect(publicKey).toEqual(keypair.publicKey);
+      expect(expandedKey).toEqual(blob);
+    });
+
+    it('should reject corrupted or truncated blobs', () => {
+      const corrupted = new Uint8Array(blob);
+      corrupted[1000] ^= 0x01;
+      expect(() => falcon.openSigner(corrupted)).toThrow();
+      expect(() => falcon.openSigner(blob.subarray(8))).toThrow();
+    });
+
+    it('should refuse to sign once closed', () => {
+      const signer = falcon.openSigner(blob);
+      signer.close();
+      signer.close();
+      expect(() => signer.sign(new Uint8Array(1), new Uint8Array(48))).toThrow();
+    });
+  });
+
+  describe('SIMD Module Variants', () => {
+    it('should report WASM features as booleans', () => {
+      const features = detectWasmFeatures();
+      expect(typeof features.simd128).toBe('boolean');
+      expect(typeof features.relaxedSimd).toBe('boolean');
+    });
+
+    it('should load the baseline build on request', async () => {
+      const f = await Falcon512.load({ variant: 'baseline' });
+      expect(f.variant).toBe('baseline');
+    });
+
+    it('should reject unknown variants', async () => {
+      await expect(Falcon512.load({ variant: 'avx512' })).rejects.toThrow('Unknown WASM variant');
+    });
+
+    it('should produce the same keys and signatures as the baseline', async () => {
+      const f = await Falcon512.load();
+      const seed = new Uint8Array(48).fill(7);
+      const rngSeed = new Uint8Array(48).fill(9);
+      const message = new TextEncoder().encode('variant check');
+
+      const a = falcon.createKeypairFromSeed(seed);
+      const b = f.createKeypairFromSeed(seed);
+      expect(b.publicKey).toEqual(a.publicKey);
+      expect(b.privateKey).toEqual(a.privateKey);
+
+      const sig = f.signMessage(message, b.privateKey, rngSeed);
+      expect(sig).toEqual(falcon.signMessage(message, a.privateKey, rngSeed));
+      expect(falcon.verifySignature(message, sig, a.publicKey)).toBe(true);
+    });
+
+    it('should sign identically in the low-memory build', async () => {
+      let f;
+      try {
+        f = await Falcon512.load({ variant: 'lowmem' });
+      } catch (e) {
+        return; // `./build.sh lowmem` not run
+      }
+      expect(f.variant).toBe('lowmem');
+      const rngSeed = new Uint8Array(48).fill(3);
+      const message = new TextEncoder().encode('lowmem check');
+      const { publicKey, privateKey } = falcon.createKeypairFromSeed(new Uint8Array(48).fill(5));
+
+      const sig = f.signMessage(message, privateKey, rngSeed);
+      expect(sig).toEqual(falcon.signMessage(message, privateKey, rngSeed));
+      expect(f.verifySignature(message, sig, publicKey)).toBe(true);
+
+      const hm = falcon.hashToPoint(message);
+      expect(f.signPoly(hm, privateKey)).toEqual(falcon.signPoly(hm, privateKey));
+    });
+  });
+
+  // Node.js worker that completes the pool handshake, then exits with code
+  // 7 on the first message of the given type; a ring worker first waits for
+  // requests to be published
+  const exitingWorker = (type) => defaultCreateWorker(new URL('data:text/javascript,' + encodeURIComponent(`
+    import { parentPort } from 'node:worker_threads';
+    parentPort.on('message', (msg) => {
+      if (msg.type === 'init') {
+        parentPort.postMessage({ type: 'ready', variant: 'fake' });
+      } else if (msg.type === ${JSON.stringify(type)}) {
+        if (msg.req) {
+          Atomics.wait(new Int32Array(msg.req, 0, 16), 2, 0);
+        }
+        process.exit(7);
+      }
+    });
+    parentPort.postMessage({ type: 'loaded' });
+  `)));
+
+  describe('Worker Pool', () => {
+    let pool;
+    let keypair;
+    const rngSeed = new Uint8Array(48).fill(11);
+
+    beforeAll(async () => {
+      pool = await FalconPool.create({ size: 2, variant: 'baseline' });
+      keypair = falcon.createKeypairFromSeed(new Uint8Array(48).fill(12));
+    });
+
+    afterAll(async () => {
+      await pool.close();
+    });
+
+    it('should sign and verify like the main-thread API', async () => {
+      const message = new TextEncoder().encode('pool check');
+      const sig = await pool.sign(message, keypair.privateKey, { rngSeed });
+      expect(sig).toEqual(falcon.signMessage(message, keypair.privateKey, rngSeed));
+      expect(await pool.verify(message, sig, keypair.publicKey)).toBe(true);
+      expect(await pool.verify(new Uint8Array(1), sig, keypair.publicKey)).toBe(false);
+    });
+
+    it('should serve interactive calls ahead of queued bulk work', async () => {
+      const message = new TextEncoder().encode('bulk');
+      const signature = falcon.signMessage(message, keypair.privateKey, rngSeed);
+      const jobs = Array.from({ length: 256 }, () => ({ message, signature, publicKey: keypair.publicKey }));
+
+      let bulkDone = false;
+      const bulk = pool.verifyMany(jobs).then((r) => { bulkDone = true; return r; });
+      const sig = await pool.sign(message, keypair.privateKey, { rngSeed });
+      expect(bulkDone).toBe(false);
+      expect(sig).toEqual(signature);
+      expect((await bulk).every((ok) => ok)).toBe(true);
+
+      const m = pool.metrics();
+      expect(m.bulk.completed).toBeGreaterThanOrEqual(256);
+      expect(m.bulk.batches).toBeGreaterThanOrEqual(256 / m.bulk.maxBatch);
+      expect(m.bulk.maxConcurrency).toBe(1);
+      expect(m.interactive.queueTime.max).toBeLessThan(m.bulk.queueTime.max);
+    });
+
+    it('should reject unknown classes and failed calls', async () => {
+      await expect(pool.sign(new Uint8Array(1), keypair.privateKey, { priority: 'urgent' }))
+        .rejects.toThrow('Unknown priority class');
+      await expect(pool.sign(new Uint8Array(1), new Uint8Array(3), { rngSeed }))
+        .rejects.toThrow('Invalid private key size');
+    });
+  });
+
+  describe('Worker Pool Failures', () => {
+    it('should reject calls of a worker that exits', async () => {
+      const pool = await FalconPool.create({ size: 1, createWorker: () => exitingWorker('run') });
+      try {
+        const sign = pool.sign(new Uint8Array(1), new Uint8Array(1281));
+        const queued = pool.verify(new Uint8Array(1), new Uint8Array(1), new Uint8Array(897));
+        await expect(sign).rejects.toThrow('Worker exited with code 7');
+        await expect(queued).rejects.toThrow('All pool workers failed');
+      } finally {
+        await pool.close();
+      }
+    });
+  });
+
+  describe('Shared-Memory Verification', () => {
+    it('should return the same results as verifySignature', async () => {
+      // Small rings, so that records wrap around and requests wait in the backlog
+      const ingest = await FalconIngest.create({ workers: 2, ringBytes: 16384, completionSlots: 8, variant: 'baseline' });
+      try {
+        const keypair = falcon.createKeypairFromSeed(new Uint8Array(48).fill(13));
+        const jobs = [];
+        for (let i = 0; i < 64; i++) {
+          const message = new TextEncoder().encode(`ring message ${i}`.repeat(1 + i % 5));
+          let signature = falcon.signMessage(message, keypair.privateKey, new Uint8Array(48).fill(i));
+          if (i % 3 === 0) {
+            signature = signature.slice();
+            signature[signature.length >> 1] ^= 1;
+          }
+          jobs.push({ message, signature });
+        }
+
+        const results = await Promise.all(jobs.map((j) => ingest.verify(j.message, j.signature, keypair.publicKey)));
+        expect(results).toEqual(jobs.map((j) => falcon.verifySignature(j.message, j.signature, keypair.publicKey)));
+        expect(results.filter((ok) => !ok).length).toBeGreaterThan(0);
+
+        const s = ingest.stats();
+        expect(s.completed).toBe(64);
+        expect(s.pending).toBe(0);
+        expect(s.backlogged).toBeGreaterThan(0);
+      } finally {
+        await ingest.close();
+      }
+      await expect(ingest.verify(new Uint8Array(1), new Uint8Array(1), new Uint8Array(897)))
+        .rejects.toThrow('Ingest is closed');
+    });
+
+    it('should reject the requests of a lane whose worker exits', async () => {
+      let started = 0;
+      const ingest = await FalconIngest.create({
+        workers: 2,
+        variant: 'baseline',
+        createWorker: () => (started++ === 1 ? exitingWorker('ring') : defaultCreateWorker()),
+      });
+      try {
+        const keypair = falcon.createKeypairFromSeed(new Uint8Array(48).fill(14));
+        const message = new TextEncoder().encode('lost lane');
+        const signature = falcon.signMessage(message, keypair.privateKey, new Uint8Array(48).fill(1));
+
+        // Requests alternate between the lanes; those of the second one fail
+        const settled = await Promise.allSettled(
+          Array.from({ length: 8 }, () => ingest.verify(message, signature, keypair.publicKey)));
+        settled.forEach((r, i) => {
+          if (i % 2 === 0) {
+            expect(r).toEqual({ status: 'fulfilled', value: true });
+          } else {
+            expect(r.status).toBe('rejected');
+            expect(r.reason.message).toBe('Worker exited with code 7');
+          }
+        });
+        expect(ingest.stats().pending).toBe(0);
+
+        // The remaining lane takes all new requests
+        expect(await ingest.verify(message, signature, keypair.publicKey)).toBe(true);
+      } finally {
+        await ingest.close();
+      }
+    });
+  });
+
+  describe('Polynomial Arithmetic', () => {
+    let keypair;
+
+    beforeAll(() => {
+      keypair = falcon.createKeypairFromSeed(new Uint8Array(48).fill(11));
+    });
+
+    it('should recover short s1 = hm - s2·h for signed polynomials', () => {
+      const n = 3;
+      const hms = falcon.hashToPointBatch([0, 1, 2].map((i) => new TextEncoder().encode(`poly ${i}`)));
+      const s2 = falcon.signPolyBatch(hms, keypair.privateKey);
+
+      const b2 = falcon.polyBatch(s2);
+      const t = falcon.polyBatch(s2).mulPublicKey(keypair.publicKey);
+      const s1 = falcon.polyBatch(hms).sub(t);
+      try {
+        const n1 = s1.sqnorm();
+        const n2 = b2.sqnorm();
+        expect(n1.length).toBe(n);
+        for (let i = 0; i < n; i++) {
+          expect(n1[i] + n2[i]).toBeLessThanOrEqual(34034726);
+        }
+
+        // Same product through the generic multiplication by h
+        const h = falcon.polyBatch(falcon.getPublicKeyCoefficients(keypair.publicKey));
+        expect(b2.mul(h).toArray()).toEqual(t.toArray());
+        h.close();
+      } finally {
+        b2.close();
+        t.close();
+        s1.close();
+      }
+    });
+
+    it('should round-trip through the NTT and broadcast single operands', () => {
+      const coeffs = new Int16Array(2 * 512);
+      for (let i = 0; i < coeffs.length; i++) coeffs[i] = (i * 97) % 401 - 200;
+      const a = falcon.polyBatch(coeffs);
+      const one = falcon.polyBatch(1);
+      one.view()[0] = 1;
+      try {
+        expect(Array.from(a.centered())).toEqual(Array.from(coeffs));
+        expect(a.ntt().intt().centered()).toEqual(a.centered());
+        expect(a.toArray()).toEqual(a.mul(one).toArray());
+        const before = a.toArray();
+        expect(Array.from(a.add(one).sub(one).toArray())).toEqual(Array.from(before));
+        const three = falcon.polyBatch(3);
+        expect(() => a.add(three)).toThrow('Operand has 3 polynomials');
+        three.close();
+      } finally {
+        a.close();
+        one.close();
+      }
+      expect(() => a.ntt()).toThrow('Polynomial batch is closed');
+    });
+  });
+
   describe('Integration Tests', () => {
     it('should perform complete sign-verify-extract workflow', () => {
       // 1. Generate keypair